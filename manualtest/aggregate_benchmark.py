@@ -0,0 +1,39 @@
+import sys
+import time
+import sapien.core as sapien
+
+if len(sys.argv) < 2:
+    print("usage: python aggregate_benchmark.py robot.urdf [count]")
+    exit(1)
+
+filename = sys.argv[1]
+count = int(sys.argv[2]) if len(sys.argv) > 2 else 64
+steps = 500
+
+sim = sapien.Engine()
+
+
+def run(aggregate):
+    config = sapien.SceneConfig()
+    config.enable_articulation_aggregate = aggregate
+    scene = sim.create_scene(config)
+    scene.set_timestep(1 / 240)
+    scene.add_ground(0)
+
+    loader = scene.create_urdf_loader()
+    side = int(count ** 0.5 + 0.999)
+    for i in range(count):
+        robot = loader.load(filename)
+        robot.set_root_pose(sapien.Pose([i % side, i // side, 0.5]))
+
+    for _ in range(10):
+        scene.step()
+    t = time.time()
+    for _ in range(steps):
+        scene.step()
+    return (time.time() - t) / steps
+
+
+print("{} robots".format(count))
+for aggregate in [False, True]:
+    print("aggregate {:>5}: {:.4f} ms/step".format(str(aggregate), run(aggregate) * 1000))
@@ -0,0 +1,40 @@
+import time
+import sapien.core as sapien
+from sapien.core import Pose
+
+frames = 200
+
+sim = sapien.Engine()
+renderer = sapien.VulkanRenderer(offscreen_only=True)
+sim.set_renderer(renderer)
+scene = sim.create_scene()
+scene.add_ground(0)
+scene.set_ambient_light([0.5, 0.5, 0.5])
+builder = scene.create_actor_builder()
+builder.add_box_visual(half_size=[0.1, 0.1, 0.1], color=[0.8, 0.2, 0.2])
+builder.build().set_pose(Pose([0, 0, 0.1]))
+
+camera = scene.add_camera("camera", 640, 480, 1, 0.1, 100)
+camera.set_local_pose(Pose([-1, 0, 0.5], [0.9659258, 0, 0.258819, 0]))
+scene.update_render()
+
+t = time.time()
+for _ in range(frames):
+    scene.update_render()
+    camera.take_picture()
+    color = camera.get_float_texture("Color")
+    seg = camera.get_uint32_texture("Segmentation")
+print("blocking readback: {:.1f} fps".format(frames / (time.time() - t)))
+
+# overlap: read picture i while picture i + 1 renders
+names = ["Color", "Segmentation"]
+scene.update_render()
+camera.take_picture_async(names)
+t = time.time()
+for _ in range(frames):
+    color = camera.get_image_async("Color")
+    seg = camera.get_image_async("Segmentation")
+    scene.update_render()
+    camera.take_picture_async(names)
+    color.mean()  # still valid, the new picture renders into the other buffers
+print("async readback: {:.1f} fps".format(frames / (time.time() - t)))
@@ -0,0 +1,32 @@
+import sys
+import time
+import sapien.core as sapien
+
+if len(sys.argv) < 3:
+    print("usage: python bundle.py robot.urdf robot.sapien_bundle")
+    exit(1)
+
+sim = sapien.Engine()
+renderer = sapien.VulkanRenderer(offscreen_only=True)
+sim.set_renderer(renderer)
+
+scene = sim.create_scene()
+loader = scene.create_urdf_loader()
+loader.fix_root_link = True
+
+t = time.time()
+loader.save_bundle(sys.argv[1], sys.argv[2])
+print("bundled in {:.3f}s".format(time.time() - t))
+
+# load into a fresh engine so collision meshes come from the bundle
+del loader, scene, sim, renderer
+sim = sapien.Engine()
+renderer = sapien.VulkanRenderer(offscreen_only=True)
+sim.set_renderer(renderer)
+scene = sim.create_scene()
+loader = scene.create_urdf_loader()
+loader.fix_root_link = True
+
+t = time.time()
+robot = loader.load_bundle(sys.argv[2])
+print("loaded {} links from bundle in {:.3f}s".format(len(robot.get_links()), time.time() - t))
@@ -0,0 +1,57 @@
+import time
+import numpy as np
+import sapien.core as sapien
+from sapien.core import Pose
+
+frames = 50
+
+sim = sapien.Engine()
+renderer = sapien.CpuRenderer()
+sim.set_renderer(renderer)
+
+scene = sim.create_scene()
+scene.add_ground(0)
+scene.set_ambient_light([0.3, 0.3, 0.3])
+scene.add_directional_light([0, 0.5, -1], [0.7, 0.7, 0.7])
+
+builder = scene.create_actor_builder()
+builder.add_box_visual(half_size=[0.1, 0.1, 0.1], color=[0.8, 0.2, 0.2])
+builder.add_box_collision(half_size=[0.1, 0.1, 0.1])
+for i in range(5):
+    box = builder.build()
+    box.set_pose(Pose([0.3 * i - 0.6, 0, 0.1]))
+
+builder = scene.create_actor_builder()
+builder.add_sphere_visual(radius=0.1, color=[0.2, 0.8, 0.2])
+builder.add_capsule_visual(pose=Pose([0, 0, 0.3]), radius=0.05, half_length=0.1,
+                           color=[0.2, 0.2, 0.8])
+builder.add_sphere_collision(radius=0.1)
+ball = builder.build()
+ball.set_pose(Pose([0, 0.4, 0.1]))
+scene.step()
+scene.update_render()
+
+
+def run(width, height):
+    camera = scene.add_camera("camera_{}x{}".format(width, height), width, height, 1, 0.1, 100)
+    camera.set_local_pose(Pose([-1.5, 0, 0.8], [0.9659258, 0, 0.258819, 0]))
+    camera.take_picture()
+
+    t = time.time()
+    for _ in range(frames):
+        camera.take_picture()
+        color = camera.get_color_rgba()
+        depth = camera.get_float_texture("Depth")
+        seg = camera.get_visual_actor_segmentation()
+    fps = frames / (time.time() - t)
+
+    assert color.shape == (height, width, 4)
+    assert depth.shape == (height, width)
+    assert seg.shape == (height, width, 4)
+    print("{}x{}: {:.1f} fps, {} actors visible".format(
+        width, height, fps, len(np.unique(seg[..., 1])) - 1))
+    scene.remove_camera(camera)
+
+
+run(128, 128)
+run(640, 480)
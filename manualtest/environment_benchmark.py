@@ -0,0 +1,73 @@
+import sys
+import time
+import sapien.core as sapien
+
+if len(sys.argv) < 2:
+    print("usage: python environment_benchmark.py robot.urdf")
+    exit(1)
+
+filename = sys.argv[1]
+steps = 200
+
+sim = sapien.Engine()
+
+
+def run_environments(count):
+    scene = sim.create_scene()
+    scene.set_timestep(1 / 240)
+    scene.add_ground(0)
+
+    loader = scene.create_urdf_loader()
+    side = int(count ** 0.5 + 0.999)
+    for i in range(count):
+        # environments may overlap since they never collide with each other
+        env = scene.add_environment([(i % side) * 2, (i // side) * 2, 0])
+        loader.environment = env
+        robot = loader.load(filename)
+        robot.set_root_pose(sapien.Pose(scene.get_environment_offset(env) + [0, 0, 0.5]))
+        scene.save_environment_state(env)
+
+    for _ in range(10):
+        scene.step()
+    t = time.time()
+    for _ in range(steps):
+        scene.step()
+    step_time = time.time() - t
+
+    t = time.time()
+    for env in range(count):
+        scene.reset_environment(env)
+    reset_time = time.time() - t
+    return count * steps / step_time, reset_time
+
+
+def run_scenes(count):
+    scenes = []
+    for i in range(count):
+        scene = sim.create_scene()
+        scene.set_timestep(1 / 240)
+        scene.add_ground(0)
+        loader = scene.create_urdf_loader()
+        robot = loader.load(filename)
+        robot.set_root_pose(sapien.Pose([0, 0, 0.5]))
+        scenes.append(scene)
+
+    for _ in range(10):
+        for scene in scenes:
+            scene.step()
+    t = time.time()
+    for _ in range(steps):
+        for scene in scenes:
+            scene.step()
+    return count * steps / (time.time() - t)
+
+
+for count in [64, 256, 1024]:
+    env_rate, reset_time = run_environments(count)
+    scene_rate = run_scenes(count)
+    print(
+        "{:>5} envs: one scene {:>10.0f} env-steps/s (reset all {:.2f} ms), "
+        "separate scenes {:>10.0f} env-steps/s".format(
+            count, env_rate, reset_time * 1000, scene_rate
+        )
+    )
@@ -0,0 +1,54 @@
+import os
+import time
+import sapien.core as sapien
+from sapien.core import Pose
+
+filename = "/tmp/episode.sapien"
+steps = 5000
+
+sim = sapien.Engine()
+sim.set_renderer(sapien.NullRenderer())
+scene = sim.create_scene()
+scene.set_timestep(1 / 240)
+scene.add_ground(0)
+
+builder = scene.create_actor_builder()
+builder.add_box_collision(half_size=[0.05, 0.05, 0.05])
+builder.add_box_visual(half_size=[0.05, 0.05, 0.05])
+for i in range(200):
+    box = builder.build()
+    box.set_pose(Pose([(i % 10) * 0.2, (i // 10 % 10) * 0.2, 0.1 + 0.2 * (i // 100)]))
+scene.add_camera("camera", 128, 128, 1, 0.1, 100)
+
+t = time.time()
+for _ in range(steps):
+    scene.step()
+    scene.update_render()
+baseline = time.time() - t
+
+scene.start_recording(filename)
+t = time.time()
+for _ in range(steps):
+    scene.step()
+    scene.update_render()
+recording = time.time() - t
+scene.stop_recording()
+
+print("record overhead per frame: {:.1f} us".format((recording - baseline) / steps * 1e6))
+print("file size: {:.1f} KB, {:.1f} bytes per frame".format(
+    os.path.getsize(filename) / 1024, os.path.getsize(filename) / steps))
+
+# replay without stepping, driving the bodies of the recorded scene
+bodies = [b for a in scene.get_all_actors() for b in a.get_visual_bodies()]
+replayer = sapien.EpisodeReplayer(filename)
+replayer.bind(bodies)
+
+t = time.time()
+for i in range(replayer.frame_count):
+    replayer.apply(i)
+print("sequential replay: {:.0f} fps".format(replayer.frame_count / (time.time() - t)))
+
+t = time.time()
+for i in range(1000):
+    replayer.apply((i * 7919) % replayer.frame_count)
+print("random seek replay: {:.0f} fps".format(1000 / (time.time() - t)))
@@ -0,0 +1,63 @@
+import os
+import sys
+import tempfile
+import time
+import numpy as np
+import sapien.core as sapien
+
+size = int(sys.argv[1]) if len(sys.argv) > 1 else 256
+steps = 500
+spacing = 0.1
+
+sim = sapien.Engine()
+
+# rolling terrain
+x, y = np.meshgrid(np.arange(size), np.arange(size))
+noise = np.random.RandomState(0).rand(size, size)
+heights = 0.3 * np.sin(x * 0.15) * np.cos(y * 0.1) + 0.05 * noise
+height_field = sim.create_height_field(heights.astype(np.float32), [spacing, spacing, 1])
+
+# the equivalent triangle mesh, written once so both runs share the same surface
+mesh_file = os.path.join(tempfile.mkdtemp(), "terrain.obj")
+with open(mesh_file, "w") as f:
+    for v in height_field.vertices:
+        f.write("v {} {} {}\n".format(*v))
+    for t in height_field.indices.reshape(-1, 3) + 1:
+        f.write("f {} {} {}\n".format(*t))
+
+
+def run(use_height_field):
+    scene = sim.create_scene()
+    scene.set_timestep(1 / 240)
+
+    t = time.time()
+    builder = scene.create_actor_builder()
+    if use_height_field:
+        builder.add_height_field_collision(height_field)
+    else:
+        builder.add_nonconvex_collision_from_file(mesh_file)
+    builder.build_static()
+    build_time = time.time() - t
+
+    extent = (size - 1) * spacing
+    for i in range(10):
+        for j in range(10):
+            builder = scene.create_actor_builder()
+            if (i + j) % 2:
+                builder.add_sphere_collision(radius=0.1)
+            else:
+                builder.add_box_collision(half_size=[0.1, 0.1, 0.1])
+            body = builder.build()
+            body.set_pose(sapien.Pose([(i + 0.5) * extent / 10, (j + 0.5) * extent / 10, 1]))
+
+    t = time.time()
+    for _ in range(steps):
+        scene.step()
+    return build_time, (time.time() - t) / steps
+
+
+print("{}x{} samples, {} triangles".format(size, size, len(height_field.indices) // 3))
+print("{:>14} {:>12} {:>12}".format("", "build (s)", "step (ms)"))
+for name, use_height_field in [("triangle mesh", False), ("heightfield", True)]:
+    build_time, step_time = run(use_height_field)
+    print("{:>14} {:>12.3f} {:>12.4f}".format(name, build_time, step_time * 1000))
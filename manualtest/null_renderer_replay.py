@@ -0,0 +1,42 @@
+import time
+import sapien.core as sapien
+from sapien.core import Pose
+from sapien.utils import Viewer
+
+# record headless
+sim = sapien.Engine()
+sim.set_renderer(sapien.NullRenderer())
+scene = sim.create_scene()
+scene.set_timestep(1 / 240)
+scene.add_ground(0)
+scene.add_directional_light([0, 1, -1], [0.5, 0.5, 0.5])
+
+builder = scene.create_actor_builder()
+builder.add_box_collision(half_size=[0.1, 0.1, 0.1])
+builder.add_box_visual(half_size=[0.1, 0.1, 0.1], color=[0.8, 0.2, 0.2])
+for i in range(10):
+    box = builder.build()
+    box.set_pose(Pose([0, 0, 0.3 + 0.25 * i]))
+
+record = scene.renderer_scene
+record.recording = True
+t = time.time()
+for _ in range(1000):
+    scene.step()
+    scene.update_render()
+print("recorded {} frames in {:.3f}s".format(record.frame_count, time.time() - t))
+
+# replay in the Vulkan renderer
+renderer = sapien.VulkanRenderer()
+sim2 = sapien.Engine()
+sim2.set_renderer(renderer)
+replay_scene = sim2.create_scene()
+bodies = record.instantiate(replay_scene.renderer_scene)
+
+viewer = Viewer(renderer)
+viewer.set_scene(replay_scene)
+viewer.set_camera_xyz(-3, 0, 1)
+for i in range(record.frame_count):
+    record.apply_frame(i, bodies)
+    replay_scene.update_render()
+    viewer.render()
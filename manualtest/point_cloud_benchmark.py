@@ -0,0 +1,81 @@
+import time
+import numpy as np
+import sapien.core as sapien
+from sapien.core import Pose
+
+camera_count = 8
+frames = 20
+voxel = 0.01
+
+sim = sapien.Engine()
+renderer = sapien.VulkanRenderer(offscreen_only=True)
+sim.set_renderer(renderer)
+scene = sim.create_scene()
+scene.add_ground(0)
+scene.set_ambient_light([0.5, 0.5, 0.5])
+builder = scene.create_actor_builder()
+builder.add_box_visual(half_size=[0.1, 0.1, 0.1], color=[0.8, 0.2, 0.2])
+box = builder.build()
+box.set_pose(Pose([0, 0, 0.1]))
+
+cameras = []
+for i in range(camera_count):
+    angle = 2 * np.pi * i / camera_count
+    camera = scene.add_camera("camera{}".format(i), 640, 480, 1, 0.1, 100)
+    position = np.array([np.cos(angle), np.sin(angle), 0.5])
+    forward = -position / np.linalg.norm(position)
+    left = np.cross([0, 0, 1], forward)
+    left /= np.linalg.norm(left)
+    up = np.cross(forward, left)
+    mat = np.eye(4)
+    mat[:3, :3] = np.stack([forward, left, up], axis=1)
+    mat[:3, 3] = position
+    camera.set_local_pose(Pose.from_transformation_matrix(mat))
+    cameras.append(camera)
+
+scene.update_render()
+for camera in cameras:
+    camera.take_picture()
+
+
+def numpy_fusion():
+    points, labels = [], []
+    for camera in cameras:
+        position = camera.get_float_texture("Position")
+        seg = camera.get_uint32_texture("Segmentation")
+        mask = (position[..., 3] < 1) & (-position[..., 2] < 2)
+        model = camera.get_model_matrix()
+        points.append(position[mask][:, :3] @ model[:3, :3].T + model[:3, 3])
+        labels.append(seg[..., 1][mask])
+    points = np.concatenate(points)
+    labels = np.concatenate(labels)
+    keys, inverse = np.unique(np.floor(points / voxel).astype(np.int64), axis=0,
+                              return_inverse=True)
+    counts = np.bincount(inverse.ravel())
+    mean = np.stack([np.bincount(inverse.ravel(), points[:, k]) for k in range(3)], 1)
+    return mean / counts[:, None]
+
+
+fusion = sapien.PointCloudBuilder()
+fusion.set_depth_range(0, 2)
+fusion.voxel_size = voxel
+
+ref = numpy_fusion()
+cloud = fusion.build(cameras, with_label=True)
+print("numpy {} points, native {} points".format(len(ref), len(cloud["xyz"])))
+assert len(ref) == len(cloud["xyz"])
+
+t = time.time()
+for _ in range(frames):
+    numpy_fusion()
+print("numpy: {:.1f} ms".format((time.time() - t) / frames * 1000))
+
+t = time.time()
+for _ in range(frames):
+    fusion.build(cameras, with_color=True, with_label=True)
+print("native: {:.1f} ms".format((time.time() - t) / frames * 1000))
+
+fusion.set_segmentation_filter([box.get_id()])
+cloud = fusion.build(cameras, with_label=True)
+assert (cloud["label"] == box.get_id()).all()
+print("box points:", len(cloud["xyz"]))
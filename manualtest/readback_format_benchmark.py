@@ -0,0 +1,67 @@
+import time
+import numpy as np
+import sapien.core as sapien
+from sapien.core import Pose
+
+frames = 200
+camera_count = 16
+
+sim = sapien.Engine()
+renderer = sapien.VulkanRenderer(offscreen_only=True)
+sim.set_renderer(renderer)
+scene = sim.create_scene()
+scene.add_ground(0)
+scene.set_ambient_light([0.5, 0.5, 0.5])
+builder = scene.create_actor_builder()
+builder.add_box_visual(half_size=[0.1, 0.1, 0.1], color=[0.8, 0.2, 0.2])
+builder.build().set_pose(Pose([0, 0, 0.1]))
+
+cameras = []
+for i in range(camera_count):
+    camera = scene.add_camera("camera{}".format(i), 640, 480, 1, 0.1, 100)
+    camera.set_local_pose(Pose([-1, 0.05 * i, 0.5], [0.9659258, 0, 0.258819, 0]))
+    cameras.append(camera)
+scene.update_render()
+for camera in cameras:
+    camera.take_picture()
+
+# conversions agree with numpy on the float images
+camera = cameras[0]
+color = camera.get_color_rgba()
+expected = (np.clip(color[..., :3], 0, 1) * 255 + 0.5).astype(np.uint8)
+assert (camera.get_color_rgb8() == expected).all()
+assert (camera.get_float16_texture("Color") == color.astype(np.float16)).all()
+position = camera.get_float_texture("Position")
+depth = np.where(position[..., 3] < 1, -position[..., 2], 0)
+assert np.allclose(camera.get_depth(), depth)
+
+
+def bench(name, fn):
+    t = time.time()
+    for _ in range(frames):
+        scene.update_render()
+        for camera in cameras:
+            camera.take_picture()
+        for camera in cameras:
+            fn(camera)
+    print("{}: {:.1f} fps".format(name, frames / (time.time() - t)))
+
+
+bench("float + numpy uint8",
+      lambda c: (np.clip(c.get_color_rgba()[..., :3], 0, 1) * 255).astype(np.uint8))
+bench("native uint8", lambda c: c.get_color_rgb8())
+bench("native float16", lambda c: c.get_float16_texture("Color"))
+bench("float + numpy depth", lambda c: -c.get_float_texture("Position")[..., 2])
+bench("native depth", lambda c: c.get_depth())
+
+# converted straight from the mapped readback buffers
+names = ["Color", "Position"]
+t = time.time()
+for _ in range(frames):
+    scene.update_render()
+    for camera in cameras:
+        camera.take_picture_async(names)
+    for camera in cameras:
+        camera.get_color_rgb8_async()
+        camera.get_depth_async()
+print("async uint8 + depth: {:.1f} fps".format(frames / (time.time() - t)))
@@ -0,0 +1,56 @@
+import time
+import numpy as np
+import sapien.core as sapien
+from sapien.core import Pose
+
+camera_count = 32
+frames = 50
+
+
+def build(share):
+    sim = sapien.Engine()
+    renderer = sapien.VulkanRenderer(offscreen_only=True)
+    renderer.share_camera_targets = share
+    sim.set_renderer(renderer)
+    scene = sim.create_scene()
+    scene.add_ground(0)
+    scene.set_ambient_light([0.5, 0.5, 0.5])
+    builder = scene.create_actor_builder()
+    builder.add_box_visual(half_size=[0.1, 0.1, 0.1], color=[0.8, 0.2, 0.2])
+    builder.build().set_pose(Pose([0, 0, 0.1]))
+
+    t = time.time()
+    cameras = []
+    for i in range(camera_count):
+        camera = scene.add_camera("camera{}".format(i), 640, 480, 1, 0.1, 100)
+        camera.set_local_pose(Pose([-1, 0.05 * i, 0.5], [0.9659258, 0, 0.258819, 0]))
+        cameras.append(camera)
+    create_time = time.time() - t
+    return sim, renderer, scene, cameras, create_time
+
+
+results = {}
+for share in [False, True]:
+    sim, renderer, scene, cameras, create_time = build(share)
+    scene.update_render()
+    for camera in cameras:
+        camera.take_picture()
+    t = time.time()
+    for _ in range(frames):
+        scene.update_render()
+        for camera in cameras:
+            camera.take_picture()
+        images = [c.get_float_texture("Color") for c in cameras]
+    fps = frames / (time.time() - t)
+    results[share] = images
+
+    stats = renderer.get_camera_memory_stats()
+    targets = sum(s["render_target_bytes"] / s["sharing_cameras"] for s in stats)
+    readback = sum(s["readback_bytes"] for s in stats)
+    print("shared={}: create {:.2f} s, {:.1f} fps, targets {:.1f} MB, readback {:.1f} MB".format(
+        share, create_time, fps, targets / 2**20, readback / 2**20))
+    del cameras, scene, renderer, sim
+
+# every camera keeps its own picture when the targets are shared
+for a, b in zip(results[False], results[True]):
+    assert np.allclose(a, b)
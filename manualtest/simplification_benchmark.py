@@ -0,0 +1,64 @@
+import sys
+import time
+import numpy as np
+import sapien.core as sapien
+
+if len(sys.argv) < 2:
+    print("usage: python simplification_benchmark.py mesh.obj [budget ...]")
+    exit(1)
+
+filename = sys.argv[1]
+budgets = [int(b) for b in sys.argv[2:]] or [0, 20000, 5000, 1000, 200]
+steps = 500
+
+sim = sapien.Engine()
+
+
+def run(budget):
+    """drop a grid of spheres and convex copies onto the static mesh"""
+    scene = sim.create_scene()
+    scene.set_timestep(1 / 240)
+
+    builder = scene.create_actor_builder()
+    builder.add_nonconvex_collision_from_file(filename, max_triangles=budget)
+    builder.build_static()
+
+    bodies = []
+    for i in range(5):
+        for j in range(5):
+            builder = scene.create_actor_builder()
+            if (i + j) % 2:
+                builder.add_sphere_collision(radius=0.05)
+            else:
+                builder.add_collision_from_file(
+                    filename, scale=[0.1, 0.1, 0.1], max_triangles=budget
+                )
+            body = builder.build()
+            body.set_pose(sapien.Pose([(i - 2) * 0.2, (j - 2) * 0.2, 1]))
+            bodies.append(body)
+
+    for _ in range(10):
+        scene.step()
+    t = time.time()
+    for _ in range(steps - 10):
+        scene.step()
+    dt = (time.time() - t) / (steps - 10)
+    return dt, np.array([b.get_pose().p for b in bodies])
+
+
+results = {}
+for budget in budgets:
+    t = time.time()
+    results[budget] = run(budget)
+    results[budget] += (time.time() - t,)
+
+reference = results[budgets[0]][1]
+print("{:>10} {:>12} {:>12} {:>14}".format("budget", "step (ms)", "total (s)", "rest err (m)"))
+for budget in budgets:
+    dt, positions, total = results[budget]
+    err = np.linalg.norm(positions - reference, axis=1).mean()
+    print(
+        "{:>10} {:>12.4f} {:>12.3f} {:>14.5f}".format(
+            budget or "full", dt * 1000, total, err
+        )
+    )
@@ -0,0 +1,54 @@
+import time
+import numpy as np
+import sapien.core as sapien
+from sapien.sensor.depth_processor import calc_main_depth_from_left_right_ir
+
+# fakesense_j415 IR cameras looking at a textured plane
+frames = 10
+ir_w, ir_h = 1280, 720
+rgb_w, rgb_h = 1920, 1080
+k_ir = np.array([[920.0, 0, 640], [0, 920, 360], [0, 0, 1]])
+k_rgb = np.array([[1380.0, 0, 960], [0, 1380, 540], [0, 0, 1]])
+baseline = 0.0545
+depth = 0.8
+
+ex_main = np.eye(4)
+ex_l = np.eye(4)
+ex_l[0, 3] = -0.0175
+ex_r = np.eye(4)
+ex_r[0, 3] = -0.0175 - baseline
+
+rng = np.random.default_rng(0)
+texture = rng.integers(0, 256, (ir_h, ir_w + 256)).astype(np.float32)
+x = np.arange(ir_w) + 128.0
+disparity = k_ir[0, 0] * baseline / depth
+ir_l = np.stack([np.interp(x, np.arange(ir_w + 256), row) for row in texture]).astype(np.uint8)
+ir_r = np.stack([np.interp(x + disparity, np.arange(ir_w + 256), row) for row in texture])
+ir_r = ir_r.astype(np.uint8)
+
+
+def report(name, fn):
+    fn()
+    t = time.time()
+    for _ in range(frames):
+        result = fn()
+    valid = result > 0
+    print(
+        "{}: {:.1f} ms, valid {:.3f}, median depth {:.4f} (truth {})".format(
+            name, (time.time() - t) / frames * 1000, valid.mean(), np.median(result[valid]), depth
+        )
+    )
+
+
+report(
+    "python",
+    lambda: calc_main_depth_from_left_right_ir(
+        ir_l, ir_r, ex_l, ex_r, ex_main, k_ir, k_ir, k_rgb,
+        ndisp=128, use_noise=False, main_cam_size=(rgb_w, rgb_h),
+    ),
+)
+
+processor = sapien.StereoDepthProcessor(
+    ir_w, ir_h, k_ir, k_ir, ex_l, ex_r, rgb_w, rgb_h, k_rgb, ex_main
+)
+report("native", lambda: processor.compute(ir_l, ir_r))
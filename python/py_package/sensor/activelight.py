@@ -6,9 +6,10 @@ from ..core import (
     Scene,
     ArticulationBase,
     CameraEntity,
+    StereoDepthConfig,
+    StereoDepthProcessor,
 )
 
-from .depth_processor import calc_main_depth_from_left_right_ir
 from .sensor_base import SensorEntity
 
 from typing import Optional, Tuple
@@ -85,6 +86,7 @@ class ActiveLightSensor(SensorEntity):
         self.pose = Pose()
 
         self._create_cameras()
+        self._create_depth_processor()
         self.alight = self.scene.add_active_light(
             pose=Pose([0, 0, 0]),
             color=[0, 0, 0],
@@ -150,21 +152,8 @@ class ActiveLightSensor(SensorEntity):
             self._fetch('ir_l')
             self._fetch('ir_r')
 
-            ex_l = self._pose2cv2ex(self.trans_pose_l)
-            ex_r = self._pose2cv2ex(self.trans_pose_r)
-            ex_main = self._pose2cv2ex(Pose())
-
-            depth = calc_main_depth_from_left_right_ir(
-                self._float2uint8(self._ir_l),
-                self._float2uint8(self._ir_r),
-                ex_l, ex_r, ex_main,
-                self.ir_intrinsic, self.ir_intrinsic, self.rgb_intrinsic,
-                lr_consistency=False, main_cam_size=(self.rgb_w, self.rgb_h),
-                ndisp=128, use_census=True, register_depth=True, census_wsize=7,
-                use_noise=False)
-            depth[depth > self.max_depth] = 0
-            depth[depth < self.min_depth] = 0
-            self._depth = depth
+            self._depth = self.depth_processor.compute(
+                self._float2uint8(self._ir_l), self._float2uint8(self._ir_r))
 
         return copy(self._depth)
 
@@ -234,6 +223,21 @@ class ActiveLightSensor(SensorEntity):
             self.ir_intrinsic[0, 1]
         )
 
+    def _create_depth_processor(self):
+        # native port of depth_processor.calc_main_depth_from_left_right_ir
+        config = StereoDepthConfig()
+        config.max_disparity = 128
+        config.census_size = 7
+        config.register_depth = True
+        config.median_size = 5
+        config.use_noise = False
+        config.min_depth = self.min_depth
+        config.max_depth = self.max_depth
+        self.depth_processor = StereoDepthProcessor(
+            self.ir_w, self.ir_h, self.ir_intrinsic, self.ir_intrinsic,
+            self._pose2cv2ex(self.trans_pose_l), self._pose2cv2ex(self.trans_pose_r),
+            self.rgb_w, self.rgb_h, self.rgb_intrinsic, self._pose2cv2ex(Pose()), config)
+
     def _ir_mode(self):
         if self.light_pattern is None:
             return
@@ -25,6 +25,10 @@
 #include "articulation/sapien_kinematic_joint.h"
 #include "articulation/sapien_link.h"
 #include "articulation/urdf_loader.h"
+#include "episode_recorder.h"
+#include "mesh_cache.h"
+#include "point_cloud_builder.h"
+#include "depth_processor.h"
 #include "event_system/event_system.h"
 
 #include "renderer/svulkan2_renderer.h"
@@ -32,6 +36,9 @@
 
 #include "renderer/kuafu_renderer.hpp"
 
+#include "renderer/cpu_renderer.h"
+#include "renderer/null_renderer.h"
+
 #ifdef _USE_PINOCCHIO
 #include "articulation/pinocchio_model.h"
 #endif
@@ -41,28 +48,148 @@
 using namespace sapien;
 namespace py = pybind11;
 
-py::array_t<float> getFloatImageFromCamera(SCamera &cam, std::string const &name) {
-  uint32_t width = cam.getWidth();
-  uint32_t height = cam.getHeight();
-  auto image = cam.getRendererCamera()->getFloatImage(name);
+/** numpy array owning a downloaded image, the vector is moved instead of copied */
+template <typename T>
+py::array_t<T> makeImageArray(std::vector<T> &&image, uint32_t width, uint32_t height) {
   uint32_t channel = image.size() / (width * height);
+  auto data = new std::vector<T>(std::move(image));
+  py::capsule owner(data, [](void *p) { delete static_cast<std::vector<T> *>(p); });
   if (channel == 1) {
-    return py::array_t<float>({height, width}, image.data());
+    return py::array_t<T>({height, width}, data->data(), owner);
   } else {
-    return py::array_t<float>({height, width, channel}, image.data());
+    return py::array_t<T>({height, width, channel}, data->data(), owner);
   }
 }
 
+/** numpy array of rows owning a vector, 1D for a single column */
+template <typename T> py::array_t<T> makeRowArray(std::vector<T> &&data, size_t columns) {
+  size_t rows = data.size() / columns;
+  auto owned = new std::vector<T>(std::move(data));
+  py::capsule owner(owned, [](void *p) { delete static_cast<std::vector<T> *>(p); });
+  if (columns == 1) {
+    return py::array_t<T>({rows}, owned->data(), owner);
+  }
+  return py::array_t<T>({rows, columns}, owned->data(), owner);
+}
+
+py::array_t<float> getFloatImageFromCamera(SCamera &cam, std::string const &name) {
+  return makeImageArray(cam.getRendererCamera()->getFloatImage(name), cam.getWidth(),
+                        cam.getHeight());
+}
+
 py::array_t<uint32_t> getUintImageFromCamera(SCamera &cam, std::string const &name) {
-  uint32_t width = cam.getWidth();
-  uint32_t height = cam.getHeight();
-  auto image = cam.getRendererCamera()->getUintImage(name);
-  uint32_t channel = image.size() / (width * height);
-  if (channel == 1) {
-    return py::array_t<uint32_t>({height, width}, image.data());
+  return makeImageArray(cam.getRendererCamera()->getUintImage(name), cam.getWidth(),
+                        cam.getHeight());
+}
+
+/** float16 numpy array over the half precision bits of a converted image */
+py::array makeHalfImageArray(std::vector<uint16_t> &&image, uint32_t width, uint32_t height) {
+  return makeImageArray(std::move(image), width, height).attr("view")("float16").cast<py::array>();
+}
+
+py::array getHalfImageFromCamera(SCamera &cam, std::string const &name) {
+  return makeHalfImageArray(cam.getRendererCamera()->getHalfImage(name), cam.getWidth(),
+                            cam.getHeight());
+}
+
+using IRImageArray = py::array_t<uint8_t, py::array::c_style | py::array::forcecast>;
+
+/** row major copy of a 2D uint8 image of the given size */
+std::vector<uint8_t> getIRImage(IRImageArray const &image, uint32_t width, uint32_t height) {
+  if (image.ndim() != 2 || image.shape(0) != static_cast<py::ssize_t>(height) ||
+      image.shape(1) != static_cast<py::ssize_t>(width)) {
+    throw std::invalid_argument("IR image must be a (" + std::to_string(height) + ", " +
+                                std::to_string(width) + ") array");
+  }
+  return std::vector<uint8_t>(image.data(), image.data() + image.size());
+}
+
+Renderer::SVulkan2Camera *getVulkanCamera(SCamera &cam) {
+  auto vcam = dynamic_cast<Renderer::SVulkan2Camera *>(cam.getRendererCamera());
+  if (!vcam) {
+    throw std::runtime_error("this function is only supported by the Vulkan renderer");
+  }
+  return vcam;
+}
+
+using ReadbackBuffer = std::shared_ptr<svulkan2::core::Buffer>;
+
+/** numpy view of the mapped readback buffer
+ *
+ *  The view keeps the buffer alive but not its content: the camera copies into it again two
+ *  pictures later.
+ */
+py::array getImageAsyncFromCamera(SCamera &cam, std::string const &name) {
+  auto image = getVulkanCamera(cam)->getImageAsync(name);
+  py::dtype dtype = image.format == vk::Format::eR32G32B32A32Uint ? py::dtype::of<uint32_t>()
+                    : image.format == vk::Format::eR8G8B8A8Unorm  ? py::dtype::of<uint8_t>()
+                                                                  : py::dtype::of<float>();
+  std::vector<py::ssize_t> shape{image.height, image.width};
+  if (image.channels > 1) {
+    shape.push_back(image.channels);
+  }
+  // the base stops numpy from copying and holds a reference to the buffer
+  py::capsule base(new ReadbackBuffer(image.buffer),
+                   [](void *p) { delete static_cast<ReadbackBuffer *>(p); });
+  return py::array(dtype, shape, image.data, base);
+}
+
+py::capsule getDLTensorAsyncFromCamera(SCamera &cam, std::string const &name) {
+  auto image = getVulkanCamera(cam)->getImageAsync(name);
+  auto tensor = new DLManagedTensor();
+  int ndim = image.channels > 1 ? 3 : 2;
+  auto shape = new int64_t[3]{image.height, image.width, image.channels};
+  tensor->dl_tensor.data = const_cast<void *>(image.data);
+  tensor->dl_tensor.device = {DLDeviceType::kDLCPU, 0};
+  tensor->dl_tensor.ndim = ndim;
+  if (image.format == vk::Format::eR32G32B32A32Uint) {
+    tensor->dl_tensor.dtype = {DLDataTypeCode::kDLUInt, 32, 1};
+  } else if (image.format == vk::Format::eR8G8B8A8Unorm) {
+    tensor->dl_tensor.dtype = {DLDataTypeCode::kDLUInt, 8, 1};
   } else {
-    return py::array_t<uint32_t>({height, width, channel}, image.data());
+    tensor->dl_tensor.dtype = {DLDataTypeCode::kDLFloat, 32, 1};
   }
+  tensor->dl_tensor.shape = shape;
+  tensor->dl_tensor.strides = nullptr;
+  tensor->dl_tensor.byte_offset = 0;
+  tensor->manager_ctx = new ReadbackBuffer(image.buffer);
+  tensor->deleter = [](DLManagedTensor *self) {
+    delete[] self->dl_tensor.shape;
+    delete static_cast<ReadbackBuffer *>(self->manager_ctx);
+    delete self;
+  };
+  auto capsule_destructor = [](PyObject *data) {
+    DLManagedTensor *tensor = (DLManagedTensor *)PyCapsule_GetPointer(data, "dltensor");
+    if (tensor) {
+      tensor->deleter(const_cast<DLManagedTensor *>(tensor));
+    } else {
+      PyErr_Clear();
+    }
+  };
+  return py::capsule(tensor, "dltensor", capsule_destructor);
+}
+
+py::dict memoryStats2dict(Renderer::SVulkan2CameraMemoryStats const &stats) {
+  py::dict d;
+  d["scene"] = stats.sceneName;
+  d["camera_index"] = stats.cameraIndex;
+  d["render_target_bytes"] = stats.renderTargetBytes;
+  d["readback_bytes"] = stats.readbackBytes;
+  d["sharing_cameras"] = stats.sharingCameras;
+  return d;
+}
+
+py::array_t<float> poses2array(std::vector<PxTransform> const &poses) {
+  py::array_t<float> arr({poses.size(), size_t(7)});
+  auto r = arr.mutable_unchecked<2>();
+  for (size_t i = 0; i < poses.size(); ++i) {
+    auto &pose = poses[i];
+    std::array<float, 7> row{pose.p.x, pose.p.y, pose.p.z, pose.q.w, pose.q.x, pose.q.y, pose.q.z};
+    for (size_t j = 0; j < 7; ++j) {
+      r(i, j) = row[j];
+    }
+  }
+  return arr;
 }
 
 URDF::URDFConfig parseURDFConfig(py::dict &dict) {
@@ -134,6 +261,101 @@ URDF::URDFConfig parseURDFConfig(py::dict &dict) {
 
 PxVec3 array2vec3(const py::array_t<PxReal> &arr) { return {arr.at(0), arr.at(1), arr.at(2)}; }
 
+STrajectory::Interpolation str2interpolation(std::string const &name) {
+  if (name == "linear") {
+    return STrajectory::Interpolation::eLINEAR;
+  }
+  if (name == "cubic") {
+    return STrajectory::Interpolation::eCUBIC;
+  }
+  if (name == "quintic") {
+    return STrajectory::Interpolation::eQUINTIC;
+  }
+  throw std::invalid_argument("Unknown interpolation " + name +
+                              ", expected linear, cubic or quintic");
+}
+
+template <typename Trajectory> py::dict trajectory2dict(Trajectory const &trajectory) {
+  py::dict status;
+  status["active"] = trajectory.isActive();
+  status["finished"] = trajectory.isFinished();
+  status["time"] = trajectory.getTime();
+  status["duration"] = trajectory.getDuration();
+  return status;
+}
+
+using SceneDataDict = std::map<std::string, std::map<physx_id_t, std::vector<PxReal>>>;
+
+SceneDataDict scenedata2dict(SceneData const &data) {
+  SceneDataDict output;
+  output["actor"] = data.mActorData;
+  output["articulation"] = data.mArticulationData;
+  output["articulation_drive"] = data.mArticulationDriveData;
+  return output;
+}
+
+SceneData dict2scenedata(SceneDataDict const &input) {
+  SceneData data;
+  auto t1 = input.find("actor");
+  auto t2 = input.find("articulation");
+  auto t3 = input.find("articulation_drive");
+  if (t1 == input.end()) {
+    throw std::invalid_argument("unpack missing key: actor");
+  }
+  if (t2 == input.end()) {
+    throw std::invalid_argument("unpack missing key: articulation");
+  }
+  if (t3 == input.end()) {
+    throw std::invalid_argument("unpack missing key: articulation_drive");
+  }
+  data.mActorData = t1->second;
+  data.mArticulationData = t2->second;
+  data.mArticulationDriveData = t3->second;
+  return data;
+}
+
+/* Future of an asynchronous load, resolved at a scene step. Awaiting it waits in the default
+ * executor of the event loop, so the loop (or another thread) must keep stepping the scene. */
+template <typename T> struct LoadFuture {
+  std::shared_future<T *> future;
+
+  bool done() const {
+    return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+  }
+};
+
+template <typename T> void bindLoadFuture(py::module &m, char const *name) {
+  py::class_<LoadFuture<T>>(m, name)
+      .def("done", &LoadFuture<T>::done,
+           "True once the object has been added to the scene (or loading failed)")
+      .def(
+          "result",
+          [](LoadFuture<T> &f) {
+            if (!f.done()) {
+              throw std::runtime_error(
+                  "Load is not finished, step the scene until done() returns True");
+            }
+            return f.future.get();
+          },
+          py::return_value_policy::reference)
+      .def(
+          "wait",
+          [](LoadFuture<T> &f) {
+            {
+              py::gil_scoped_release release;
+              f.future.wait();
+            }
+            return f.future.get();
+          },
+          "Block until the load finishes and return the result. Another thread must step the "
+          "scene.",
+          py::return_value_policy::reference)
+      .def("__await__", [](py::object self) {
+        auto loop = py::module::import("asyncio").attr("get_event_loop")();
+        return loop.attr("run_in_executor")(py::none(), self.attr("wait")).attr("__await__")();
+      });
+}
+
 template <typename T> py::array_t<T> make_array(std::vector<T> const &values) {
   return py::array_t(values.size(), values.data());
 }
@@ -150,6 +372,17 @@ py::array_t<PxReal> mat42array(glm::mat4 const &mat) {
   return py::array_t<PxReal>({4, 4}, arr);
 }
 
+std::shared_ptr<SHeightField>
+array2heightfield(Simulation &sim,
+                  py::array_t<PxReal, py::array::c_style | py::array::forcecast> const &heights,
+                  py::array_t<PxReal> const &scale) {
+  if (heights.ndim() != 2) {
+    throw std::runtime_error("heights must be a 2D array of shape (rows, columns)");
+  }
+  std::vector<PxReal> data(heights.data(), heights.data() + heights.size());
+  return sim.createHeightField(data, heights.shape(0), heights.shape(1), array2vec3(scale));
+}
+
 #define DEPRECATE_WARN(OLD, NEW)                                                                  \
   PyErr_WarnEx(PyExc_DeprecationWarning, #OLD " is deprecated, use " #NEW " instead.", 1)
 
@@ -165,6 +398,9 @@ void buildSapien(py::module &m) {
   auto PyConvexMeshGeometry = py::class_<SConvexMeshGeometry, SGeometry>(m, "ConvexMeshGeometry");
   auto PyNonconvexMeshGeometry =
       py::class_<SNonconvexMeshGeometry, SGeometry>(m, "NonconvexMeshGeometry");
+  auto PyHeightFieldGeometry =
+      py::class_<SHeightFieldGeometry, SGeometry>(m, "HeightFieldGeometry");
+  auto PyHeightField = py::class_<SHeightField, std::shared_ptr<SHeightField>>(m, "HeightField");
 
   auto PyCollisionShape = py::class_<SCollisionShape>(m, "CollisionShape");
 
@@ -206,7 +442,7 @@ void buildSapien(py::module &m) {
   auto PyKinematicLink = py::class_<SKLink, SLinkBase>(m, "KinematicLink");
   auto PyJointBase = py::class_<SJointBase>(m, "JointBase");
   auto PyJoint = py::class_<SJoint, SJointBase>(m, "Joint");
-  py::class_<SKJoint, SJointBase>(m, "KinematicJoint");
+  auto PyKinematicJoint = py::class_<SKJoint, SJointBase>(m, "KinematicJoint");
   py::class_<SKJointFixed, SKJoint>(m, "KinematicJointFixed");
   py::class_<SKJointSingleDof, SKJoint>(m, "KinematicJointSingleDof");
   py::class_<SKJointPrismatic, SKJointSingleDof>(m, "KinematicJointPrismatic");
@@ -216,11 +452,20 @@ void buildSapien(py::module &m) {
       py::class_<SArticulationDrivable, SArticulationBase>(m, "ArticulationDrivable");
   auto PyArticulation = py::class_<SArticulation, SArticulationDrivable>(m, "Articulation");
   py::class_<SKArticulation, SArticulationDrivable>(m, "KinematicArticulation");
+  auto PyController = py::class_<SController, std::shared_ptr<SController>>(m, "Controller");
+  py::class_<SJointPDController, SController, std::shared_ptr<SJointPDController>>(
+      m, "JointPDController");
+  py::class_<SJointImpedanceController, SController, std::shared_ptr<SJointImpedanceController>>(
+      m, "JointImpedanceController");
+  auto PyOperationalSpaceController =
+      py::class_<SOperationalSpaceController, SController,
+                 std::shared_ptr<SOperationalSpaceController>>(m, "OperationalSpaceController");
 
   auto PyContact = py::class_<SContact>(m, "Contact");
   auto PyTrigger = py::class_<STrigger>(m, "Trigger");
   auto PyContactPoint = py::class_<SContactPoint>(m, "ContactPoint");
 
+  auto PyAggregate = py::class_<SAggregate>(m, "Aggregate");
   auto PyActorBuilder = py::class_<ActorBuilder, std::shared_ptr<ActorBuilder>>(m, "ActorBuilder");
   auto PyShapeRecord = py::class_<ActorBuilder::ShapeRecord>(m, "ShapeRecord");
   auto PyVisualRecord = py::class_<ActorBuilder::VisualRecord>(m, "VisualRecord");
@@ -237,6 +482,10 @@ void buildSapien(py::module &m) {
 
   auto PySubscription = py::class_<Subscription>(m, "Subscription");
 
+  bindLoadFuture<SActor>(m, "ActorFuture");
+  bindLoadFuture<SArticulation>(m, "ArticulationFuture");
+  bindLoadFuture<SKArticulation>(m, "KinematicArticulationFuture");
+
 #ifdef _USE_PINOCCHIO
   auto PyPinocchioModel = py::class_<PinocchioModel>(m, "PinocchioModel");
 #endif
@@ -301,6 +550,70 @@ void buildSapien(py::module &m) {
       .def_static("set_log_level", &Renderer::KuafuRenderer::setLogLevel, py::arg("level"))
       .def_property_readonly("is_running", &Renderer::KuafuRenderer::isRunning);
 
+  auto PyCpuRenderer = py::class_<Renderer::CpuRenderer, Renderer::IPxrRenderer,
+                                  std::shared_ptr<Renderer::CpuRenderer>>(m, "CpuRenderer");
+  PyCpuRenderer
+      .def(py::init<uint32_t, bool>(),
+           "Ray tracing renderer running on CPU threads, for machines without a GPU. It renders "
+           "Color, Albedo, Normal, Position, Depth and Segmentation without textures or shadows.",
+           py::arg("thread_count") = 0, py::arg("lighting") = true)
+      .def_property_readonly("lighting", &Renderer::CpuRenderer::getLighting);
+
+  auto PyNullRenderer = py::class_<Renderer::NullRenderer, Renderer::IPxrRenderer,
+                                   std::shared_ptr<Renderer::NullRenderer>>(m, "NullRenderer");
+  PyNullRenderer.def(py::init<>(),
+                     "Renderer for headless runs that only keeps mesh references, materials and "
+                     "poses. It produces no images; its scenes can record episodes and add their "
+                     "bodies to the scene of another renderer for replay.");
+
+  auto PyNullScene = py::class_<Renderer::NullScene, Renderer::IPxrScene>(m, "NullScene");
+  PyNullScene
+      .def_property("recording", &Renderer::NullScene::isRecording,
+                    &Renderer::NullScene::setRecording,
+                    "When true, every update_render appends the body poses and visibility as a "
+                    "frame")
+      .def_property_readonly("frame_count",
+                             [](Renderer::NullScene &scene) { return scene.getFrames().size(); })
+      .def("clear_frames", &Renderer::NullScene::clearFrames)
+      .def(
+          "get_poses",
+          [](Renderer::NullScene &scene) { return poses2array(scene.getPoses()); },
+          "Current body poses by slot as an (n, 7) array of position and wxyz quaternion")
+      .def("get_visibility",
+           [](Renderer::NullScene &scene) { return make_array(scene.getVisibility()); })
+      .def(
+          "get_frame_poses",
+          [](Renderer::NullScene &scene, uint32_t index) {
+            if (index >= scene.getFrames().size()) {
+              throw std::out_of_range("invalid frame index");
+            }
+            return poses2array(scene.getFrames()[index].poses);
+          },
+          py::arg("index"))
+      .def(
+          "get_frame_visibility",
+          [](Renderer::NullScene &scene, uint32_t index) {
+            if (index >= scene.getFrames().size()) {
+              throw std::out_of_range("invalid frame index");
+            }
+            return make_array(scene.getFrames()[index].visibility);
+          },
+          py::arg("index"))
+      .def("instantiate", &Renderer::NullScene::instantiate,
+           "Add the bodies and lights of this scene to another render scene. Returns the new "
+           "bodies by slot (None for removed bodies) to be passed to apply_frame.",
+           py::arg("target"), py::return_value_policy::reference)
+      .def(
+          "apply_frame",
+          [](Renderer::NullScene &scene, uint32_t index,
+             std::vector<Renderer::IPxrRigidbody *> const &bodies) {
+            if (index >= scene.getFrames().size()) {
+              throw std::out_of_range("invalid frame index");
+            }
+            Renderer::NullScene::applyFrame(scene.getFrames()[index], bodies);
+          },
+          py::arg("index"), py::arg("bodies"));
+
   // auto PyKuafuCamera = py::class_<Renderer::KuafuCamera, Renderer::ICamera>(m, "KuafuCamera");
   // PyKuafuCamera.def("set_full_perspective", &Renderer::KuafuCamera::setFullPerspective,
   //                   "Set camera into perspective projection mode with full camera parameters",
@@ -403,6 +716,34 @@ void buildSapien(py::module &m) {
       .def_property_readonly(
           "indices", [](SNonconvexMeshGeometry &g) { return make_array<uint32_t>(g.indices); });
 
+  PyHeightFieldGeometry.def_readonly("rows", &SHeightFieldGeometry::rows)
+      .def_readonly("columns", &SHeightFieldGeometry::columns)
+      .def_readonly("row_scale", &SHeightFieldGeometry::rowScale)
+      .def_readonly("column_scale", &SHeightFieldGeometry::columnScale)
+      .def_property_readonly("heights", [](SHeightFieldGeometry &g) {
+        return py::array_t<PxReal>({g.rows, g.columns}, g.heights.data());
+      });
+
+  PyHeightField.def_property_readonly("rows", &SHeightField::getRows)
+      .def_property_readonly("columns", &SHeightField::getColumns)
+      .def_property_readonly("scale",
+                             [](SHeightField &h) { return vec32array(h.getScale()); })
+      .def_property_readonly("heights",
+                             [](SHeightField &h) {
+                               auto heights = h.getHeights();
+                               return py::array_t<PxReal>({h.getRows(), h.getColumns()},
+                                                          heights.data());
+                             })
+      .def_property_readonly("vertices",
+                             [](SHeightField &h) {
+                               auto &v = h.getVertices();
+                               return py::array_t<PxReal>({static_cast<int>(v.size()), 3},
+                                                          reinterpret_cast<PxReal const *>(
+                                                              v.data()));
+                             })
+      .def_property_readonly(
+          "indices", [](SHeightField &h) { return make_array<uint32_t>(h.getIndices()); });
+
   PyCollisionShape
       .def_property_readonly("actor", &SCollisionShape::getActor,
                              py::return_value_policy::reference)
@@ -414,7 +755,7 @@ collision groups determine the collision behavior of objects. Let A.gx denote th
 
 ((A.g0 & B.g1) or (A.g1 & B.g0)) and (not ((A.g2 & B.g2) and ((A.g3 & 0xffff) == (B.g3 & 0xffff))))
 
-Here is some explanation: g2 is the "ignore group" and g3 is the "id group". The only the lower 16 bits of the id group is used since the upper 16 bits are reserved for other purposes in the future. When 2 collision shapes have the same ID (g3), then if any of their g2 bits match, their collisions are definitely ignored.
+Here is some explanation: g2 is the "ignore group" and g3 is the "id group". The id group must not exceed 0xffff (a ValueError is raised otherwise) since the upper 16 bits hold the environment slot of the scene (see Scene.add_environment) and are left unchanged. When 2 collision shapes have the same ID (g3), then if any of their g2 bits match, their collisions are definitely ignored.
 
 If after testing g2 and g3, the objects may collide, g0 and g1 come into play. g0 is the "contact type group" and g1 is the "contact affinity group". Collision shapes collide only when a bit in the contact type of the first shape matches a bit in the contact affinity of the second shape.)doc",
            py::arg("group0"), py::arg("group1"), py::arg("group2"), py::arg("group3"))
@@ -639,6 +980,8 @@ If after testing g2 and g3, the objects may collide, g0 and g1 come into play. g
       .def_readwrite("enable_enhanced_determinism", &SceneConfig::enableEnhancedDeterminism)
       .def_readwrite("enable_friction_every_iteration", &SceneConfig::enableFrictionEveryIteration)
       .def_readwrite("enable_adaptive_force", &SceneConfig::enableAdaptiveForce)
+      .def_readwrite("enable_articulation_aggregate", &SceneConfig::enableArticulationAggregate)
+      .def_readwrite("actor_aggregate_shape_count", &SceneConfig::actorAggregateShapeCount)
       .def("__repr__", [](SceneConfig &) { return "SceneConfig()"; });
 
   //======== Simulation ========//
@@ -653,8 +996,66 @@ If after testing g2 and g3, the objects may collide, g0 and g1 come into play. g
       .def("get_renderer", &Simulation::getRenderer)
       .def("set_renderer", &Simulation::setRenderer, py::arg("renderer"))
       .def("set_log_level", &Simulation::setLogLevel, py::arg("level"))
+      .def_property_static(
+          "mesh_cache_capacity", [](py::object) { return MeshCache::Get().getCapacity(); },
+          [](py::object, size_t bytes) { MeshCache::Get().setCapacity(bytes); },
+          "Bytes of decoded mesh files kept for collision loading and rendering")
+      .def_static(
+          "get_mesh_cache_size", []() { return MeshCache::Get().getSize(); },
+          "Bytes of decoded mesh files currently cached")
       .def("create_physical_material", &Simulation::createPhysicalMaterial,
-           py::arg("static_friction"), py::arg("dynamic_friction"), py::arg("restitution"));
+           py::arg("static_friction"), py::arg("dynamic_friction"), py::arg("restitution"))
+      .def("create_height_field", &array2heightfield,
+           R"doc(
+Create a heightfield from a (rows, columns) array. Rows run along y and columns along x.
+
+Args:
+  heights: sample heights, multiplied by scale[2]
+  scale: column spacing, row spacing and height multiplier)doc",
+           py::arg("heights"), py::arg("scale") = make_array<PxReal>({1, 1, 1}))
+      .def(
+          "create_height_field_from_image",
+          [](Simulation &sim, std::string const &filename, py::array_t<PxReal> const &scale) {
+            py::module pil;
+            try {
+              pil = py::module::import("PIL.Image");
+            } catch (py::error_already_set &e) {
+              if (!e.matches(PyExc_ImportError)) {
+                throw;
+              }
+              throw std::runtime_error("create_height_field_from_image requires Pillow");
+            }
+            auto np = py::module::import("numpy");
+            auto image = pil.attr("open")(filename);
+            std::string mode = py::str(image.attr("mode"));
+            if (mode != "F" && mode != "I" && mode.rfind("I;16", 0) != 0) {
+              image = image.attr("convert")("L");
+              mode = "L";
+            }
+            auto heights = np.attr("asarray")(image, "float32");
+
+            // integer pixels are normalized by their bit depth, float pixels are used as is
+            PxReal range = 1.f;
+            if (mode == "L") {
+              range = 255.f;
+            } else if (mode != "F") {
+              // 16 bit PNGs may open as 32 bit "I"
+              bool fits16 = heights.attr("min")().cast<float>() >= 0.f &&
+                            heights.attr("max")().cast<float>() <= 65535.f;
+              range = mode == "I" && !fits16 ? 2147483647.f : 65535.f;
+            }
+            return array2heightfield(
+                sim,
+                py::array_t<PxReal, py::array::c_style | py::array::forcecast>::ensure(
+                    heights.attr("__truediv__")(range)),
+                scale);
+          },
+          R"doc(
+Create a heightfield from a grayscale image. 8 and 16 bit pixel values are normalized to
+[0, 1] by their bit depth, 32 bit integers by 2^31 - 1 and floating point images are used as
+is. Heights are then multiplied by scale[2]. Image rows run along y and columns along x.
+Requires Pillow.)doc",
+          py::arg("filename"), py::arg("scale") = make_array<PxReal>({1, 1, 1}));
 
   PyScene.def_property_readonly("name", &SScene::getName)
       .def_property_readonly("engine", &SScene::getSimulation)
@@ -664,6 +1065,16 @@ If after testing g2 and g3, the objects may collide, g0 and g1 come into play. g
       .def_property("default_physical_material", &SScene::getDefaultMaterial,
                     &SScene::setDefaultMaterial)
       .def("create_actor_builder", &SScene::createActorBuilder)
+      .def("create_aggregate", py::overload_cast<uint32_t, bool>(&SScene::createAggregate),
+           R"doc(
+Create a broadphase group. Actors and articulations built with the aggregate set on their
+builder are tested against the rest of the scene as a single entry.
+
+Args:
+  max_actor_count: capacity in actors, each articulation link counts as one (at most 128)
+  self_collision: whether members may collide with each other)doc",
+           py::arg("max_actor_count"), py::arg("self_collision") = true,
+           py::return_value_policy::reference)
       .def("create_articulation_builder", &SScene::createArticulationBuilder)
       .def("create_urdf_loader", &SScene::createURDFLoader)
       .def("create_physical_material", &SScene::createPhysicalMaterial, py::arg("static_friction"),
@@ -726,6 +1137,8 @@ If after testing g2 and g3, the objects may collide, g0 and g1 come into play. g
       .def("step", &SScene::step)
       .def("step_async", &SScene::stepAsync)
       .def("step_wait", &SScene::stepWait)
+      .def("update_articulation_link_poses", &SScene::updateArticulationLinkPoses,
+           "Call update_link_poses on every articulation in the scene")
       .def("update_render", &SScene::updateRender)
       .def("add_ground", &SScene::addGround, py::arg("altitude"), py::arg("render") = true,
            py::arg("material") = nullptr, py::arg("render_material") = nullptr,
@@ -739,6 +1152,35 @@ If after testing g2 and g3, the objects may collide, g0 and g1 come into play. g
       .def("create_drive", &SScene::createDrive, py::arg("actor1"), py::arg("pose1"),
            py::arg("actor2"), py::arg("pose2"), py::return_value_policy::reference)
       .def_property_readonly("render_id_to_visual_name", &SScene::findRenderId2VisualName)
+      .def_property_readonly(
+          "visual_id_to_actor_id",
+          [](SScene &s) {
+            auto &table = s.getVisualActorIds();
+            return py::array_t<physx_id_t>(table.size(), table.data());
+          },
+          "Actor or link id of each visual id, 0 for unused ids. Remaps the visual channel of a "
+          "segmentation image with table[seg[..., 0]]. Every access returns a copy covering "
+          "the generated visual ids; ids set by hand past them are only in "
+          "render_id_to_visual_name.")
+      .def_property_readonly("visual_id_to_name", &SScene::getVisualNames,
+                             "Name of each visual id, empty for unused ids. Covers the same ids "
+                             "as visual_id_to_actor_id.")
+      .def_property_readonly(
+          "actor_id_to_link_index",
+          [](SScene &s) {
+            auto &table = s.getActorLinkIndices();
+            return py::array_t<int32_t>(table.size(), table.data());
+          },
+          "Index of each link id in its articulation, -1 for other ids. Every access "
+          "returns a copy covering all actor ids so far.")
+      .def_property_readonly(
+          "actor_id_to_articulation_id",
+          [](SScene &s) {
+            auto &table = s.getActorArticulationIds();
+            return py::array_t<physx_id_t>(table.size(), table.data());
+          },
+          "Root link id of the articulation of each link id, 0 for other ids. Every access "
+          "returns a copy covering all actor ids so far.")
 
       // renderer
       .def_property_readonly("renderer_scene", &SScene::getRendererScene,
@@ -805,38 +1247,211 @@ If after testing g2 and g3, the objects may collide, g0 and g1 come into play. g
            py::arg("nx"), py::arg("py"), py::arg("ny"), py::arg("pz"), py::arg("nz"))
 
       // save
-      .def("pack",
-           [](SScene &scene) {
-             auto data = scene.packScene();
-             std::map<std::string, std::map<physx_id_t, std::vector<PxReal>>> output;
-             output["actor"] = data.mActorData;
-             output["articulation"] = data.mArticulationData;
-             output["articulation_drive"] = data.mArticulationDriveData;
-             return output;
-           })
+      .def("pack", [](SScene &scene) { return scenedata2dict(scene.packScene()); })
       .def(
           "unpack",
-          [](SScene &scene,
-             std::map<std::string, std::map<physx_id_t, std::vector<PxReal>>> const &input) {
-            SceneData data;
-            auto t1 = input.find("actor");
-            auto t2 = input.find("articulation");
-            auto t3 = input.find("articulation_drive");
-            if (t1 == input.end()) {
-              throw std::invalid_argument("unpack missing key: actor");
+          [](SScene &scene, SceneDataDict const &input) {
+            scene.unpackScene(dict2scenedata(input));
+          },
+          py::arg("data"))
+
+      // environments
+      .def("add_environment",
+           [](SScene &scene, py::array_t<PxReal> const &offset) {
+             return scene.addEnvironment(array2vec3(offset));
+           },
+           R"doc(
+Add an environment slot hosted by this scene and return its index. Set the index as the
+environment of actor builders, articulation builders or URDF loaders to build into it.
+
+Objects built into an environment start at its offset and only collide with objects of the same
+environment and with shared objects (environment -1, e.g. the ground). Poses are still given in
+the scene frame.)doc",
+           py::arg("offset"))
+      .def_property_readonly("environment_count", &SScene::getEnvironmentCount)
+      .def(
+          "get_environment_offset",
+          [](SScene &scene, int environment) {
+            return vec32array(scene.getEnvironmentOffset(environment));
+          },
+          py::arg("environment"))
+      .def("get_environment_actors", &SScene::getEnvironmentActors, py::arg("environment"),
+           py::return_value_policy::reference)
+      .def("get_environment_articulations", &SScene::getEnvironmentArticulations,
+           py::arg("environment"), py::return_value_policy::reference)
+      .def(
+          "pack_environment",
+          [](SScene &scene, uint32_t environment) {
+            return scenedata2dict(scene.packEnvironment(environment));
+          },
+          "Pack one environment with poses relative to its offset, see unpack_environment",
+          py::arg("environment"))
+      .def(
+          "unpack_environment",
+          [](SScene &scene, uint32_t environment, SceneDataDict const &input) {
+            scene.unpackEnvironment(environment, dict2scenedata(input));
+          },
+          "Unpack data from pack_environment into any environment built the same way",
+          py::arg("environment"), py::arg("data"))
+      .def("save_environment_state", &SScene::saveEnvironmentState, py::arg("environment"))
+      .def("reset_environment", &SScene::resetEnvironment,
+           "Restore the state stored by save_environment_state", py::arg("environment"))
+
+      .def("start_recording", &SScene::startRecording,
+           "Record poses, visibility and camera poses at every update_render to a compressed "
+           "episode file, replayed by EpisodeReplayer. Positions are quantized to "
+           "position_precision meters.",
+           py::arg("filename"), py::arg("position_precision") = 1e-4f,
+           py::arg("chunk_size") = 256)
+      .def("stop_recording", &SScene::stopRecording)
+      .def_property_readonly("is_recording", &SScene::isRecording);
+
+  auto PyEpisodeReplayer = py::class_<EpisodeReplayer>(m, "EpisodeReplayer");
+  PyEpisodeReplayer.def(py::init<std::string const &>(), py::arg("filename"))
+      .def_property_readonly("frame_count", &EpisodeReplayer::getFrameCount)
+      .def_property_readonly("chunk_count", &EpisodeReplayer::getChunkCount)
+      .def(
+          "get_frame",
+          [](EpisodeReplayer &replayer, uint32_t index) {
+            auto &frame = replayer.getFrame(index);
+            py::dict dict;
+            dict["ids"] = make_array(frame.ids);
+            dict["poses"] = poses2array(frame.poses);
+            dict["visibility"] = make_array(frame.visibility);
+            dict["camera_poses"] = poses2array(frame.cameraPoses);
+            return dict;
+          },
+          "Object ids, (n, 7) poses as position and wxyz quaternion, visibility and camera poses "
+          "of a frame",
+          py::arg("index"))
+      .def("bind", &EpisodeReplayer::bind,
+           "Render bodies to drive, matched to recorded actors and links by their actor id",
+           py::arg("bodies"))
+      .def(
+          "bind_cameras",
+          [](EpisodeReplayer &replayer, std::vector<SCamera *> const &cameras) {
+            std::vector<Renderer::ICamera *> renderCameras;
+            for (auto cam : cameras) {
+              renderCameras.push_back(cam ? cam->getRendererCamera() : nullptr);
             }
-            if (t2 == input.end()) {
-              throw std::invalid_argument("unpack missing key: articulation");
+            replayer.bindCameras(renderCameras);
+          },
+          "Cameras to drive, matched to recorded cameras by order", py::arg("cameras"))
+      .def("apply", &EpisodeReplayer::apply,
+           "Set bound bodies and cameras to a frame, seeking to any frame is allowed",
+           py::arg("index"));
+
+  auto PyPointCloudBuilder = py::class_<PointCloudBuilder>(
+      m, "PointCloudBuilder",
+      "Fuses the Position images of several cameras into a world space point cloud, filtered "
+      "by depth and segmentation and optionally voxel downsampled on a hash grid");
+  PyPointCloudBuilder.def(py::init<uint32_t>(), py::arg("thread_count") = 0)
+      .def("set_depth_range", &PointCloudBuilder::setDepthRange,
+           "Keep points whose depth along the camera view axis is in [min_depth, max_depth]",
+           py::arg("min_depth"), py::arg("max_depth"))
+      .def_property_readonly("min_depth", &PointCloudBuilder::getMinDepth)
+      .def_property_readonly("max_depth", &PointCloudBuilder::getMaxDepth)
+      .def_property("voxel_size", &PointCloudBuilder::getVoxelSize,
+                    &PointCloudBuilder::setVoxelSize,
+                    "Edge of the downsampling voxels, 0 keeps every point. A voxel becomes the "
+                    "mean position and color of its points and the label of its first point.")
+      .def("set_segmentation_filter", &PointCloudBuilder::setSegmentationFilter,
+           "Keep points whose segmentation id is in ids, an empty list keeps all. Level 0 "
+           "filters and labels by visual id, level 1 by actor id.",
+           py::arg("ids"), py::arg("level") = 1)
+      .def(
+          "build",
+          [](PointCloudBuilder &builder, std::vector<SCamera *> const &cameras, bool withColor,
+             bool withLabel) {
+            auto cloud = builder.build(cameras, withColor, withLabel);
+            py::dict result;
+            result["xyz"] = makeRowArray(std::move(cloud.points), 3);
+            if (withColor) {
+              result["rgb"] = makeRowArray(std::move(cloud.colors), 3);
             }
-            if (t3 == input.end()) {
-              throw std::invalid_argument("unpack missing key: articulation_drive");
+            if (withLabel) {
+              result["label"] = makeRowArray(std::move(cloud.labels), 1);
             }
-            data.mActorData = t1->second;
-            data.mArticulationData = t2->second;
-            data.mArticulationDriveData = t3->second;
-            scene.unpackScene(data);
+            return result;
+          },
+          "Fuse the latest pictures of the cameras into a dict with xyz (n x 3), and rgb (n x 3) "
+          "and label (n) when requested. Pictures must contain Position, and Color or "
+          "Segmentation when needed.",
+          py::arg("cameras"), py::arg("with_color") = false, py::arg("with_label") = false);
+
+  auto PyStereoDepthConfig = py::class_<StereoDepthConfig>(m, "StereoDepthConfig");
+  PyStereoDepthConfig.def(py::init<>())
+      .def_readwrite("use_noise", &StereoDepthConfig::useNoise)
+      .def_readwrite("noise_scale", &StereoDepthConfig::noiseScale)
+      .def_readwrite("noise_blur_size", &StereoDepthConfig::noiseBlurSize)
+      .def_readwrite("noise_blur_sigma", &StereoDepthConfig::noiseBlurSigma)
+      .def_readwrite("speckle_shape", &StereoDepthConfig::speckleShape)
+      .def_readwrite("speckle_scale", &StereoDepthConfig::speckleScale)
+      .def_readwrite("gaussian_mu", &StereoDepthConfig::gaussianMu)
+      .def_readwrite("gaussian_sigma", &StereoDepthConfig::gaussianSigma)
+      .def_readwrite("seed", &StereoDepthConfig::seed)
+      .def_readwrite("census_size", &StereoDepthConfig::censusSize)
+      .def_readwrite("max_disparity", &StereoDepthConfig::maxDisparity)
+      .def_readwrite("eight_paths", &StereoDepthConfig::eightPaths)
+      .def_readwrite("penalty1", &StereoDepthConfig::penalty1)
+      .def_readwrite("penalty2", &StereoDepthConfig::penalty2)
+      .def_readwrite("uniqueness_ratio", &StereoDepthConfig::uniquenessRatio)
+      .def_readwrite("max_left_right_diff", &StereoDepthConfig::maxLeftRightDiff)
+      .def_readwrite("speckle_window_size", &StereoDepthConfig::speckleWindowSize)
+      .def_readwrite("speckle_range", &StereoDepthConfig::speckleRange)
+      .def_readwrite("register_depth", &StereoDepthConfig::registerDepth)
+      .def_readwrite("median_size", &StereoDepthConfig::medianSize)
+      .def_readwrite("min_depth", &StereoDepthConfig::minDepth)
+      .def_readwrite("max_depth", &StereoDepthConfig::maxDepth);
+
+  auto PyStereoDepthProcessor = py::class_<StereoDepthProcessor>(
+      m, "StereoDepthProcessor",
+      "Depth of an active stereo sensor from a pair of IR images: IR noise, semi-global "
+      "matching with uniqueness, left-right and speckle checks, and registration into the main "
+      "camera. Intrinsics and extrinsics use the OpenCV convention, extrinsics map world to "
+      "camera.");
+  PyStereoDepthProcessor
+      .def(py::init<uint32_t, uint32_t, Eigen::Matrix3f const &, Eigen::Matrix3f const &,
+                    Eigen::Matrix4f const &, Eigen::Matrix4f const &, uint32_t, uint32_t,
+                    Eigen::Matrix3f const &, Eigen::Matrix4f const &, StereoDepthConfig const &,
+                    uint32_t>(),
+           py::arg("width"), py::arg("height"), py::arg("left_intrinsic"),
+           py::arg("right_intrinsic"), py::arg("left_extrinsic"), py::arg("right_extrinsic"),
+           py::arg("main_width"), py::arg("main_height"), py::arg("main_intrinsic"),
+           py::arg("main_extrinsic"), py::arg("config") = StereoDepthConfig(),
+           py::arg("thread_count") = 0)
+      .def_property_readonly("config", &StereoDepthProcessor::getConfig)
+      .def(
+          "compute",
+          [](StereoDepthProcessor &processor, IRImageArray left, IRImageArray right) {
+            uint32_t width = processor.getWidth(), height = processor.getHeight();
+            auto depth = processor.compute(getIRImage(left, width, height),
+                                           getIRImage(right, width, height));
+            return makeImageArray(std::move(depth), processor.getOutputWidth(),
+                                  processor.getOutputHeight());
+          },
+          "Depth from uint8 IR images, in the main camera when registering and the left camera "
+          "otherwise, 0 where invalid",
+          py::arg("left"), py::arg("right"))
+      .def(
+          "compute_disparity",
+          [](StereoDepthProcessor &processor, IRImageArray left, IRImageArray right) {
+            uint32_t width = processor.getWidth(), height = processor.getHeight();
+            auto disparity = processor.computeDisparity(getIRImage(left, width, height),
+                                                        getIRImage(right, width, height));
+            return makeImageArray(std::move(disparity), width, height);
           },
-          py::arg("data"));
+          "Disparity of the left image in pixels, -1 where invalid. No noise is added.",
+          py::arg("left"), py::arg("right"))
+      .def(
+          "add_ir_noise",
+          [](StereoDepthProcessor &processor, IRImageArray image, uint64_t seed) {
+            uint32_t width = processor.getWidth(), height = processor.getHeight();
+            return makeImageArray(processor.addNoise(getIRImage(image, width, height), seed),
+                                  width, height);
+          },
+          "IR image with the noise model of the config applied", py::arg("image"),
+          py::arg("seed") = 0);
 
   //======= Drive =======//
   PyDrive.def("set_x_limit", &SDrive6D::setXLimit, py::arg("low"), py::arg("high"))
@@ -867,12 +1482,41 @@ If after testing g2 and g3, the objects may collide, g0 and g1 come into play. g
       .def("free_motion", &SDrive6D::freeMotion, py::arg("tx"), py::arg("ty"), py::arg("tz"),
            py::arg("rx"), py::arg("ry"), py::arg("rz"))
       .def("set_target", &SDrive6D::setTarget, py::arg("pose"))
+      .def("get_target", &SDrive6D::getTarget)
+      .def("get_target_velocity",
+           [](SDrive6D &d) {
+             auto [linear, angular] = d.getTargetVelocity();
+             return std::make_tuple(vec32array(linear), vec32array(angular));
+           })
       .def(
           "set_target_velocity",
           [](SDrive6D &d, py::array_t<PxReal> const &linear, py::array_t<PxReal> const &angular) {
             d.setTargetVelocity(array2vec3(linear), array2vec3(angular));
           },
-          py::arg("linear"), py::arg("angular"));
+          py::arg("linear"), py::arg("angular"))
+      .def(
+          "set_target_trajectory",
+          [](SDrive6D &d, py::array_t<PxReal> const &times, std::vector<PxTransform> const &poses,
+             std::string const &interpolation) {
+            d.setTargetTrajectory(std::vector<PxReal>(times.data(), times.data() + times.size()),
+                                  poses, str2interpolation(interpolation));
+          },
+          "Replace the target trajectory, interpolated into target pose and velocity inside "
+          "scene.step. If the first time is positive, the current target is used as the "
+          "waypoint at time 0.",
+          py::arg("times"), py::arg("poses"), py::arg("interpolation") = "cubic")
+      .def(
+          "append_target_trajectory",
+          [](SDrive6D &d, py::array_t<PxReal> const &times, std::vector<PxTransform> const &poses) {
+            d.appendTargetTrajectory(
+                std::vector<PxReal>(times.data(), times.data() + times.size()), poses);
+          },
+          py::arg("times"), py::arg("poses"))
+      .def("stop_target_trajectory", &SDrive6D::stopTargetTrajectory)
+      .def(
+          "get_target_trajectory_status",
+          [](SDrive6D &d) { return trajectory2dict(d.getTargetTrajectory()); },
+          "Return a dict with keys active, finished, time and duration.");
 
   PyEntity.def_property("name", &SEntity::getName, &SEntity::setName)
       .def("get_name", &SEntity::getName)
@@ -909,6 +1553,7 @@ If after testing g2 and g3, the objects may collide, g0 and g1 come into play. g
 
       .def_property_readonly("id", &SActorBase::getId)
       .def("get_id", &SActorBase::getId)
+      .def_property_readonly("environment", &SActorBase::getEnvironment)
       .def("get_scene", &SActorBase::getScene, py::return_value_policy::reference)
       .def("get_collision_shapes", &SActorBase::getCollisionShapes,
            py::return_value_policy::reference)
@@ -1071,6 +1716,15 @@ If after testing g2 and g3, the objects may collide, g0 and g1 come into play. g
       // TODO wrapper for array-valued targets
       .def("get_global_pose", &SJoint::getGlobalPose);
 
+  PyKinematicJoint
+      .def("set_drive_property", &SKJoint::setDriveProperties, py::arg("stiffness"),
+           py::arg("damping"), py::arg("max_velocity") = PX_MAX_F32,
+           "Drive the joint with acceleration stiffness * (target - pos) + damping * "
+           "(velocity_target - vel), limiting the velocity to max_velocity. No effect on fixed "
+           "joints.")
+      .def("set_drive_velocity_target", &SKJoint::setDriveVelocityTarget, py::arg("velocity"),
+           "One value per joint DOF");
+
   //======== End Joint ========//
 
   PyArticulationBase
@@ -1158,10 +1812,17 @@ If after testing g2 and g3, the objects may collide, g0 and g1 come into play. g
       .def("get_root_pose", &SArticulationBase::getRootPose)
       .def("set_root_pose", &SArticulationBase::setRootPose, py::arg("pose"))
       .def("set_pose", &SArticulationBase::setRootPose, py::arg("pose"), "same as set_root_pose")
+      .def("update_link_poses", &SArticulationBase::updateLinkPoses,
+           "Compute link poses from the root pose and current qpos and apply them to link "
+           "get_pose and the render bodies. Call after set_qpos to get valid link poses "
+           "without a simulation step.")
 #ifdef _USE_PINOCCHIO
       .def("create_pinocchio_model", &SArticulationBase::createPinocchioModel,
            "Create the kinematic and dynamic model of this articulation implemented by the "
            "Pinocchio library. Allowing computing forward/inverse kinematics/dynamics.")
+      .def("create_pinocchio_model_from_urdf", &SArticulationBase::createPinocchioModelFromURDF,
+           "Same as create_pinocchio_model, but built by exporting this articulation to URDF "
+           "and parsing it. Slower; kept to check the direct construction against.")
 #endif
       .def("export_urdf", &SArticulationBase::exportURDF, py::arg("cache_dir") = std::string())
       .def("get_builder", &SArticulationBase::getBuilder);
@@ -1241,11 +1902,143 @@ If after testing g2 and g3, the objects may collide, g0 and g1 come into play. g
       .def("compute_cartesian_diff_ik", &SArticulation::computeCartesianVelocityDiffIK,
            py::arg("world_velocity"), py::arg("commanded_link_id"),
            py::arg("active_joint_ids") = std::vector<uint32_t>())
+      .def(
+          "add_joint_pd_controller",
+          [](SArticulation &a, py::array_t<PxReal> const &stiffness,
+             py::array_t<PxReal> const &damping, py::array_t<PxReal> const &forceLimit,
+             bool gravityCompensation) {
+            auto c = std::make_shared<SJointPDController>(
+                &a, std::vector<PxReal>(stiffness.data(), stiffness.data() + stiffness.size()),
+                std::vector<PxReal>(damping.data(), damping.data() + damping.size()),
+                std::vector<PxReal>(forceLimit.data(), forceLimit.data() + forceLimit.size()),
+                gravityCompensation);
+            a.addController(c);
+            return c;
+          },
+          R"doc(
+Add a joint PD controller running at simulation rate inside scene.step.
+Write targets into controller.setpoint, laid out as [qpos_target, qvel_target].
+
+Args:
+  stiffness: per-joint stiffness
+  damping: per-joint damping
+  force_limit: per-joint force limit, empty for no limit
+  gravity_compensation: add generalized gravity force computed by PhysX
+)doc",
+          py::arg("stiffness"), py::arg("damping"),
+          py::arg("force_limit") = py::array_t<PxReal>(), py::arg("gravity_compensation") = true)
+      .def(
+          "add_joint_impedance_controller",
+          [](SArticulation &a, py::array_t<PxReal> const &stiffness,
+             py::array_t<PxReal> const &damping) {
+            auto c = std::make_shared<SJointImpedanceController>(
+                &a, std::vector<PxReal>(stiffness.data(), stiffness.data() + stiffness.size()),
+                std::vector<PxReal>(damping.data(), damping.data() + damping.size()));
+            a.addController(c);
+            return c;
+          },
+          "Add a joint impedance controller. Write targets into controller.setpoint, laid out as "
+          "[qpos_target, qvel_target, qacc_target].",
+          py::arg("stiffness"), py::arg("damping"))
+      .def(
+          "add_operational_space_controller",
+          [](SArticulation &a, uint32_t linkIndex, PxReal positionStiffness,
+             PxReal positionDamping, PxReal rotationStiffness, PxReal rotationDamping) {
+            auto c = std::make_shared<SOperationalSpaceController>(
+                &a, linkIndex, positionStiffness, positionDamping, rotationStiffness,
+                rotationDamping);
+            a.addController(c);
+            return c;
+          },
+          "Add an operational space controller for a link. Write targets into "
+          "controller.setpoint, laid out as [position(3), quaternion wxyz(4), "
+          "linear_velocity(3), angular_velocity(3)] in world frame.",
+          py::arg("link_index"), py::arg("position_stiffness"), py::arg("position_damping"),
+          py::arg("rotation_stiffness"), py::arg("rotation_damping"))
+      .def("remove_controller", &SArticulation::removeController, py::arg("controller"))
+      .def("get_controllers", &SArticulation::getControllers)
+      .def(
+          "set_drive_trajectory",
+          [](SArticulation &a, py::array_t<PxReal> const &times,
+             py::array_t<PxReal> const &positions, py::array_t<PxReal> const &velocities,
+             std::string const &interpolation) {
+            a.setDriveTrajectory(
+                std::vector<PxReal>(times.data(), times.data() + times.size()),
+                std::vector<PxReal>(positions.data(), positions.data() + positions.size()),
+                std::vector<PxReal>(velocities.data(), velocities.data() + velocities.size()),
+                str2interpolation(interpolation));
+          },
+          R"doc(
+Replace the drive trajectory, interpolated into drive targets inside scene.step.
+Times are relative to now; if the first time is positive, the current drive target is used as
+the waypoint at time 0.
+
+Args:
+  times: [n] strictly increasing waypoint times
+  positions: [n, dof] waypoint drive targets
+  velocities: [n, dof] waypoint velocities, empty to estimate them
+  interpolation: one of linear, cubic, quintic
+)doc",
+          py::arg("times"), py::arg("positions"), py::arg("velocities") = py::array_t<PxReal>(),
+          py::arg("interpolation") = "cubic")
+      .def(
+          "append_drive_trajectory",
+          [](SArticulation &a, py::array_t<PxReal> const &times,
+             py::array_t<PxReal> const &positions, py::array_t<PxReal> const &velocities) {
+            a.appendDriveTrajectory(
+                std::vector<PxReal>(times.data(), times.data() + times.size()),
+                std::vector<PxReal>(positions.data(), positions.data() + positions.size()),
+                std::vector<PxReal>(velocities.data(), velocities.data() + velocities.size()));
+          },
+          "Append waypoints to the drive trajectory, times are on the same clock as the current "
+          "trajectory.",
+          py::arg("times"), py::arg("positions"), py::arg("velocities") = py::array_t<PxReal>())
+      .def("stop_drive_trajectory", &SArticulation::stopDriveTrajectory,
+           "Drop the drive trajectory and hold the current drive target.")
+      .def(
+          "get_drive_trajectory_status",
+          [](SArticulation &a) {
+            if (auto t = a.getDriveTrajectory()) {
+              return trajectory2dict(*t);
+            }
+            return trajectory2dict(STrajectory(a.dof()));
+          },
+          "Return a dict with keys active, finished, time and duration.")
       .def("pack", &SArticulation::packData)
       .def("unpack", [](SArticulation &a, const py::array_t<PxReal> &arr) {
         a.unpackData(std::vector<PxReal>(arr.data(), arr.data() + arr.size()));
       });
 
+  PyController
+      .def_property_readonly(
+          "setpoint",
+          [](std::shared_ptr<SController> c) {
+            // the view keeps the controller alive after remove_controller
+            auto &setpoint = c->getSetpoint();
+            auto owner = new std::shared_ptr<SController>(std::move(c));
+            py::capsule base(owner, [](void *p) {
+              delete static_cast<std::shared_ptr<SController> *>(p);
+            });
+            return py::array_t<PxReal>(setpoint.size(), setpoint.data(), base);
+          },
+          "Writable view of the setpoint buffer read by the controller every step")
+      .def(
+          "set_setpoint",
+          [](SController &c, py::array_t<PxReal> const &arr) {
+            c.setSetpoint(std::vector<PxReal>(arr.data(), arr.data() + arr.size()));
+          },
+          py::arg("setpoint"))
+      .def_property("enabled", &SController::isEnabled, &SController::setEnabled)
+      .def_property("model_tolerance", &SController::getModelTolerance,
+                    &SController::setModelTolerance,
+                    "Joint distance after which the mass matrix and Jacobian are recomputed. The "
+                    "default 0 recomputes them every step; a positive value reuses them while "
+                    "no joint moved further, trading model accuracy for speed.")
+      .def_property_readonly("articulation", &SController::getArticulation,
+                             py::return_value_policy::reference);
+  PyOperationalSpaceController.def_property_readonly(
+      "link_index", &SOperationalSpaceController::getLinkIndex);
+
   //======== End Articulation ========//
 
   PyContact
@@ -1308,35 +2101,48 @@ If after testing g2 and g3, the objects may collide, g0 and g1 come into play. g
 
   //======== Builders ========
 
+  PyAggregate.def_property_readonly("max_actor_count", &SAggregate::getMaxActorCount)
+      .def_property_readonly("actor_count", &SAggregate::getActorCount)
+      .def_property_readonly("self_collision", &SAggregate::getSelfCollision);
+
   PyActorBuilder.def("set_scene", &ActorBuilder::setScene)
+      .def_property("aggregate", &ActorBuilder::getAggregate, &ActorBuilder::setAggregate,
+                    py::return_value_policy::reference)
+      .def_property("environment", &ActorBuilder::getEnvironment, &ActorBuilder::setEnvironment)
       .def(
           "add_collision_from_file",
           [](ActorBuilder &a, std::string const &filename, PxTransform const &pose,
              py::array_t<PxReal> const &scale, std::shared_ptr<SPhysicalMaterial> material,
-             PxReal density, PxReal patchRadius, PxReal minPatchRadius, bool isTrigger) {
+             PxReal density, PxReal patchRadius, PxReal minPatchRadius, bool isTrigger,
+             uint32_t maxTriangles) {
             a.addConvexShapeFromFile(filename, pose, array2vec3(scale), material, density,
-                                     patchRadius, minPatchRadius, isTrigger);
+                                     patchRadius, minPatchRadius, isTrigger, maxTriangles);
           },
           R"doc(
 Add a collision shape from file (see assimp for supported formats).
-If the shape in the file is not convex, it will be converted by the PhysX backend.)doc",
+If the shape in the file is not convex, it will be converted by the PhysX backend.
+
+Args:
+  max_triangles: if nonzero, the mesh is simplified to at most this many triangles
+    before cooking. Simplified meshes are cached separately for each budget.)doc",
           py::arg("filename"), py::arg("pose") = PxTransform(PxIdentity),
           py::arg("scale") = make_array<PxReal>({1, 1, 1}), py::arg("material") = nullptr,
           py::arg("density") = 1000, py::arg("patch_radius") = 0.f,
-          py::arg("min_patch_radius") = 0.f, py::arg("is_trigger") = false)
+          py::arg("min_patch_radius") = 0.f, py::arg("is_trigger") = false,
+          py::arg("max_triangles") = 0)
       .def(
           "add_nonconvex_collision_from_file",
           [](ActorBuilder &a, std::string const &filename, PxTransform const &pose,
              py::array_t<PxReal> const &scale, std::shared_ptr<SPhysicalMaterial> material,
-             PxReal patchRadius, PxReal minPatchRadius, bool isTrigger) {
+             PxReal patchRadius, PxReal minPatchRadius, bool isTrigger, uint32_t maxTriangles) {
             a.addNonConvexShapeFromFile(filename, pose, array2vec3(scale), material, patchRadius,
-                                        minPatchRadius, isTrigger);
+                                        minPatchRadius, isTrigger, maxTriangles);
           },
-          R"doc(Add a nonconvex collision shape from a file. If it is not a trigger, then it is only valid for static and kinematic actors.)doc",
+          R"doc(Add a nonconvex collision shape from a file. If it is not a trigger, then it is only valid for static and kinematic actors. A nonzero max_triangles simplifies the mesh to at most this many triangles before cooking.)doc",
           py::arg("filename"), py::arg("pose") = PxTransform(PxIdentity),
           py::arg("scale") = make_array<PxReal>({1, 1, 1}), py::arg("material") = nullptr,
           py::arg("patch_radius") = 0.f, py::arg("min_patch_radius") = 0.f,
-          py::arg("is_trigger") = false)
+          py::arg("is_trigger") = false, py::arg("max_triangles") = 0)
       .def(
           "add_multiple_collisions_from_file",
           [](ActorBuilder &a, std::string const &filename, PxTransform const &pose,
@@ -1352,6 +2158,36 @@ Different from @add_collision_from_file, all connected components in the file wi
           py::arg("scale") = make_array<PxReal>({1, 1, 1}), py::arg("material") = nullptr,
           py::arg("density") = 1000, py::arg("patch_radius") = 0.f,
           py::arg("min_patch_radius") = 0.f, py::arg("is_trigger") = false)
+      .def(
+          "add_decomposed_collisions_from_file",
+          [](ActorBuilder &a, std::string const &filename, PxTransform const &pose,
+             py::array_t<PxReal> const &scale, std::shared_ptr<SPhysicalMaterial> material,
+             PxReal density, PxReal patchRadius, PxReal minPatchRadius, bool isTrigger,
+             uint32_t resolution, uint32_t maxConvexHulls, float maxConcavity) {
+            ConvexDecompositionConfig config;
+            config.resolution = resolution;
+            config.maxConvexHulls = maxConvexHulls;
+            config.maxConcavity = maxConcavity;
+            a.addDecomposedConvexShapesFromFile(filename, pose, array2vec3(scale), material,
+                                                density, patchRadius, minPatchRadius, isTrigger,
+                                                config);
+          },
+          R"doc(
+Add collision shapes from an approximate convex decomposition of a nonconvex mesh, which is
+valid for dynamic actors. The decomposition is cached on disk by file content.
+
+Args:
+  resolution: voxels along the longest side of the mesh
+  max_convex_hulls: maximum number of convex parts
+  max_concavity: stop splitting when the empty space in every part's hull is below this
+    fraction of the hull volume of the whole mesh
+)doc",
+          py::arg("filename"), py::arg("pose") = PxTransform(PxIdentity),
+          py::arg("scale") = make_array<PxReal>({1, 1, 1}), py::arg("material") = nullptr,
+          py::arg("density") = 1000, py::arg("patch_radius") = 0.f,
+          py::arg("min_patch_radius") = 0.f, py::arg("is_trigger") = false,
+          py::arg("resolution") = 32, py::arg("max_convex_hulls") = 16,
+          py::arg("max_concavity") = 0.01f)
       .def(
           "add_box_collision",
           [](ActorBuilder &a, PxTransform const &pose, py::array_t<PxReal> const &halfSize,
@@ -1374,6 +2210,27 @@ Different from @add_collision_from_file, all connected components in the file wi
            py::arg("pose") = PxTransform(PxIdentity), py::arg("radius") = 1,
            py::arg("material") = nullptr, py::arg("density") = 1000, py::arg("patch_radius") = 0.f,
            py::arg("min_patch_radius") = 0.f, py::arg("is_trigger") = false)
+      .def("add_height_field_collision", &ActorBuilder::addHeightFieldShape,
+           R"doc(Add a heightfield collision shape. Only valid for static and kinematic actors.)doc",
+           py::arg("height_field"), py::arg("pose") = PxTransform(PxIdentity),
+           py::arg("material") = nullptr, py::arg("patch_radius") = 0.f,
+           py::arg("min_patch_radius") = 0.f, py::arg("is_trigger") = false)
+      .def(
+          "add_height_field_visual",
+          [](ActorBuilder &a, std::shared_ptr<SHeightField> heightField, PxTransform const &pose,
+             py::array_t<PxReal> color, std::string const &name) {
+            a.addHeightFieldVisual(heightField, pose, array2vec3(color), name);
+          },
+          py::arg("height_field"), py::arg("pose") = PxTransform(PxIdentity),
+          py::arg("color") = make_array<PxReal>({1, 1, 1}), py::arg("name") = "")
+      .def(
+          "add_height_field_visual",
+          [](ActorBuilder &a, std::shared_ptr<SHeightField> heightField, PxTransform const &pose,
+             std::shared_ptr<Renderer::IPxrMaterial> &mat, std::string const &name) {
+            a.addHeightFieldVisualWithMaterial(heightField, pose, mat, name);
+          },
+          py::arg("height_field"), py::arg("pose") = PxTransform(PxIdentity),
+          py::arg("material") = nullptr, py::arg("name") = "")
       .def(
           "add_box_visual",
           [](ActorBuilder &a, PxTransform const &pose, py::array_t<PxReal> const &halfSize,
@@ -1463,8 +2320,8 @@ References:
 )doc",
           py::arg("mass"), py::arg("inertia_pose"), py::arg("inertia"))
       .def("set_collision_groups", &ActorBuilder::setCollisionGroup,
-           "see CollisionShape.set_collision_groups", py::arg("group0"), py::arg("group1"),
-           py::arg("group2"), py::arg("group3"))
+           "see CollisionShape.set_collision_groups, group3 must not exceed 0xffff",
+           py::arg("group0"), py::arg("group1"), py::arg("group2"), py::arg("group3"))
       .def("reset_collision_groups", &ActorBuilder::resetCollisionGroup)
       .def(
           "build", [](ActorBuilder &a, std::string const &name) { return a.build(false, name); },
@@ -1474,7 +2331,14 @@ References:
           [](ActorBuilder &a, std::string const &name) { return a.build(true, name); },
           py::arg("name") = "", py::return_value_policy::reference)
       .def("build_static", &ActorBuilder::buildStatic, py::return_value_policy::reference,
-           py::arg("name") = "");
+           py::arg("name") = "")
+      .def(
+          "build_async",
+          [](ActorBuilder &a, bool isKinematic, std::string const &name) {
+            return LoadFuture<SActor>{a.buildAsync(isKinematic, name).share()};
+          },
+          "Load meshes in the background, the actor is built at the next scene step",
+          py::arg("is_kinematic") = false, py::arg("name") = "");
 
   PyShapeRecord.def_readonly("filename", &ActorBuilder::ShapeRecord::filename)
       .def_property_readonly("type",
@@ -1492,6 +2356,10 @@ References:
                                  return "Sphere";
                                case sapien::ActorBuilder::ShapeRecord::NonConvexMesh:
                                  return "Nonconvex";
+                               case sapien::ActorBuilder::ShapeRecord::DecomposedMesh:
+                                 return "Decomposed";
+                               case sapien::ActorBuilder::ShapeRecord::HeightField:
+                                 return "HeightField";
                                }
                                return "";
                              })
@@ -1501,6 +2369,8 @@ References:
       .def_readonly("length", &ActorBuilder::ShapeRecord::length)
       .def_readonly("pose", &ActorBuilder::ShapeRecord::pose)
       .def_readonly("density", &ActorBuilder::ShapeRecord::density)
+      .def_readonly("max_triangles", &ActorBuilder::ShapeRecord::maxTriangles)
+      .def_readonly("height_field", &ActorBuilder::ShapeRecord::heightField)
       .def_readonly("material", &ActorBuilder::ShapeRecord::material,
                     py::return_value_policy::reference);
 
@@ -1516,6 +2386,8 @@ References:
                                  return "Capsule";
                                case sapien::ActorBuilder::VisualRecord::Sphere:
                                  return "Sphere";
+                               case sapien::ActorBuilder::VisualRecord::HeightField:
+                                 return "HeightField";
                                }
                                return "";
                              })
@@ -1612,6 +2484,12 @@ Args:
 
   PyArticulationBuilder.def("set_scene", &ArticulationBuilder::setScene, py::arg("scene"))
       .def("get_scene", &ArticulationBuilder::getScene)
+      .def_property("aggregate", &ArticulationBuilder::getAggregate,
+                    &ArticulationBuilder::setAggregate, py::return_value_policy::reference)
+      .def_property("self_collision", &ArticulationBuilder::getSelfCollision,
+                    &ArticulationBuilder::setSelfCollision)
+      .def_property("environment", &ArticulationBuilder::getEnvironment,
+                    &ArticulationBuilder::setEnvironment)
       .def(
           "create_link_builder",
           [](ArticulationBuilder &b, std::shared_ptr<LinkBuilder> parent) {
@@ -1630,7 +2508,14 @@ Args:
       .def_readwrite("load_multiple_collisions_from_file",
                      &URDF::URDFLoader::multipleMeshesInOneFile)
       .def_readwrite("collision_is_visual", &URDF::URDFLoader::collisionIsVisual)
+      .def_readwrite("environment", &URDF::URDFLoader::environment)
       .def_readwrite("scale", &URDF::URDFLoader::scale)
+      .def_readwrite("use_compiled_cache", &URDF::URDFLoader::useCompiledCache,
+                     "Reuse compiled URDF descriptions within this process, off by default. The 64 most "
+                     "recently used descriptions are kept and invalidated by mesh file changes.")
+      .def_readwrite("compiled_cache_directory", &URDF::URDFLoader::compiledCacheDirectory,
+                     "Directory to share compiled URDF descriptions across processes, empty to "
+                     "disable")
       .def(
           "load",
           [](URDF::URDFLoader &loader, std::string const &filename, py::dict &dict) {
@@ -1683,7 +2568,39 @@ Args:
             auto config = parseURDFConfig(dict);
             return loader.loadFileAsArticulationBuilder(filename, config);
           },
-          py::return_value_policy::reference, py::arg("filename"), py::arg("config") = py::dict());
+          py::return_value_policy::reference, py::arg("filename"), py::arg("config") = py::dict())
+      .def("save_bundle", &URDF::URDFLoader::saveBundle,
+           "Pack a URDF with its cooked collision meshes and visual meshes into one file",
+           py::arg("filename"), py::arg("bundle_filename"))
+      .def(
+          "load_bundle",
+          [](URDF::URDFLoader &loader, std::string const &filename, py::dict &dict) {
+            auto config = parseURDFConfig(dict);
+            return loader.loadBundle(filename, config);
+          },
+          "Load an articulation from a file written by save_bundle. Bundled meshes are only "
+          "used by this loader and are released with it.",
+          py::return_value_policy::reference, py::arg("bundle_filename"),
+          py::arg("config") = py::dict())
+      .def(
+          "load_async",
+          [](URDF::URDFLoader &loader, std::string const &filename, py::dict &dict) {
+            auto config = parseURDFConfig(dict);
+            return LoadFuture<SArticulation>{loader.loadAsync(filename, config).share()};
+          },
+          R"doc(
+Same as load, but parsing, mesh loading and render model loading run in background threads.
+The articulation is added to the scene at the next step after loading finishes. The returned
+future can be polled with done() or awaited while the scene keeps stepping.
+)doc",
+          py::arg("filename"), py::arg("config") = py::dict())
+      .def(
+          "load_kinematic_async",
+          [](URDF::URDFLoader &loader, std::string const &filename, py::dict &dict) {
+            auto config = parseURDFConfig(dict);
+            return LoadFuture<SKArticulation>{loader.loadKinematicAsync(filename, config).share()};
+          },
+          py::arg("filename"), py::arg("config") = py::dict());
 
   PySubscription.def("unsubscribe", &Subscription::unsubscribe);
 
@@ -1763,6 +2680,24 @@ Args:
           "_internal_context",
           [](Renderer::SVulkan2Renderer &renderer) { return renderer.mContext.get(); },
           py::return_value_policy::reference)
+      .def_property("share_camera_targets", &Renderer::SVulkan2Renderer::getShareCameraTargets,
+                    &Renderer::SVulkan2Renderer::setShareCameraTargets,
+                    "When true, cameras created afterwards with the same shader directory and "
+                    "resolution share pipelines and render targets, also across scenes. They "
+                    "render in turn and copy all their textures to host memory after every "
+                    "picture.")
+      .def(
+          "get_camera_memory_stats",
+          [](Renderer::SVulkan2Renderer &renderer) {
+            py::list stats;
+            for (auto &s : renderer.getCameraMemoryStats()) {
+              stats.append(memoryStats2dict(s));
+            }
+            return stats;
+          },
+          "Render target and readback memory of every camera. Shared render targets are "
+          "reported by every camera using them. A sharing camera keeps two host copies of "
+          "every readable target, which readback_bytes includes.")
       .def("clear_cached_resources", [](Renderer::SVulkan2Renderer &renderer) {
         renderer.mContext->getResourceManager()->clearCachedResources();
       });
@@ -1979,6 +2914,23 @@ Args:
       .def("get_visual_actor_segmentation",
            [](SCamera &c) { return getUintImageFromCamera(c, "Segmentation"); })
 
+      .def(
+          "get_color_rgb8",
+          [](SCamera &c) {
+            return makeImageArray(c.getRendererCamera()->getColorRGB8(), c.getWidth(),
+                                  c.getHeight());
+          },
+          "Color as uint8 RGB, converted in native code")
+      .def("get_float16_texture", &getHalfImageFromCamera,
+           "Float texture converted to float16 in native code", py::arg("texture_name"))
+      .def(
+          "get_depth",
+          [](SCamera &c) {
+            return makeImageArray(c.getRendererCamera()->getDepthImage(), c.getWidth(),
+                                  c.getHeight());
+          },
+          "Positive depth along the view axis, 0 where nothing is rendered")
+
       .def(
           "get_dl_tensor",
           [](SCamera &cam, std::string const &name) {
@@ -1996,6 +2948,50 @@ Args:
           "Get raw GPU memory for a render target in the dl format. It can be wrapped into "
           "PyTorch or Tensorflow using their API",
           py::arg("texture_name"))
+      .def(
+          "take_picture_async",
+          [](SCamera &cam, std::vector<std::string> const &names) {
+            getVulkanCamera(cam)->takePictureAsync(names);
+          },
+          "Render and start copying the named textures to host memory. It waits for the "
+          "previous picture of this camera to finish, not for this one. The images of a "
+          "picture stay valid while the next picture renders and are overwritten by the one "
+          "after it.",
+          py::arg("texture_names"))
+      .def("get_image_async", &getImageAsyncFromCamera,
+           "Numpy view (no copy) of a texture from the latest take_picture_async. The view "
+           "keeps its memory alive, but the second take_picture_async after this one writes "
+           "into it; copy it to keep the image longer.",
+           py::arg("texture_name"))
+      .def("get_dl_tensor_async", &getDLTensorAsyncFromCamera,
+           "CPU dl tensor (no copy) of a texture from the latest take_picture_async, with the "
+           "same lifetime as get_image_async",
+           py::arg("texture_name"))
+      .def(
+          "get_memory_stats",
+          [](SCamera &c) { return memoryStats2dict(getVulkanCamera(c)->getMemoryStats()); },
+          "Render target and readback memory of this camera (Vulkan only)")
+      .def(
+          "get_color_rgb8_async",
+          [](SCamera &c) {
+            return makeImageArray(getVulkanCamera(c)->getColorRGB8Async(), c.getWidth(),
+                                  c.getHeight());
+          },
+          "get_color_rgb8 of the latest take_picture_async, converted from the mapped buffer")
+      .def(
+          "get_float16_texture_async",
+          [](SCamera &c, std::string const &name) {
+            return makeHalfImageArray(getVulkanCamera(c)->getHalfImageAsync(name), c.getWidth(),
+                                      c.getHeight());
+          },
+          "get_float16_texture of the latest take_picture_async", py::arg("texture_name"))
+      .def(
+          "get_depth_async",
+          [](SCamera &c) {
+            return makeImageArray(getVulkanCamera(c)->getDepthImageAsync(), c.getWidth(),
+                                  c.getHeight());
+          },
+          "get_depth of the latest take_picture_async, Position must have been requested")
       .def(
           "get_camera_matrix", [](SCamera &c) { return mat42array(c.getCameraMatrix()); },
           "Get intrinsic camera matrix in OpenCV format.")
@@ -3,6 +3,7 @@
 #include "sapien_scene.h"
 #include "simulation.h"
 #include <spdlog/spdlog.h>
+#include <stdexcept>
 
 namespace sapien {
 
@@ -27,7 +28,7 @@ void ActorBuilder::addNonConvexShapeFromFile(const std::string &filename, const
                                              const PxVec3 &scale,
                                              std::shared_ptr<SPhysicalMaterial> material,
                                              PxReal patchRadius, PxReal minPatchRadius,
-                                             bool isTrigger) {
+                                             bool isTrigger, uint32_t maxTriangles) {
   ShapeRecord r;
   r.type = ShapeRecord::Type::NonConvexMesh;
   r.filename = filename;
@@ -38,6 +39,7 @@ void ActorBuilder::addNonConvexShapeFromFile(const std::string &filename, const
   r.patchRadius = patchRadius;
   r.minPatchRadius = minPatchRadius;
   r.isTrigger = isTrigger;
+  r.maxTriangles = maxTriangles;
 
   mShapeRecord.push_back(r);
 }
@@ -46,7 +48,8 @@ void ActorBuilder::addConvexShapeFromFile(const std::string &filename, const PxT
                                           const PxVec3 &scale,
                                           std::shared_ptr<SPhysicalMaterial> material,
                                           PxReal density, PxReal patchRadius,
-                                          PxReal minPatchRadius, bool isTrigger) {
+                                          PxReal minPatchRadius, bool isTrigger,
+                                          uint32_t maxTriangles) {
   ShapeRecord r;
   r.type = ShapeRecord::Type::SingleMesh;
   r.filename = filename;
@@ -57,6 +60,7 @@ void ActorBuilder::addConvexShapeFromFile(const std::string &filename, const PxT
   r.patchRadius = patchRadius;
   r.minPatchRadius = minPatchRadius;
   r.isTrigger = isTrigger;
+  r.maxTriangles = maxTriangles;
 
   mShapeRecord.push_back(r);
 }
@@ -81,6 +85,26 @@ void ActorBuilder::addMultipleConvexShapesFromFile(const std::string &filename,
   mShapeRecord.push_back(r);
 }
 
+void ActorBuilder::addDecomposedConvexShapesFromFile(
+    const std::string &filename, const PxTransform &pose, const PxVec3 &scale,
+    std::shared_ptr<SPhysicalMaterial> material, PxReal density, PxReal patchRadius,
+    PxReal minPatchRadius, bool isTrigger, ConvexDecompositionConfig const &config) {
+
+  ShapeRecord r;
+  r.type = ShapeRecord::Type::DecomposedMesh;
+  r.filename = filename;
+  r.pose = pose;
+  r.scale = scale;
+  r.material = material;
+  r.density = density;
+  r.patchRadius = patchRadius;
+  r.minPatchRadius = minPatchRadius;
+  r.isTrigger = isTrigger;
+  r.decomposition = config;
+
+  mShapeRecord.push_back(r);
+}
+
 void ActorBuilder::addBoxShape(const PxTransform &pose, const PxVec3 &halfSize,
                                std::shared_ptr<SPhysicalMaterial> material, PxReal density,
                                PxReal patchRadius, PxReal minPatchRadius, bool isTrigger) {
@@ -130,6 +154,27 @@ void ActorBuilder::addSphereShape(const PxTransform &pose, PxReal radius,
   mShapeRecord.push_back(r);
 }
 
+void ActorBuilder::addHeightFieldShape(std::shared_ptr<SHeightField> heightField,
+                                       const PxTransform &pose,
+                                       std::shared_ptr<SPhysicalMaterial> material,
+                                       PxReal patchRadius, PxReal minPatchRadius, bool isTrigger) {
+  if (!heightField) {
+    throw std::runtime_error("Failed to add heightfield shape: heightfield is null");
+  }
+  ShapeRecord r;
+  r.type = ShapeRecord::Type::HeightField;
+  r.heightField = heightField;
+  r.pose = pose;
+  r.scale = heightField->getScale();
+  r.material = material;
+  r.density = 0.f;
+  r.patchRadius = patchRadius;
+  r.minPatchRadius = minPatchRadius;
+  r.isTrigger = isTrigger;
+
+  mShapeRecord.push_back(r);
+}
+
 void ActorBuilder::addBoxVisualWithMaterial(const PxTransform &pose, const PxVec3 &halfSize,
                                             std::shared_ptr<Renderer::IPxrMaterial> material,
                                             std::string const &name) {
@@ -207,6 +252,38 @@ void ActorBuilder::addSphereVisual(const PxTransform &pose, PxReal radius, const
   addSphereVisualWithMaterial(pose, radius, mat, name);
 }
 
+void ActorBuilder::addHeightFieldVisualWithMaterial(
+    std::shared_ptr<SHeightField> heightField, const PxTransform &pose,
+    std::shared_ptr<Renderer::IPxrMaterial> material, std::string const &name) {
+  if (!heightField) {
+    throw std::runtime_error("Failed to add heightfield visual: heightfield is null");
+  }
+  auto renderer = mScene->getSimulation()->getRenderer();
+  if (!material && renderer) {
+    material = mScene->getSimulation()->getRenderer()->createMaterial();
+  }
+  VisualRecord r;
+  r.type = VisualRecord::Type::HeightField;
+  r.heightField = heightField;
+  r.pose = pose;
+  r.scale = {1, 1, 1};
+  r.material = material;
+  r.name = name;
+
+  mVisualRecord.push_back(r);
+}
+
+void ActorBuilder::addHeightFieldVisual(std::shared_ptr<SHeightField> heightField,
+                                        const PxTransform &pose, const PxVec3 &color,
+                                        std::string const &name) {
+  auto renderer = mScene->getSimulation()->getRenderer();
+  auto mat = renderer ? renderer->createMaterial() : nullptr;
+  if (mat) {
+    mat->setBaseColor({color.x, color.y, color.z, 1.f});
+  }
+  addHeightFieldVisualWithMaterial(heightField, pose, mat, name);
+}
+
 void ActorBuilder::addVisualFromFile(const std::string &filename, const PxTransform &pose,
                                      const PxVec3 &scale,
                                      std::shared_ptr<Renderer::IPxrMaterial> material,
@@ -238,8 +315,8 @@ void ActorBuilder::buildShapes(std::vector<std::unique_ptr<SCollisionShape>> &sh
 
     switch (r.type) {
     case ShapeRecord::Type::NonConvexMesh: {
-      PxTriangleMesh *mesh =
-          mScene->getSimulation()->getMeshManager().loadNonConvexMesh(r.filename);
+      PxTriangleMesh *mesh = mScene->getSimulation()->getMeshManager().loadNonConvexMesh(
+          r.filename, true, true, r.maxTriangles);
       if (!mesh) {
         spdlog::get("SAPIEN")->error("Failed to load non-convex mesh for actor");
         continue;
@@ -261,7 +338,8 @@ void ActorBuilder::buildShapes(std::vector<std::unique_ptr<SCollisionShape>> &sh
     }
 
     case ShapeRecord::Type::SingleMesh: {
-      PxConvexMesh *mesh = mScene->getSimulation()->getMeshManager().loadMesh(r.filename);
+      PxConvexMesh *mesh = mScene->getSimulation()->getMeshManager().loadMesh(
+          r.filename, true, true, r.maxTriangles);
       if (!mesh) {
         spdlog::get("SAPIEN")->error("Failed to load convex mesh for actor");
         continue;
@@ -284,8 +362,12 @@ void ActorBuilder::buildShapes(std::vector<std::unique_ptr<SCollisionShape>> &sh
       break;
     }
 
-    case ShapeRecord::Type::MultipleMeshes: {
-      auto meshes = mScene->getSimulation()->getMeshManager().loadMeshGroup(r.filename);
+    case ShapeRecord::Type::MultipleMeshes:
+    case ShapeRecord::Type::DecomposedMesh: {
+      auto &meshManager = mScene->getSimulation()->getMeshManager();
+      auto meshes = r.type == ShapeRecord::Type::MultipleMeshes
+                        ? meshManager.loadMeshGroup(r.filename)
+                        : meshManager.loadDecomposedMesh(r.filename, r.decomposition);
       for (auto mesh : meshes) {
         if (!mesh) {
           spdlog::get("SAPIEN")->error("Failed to load part of the convex mesh for actor");
@@ -367,6 +449,25 @@ void ActorBuilder::buildShapes(std::vector<std::unique_ptr<SCollisionShape>> &sh
       densities.push_back(r.density);
       break;
     }
+
+    case ShapeRecord::Type::HeightField: {
+      auto shape =
+          mScene->getSimulation()->createCollisionShape(r.heightField->getGeometry(), material);
+      if (!shape) {
+        throw std::runtime_error("Failed to create heightfield shape");
+      }
+      shape->setContactOffset(mScene->mDefaultContactOffset);
+      PxVec3 offset(0, 0, r.heightField->getHeightOffset());
+      shape->setLocalPose(r.pose * PxTransform(offset, SHeightField::Frame));
+      shape->setTorsionalPatchRadius(r.patchRadius);
+      shape->setMinTorsionalPatchRadius(r.minPatchRadius);
+      if (r.isTrigger) {
+        shape->setIsTrigger(true);
+      }
+      shapes.push_back(std::move(shape));
+      densities.push_back(0);
+      break;
+    }
     }
   }
 }
@@ -395,6 +496,10 @@ void ActorBuilder::buildVisuals(std::vector<Renderer::IPxrRigidbody *> &renderBo
     case VisualRecord::Type::Mesh:
       body = rScene->addRigidbody(r.filename, r.scale, r.material);
       break;
+    case VisualRecord::Type::HeightField:
+      body = rScene->addRigidbody(r.heightField->getVertices(), r.heightField->getNormals(),
+                                  r.heightField->getIndices(), r.scale, r.material);
+      break;
     }
     if (body) {
       physx_id_t newId = mScene->mRenderIdGenerator.next();
@@ -410,6 +515,11 @@ void ActorBuilder::buildVisuals(std::vector<Renderer::IPxrRigidbody *> &renderBo
 }
 
 void ActorBuilder::setCollisionGroup(uint32_t g0, uint32_t g1, uint32_t g2, uint32_t g3) {
+  // checked here so a build does not fail halfway
+  if (g3 > 0xffff) {
+    throw std::invalid_argument("collision group 3 must not exceed 0xffff, the high 16 bits "
+                                "hold the environment");
+  }
   mCollisionGroup.w0 = g0;
   mCollisionGroup.w1 = g1;
   mCollisionGroup.w2 = g2;
@@ -563,6 +673,18 @@ void ActorBuilder::buildCollisionVisuals(
                                           PxVec3{1, 0, 0});
       break;
     }
+    case PxGeometryType::eHEIGHTFIELD: {
+      PxHeightFieldGeometry geom;
+      shape->getPxShape()->getHeightFieldGeometry(geom);
+
+      std::vector<PxVec3> vertices;
+      std::vector<PxVec3> normals;
+      std::vector<uint32_t> triangles;
+      SHeightField::generateMesh(geom, vertices, normals, triangles);
+      cBody = rendererScene->addRigidbody(vertices, normals, triangles, {1, 1, 1},
+                                          PxVec3{1, 0, 0});
+      break;
+    }
     default:
       spdlog::get("SAPIEN")->error(
           "Failed to create collision shape rendering: unrecognized geometry type.");
@@ -578,7 +700,20 @@ void ActorBuilder::buildCollisionVisuals(
   }
 }
 
+bool ActorBuilder::hasHeightFieldShape() const {
+  for (auto &r : mShapeRecord) {
+    if (r.type == ShapeRecord::Type::HeightField) {
+      return true;
+    }
+  }
+  return false;
+}
+
 SActor *ActorBuilder::build(bool isKinematic, std::string const &name) const {
+  if (!isKinematic && hasHeightFieldShape()) {
+    throw std::runtime_error("Failed to build actor: heightfield shapes require a static or "
+                             "kinematic actor");
+  }
   physx_id_t actorId = mScene->mActorIdGenerator.next();
 
   std::vector<std::unique_ptr<SCollisionShape>> shapes;
@@ -598,15 +733,18 @@ SActor *ActorBuilder::build(bool isKinematic, std::string const &name) const {
     body->setSegmentationId(actorId);
   }
 
+  PxVec3 offset = mScene->getEnvironmentOffset(mEnvironment);
   PxRigidDynamic *actor =
-      mScene->getSimulation()->mPhysicsSDK->createRigidDynamic(PxTransform(PxIdentity));
+      mScene->getSimulation()->mPhysicsSDK->createRigidDynamic(PxTransform(offset));
   auto sActor =
       std::unique_ptr<SActor>(new SActor(actor, actorId, mScene, renderBodies, collisionBodies));
 
   actor->setRigidBodyFlag(PxRigidBodyFlag::eKINEMATIC, isKinematic);
+  SAggregate *aggregate = selectAggregate(shapes.size());
   for (size_t i = 0; i < shapes.size(); ++i) {
     shapes[i]->setCollisionGroups(mCollisionGroup.w0, mCollisionGroup.w1, mCollisionGroup.w2,
                                   mCollisionGroup.w3);
+    shapes[i]->setEnvironment(mEnvironment);
     sActor->attachShape(std::move(shapes[i]));
   }
   if (shapes.size() && mUseDensity) {
@@ -644,6 +782,7 @@ SActor *ActorBuilder::build(bool isKinematic, std::string const &name) const {
   sActor->mCol1 = mCollisionGroup.w0;
   sActor->mCol2 = mCollisionGroup.w1;
   sActor->mCol3 = mCollisionGroup.w2;
+  sActor->mEnvironment = mEnvironment;
 
   actor->userData = sActor.get();
 
@@ -652,12 +791,71 @@ SActor *ActorBuilder::build(bool isKinematic, std::string const &name) const {
                                   mScene->mDefaultSolverVelocityIterations);
 
   auto result = sActor.get();
-  mScene->addActor(std::move(sActor));
+  mScene->addActor(std::move(sActor), aggregate);
 
   result->mBuilder = shared_from_this();
   return result;
 }
 
+void ActorBuilder::prepare() const {
+  auto &meshManager = mScene->getSimulation()->getMeshManager();
+  for (auto &r : mShapeRecord) {
+    switch (r.type) {
+    case ShapeRecord::Type::NonConvexMesh:
+      meshManager.loadNonConvexMesh(r.filename, true, true, r.maxTriangles);
+      break;
+    case ShapeRecord::Type::SingleMesh:
+      meshManager.loadMesh(r.filename, true, true, r.maxTriangles);
+      break;
+    case ShapeRecord::Type::MultipleMeshes:
+      meshManager.loadMeshGroup(r.filename);
+      break;
+    case ShapeRecord::Type::DecomposedMesh:
+      meshManager.loadDecomposedMesh(r.filename, r.decomposition);
+      break;
+    default:
+      break;
+    }
+  }
+
+  auto renderer = mScene->getSimulation()->getRenderer();
+  if (!renderer) {
+    return;
+  }
+  for (auto &r : mVisualRecord) {
+    if (r.type == VisualRecord::Type::Mesh) {
+      renderer->preloadModel(r.filename);
+    }
+  }
+}
+
+std::future<SActor *> ActorBuilder::buildAsync(bool isKinematic, std::string const &name) {
+  auto promise = std::make_shared<std::promise<SActor *>>();
+  auto future = promise->get_future();
+  auto builder = shared_from_this();
+  mScene->runInBackground([=]() {
+    try {
+      builder->prepare();
+    } catch (...) {
+      promise->set_exception(std::current_exception());
+      return;
+    }
+    builder->mScene->scheduleAtStep(
+        [=]() {
+          try {
+            promise->set_value(builder->build(isKinematic, name));
+          } catch (...) {
+            promise->set_exception(std::current_exception());
+          }
+        },
+        [=]() {
+          promise->set_exception(std::make_exception_ptr(
+              std::runtime_error("Scene was destroyed before the actor was added")));
+        });
+  });
+  return future;
+}
+
 SActorStatic *ActorBuilder::buildStatic(std::string const &name) const {
   physx_id_t actorId = mScene->mActorIdGenerator.next();
 
@@ -684,13 +882,16 @@ SActorStatic *ActorBuilder::buildStatic(std::string const &name) const {
   data.word2 = mCollisionGroup.w2;
   data.word3 = 0;
 
+  PxVec3 offset = mScene->getEnvironmentOffset(mEnvironment);
   PxRigidStatic *actor =
-      mScene->getSimulation()->mPhysicsSDK->createRigidStatic(PxTransform(PxIdentity));
+      mScene->getSimulation()->mPhysicsSDK->createRigidStatic(PxTransform(offset));
   auto sActor = std::unique_ptr<SActorStatic>(
       new SActorStatic(actor, actorId, mScene, renderBodies, collisionBodies));
+  SAggregate *aggregate = selectAggregate(shapes.size());
   for (size_t i = 0; i < shapes.size(); ++i) {
     shapes[i]->setCollisionGroups(mCollisionGroup.w0, mCollisionGroup.w1, mCollisionGroup.w2,
                                   mCollisionGroup.w3);
+    shapes[i]->setEnvironment(mEnvironment);
     sActor->attachShape(std::move(shapes[i]));
   }
 
@@ -699,16 +900,29 @@ SActorStatic *ActorBuilder::buildStatic(std::string const &name) const {
   sActor->mCol1 = mCollisionGroup.w0;
   sActor->mCol2 = mCollisionGroup.w1;
   sActor->mCol3 = mCollisionGroup.w2;
+  sActor->mEnvironment = mEnvironment;
 
   actor->userData = sActor.get();
 
   auto result = sActor.get();
-  mScene->addActor(std::move(sActor));
+  mScene->addActor(std::move(sActor), aggregate);
 
   result->mBuilder = shared_from_this();
   return result;
 }
 
+SAggregate *ActorBuilder::selectAggregate(size_t shapeCount) const {
+  if (mAggregate) {
+    return mAggregate;
+  }
+  // shapes of one actor never collide, self collision only matters for groups
+  uint32_t minShapes = mScene->mActorAggregateShapeCount;
+  if (minShapes && shapeCount >= minShapes) {
+    return mScene->createAggregate(1, false, true);
+  }
+  return nullptr;
+}
+
 SActorStatic *ActorBuilder::buildGround(PxReal altitude, bool render,
                                         std::shared_ptr<SPhysicalMaterial> material,
                                         std::shared_ptr<Renderer::IPxrMaterial> renderMaterial,
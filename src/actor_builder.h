@@ -1,8 +1,11 @@
 #pragma once
+#include "convex_decomposition.h"
 #include "id_generator.h"
 #include "render_interface.h"
+#include "sapien_height_field.h"
 #include "sapien_material.h"
 #include <PxPhysicsAPI.h>
+#include <future>
 #include <memory>
 #include <vector>
 
@@ -14,6 +17,7 @@ class Simulation;
 class SActor;
 class SActorStatic;
 class SCollisionShape;
+class SAggregate;
 
 namespace Renderer {
 class IPxrRididbody;
@@ -22,7 +26,16 @@ class IPxrRididbody;
 class ActorBuilder : public std::enable_shared_from_this<ActorBuilder> {
 public:
   struct ShapeRecord {
-    enum Type { SingleMesh, MultipleMeshes, NonConvexMesh, Box, Capsule, Sphere } type;
+    enum Type {
+      SingleMesh,
+      MultipleMeshes,
+      NonConvexMesh,
+      Box,
+      Capsule,
+      Sphere,
+      DecomposedMesh,
+      HeightField
+    } type;
     // mesh, scale also for box
     std::string filename;
     PxVec3 scale;
@@ -39,14 +52,25 @@ public:
     PxReal patchRadius;
     PxReal minPatchRadius;
     bool isTrigger;
+
+    // decomposed mesh
+    ConvexDecompositionConfig decomposition;
+
+    // single and non-convex mesh, decimation budget, 0 keeps the full mesh
+    uint32_t maxTriangles{0};
+
+    // heightfield
+    std::shared_ptr<SHeightField> heightField;
   };
 
   struct VisualRecord {
-    enum Type { Mesh, Box, Capsule, Sphere } type;
+    enum Type { Mesh, Box, Capsule, Sphere, HeightField } type;
 
     std::string filename;
     PxVec3 scale;
 
+    std::shared_ptr<SHeightField> heightField;
+
     PxReal radius;
     PxReal length;
 
@@ -71,6 +95,9 @@ protected:
     uint32_t w0 = 1, w1 = 1, w2 = 0, w3 = 0;
   } mCollisionGroup;
 
+  SAggregate *mAggregate{};
+  int mEnvironment{-1};
+
 public:
   explicit ActorBuilder(SScene *scene = nullptr);
   ActorBuilder(ActorBuilder const &other) = delete;
@@ -90,14 +117,16 @@ public:
                                  const PxVec3 &scale = {1, 1, 1},
                                  std::shared_ptr<SPhysicalMaterial> material = nullptr,
                                  PxReal patchRadius = 0.f, PxReal minPatchRadius = 0.f,
-                                 bool isTrigger = false);
+                                 bool isTrigger = false, uint32_t maxTriangles = 0);
 
+  /* maxTriangles decimates the source mesh before cooking, see MeshManager::loadMesh */
   void addConvexShapeFromFile(const std::string &filename,
                               const PxTransform &pose = {{0, 0, 0}, PxIdentity},
                               const PxVec3 &scale = {1, 1, 1},
                               std::shared_ptr<SPhysicalMaterial> material = nullptr,
                               PxReal density = 1000.f, PxReal patchRadius = 0.f,
-                              PxReal minPatchRadius = 0.f, bool isTrigger = false);
+                              PxReal minPatchRadius = 0.f, bool isTrigger = false,
+                              uint32_t maxTriangles = 0);
 
   void addMultipleConvexShapesFromFile(const std::string &filename,
                                        const PxTransform &pose = {{0, 0, 0}, PxIdentity},
@@ -106,6 +135,16 @@ public:
                                        PxReal density = 1000.f, PxReal patchRadius = 0.f,
                                        PxReal minPatchRadius = 0.f, bool isTrigger = false);
 
+  /* Decompose a non-convex mesh into convex parts so it can be used by dynamic actors. The
+   * decomposition is cached on disk, see MeshManager::loadDecomposedMesh. */
+  void addDecomposedConvexShapesFromFile(const std::string &filename,
+                                         const PxTransform &pose = {{0, 0, 0}, PxIdentity},
+                                         const PxVec3 &scale = {1, 1, 1},
+                                         std::shared_ptr<SPhysicalMaterial> material = nullptr,
+                                         PxReal density = 1000.f, PxReal patchRadius = 0.f,
+                                         PxReal minPatchRadius = 0.f, bool isTrigger = false,
+                                         ConvexDecompositionConfig const &config = {});
+
   void addBoxShape(const PxTransform &pose = {{0, 0, 0}, PxIdentity},
                    const PxVec3 &halfSize = {1, 1, 1},
                    std::shared_ptr<SPhysicalMaterial> material = nullptr, PxReal density = 1000.f,
@@ -122,6 +161,13 @@ public:
                       PxReal density = 1000.f, PxReal patchRadius = 0.f,
                       PxReal minPatchRadius = 0.f, bool isTrigger = false);
 
+  /* heightfield terrain, only valid for static and kinematic actors */
+  void addHeightFieldShape(std::shared_ptr<SHeightField> heightField,
+                           const PxTransform &pose = {{0, 0, 0}, PxIdentity},
+                           std::shared_ptr<SPhysicalMaterial> material = nullptr,
+                           PxReal patchRadius = 0.f, PxReal minPatchRadius = 0.f,
+                           bool isTrigger = false);
+
   /* Visual functions */
   void addBoxVisualWithMaterial(const PxTransform &pose = {{0, 0, 0}, PxIdentity},
                                 const PxVec3 &halfSize = {1, 1, 1},
@@ -146,6 +192,15 @@ public:
   void addSphereVisual(const PxTransform &pose = {{0, 0, 0}, PxIdentity}, PxReal radius = 1,
                        const PxVec3 &color = {1, 1, 1}, std::string const &name = "");
 
+  /* renders the mesh generated with the heightfield */
+  void addHeightFieldVisualWithMaterial(std::shared_ptr<SHeightField> heightField,
+                                        const PxTransform &pose = {{0, 0, 0}, PxIdentity},
+                                        std::shared_ptr<Renderer::IPxrMaterial> material = {},
+                                        std::string const &name = "");
+  void addHeightFieldVisual(std::shared_ptr<SHeightField> heightField,
+                            const PxTransform &pose = {{0, 0, 0}, PxIdentity},
+                            const PxVec3 &color = {1, 1, 1}, std::string const &name = "");
+
   void addVisualFromFile(const std::string &filename,
                          const PxTransform &pose = PxTransform({0, 0, 0}, PxIdentity),
                          const PxVec3 &scale = {1, 1, 1},
@@ -159,6 +214,14 @@ public:
   void addCollisionGroup(uint32_t g0, uint32_t g1, uint32_t g2, uint32_t g3);
   void resetCollisionGroup();
 
+  /* actors built afterwards join the aggregate, see SScene::createAggregate */
+  inline void setAggregate(SAggregate *aggregate) { mAggregate = aggregate; }
+  inline SAggregate *getAggregate() const { return mAggregate; }
+
+  /* actors built afterwards belong to the environment, see SScene::addEnvironment */
+  inline void setEnvironment(int environment) { mEnvironment = environment; }
+  inline int getEnvironment() const { return mEnvironment; }
+
   // calling this function will overwrite the densities
   void setMassAndInertia(PxReal mass, PxTransform const &cMassPose, PxVec3 const &inertia);
   inline void setScene(SScene *scene) { mScene = scene; }
@@ -166,6 +229,20 @@ public:
   SActor *build(bool isKinematic = false, std::string const &name = "") const;
   SActorStatic *buildStatic(std::string const &name = "") const;
 
+  /** load and cook collision meshes and preload render models referenced by this builder
+   *
+   *  Only touches the thread-safe mesh and render model caches, so it may run on a worker
+   *  thread. A later build call then finds every asset already loaded.
+   */
+  void prepare() const;
+
+  /** prepare on the simulation thread pool and build at the next scene step
+   *
+   *  The future becomes ready when the scene steps after preparation has finished. If the
+   *  scene is destroyed first, the future holds a std::runtime_error.
+   */
+  std::future<SActor *> buildAsync(bool isKinematic = false, std::string const &name = "");
+
   SActorStatic *buildGround(PxReal altitude, bool render,
                             std::shared_ptr<SPhysicalMaterial> material,
                             std::shared_ptr<Renderer::IPxrMaterial> renderMaterial = {},
@@ -179,6 +256,8 @@ protected:
                     std::vector<physx_id_t> &renderIds) const;
   void buildCollisionVisuals(std::vector<Renderer::IPxrRigidbody *> &collisionBodies,
                              std::vector<std::unique_ptr<SCollisionShape>> &shapes) const;
+  SAggregate *selectAggregate(size_t shapeCount) const;
+  bool hasHeightFieldShape() const;
 };
 
 } // namespace sapien
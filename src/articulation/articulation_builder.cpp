@@ -160,6 +160,8 @@ bool LinkBuilder::build(SArticulation &articulation) const {
   data.word2 = mCollisionGroup.w2;
   data.word3 = 0;
 
+  int environment = mArticulationBuilder->getEnvironment();
+
   // wrap link
   links[mIndex] = std::unique_ptr<SLink>(new SLink(pxLink, &articulation, linkId,
                                                    mArticulationBuilder->getScene(), renderBodies,
@@ -168,6 +170,7 @@ bool LinkBuilder::build(SArticulation &articulation) const {
   for (size_t i = 0; i < shapes.size(); ++i) {
     shapes[i]->setCollisionGroups(mCollisionGroup.w0, mCollisionGroup.w1, mCollisionGroup.w2,
                                   mCollisionGroup.w3);
+    shapes[i]->setEnvironment(environment);
     links[mIndex]->attachShape(std::move(shapes[i]));
   }
 
@@ -204,6 +207,7 @@ bool LinkBuilder::build(SArticulation &articulation) const {
   links[mIndex]->mCol1 = mCollisionGroup.w0;
   links[mIndex]->mCol2 = mCollisionGroup.w1;
   links[mIndex]->mCol3 = mCollisionGroup.w2;
+  links[mIndex]->mEnvironment = environment;
   links[mIndex]->mIndex = mIndex;
 
   pxLink->userData = links[mIndex].get();
@@ -258,8 +262,10 @@ bool LinkBuilder::buildKinematic(SKArticulation &articulation) const {
   data.word2 = mCollisionGroup.w2;
   data.word3 = 0;
 
-  PxRigidDynamic *actor =
-      mScene->getSimulation()->mPhysicsSDK->createRigidDynamic(PxTransform(PxIdentity));
+  int environment = mArticulationBuilder->getEnvironment();
+
+  PxRigidDynamic *actor = mScene->getSimulation()->mPhysicsSDK->createRigidDynamic(
+      PxTransform(mScene->getEnvironmentOffset(environment)));
   actor->setRigidBodyFlag(PxRigidBodyFlag::eKINEMATIC, true);
   links[mIndex] = std::unique_ptr<SKLink>(new SKLink(actor, &articulation, linkId,
                                                      mArticulationBuilder->getScene(),
@@ -267,6 +273,7 @@ bool LinkBuilder::buildKinematic(SKArticulation &articulation) const {
   for (size_t i = 0; i < shapes.size(); ++i) {
     shapes[i]->setCollisionGroups(mCollisionGroup.w0, mCollisionGroup.w1, mCollisionGroup.w2,
                                   mCollisionGroup.w3);
+    shapes[i]->setEnvironment(environment);
     links[mIndex]->attachShape(std::move(shapes[i]));
   }
 
@@ -288,6 +295,7 @@ bool LinkBuilder::buildKinematic(SKArticulation &articulation) const {
   links[mIndex]->mCol1 = mCollisionGroup.w0;
   links[mIndex]->mCol2 = mCollisionGroup.w1;
   links[mIndex]->mCol3 = mCollisionGroup.w2;
+  links[mIndex]->mEnvironment = environment;
   links[mIndex]->mIndex = mIndex;
 
   actor->userData = links[mIndex].get();
@@ -300,12 +308,14 @@ bool LinkBuilder::buildKinematic(SKArticulation &articulation) const {
           new SKJointFixed(&articulation, links[mParent].get(), links[mIndex].get()));
       break;
     case PxArticulationJointType::eREVOLUTE:
-      j = std::unique_ptr<SKJoint>(
-          new SKJointRevolute(&articulation, links[mParent].get(), links[mIndex].get()));
+      j = std::unique_ptr<SKJoint>(new SKJointRevolute(&articulation, links[mParent].get(),
+                                                       links[mIndex].get(),
+                                                       articulation.allocateJointSlot()));
       break;
     case PxArticulationJointType::ePRISMATIC:
-      j = std::unique_ptr<SKJoint>(
-          new SKJointPrismatic(&articulation, links[mParent].get(), links[mIndex].get()));
+      j = std::unique_ptr<SKJoint>(new SKJointPrismatic(&articulation, links[mParent].get(),
+                                                        links[mIndex].get(),
+                                                        articulation.allocateJointSlot()));
       break;
     default:
       spdlog::get("SAPIEN")->error("Unsupported kinematic joint type");
@@ -333,6 +343,12 @@ std::shared_ptr<LinkBuilder> ArticulationBuilder::createLinkBuilder(int parentId
   return mLinkBuilders.back();
 }
 
+void ArticulationBuilder::prepare() const {
+  for (auto &builder : mLinkBuilders) {
+    builder->prepare();
+  }
+}
+
 std::string ArticulationBuilder::summary() const {
   std::stringstream ss;
   ss << "======= Link Summary =======" << std::endl;
@@ -396,6 +412,13 @@ SArticulation *ArticulationBuilder::build(bool fixBase) const {
   if (!prebuild(sorted)) {
     return nullptr;
   }
+  for (auto &builder : mLinkBuilders) {
+    if (builder->hasHeightFieldShape()) {
+      spdlog::get("SAPIEN")->error(
+          "Failed to build articulation: heightfield shapes require a kinematic articulation");
+      return nullptr;
+    }
+  }
 
   auto sArticulation = std::unique_ptr<SArticulation>(new SArticulation(mScene));
   sArticulation->mPxArticulation =
@@ -414,7 +437,19 @@ SArticulation *ArticulationBuilder::build(bool fixBase) const {
   }
 
   auto result = sArticulation.get();
-  mScene->addArticulation(std::move(sArticulation));
+  SAggregate *aggregate = mAggregate;
+  uint32_t linkCount = result->mLinks.size();
+  if (!aggregate && (mScene->mArticulationAggregate || !mSelfCollision)) {
+    if (linkCount <= SAggregate::MaxActorCount) {
+      // one broadphase entry for all links
+      aggregate = mScene->createAggregate(linkCount, mSelfCollision, true);
+    } else if (!mSelfCollision) {
+      spdlog::get("SAPIEN")->warn("Articulation has {} links, more than an aggregate holds. "
+                                  "Self collision stays enabled.",
+                                  linkCount);
+    }
+  }
+  mScene->addArticulation(std::move(sArticulation), aggregate);
 
   {
     uint32_t totalLinkCount = result->mLinks.size();
@@ -460,6 +495,7 @@ SArticulation *ArticulationBuilder::build(bool fixBase) const {
       result->mRootLink = static_cast<SLink *>(j->getChildLink());
     }
   }
+  result->mSortedIndices = sorted;
 
   result->mCache = result->mPxArticulation->createCache();
   result->mPxArticulation->zeroCache(*result->mCache);
@@ -472,6 +508,10 @@ SArticulation *ArticulationBuilder::build(bool fixBase) const {
   std::vector<PxReal> qvel(result->dof(), 0);
   result->setQvel(qvel);
 
+  if (mEnvironment >= 0) {
+    result->setRootPose(PxTransform(mScene->getEnvironmentOffset(mEnvironment)));
+  }
+
   result->mBuilder = shared_from_this();
 
   return result;
@@ -512,9 +552,11 @@ SKArticulation *ArticulationBuilder::buildKinematic() const {
   for (auto &j : result->mJoints) {
     result->mDof += j->getDof();
   }
-  result->mSortedIndices = sorted;
-
   result->mRootLink = static_cast<SKLink *>(result->mJoints[sorted[0]]->getChildLink());
+  result->initSortedLinks(sorted);
+  if (mEnvironment >= 0) {
+    result->setRootPose(PxTransform(mScene->getEnvironmentOffset(mEnvironment)));
+  }
 
   result->mBuilder = shared_from_this();
 
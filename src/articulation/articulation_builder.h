@@ -74,6 +74,10 @@ class ArticulationBuilder : public std::enable_shared_from_this<ArticulationBuil
 
   SScene *mScene;
 
+  SAggregate *mAggregate{};
+  bool mSelfCollision{true};
+  int mEnvironment{-1};
+
 public:
   ArticulationBuilder(SScene *scene = nullptr);
 
@@ -88,9 +92,24 @@ public:
   std::shared_ptr<LinkBuilder> createLinkBuilder(std::shared_ptr<LinkBuilder> parent = nullptr);
   std::shared_ptr<LinkBuilder> createLinkBuilder(int parentIdx);
 
+  /* build into a shared aggregate instead of one per articulation */
+  inline void setAggregate(SAggregate *aggregate) { mAggregate = aggregate; }
+  inline SAggregate *getAggregate() const { return mAggregate; }
+
+  /* when disabled, links never collide with each other regardless of collision groups */
+  inline void setSelfCollision(bool enable) { mSelfCollision = enable; }
+  inline bool getSelfCollision() const { return mSelfCollision; }
+
+  /* all links belong to the environment, the root starts at its offset */
+  inline void setEnvironment(int environment) { mEnvironment = environment; }
+  inline int getEnvironment() const { return mEnvironment; }
+
   SArticulation *build(bool fixBase = false) const;
   SKArticulation *buildKinematic() const;
 
+  /** prepare all link builders, see ActorBuilder::prepare */
+  void prepare() const;
+
   std::string summary() const;
 
   std::vector<LinkBuilder *> getLinkBuilders();
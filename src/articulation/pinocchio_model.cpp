@@ -1,10 +1,15 @@
 #ifdef _USE_PINOCCHIO
 #include "pinocchio_model.h"
+#include "sapien_articulation_base.h"
+#include "sapien_joint.h"
+#include "sapien_link.h"
 #include <pinocchio/algorithm/aba.hpp>
 #include <pinocchio/algorithm/crba.hpp>
 #include <pinocchio/algorithm/joint-configuration.hpp>
 #include <pinocchio/algorithm/rnea.hpp>
 
+#include <limits>
+
 #define ASSERT(exp, info)                                                                         \
   if (!(exp)) {                                                                                   \
     throw std::runtime_error((info));                                                             \
@@ -21,6 +26,129 @@ std::unique_ptr<PinocchioModel> PinocchioModel::fromURDFXML(std::string const &u
   return m;
 }
 
+static pinocchio::SE3 PxTransform2SE3(physx::PxTransform const &T) {
+  return pinocchio::SE3(Eigen::Quaterniond(T.q.w, T.q.x, T.q.y, T.q.z).toRotationMatrix(),
+                        Eigen::Vector3d(T.p.x, T.p.y, T.p.z));
+}
+
+/** inertia of a link expressed in the link frame */
+static pinocchio::Inertia linkInertia(SLinkBase *link) {
+  physx::PxTransform massPose = link->getCMassLocalPose();
+  physx::PxVec3 I = link->getInertia();
+  Eigen::Matrix3d R =
+      Eigen::Quaterniond(massPose.q.w, massPose.q.x, massPose.q.y, massPose.q.z).toRotationMatrix();
+  Eigen::Matrix3d rot = R * Eigen::Vector3d(I.x, I.y, I.z).asDiagonal() * R.transpose();
+  return pinocchio::Inertia(link->getMass(),
+                            Eigen::Vector3d(massPose.p.x, massPose.p.y, massPose.p.z), rot);
+}
+
+std::unique_ptr<PinocchioModel> PinocchioModel::fromSArticulation(SArticulationBase &articulation,
+                                                                  Eigen::Vector3d gravity) {
+  auto m = std::unique_ptr<PinocchioModel>(new PinocchioModel);
+  auto &model = m->model;
+
+  // links[i] is the child link of joints[i]
+  auto links = articulation.getBaseLinks();
+  auto joints = articulation.getBaseJoints();
+
+  uint32_t root = links.size();
+  std::vector<std::vector<uint32_t>> children(links.size());
+  for (uint32_t i = 0; i < joints.size(); ++i) {
+    if (auto parent = joints[i]->getParentLink()) {
+      children[parent->getIndex()].push_back(i);
+    } else {
+      root = i;
+    }
+  }
+  ASSERT(root < links.size(), "failed to find root link");
+
+  // fixed joints are merged into the parent, so each link is attached to a pinocchio joint
+  // with some placement in that joint frame
+  std::vector<pinocchio::JointIndex> linkJoint(links.size(), 0);
+  std::vector<pinocchio::SE3> linkPlacement(links.size(), pinocchio::SE3::Identity());
+  std::vector<pinocchio::FrameIndex> linkFrame(links.size(), 0);
+  std::vector<pinocchio::JointIndex> jointIndex(joints.size(), 0);
+
+  double inf = std::numeric_limits<double>::infinity();
+  std::vector<uint32_t> stack = {root};
+  while (!stack.empty()) {
+    uint32_t idx = stack.back();
+    stack.pop_back();
+
+    auto joint = joints[idx];
+    std::string jointName = "joint_" + std::to_string(idx);
+    pinocchio::FrameIndex jointFrame;
+
+    if (!joint->getParentLink()) {
+      jointFrame = model.addFrame(pinocchio::Frame(jointName, 0, 0, pinocchio::SE3::Identity(),
+                                                   pinocchio::FIXED_JOINT));
+    } else {
+      uint32_t p = joint->getParentLink()->getIndex();
+      pinocchio::SE3 j2p = linkPlacement[p] * PxTransform2SE3(joint->getParentPose());
+      pinocchio::SE3 c2j = PxTransform2SE3(joint->getChildPose().getInverse());
+
+      switch (joint->getType()) {
+      case physx::PxArticulationJointType::eFIX:
+        jointFrame = model.addFrame(
+            pinocchio::Frame(jointName, linkJoint[p], linkFrame[p], j2p, pinocchio::FIXED_JOINT));
+        linkJoint[idx] = linkJoint[p];
+        linkPlacement[idx] = j2p * c2j;
+        break;
+      case physx::PxArticulationJointType::eREVOLUTE:
+      case physx::PxArticulationJointType::ePRISMATIC: {
+        auto limits = joint->getLimits();
+        pinocchio::JointIndex id;
+        Eigen::VectorXd unlimited = Eigen::VectorXd::Constant(1, inf);
+        if (joint->getType() == physx::PxArticulationJointType::eREVOLUTE &&
+            limits[0][0] < -10) {
+          // continuous joint, same as the URDF parser
+          id = model.addJoint(linkJoint[p], pinocchio::JointModelRUBX(), j2p, jointName);
+        } else {
+          pinocchio::JointModel jm;
+          if (joint->getType() == physx::PxArticulationJointType::eREVOLUTE) {
+            jm = pinocchio::JointModelRX();
+          } else {
+            jm = pinocchio::JointModelPX();
+          }
+          id = model.addJoint(linkJoint[p], jm, j2p, jointName, unlimited, unlimited,
+                              Eigen::VectorXd::Constant(1, limits[0][0]),
+                              Eigen::VectorXd::Constant(1, limits[0][1]));
+        }
+        jointFrame = model.addJointFrame(id, linkFrame[p]);
+        jointIndex[idx] = id;
+        linkJoint[idx] = id;
+        linkPlacement[idx] = c2j;
+        break;
+      }
+      default:
+        throw std::runtime_error(
+            "Unsupported joint in computation. Currently support: fixed, revolute, prismatic");
+      }
+    }
+
+    model.appendBodyToJoint(linkJoint[idx], linkInertia(links[idx]), linkPlacement[idx]);
+    linkFrame[idx] = model.addBodyFrame("link_" + std::to_string(idx), linkJoint[idx],
+                                        linkPlacement[idx], jointFrame);
+
+    for (uint32_t c : children[idx]) {
+      stack.push_back(c);
+    }
+  }
+
+  model.gravity = {gravity, Eigen::Vector3d{0, 0, 0}};
+  m->data = pinocchio::Data(model);
+
+  std::vector<pinocchio::JointIndex> activeJoints;
+  for (uint32_t i = 0; i < joints.size(); ++i) {
+    if (joints[i]->getDof() > 0) {
+      activeJoints.push_back(jointIndex[i]);
+    }
+  }
+  m->setJointIndexOrder(activeJoints);
+  m->setLinkFrameOrder(linkFrame);
+  return m;
+}
+
 Eigen::VectorXd PinocchioModel::posS2P(const Eigen::VectorXd &qext) {
   Eigen::VectorXd qint(model.nq);
   uint32_t count = 0;
@@ -72,13 +200,23 @@ Eigen::VectorXd PinocchioModel::posP2S(const Eigen::VectorXd &qint) {
 }
 
 void PinocchioModel::setJointOrder(std::vector<std::string> names) {
-  Eigen::VectorXi v(model.nv);
-  int count = 0;
+  std::vector<pinocchio::JointIndex> indices;
   for (auto &name : names) {
     auto i = model.getJointId(name);
     if (i == static_cast<pinocchio::JointIndex>(model.njoints)) {
       throw std::invalid_argument("invalid names in setJointOrder");
     }
+    indices.push_back(i);
+  }
+  setJointIndexOrder(indices);
+}
+
+void PinocchioModel::setJointIndexOrder(std::vector<pinocchio::JointIndex> const &indices) {
+  Eigen::VectorXi v(model.nv);
+  int count = 0;
+  for (auto i : indices) {
+    ASSERT(i < static_cast<pinocchio::JointIndex>(model.njoints),
+           "invalid index in setJointIndexOrder");
     auto size = model.nvs[i];
     auto qi = model.idx_vs[i];
     for (int s = 0; s < size; ++s) {
@@ -88,14 +226,11 @@ void PinocchioModel::setJointOrder(std::vector<std::string> names) {
   ASSERT(count == model.nv, "setJointOrder failed");
   indexS2P = Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic>(v);
 
-  QIDX = Eigen::VectorXi(names.size());
-  NQ = Eigen::VectorXi(names.size());
-  NV = Eigen::VectorXi(names.size());
-  for (size_t N = 0; N < names.size(); ++N) {
-    auto i = model.getJointId(names[N]);
-    if (i == static_cast<pinocchio::JointIndex>(model.njoints)) {
-      throw std::invalid_argument("invalid names in setJointOrder");
-    }
+  QIDX = Eigen::VectorXi(indices.size());
+  NQ = Eigen::VectorXi(indices.size());
+  NV = Eigen::VectorXi(indices.size());
+  for (size_t N = 0; N < indices.size(); ++N) {
+    auto i = indices[N];
     NQ[N] = model.nqs[i];
     NV[N] = model.nvs[i];
     QIDX[N] = model.idx_qs[i];
@@ -103,13 +238,22 @@ void PinocchioModel::setJointOrder(std::vector<std::string> names) {
 }
 
 void PinocchioModel::setLinkOrder(std::vector<std::string> names) {
-  linkIdx2FrameIdx = {};
-  Eigen::VectorXi v(names.size());
+  std::vector<pinocchio::FrameIndex> indices;
   for (auto &name : names) {
     auto i = model.getFrameId(name, pinocchio::BODY);
     if (i == static_cast<pinocchio::FrameIndex>(model.nframes)) {
       throw std::invalid_argument("invalid names in setLinkOrder");
     }
+    indices.push_back(i);
+  }
+  setLinkFrameOrder(indices);
+}
+
+void PinocchioModel::setLinkFrameOrder(std::vector<pinocchio::FrameIndex> const &indices) {
+  linkIdx2FrameIdx = {};
+  for (auto i : indices) {
+    ASSERT(i < static_cast<pinocchio::FrameIndex>(model.nframes),
+           "invalid index in setLinkFrameOrder");
     linkIdx2FrameIdx.push_back(i);
   }
 }
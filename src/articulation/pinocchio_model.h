@@ -8,6 +8,7 @@
 #include <pinocchio/parsers/urdf.hpp>
 
 namespace sapien {
+class SArticulationBase;
 
 class PinocchioModel {
   pinocchio::Model model{};
@@ -32,6 +33,15 @@ public:
   static std::unique_ptr<PinocchioModel> fromURDFXML(std::string const &urdf,
                                                      Eigen::Vector3d gravity);
 
+  /** build the model directly from the joints and links of an articulation
+   *
+   *  The root is fixed to the world. Joint and link orders follow SAPIEN indices, so no
+   *  further call to setJointOrder/setLinkOrder is needed.
+   *  Throws if the articulation contains a joint type that cannot be converted.
+   */
+  static std::unique_ptr<PinocchioModel> fromSArticulation(SArticulationBase &articulation,
+                                                           Eigen::Vector3d gravity);
+
   PinocchioModel(PinocchioModel const &other) = delete;
   PinocchioModel &operator=(PinocchioModel const &other) = delete;
   ~PinocchioModel() = default;
@@ -47,6 +57,10 @@ public:
   void setJointOrder(std::vector<std::string> names);
   void setLinkOrder(std::vector<std::string> names);
 
+  /** same as setJointOrder/setLinkOrder, but with pinocchio joint and frame indices */
+  void setJointIndexOrder(std::vector<pinocchio::JointIndex> const &indices);
+  void setLinkFrameOrder(std::vector<pinocchio::FrameIndex> const &indices);
+
   /** generate a random qpos */
   Eigen::MatrixXd getRandomConfiguration();
 
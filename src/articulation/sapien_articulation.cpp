@@ -2,6 +2,7 @@
 #include "sapien_joint.h"
 #include "sapien_link.h"
 #include "sapien_scene.h"
+#include <algorithm>
 #include <numeric>
 #include <spdlog/spdlog.h>
 #include <stdexcept>
@@ -57,6 +58,7 @@ void SArticulation::setQpos(std::vector<physx::PxReal> const &v) {
     mCache->jointPosition[i] = v2[i];
   }
   mPxArticulation->applyCache(*mCache, PxArticulationCache::ePOSITION);
+  mLinkPosesValid = false;
 }
 
 std::vector<physx::PxReal> SArticulation::getQvel() const {
@@ -95,7 +97,11 @@ std::vector<physx::PxReal> SArticulation::getQf() const {
 }
 void SArticulation::setQf(std::vector<physx::PxReal> const &v) {
   CHECK_SIZE(v);
+  mUserQf = v;
+  applyQf(v);
+}
 
+void SArticulation::applyQf(std::vector<physx::PxReal> const &v) {
   auto v2 = E2I(v);
   for (size_t i = 0; i < v.size(); ++i) {
     mCache->jointForce[i] = v2[i];
@@ -127,6 +133,7 @@ void SArticulation::setQlimits(std::vector<std::array<physx::PxReal, 2>> const &
 
 void SArticulation::setRootPose(physx::PxTransform const &T) {
   mPxArticulation->teleportRootLink(T, true);
+  mLinkPosesValid = false;
 }
 
 void SArticulation::setRootVelocity(physx::PxVec3 const &v) {
@@ -141,6 +148,12 @@ SLinkBase *SArticulation::getRootLink() const { return mRootLink; }
 
 SArticulation::SArticulation(SScene *scene) : SArticulationDrivable(scene) {}
 
+SArticulation::~SArticulation() {
+  for (auto &c : mControllers) {
+    c->mArticulation = nullptr;
+  }
+}
+
 std::vector<PxReal> SArticulation::E2I(std::vector<PxReal> ev) const {
   std::vector<PxReal> iv(ev.size());
   for (uint32_t i = 0; i < ev.size(); ++i) {
@@ -362,6 +375,8 @@ SArticulation::computeManipulatorInertiaMatrix() {
 }
 
 void SArticulation::prestep() {
+  mLinkPosesValid = false;
+
   auto time = mParentScene->getTimestep();
   EventArticulationStep s;
   s.articulation = this;
@@ -374,6 +389,151 @@ void SArticulation::prestep() {
     s.time = time;
     l->EventEmitter<EventActorStep>::emit(s);
   }
+
+  if (mDriveTrajectory && mDriveTrajectory->isActive()) {
+    std::vector<PxReal> position(dof()), velocity(dof());
+    mDriveTrajectory->advance(time);
+    mDriveTrajectory->evaluate(position.data(), velocity.data());
+    setDriveTarget(position);
+    setDriveVelocityTarget(velocity);
+    if (mDriveTrajectory->isFinished()) {
+      mDriveTrajectory->markCompleted();
+    }
+  }
+
+  bool active = false;
+  if (!mControllers.empty()) {
+    auto qpos = getQpos();
+    auto qvel = getQvel();
+    std::vector<PxReal> qf = mUserQf.empty() ? std::vector<PxReal>(dof(), 0) : mUserQf;
+    for (auto &c : mControllers) {
+      if (c->isEnabled()) {
+        c->compute(qpos, qvel, qf);
+        active = true;
+      }
+    }
+    if (active) {
+      applyQf(qf);
+      mPxArticulation->wakeUp();
+    }
+  }
+  if (!active && mControllerQfApplied) {
+    // the last controller was disabled or removed, restore the user qf
+    applyQf(mUserQf.empty() ? std::vector<PxReal>(dof(), 0) : mUserQf);
+  }
+  mControllerQfApplied = active;
+}
+
+std::shared_ptr<SController>
+SArticulation::addController(std::shared_ptr<SController> controller) {
+  if (controller->getArticulation() != this) {
+    throw std::runtime_error("Failed to add controller: it is created for another articulation");
+  }
+  if (std::find(mControllers.begin(), mControllers.end(), controller) != mControllers.end()) {
+    throw std::runtime_error("Failed to add controller: it is already added");
+  }
+  mControllers.push_back(controller);
+  return controller;
+}
+
+void SArticulation::removeController(SController *controller) {
+  auto it = std::find_if(mControllers.begin(), mControllers.end(),
+                         [=](auto &c) { return c.get() == controller; });
+  if (it != mControllers.end()) {
+    (*it)->mArticulation = nullptr;
+    mControllers.erase(it);
+  }
+}
+
+std::vector<std::shared_ptr<SController>> SArticulation::getControllers() {
+  return mControllers;
+}
+
+void SArticulation::setDriveTrajectory(std::vector<PxReal> const &times,
+                                       std::vector<PxReal> const &positions,
+                                       std::vector<PxReal> const &velocities,
+                                       STrajectory::Interpolation interpolation) {
+  if (!mDriveTrajectory) {
+    mDriveTrajectory = std::make_unique<STrajectory>(dof());
+  }
+  if (!times.empty() && times[0] > 0) {
+    std::vector<PxReal> t = {0};
+    t.insert(t.end(), times.begin(), times.end());
+    auto p = getDriveTarget();
+    p.insert(p.end(), positions.begin(), positions.end());
+    std::vector<PxReal> v;
+    if (!velocities.empty()) {
+      v = getDriveVelocityTarget();
+      v.insert(v.end(), velocities.begin(), velocities.end());
+    }
+    mDriveTrajectory->setWaypoints(t, p, v, interpolation);
+  } else {
+    mDriveTrajectory->setWaypoints(times, positions, velocities, interpolation);
+  }
+}
+
+void SArticulation::appendDriveTrajectory(std::vector<PxReal> const &times,
+                                          std::vector<PxReal> const &positions,
+                                          std::vector<PxReal> const &velocities) {
+  if (!mDriveTrajectory || !mDriveTrajectory->isActive()) {
+    setDriveTrajectory(times, positions, velocities, STrajectory::Interpolation::eCUBIC);
+    return;
+  }
+  mDriveTrajectory->appendWaypoints(times, positions, velocities);
+}
+
+void SArticulation::stopDriveTrajectory() {
+  if (mDriveTrajectory) {
+    mDriveTrajectory->clear();
+  }
+  setDriveVelocityTarget(std::vector<PxReal>(dof(), 0));
+}
+
+void SArticulation::updateLinkPoses() {
+  mPxArticulation->copyInternalStateToCache(*mCache, PxArticulationCache::ePOSITION);
+
+  // position index of each joint in the cache
+  std::vector<uint32_t> qStart(mJoints.size());
+  uint32_t count = 0;
+  for (uint32_t i = 0; i < mJoints.size(); ++i) {
+    qStart[i] = count;
+    count += mJoints[i]->getDof();
+  }
+
+  mLinkPoses.resize(mLinks.size());
+  mLinkPoses[mSortedIndices[0]] = mRootLink->getPxActor()->getGlobalPose();
+  for (uint32_t n = 1; n < mSortedIndices.size(); ++n) {
+    uint32_t idx = mSortedIndices[n];
+    auto &j = mJoints[idx];
+    PxTransform jointPose(PxIdentity);
+    switch (j->getType()) {
+    case PxArticulationJointType::eREVOLUTE:
+      jointPose.q = PxQuat(mCache->jointPosition[mIndexE2I[qStart[idx]]], {1, 0, 0});
+      break;
+    case PxArticulationJointType::ePRISMATIC:
+      jointPose.p = {mCache->jointPosition[mIndexE2I[qStart[idx]]], 0, 0};
+      break;
+    case PxArticulationJointType::eFIX:
+      break;
+    default:
+      throw std::runtime_error("updateLinkPoses: unsupported joint type");
+    }
+    mLinkPoses[idx] = mLinkPoses[j->getParentLink()->getIndex()] * j->getParentPose() *
+                      jointPose * j->getChildPose().getInverse();
+  }
+  mLinkPosesValid = true;
+
+  // the PhysX links are left alone, the next step computes the same poses from qpos
+  for (uint32_t i = 0; i < mLinks.size(); ++i) {
+    mLinks[i]->updateRender(mLinkPoses[i]);
+  }
+}
+
+PxTransform SArticulation::getLinkPose(uint32_t index) const {
+  if (mLinkPosesValid) {
+    return mLinkPoses.at(index);
+  }
+  return mLinks.at(index)->getPxActor()->getGlobalPose();
 }
 
 Eigen::Matrix<PxReal, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
@@ -544,6 +704,8 @@ void SArticulation::unpackData(std::vector<PxReal> const &data) {
   p += 3;
 
   mPxArticulation->applyCache(*mCache, PxArticulationCache::eALL);
+  mUserQf = I2E(std::vector<PxReal>(mCache->jointForce, mCache->jointForce + ndof));
+  mLinkPosesValid = false;
 }
 
 std::vector<PxReal> SArticulation::packDrive() {
@@ -1,5 +1,7 @@
 #pragma once
 #include "sapien_articulation_base.h"
+#include "sapien_controller.h"
+#include "sapien_trajectory.h"
 #include <Eigen/Dense>
 #include <memory>
 
@@ -22,9 +24,21 @@ class SArticulation : public SArticulationDrivable {
   std::vector<std::unique_ptr<SJoint>> mJoints;
   SLink *mRootLink = nullptr;
 
+  std::vector<int> mSortedIndices;
+
+  /* link poses from updateLinkPoses, valid until the next step or state change */
+  std::vector<PxTransform> mLinkPoses;
+  bool mLinkPosesValid{false};
+
   std::vector<uint32_t> mIndexE2I;
   std::vector<uint32_t> mIndexI2E;
 
+  std::vector<std::shared_ptr<SController>> mControllers;
+  /* qf set by the user, controller forces are added on top of it */
+  std::vector<PxReal> mUserQf;
+  bool mControllerQfApplied{false};
+  std::unique_ptr<STrajectory> mDriveTrajectory;
+
   /* Due to the capacity of matrix, cache the permutation matrix in advance */
   Matrix<PxReal, Dynamic, Dynamic, RowMajor> mColumnPermutationI2E;
   Matrix<PxReal, Dynamic, Dynamic, RowMajor> mRowPermutationI2E;
@@ -67,6 +81,13 @@ public:
 
   void prestep() override;
 
+  /* Compute link poses from the root pose and qpos. PhysX 4.1 cannot update the links of a
+   * reduced-coordinate articulation outside of a step, so the poses are kept here and pushed
+   * to the render bodies; SLink::getPose returns them until the next step. */
+  void updateLinkPoses() override;
+  /* pose from updateLinkPoses if it is still valid, otherwise the simulated pose */
+  PxTransform getLinkPose(uint32_t index) const;
+
   SLinkBase *getRootLink() const override;
 
   inline PxArticulationReducedCoordinate *getPxArticulation() { return mPxArticulation; }
@@ -102,6 +123,26 @@ public:
   computeCartesianVelocityDiffIK(const Eigen::Matrix<PxReal, 6, 1> &cartesianVelocity,
                                  uint32_t commandedLinkId,
                                  const std::vector<uint32_t> &activeQIds = {});
+  /* Controllers, executed in prestep; their forces are added to the qf set by setQf */
+  std::shared_ptr<SController> addController(std::shared_ptr<SController> controller);
+  void removeController(SController *controller);
+  std::vector<std::shared_ptr<SController>> getControllers();
+
+  /* Drive trajectory, interpolated into drive position and velocity targets in prestep
+   *
+   * positions and velocities are flattened waypoints in external joint order. Setting a
+   * trajectory preempts the current one; if the first waypoint time is positive, the current
+   * drive target is used as the waypoint at time 0.
+   */
+  void setDriveTrajectory(std::vector<PxReal> const &times, std::vector<PxReal> const &positions,
+                          std::vector<PxReal> const &velocities,
+                          STrajectory::Interpolation interpolation);
+  void appendDriveTrajectory(std::vector<PxReal> const &times,
+                             std::vector<PxReal> const &positions,
+                             std::vector<PxReal> const &velocities);
+  void stopDriveTrajectory();
+  inline STrajectory const *getDriveTrajectory() const { return mDriveTrajectory.get(); }
+
   /* Save and Load */
   std::vector<PxReal> packData();
   void unpackData(std::vector<PxReal> const &data);
@@ -109,6 +150,8 @@ public:
   std::vector<PxReal> packDrive();
   void unpackDrive(std::vector<PxReal> const &data);
 
+  ~SArticulation();
+
 private:
   SArticulation(SScene *scene);
   SArticulation(SArticulation const &other) = delete;
@@ -117,6 +160,9 @@ private:
   std::vector<PxReal> E2I(std::vector<PxReal> ev) const;
   std::vector<PxReal> I2E(std::vector<PxReal> iv) const;
 
+  /* write qf to PhysX without changing the user qf */
+  void applyQf(std::vector<physx::PxReal> const &v);
+
   /* Functions for building permutation matrix for Jacobian calculation */
   static Matrix<PxReal, Dynamic, Dynamic, RowMajor>
   buildColumnPermutation(const std::vector<uint32_t> &indexI2E);
@@ -365,6 +365,11 @@ std::string SArticulationBase::exportTreeURDF(SLinkBase *link, physx::PxTransfor
 
 #ifdef _USE_PINOCCHIO
 std::unique_ptr<PinocchioModel> SArticulationBase::createPinocchioModel() {
+  PxVec3 gravity = getScene()->getPxScene()->getGravity();
+  return PinocchioModel::fromSArticulation(*this, {gravity.x, gravity.y, gravity.z});
+}
+
+std::unique_ptr<PinocchioModel> SArticulationBase::createPinocchioModelFromURDF() {
   PxVec3 gravity = getScene()->getPxScene()->getGravity();
   auto pm = PinocchioModel::fromURDFXML(exportKinematicsChainAsURDF(true),
                                         {gravity.x, gravity.y, gravity.z});
@@ -54,6 +54,11 @@ public:
 
   virtual void prestep() = 0;
 
+  /** compute link poses from the root pose and the current qpos, and write them to the links
+   *  immediately, so they are valid without a simulation step after setQpos
+   */
+  virtual void updateLinkPoses() = 0;
+
   virtual ~SArticulationBase() = default;
 
   std::string exportKinematicsChainAsURDF(bool fixRoot);
@@ -72,6 +77,8 @@ public:
   using SEntity::SEntity;
 #ifdef _USE_PINOCCHIO
   std::unique_ptr<PinocchioModel> createPinocchioModel();
+  /** same model as createPinocchioModel, built by exporting and parsing URDF */
+  std::unique_ptr<PinocchioModel> createPinocchioModelFromURDF();
 #endif
 
 private:
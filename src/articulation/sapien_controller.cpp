@@ -0,0 +1,192 @@
+#include "sapien_controller.h"
+#include "sapien_articulation.h"
+#include "sapien_link.h"
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace sapien {
+
+SController::SController(SArticulation *articulation, uint32_t setpointSize)
+    : mArticulation(articulation), mSetpoint(setpointSize, 0) {}
+
+void SController::setSetpoint(std::vector<PxReal> const &setpoint) {
+  if (setpoint.size() != mSetpoint.size()) {
+    throw std::runtime_error("Setpoint size does not match controller, expected " +
+                             std::to_string(mSetpoint.size()));
+  }
+  std::copy(setpoint.begin(), setpoint.end(), mSetpoint.begin());
+}
+
+void SController::setModelTolerance(PxReal tolerance) {
+  if (tolerance < 0) {
+    throw std::runtime_error("Controller model tolerance must be non-negative");
+  }
+  mModelTolerance = tolerance;
+  mModelQpos.clear();
+}
+
+bool SController::updateModelQpos(std::vector<PxReal> const &qpos) {
+  if (mModelQpos.size() == qpos.size() && mModelTolerance > 0) {
+    bool moved = false;
+    for (uint32_t i = 0; i < qpos.size(); ++i) {
+      moved |= std::abs(qpos[i] - mModelQpos[i]) > mModelTolerance;
+    }
+    if (!moved) {
+      return false;
+    }
+  }
+  mModelQpos = qpos;
+  return true;
+}
+
+/************************************************
+ * Joint PD
+ ***********************************************/
+SJointPDController::SJointPDController(SArticulation *articulation,
+                                       std::vector<PxReal> const &stiffness,
+                                       std::vector<PxReal> const &damping,
+                                       std::vector<PxReal> const &forceLimit,
+                                       bool gravityCompensation)
+    : SController(articulation, articulation->dof() * 2), mStiffness(stiffness),
+      mDamping(damping), mForceLimit(forceLimit), mGravityCompensation(gravityCompensation) {
+  uint32_t dof = articulation->dof();
+  if (mStiffness.size() != dof || mDamping.size() != dof) {
+    throw std::runtime_error("Controller gains do not match DOF of articulation");
+  }
+  if (mForceLimit.empty()) {
+    mForceLimit = std::vector<PxReal>(dof, PX_MAX_F32);
+  } else if (mForceLimit.size() != dof) {
+    throw std::runtime_error("Controller force limits do not match DOF of articulation");
+  }
+  auto qpos = articulation->getQpos();
+  std::copy(qpos.begin(), qpos.end(), mSetpoint.begin());
+}
+
+void SJointPDController::compute(std::vector<PxReal> const &qpos, std::vector<PxReal> const &qvel,
+                                 std::vector<PxReal> &qf) {
+  uint32_t dof = qpos.size();
+  std::vector<PxReal> passive;
+  if (mGravityCompensation) {
+    passive = mArticulation->computePassiveForce(true, false, false);
+  }
+  for (uint32_t i = 0; i < dof; ++i) {
+    PxReal f =
+        mStiffness[i] * (mSetpoint[i] - qpos[i]) + mDamping[i] * (mSetpoint[dof + i] - qvel[i]);
+    f = std::clamp(f, -mForceLimit[i], mForceLimit[i]);
+    qf[i] += mGravityCompensation ? f + passive[i] : f;
+  }
+}
+
+/************************************************
+ * Joint Impedance
+ ***********************************************/
+SJointImpedanceController::SJointImpedanceController(SArticulation *articulation,
+                                                     std::vector<PxReal> const &stiffness,
+                                                     std::vector<PxReal> const &damping)
+    : SController(articulation, articulation->dof() * 3), mStiffness(stiffness),
+      mDamping(damping) {
+  uint32_t dof = articulation->dof();
+  if (mStiffness.size() != dof || mDamping.size() != dof) {
+    throw std::runtime_error("Controller gains do not match DOF of articulation");
+  }
+  auto qpos = articulation->getQpos();
+  std::copy(qpos.begin(), qpos.end(), mSetpoint.begin());
+}
+
+void SJointImpedanceController::compute(std::vector<PxReal> const &qpos,
+                                        std::vector<PxReal> const &qvel,
+                                        std::vector<PxReal> &qf) {
+  uint32_t dof = qpos.size();
+  Eigen::VectorXf acc(dof);
+  for (uint32_t i = 0; i < dof; ++i) {
+    acc[i] = mStiffness[i] * (mSetpoint[i] - qpos[i]) +
+             mDamping[i] * (mSetpoint[dof + i] - qvel[i]) + mSetpoint[2 * dof + i];
+  }
+  if (updateModelQpos(qpos)) {
+    mMassMatrix = mArticulation->computeManipulatorInertiaMatrix();
+  }
+  Eigen::VectorXf f = mMassMatrix * acc;
+  auto passive = mArticulation->computePassiveForce(true, true, false);
+  for (uint32_t i = 0; i < dof; ++i) {
+    qf[i] += f[i] + passive[i];
+  }
+}
+
+/************************************************
+ * Operational Space
+ ***********************************************/
+SOperationalSpaceController::SOperationalSpaceController(SArticulation *articulation,
+                                                         uint32_t linkIndex,
+                                                         PxReal positionStiffness,
+                                                         PxReal positionDamping,
+                                                         PxReal rotationStiffness,
+                                                         PxReal rotationDamping)
+    : SController(articulation, 13), mLinkIndex(linkIndex), mPositionStiffness(positionStiffness),
+      mPositionDamping(positionDamping), mRotationStiffness(rotationStiffness),
+      mRotationDamping(rotationDamping) {
+  auto links = articulation->getSLinks();
+  if (linkIndex >= links.size() || links[linkIndex] == articulation->getRootLink()) {
+    throw std::runtime_error("Invalid link index for operational space controller");
+  }
+  auto pose = links[linkIndex]->getPose();
+  mSetpoint[0] = pose.p.x;
+  mSetpoint[1] = pose.p.y;
+  mSetpoint[2] = pose.p.z;
+  mSetpoint[3] = pose.q.w;
+  mSetpoint[4] = pose.q.x;
+  mSetpoint[5] = pose.q.y;
+  mSetpoint[6] = pose.q.z;
+}
+
+void SOperationalSpaceController::compute(std::vector<PxReal> const &qpos,
+                                          std::vector<PxReal> const &qvel,
+                                          std::vector<PxReal> &qf) {
+  uint32_t dof = qpos.size();
+  auto link = mArticulation->getSLinks()[mLinkIndex];
+
+  if (updateModelQpos(qpos)) {
+    // Jacobian rows skip the root link, 3 linear rows followed by 3 angular rows
+    uint32_t rootIndex = mArticulation->getRootLink()->getIndex();
+    uint32_t row = (mLinkIndex < rootIndex ? mLinkIndex : mLinkIndex - 1) * 6;
+    mJacobian = mArticulation->computeWorldCartesianJacobianMatrix().block(row, 0, 6, dof);
+    Eigen::MatrixXf M = mArticulation->computeManipulatorInertiaMatrix();
+    Eigen::Matrix<float, 6, 6> lambdaInv = mJacobian * M.ldlt().solve(mJacobian.transpose());
+    mLambda = lambdaInv.completeOrthogonalDecomposition().pseudoInverse();
+  }
+
+  PxTransform pose = link->getPose();
+  PxVec3 targetP(mSetpoint[0], mSetpoint[1], mSetpoint[2]);
+  PxQuat targetQ(mSetpoint[4], mSetpoint[5], mSetpoint[6], mSetpoint[3]);
+  targetQ.normalize();
+
+  PxVec3 posErr = targetP - pose.p;
+  PxQuat dq = targetQ * pose.q.getConjugate();
+  if (dq.w < 0) {
+    dq = -dq;
+  }
+  PxReal angle;
+  PxVec3 axis;
+  dq.toRadiansAndUnitAxis(angle, axis);
+  PxVec3 rotErr = axis * angle;
+
+  PxVec3 linVelErr = PxVec3(mSetpoint[7], mSetpoint[8], mSetpoint[9]) -
+                     link->getPxActor()->getLinearVelocity();
+  PxVec3 angVelErr = PxVec3(mSetpoint[10], mSetpoint[11], mSetpoint[12]) -
+                     link->getPxActor()->getAngularVelocity();
+
+  Eigen::Matrix<float, 6, 1> acc;
+  for (int i = 0; i < 3; ++i) {
+    acc[i] = mPositionStiffness * posErr[i] + mPositionDamping * linVelErr[i];
+    acc[3 + i] = mRotationStiffness * rotErr[i] + mRotationDamping * angVelErr[i];
+  }
+
+  Eigen::VectorXf f = mJacobian.transpose() * (mLambda * acc);
+  auto passive = mArticulation->computePassiveForce(true, true, false);
+  for (uint32_t i = 0; i < dof; ++i) {
+    qf[i] += f[i] + passive[i];
+  }
+}
+
+} // namespace sapien
@@ -0,0 +1,133 @@
+#pragma once
+#include <Eigen/Dense>
+#include <PxPhysicsAPI.h>
+#include <vector>
+
+namespace sapien {
+using namespace physx;
+
+class SArticulation;
+
+/** Controller computing joint forces of an articulation inside SScene::step
+ *
+ *  Controllers are shared between the articulation and their users and run in the articulation
+ *  prestep, so they run at simulation rate. The setpoint is a buffer owned by the controller and
+ *  read every step; it can be written in place (e.g. through a numpy view in Python) without a
+ *  call per substep. A controller removed from its articulation, or outliving it, is detached
+ *  and getArticulation returns nullptr.
+ */
+class SController {
+  friend class SArticulation;
+
+protected:
+  SArticulation *mArticulation;
+  std::vector<PxReal> mSetpoint;
+  bool mEnabled{true};
+
+  /* qpos at which the cached model (mass matrix, Jacobian) was computed */
+  std::vector<PxReal> mModelQpos;
+  PxReal mModelTolerance{0};
+
+  /* true if any joint moved more than the model tolerance since the last call returning true */
+  bool updateModelQpos(std::vector<PxReal> const &qpos);
+
+public:
+  SController(SArticulation *articulation, uint32_t setpointSize);
+  SController(SController const &) = delete;
+  SController &operator=(SController const &) = delete;
+  virtual ~SController() = default;
+
+  inline SArticulation *getArticulation() const { return mArticulation; }
+
+  inline std::vector<PxReal> &getSetpoint() { return mSetpoint; }
+  void setSetpoint(std::vector<PxReal> const &setpoint);
+
+  inline bool isEnabled() const { return mEnabled; }
+  inline void setEnabled(bool enabled) { mEnabled = enabled; }
+
+  /** joint distance after which a controller recomputes the mass matrix and Jacobian
+   *
+   *  The default 0 recomputes them every step. A positive tolerance reuses a model computed up
+   *  to that far from the current qpos. Passive forces are always computed every step.
+   */
+  inline PxReal getModelTolerance() const { return mModelTolerance; }
+  void setModelTolerance(PxReal tolerance);
+
+  /** accumulate joint forces of this controller into qf
+   *
+   *  qpos, qvel and qf are in the external joint order of the articulation
+   */
+  virtual void compute(std::vector<PxReal> const &qpos, std::vector<PxReal> const &qvel,
+                       std::vector<PxReal> &qf) = 0;
+};
+
+/** Joint space PD controller
+ *
+ *  qf = stiffness * (qpos* - qpos) + damping * (qvel* - qvel) [+ passive force]
+ *  setpoint: [qpos* (dof), qvel* (dof)]
+ */
+class SJointPDController : public SController {
+  std::vector<PxReal> mStiffness;
+  std::vector<PxReal> mDamping;
+  std::vector<PxReal> mForceLimit;
+  bool mGravityCompensation;
+
+public:
+  SJointPDController(SArticulation *articulation, std::vector<PxReal> const &stiffness,
+                     std::vector<PxReal> const &damping,
+                     std::vector<PxReal> const &forceLimit = {},
+                     bool gravityCompensation = true);
+
+  void compute(std::vector<PxReal> const &qpos, std::vector<PxReal> const &qvel,
+               std::vector<PxReal> &qf) override;
+};
+
+/** Joint space impedance (computed torque) controller
+ *
+ *  qf = M(qpos) (stiffness * (qpos* - qpos) + damping * (qvel* - qvel) + qacc*) + passive force
+ *  setpoint: [qpos* (dof), qvel* (dof), qacc* (dof)]
+ */
+class SJointImpedanceController : public SController {
+  std::vector<PxReal> mStiffness;
+  std::vector<PxReal> mDamping;
+
+  Eigen::MatrixXf mMassMatrix;
+
+public:
+  SJointImpedanceController(SArticulation *articulation, std::vector<PxReal> const &stiffness,
+                            std::vector<PxReal> const &damping);
+
+  void compute(std::vector<PxReal> const &qpos, std::vector<PxReal> const &qvel,
+               std::vector<PxReal> &qf) override;
+};
+
+/** Operational space controller for a single link
+ *
+ *  F = Lambda (K e + D (v* - v)), qf = J^T F + passive force
+ *  where J is the world frame Jacobian of the link and Lambda = (J M^-1 J^T)^-1
+ *  setpoint: [position (3), quaternion wxyz (4), linear velocity (3), angular velocity (3)],
+ *  all in world frame
+ */
+class SOperationalSpaceController : public SController {
+  uint32_t mLinkIndex;
+  PxReal mPositionStiffness;
+  PxReal mPositionDamping;
+  PxReal mRotationStiffness;
+  PxReal mRotationDamping;
+
+  /* Jacobian of the link and task space inertia Lambda at mModelQpos */
+  Eigen::Matrix<float, 6, Eigen::Dynamic> mJacobian;
+  Eigen::Matrix<float, 6, 6> mLambda;
+
+public:
+  SOperationalSpaceController(SArticulation *articulation, uint32_t linkIndex,
+                              PxReal positionStiffness, PxReal positionDamping,
+                              PxReal rotationStiffness, PxReal rotationDamping);
+
+  inline uint32_t getLinkIndex() const { return mLinkIndex; }
+
+  void compute(std::vector<PxReal> const &qpos, std::vector<PxReal> const &qvel,
+               std::vector<PxReal> &qf) override;
+};
+
+} // namespace sapien
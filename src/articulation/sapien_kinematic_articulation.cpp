@@ -3,6 +3,8 @@
 #include "sapien_kinematic_joint.h"
 #include "sapien_link.h"
 #include "sapien_scene.h"
+#include <Eigen/Dense>
+#include <algorithm>
 #include <spdlog/spdlog.h>
 
 #define CHECK_SIZE(v)                                                                             \
@@ -40,39 +42,32 @@ EArticulationType SKArticulation::getType() const { return EArticulationType::KI
 uint32_t SKArticulation::dof() const { return mDof; }
 
 std::vector<physx::PxReal> SKArticulation::getQpos() const {
-  std::vector<physx::PxReal> result;
-  for (auto &j : mJoints) {
-    auto p = j->getPos();
-    result.insert(result.end(), p.begin(), p.end());
+  std::vector<physx::PxReal> result(mDof);
+  for (uint32_t i = 0; i < mDof; ++i) {
+    result[i] = mJointState.pos[mIndexE2S[i]];
   }
   return result;
 }
 
 void SKArticulation::setQpos(const std::vector<physx::PxReal> &v) {
   CHECK_SIZE(v);
-  auto it = v.begin();
-  for (auto &j : mJoints) {
-    uint32_t dof = j->getDof();
-    j->setPos({it, it + dof});
-    it += dof;
+  for (uint32_t i = 0; i < mDof; ++i) {
+    uint32_t s = mIndexE2S[i];
+    mJointState.pos[s] = std::clamp(v[i], mJointState.lower[s], mJointState.upper[s]);
   }
 }
 
 std::vector<physx::PxReal> SKArticulation::getQvel() const {
-  std::vector<physx::PxReal> result;
-  for (auto &j : mJoints) {
-    auto v = j->getVel();
-    result.insert(result.end(), v.begin(), v.end());
+  std::vector<physx::PxReal> result(mDof);
+  for (uint32_t i = 0; i < mDof; ++i) {
+    result[i] = mJointState.vel[mIndexE2S[i]];
   }
   return result;
 }
 void SKArticulation::setQvel(const std::vector<physx::PxReal> &v) {
   CHECK_SIZE(v);
-  auto it = v.begin();
-  for (auto &j : mJoints) {
-    uint32_t dof = j->getDof();
-    j->setVel({it, it + dof});
-    it += dof;
+  for (uint32_t i = 0; i < mDof; ++i) {
+    mJointState.vel[mIndexE2S[i]] = v[i];
   }
 }
 
@@ -92,10 +87,10 @@ void SKArticulation::setRootPose(const physx::PxTransform &T) {
 }
 
 std::vector<std::array<physx::PxReal, 2>> SKArticulation::getQlimits() const {
-  std::vector<std::array<physx::PxReal, 2>> result;
-  for (auto &j : mJoints) {
-    auto l = j->getLimits();
-    result.insert(result.end(), l.begin(), l.end());
+  std::vector<std::array<physx::PxReal, 2>> result(mDof);
+  for (uint32_t i = 0; i < mDof; ++i) {
+    uint32_t s = mIndexE2S[i];
+    result[i] = {mJointState.lower[s], mJointState.upper[s]};
   }
   return result;
 }
@@ -112,16 +107,17 @@ void SKArticulation::setQlimits(std::vector<std::array<physx::PxReal, 2>> const
 
 void SKArticulation::setDriveTarget(std::vector<physx::PxReal> const &v) {
   CHECK_SIZE(v);
-  auto it = v.begin();
-  for (auto &j : mJoints) {
-    uint32_t dof = j->getDof();
-    j->setDriveTarget({it, it + dof});
-    it += dof;
+  for (uint32_t i = 0; i < mDof; ++i) {
+    mJointState.targetPos[mIndexE2S[i]] = v[i];
   }
 }
 
 std::vector<physx::PxReal> SKArticulation::getDriveTarget() const {
-  return std::vector<PxReal>(0, dof());
+  std::vector<physx::PxReal> result(mDof);
+  for (uint32_t i = 0; i < mDof; ++i) {
+    result[i] = mJointState.targetPos[mIndexE2S[i]];
+  }
+  return result;
 }
 
 void SKArticulation::prestep() {
@@ -138,15 +134,135 @@ void SKArticulation::prestep() {
     l->EventEmitter<EventActorStep>::emit(s);
   }
 
-  std::vector<PxTransform> poses(mJoints.size());
-  poses[mSortedIndices[0]] = mJoints[mSortedIndices[0]]->getChildLink()->getPose();
+  integrateJointState(mParentScene->getTimestep());
+  computeLinkPoses();
+  for (uint32_t n = 1; n < mSortedPxLinks.size(); ++n) {
+    mSortedPxLinks[n]->setKinematicTarget(mSortedPoses[n]);
+  }
+}
+
+void SKArticulation::integrateJointState(PxReal dt) {
+  if (mDof == 0) {
+    return;
+  }
+  using Array = Eigen::Map<Eigen::ArrayXf>;
+  Array pos(mJointState.pos.data(), mDof);
+  Array vel(mJointState.vel.data(), mDof);
+  Array lower(mJointState.lower.data(), mDof);
+  Array upper(mJointState.upper.data(), mDof);
+  Array targetPos(mJointState.targetPos.data(), mDof);
+  Array targetVel(mJointState.targetVel.data(), mDof);
+  Array stiffness(mJointState.stiffness.data(), mDof);
+  Array damping(mJointState.damping.data(), mDof);
+  Array maxVel(mJointState.maxVel.data(), mDof);
+
+  vel = (vel + (stiffness * (targetPos - pos) + damping * (targetVel - vel)) * dt)
+            .min(maxVel)
+            .max(-maxVel);
+  pos = (pos + vel * dt).min(upper).max(lower);
+}
+
+void SKArticulation::computeLinkPoses() {
+  mSortedPoses[0] = mRootLink->getPose();
+  for (uint32_t n = 1; n < mSortedPoses.size(); ++n) {
+    PxTransform const &parent = mSortedPoses[mSortedParents[n]];
+    switch (mSortedJointTypes[n]) {
+    case PxArticulationJointType::eREVOLUTE: {
+      PxQuat q(mJointState.pos[mSortedSlots[n]], {1, 0, 0});
+      mSortedPoses[n] = parent * mSortedJoint2Parent[n] * PxTransform(q) * mSortedChild2Joint[n];
+      break;
+    }
+    case PxArticulationJointType::ePRISMATIC: {
+      PxVec3 p(mJointState.pos[mSortedSlots[n]], 0, 0);
+      mSortedPoses[n] = parent * mSortedJoint2Parent[n] * PxTransform(p) * mSortedChild2Joint[n];
+      break;
+    }
+    default:
+      mSortedPoses[n] = parent * mSortedJoint2Parent[n];
+      break;
+    }
+  }
+}
+
+void SKArticulation::updateLinkPoses() {
+  computeLinkPoses();
+  for (uint32_t n = 1; n < mSortedPxLinks.size(); ++n) {
+    mSortedPxLinks[n]->setGlobalPose(mSortedPoses[n]);
+  }
+}
+
+std::vector<PxReal> SKArticulation::packData() {
+  std::vector<PxReal> data = getQpos();
+  auto qvel = getQvel();
+  data.insert(data.end(), qvel.begin(), qvel.end());
+  auto pose = getRootPose();
+  data.insert(data.end(), {pose.p.x, pose.p.y, pose.p.z, pose.q.x, pose.q.y, pose.q.z, pose.q.w});
+  return data;
+}
+
+void SKArticulation::unpackData(std::vector<PxReal> const &data) {
+  if (data.size() != 2 * mDof + 7) {
+    throw std::runtime_error("Failed to unpack kinematic articulation: data size mismatch");
+  }
+  setQpos({data.begin(), data.begin() + mDof});
+  setQvel({data.begin() + mDof, data.begin() + 2 * mDof});
+  auto p = data.data() + 2 * mDof;
+  setRootPose({{p[0], p[1], p[2]}, {p[3], p[4], p[5], p[6]}});
+  updateLinkPoses();
+}
+
+uint32_t SKArticulation::allocateJointSlot() {
+  mJointState.pos.push_back(0);
+  mJointState.vel.push_back(0);
+  mJointState.lower.push_back(-PX_MAX_F32);
+  mJointState.upper.push_back(PX_MAX_F32);
+  mJointState.targetPos.push_back(0);
+  mJointState.targetVel.push_back(0);
+  mJointState.stiffness.push_back(0);
+  mJointState.damping.push_back(0);
+  mJointState.maxVel.push_back(PX_MAX_F32);
+  return mJointState.pos.size() - 1;
+}
+
+void SKArticulation::initSortedLinks(std::vector<int> const &sorted) {
+  mSortedIndices = sorted;
 
-  for (uint32_t n = 1; n < mSortedIndices.size(); ++n) {
-    uint32_t idx = mSortedIndices[n];
-    mJoints[idx]->updatePos(mParentScene->getTimestep());
-    poses[idx] = poses[mJoints[idx]->getParentLink()->getIndex()] *
-                 mJoints[idx]->getChild2ParentTransform();
-    mLinks[idx]->getPxActor()->setKinematicTarget(poses[idx]);
+  std::vector<int> link2sorted(mLinks.size());
+  for (uint32_t n = 0; n < sorted.size(); ++n) {
+    link2sorted[sorted[n]] = n;
+  }
+
+  uint32_t n = sorted.size();
+  mSortedPxLinks.resize(n);
+  mSortedParents.assign(n, -1);
+  mSortedSlots.assign(n, -1);
+  mSortedJointTypes.resize(n);
+  mSortedJoint2Parent.resize(n);
+  mSortedChild2Joint.resize(n);
+  mSortedPoses.resize(n);
+
+  for (uint32_t k = 0; k < n; ++k) {
+    auto &joint = mJoints[sorted[k]];
+    mSortedPxLinks[k] = mLinks[sorted[k]]->getPxActor();
+    mSortedJointTypes[k] = joint->getType();
+    if (joint->getParentLink()) {
+      mSortedParents[k] = link2sorted[joint->getParentLink()->getIndex()];
+    }
+    if (joint->getDof() == 1) {
+      mSortedSlots[k] = static_cast<SKJointSingleDof *>(joint.get())->getSlot();
+      mSortedJoint2Parent[k] = joint->getParentPose();
+      mSortedChild2Joint[k] = joint->getChildPose().getInverse();
+    } else {
+      mSortedJoint2Parent[k] = joint->getParentPose() * joint->getChildPose().getInverse();
+      mSortedChild2Joint[k] = PxTransform(PxIdentity);
+    }
+  }
+
+  mIndexE2S.clear();
+  for (auto &j : mJoints) {
+    if (j->getDof() == 1) {
+      mIndexE2S.push_back(static_cast<SKJointSingleDof *>(j.get())->getSlot());
+    }
   }
 }
 
@@ -11,6 +11,9 @@ class SKJoint;
 class SKArticulation : public SArticulationDrivable {
   friend class ArticulationBuilder;
   friend class LinkBuilder;
+  friend class SKJointSingleDof;
+  friend class SKJointRevolute;
+  friend class SKJointPrismatic;
 
   std::vector<std::unique_ptr<SKLink>> mLinks;
   std::vector<std::unique_ptr<SKJoint>> mJoints;
@@ -20,6 +23,33 @@ class SKArticulation : public SArticulationDrivable {
 
   std::vector<int> mSortedIndices;
 
+  /* State of single-dof joints as structure of arrays, indexed by joint slot. Slots are
+   * assigned in topological order when links are built. */
+  struct JointState {
+    std::vector<PxReal> pos;
+    std::vector<PxReal> vel;
+    std::vector<PxReal> lower;
+    std::vector<PxReal> upper;
+    std::vector<PxReal> targetPos;
+    std::vector<PxReal> targetVel;
+    std::vector<PxReal> stiffness;
+    std::vector<PxReal> damping;
+    std::vector<PxReal> maxVel;
+  } mJointState;
+
+  /* external qpos index to joint slot */
+  std::vector<uint32_t> mIndexE2S;
+
+  /* Per-link data in topological order, precomputed at build time. For fixed joints the
+   * joint2parent transform already includes child2joint. */
+  std::vector<PxRigidDynamic *> mSortedPxLinks;
+  std::vector<int> mSortedParents; // topological position of the parent link
+  std::vector<int> mSortedSlots;   // joint slot, -1 for fixed joints
+  std::vector<PxArticulationJointType::Enum> mSortedJointTypes;
+  std::vector<PxTransform> mSortedJoint2Parent;
+  std::vector<PxTransform> mSortedChild2Joint;
+  std::vector<PxTransform> mSortedPoses; // scratch buffer for computed link poses
+
 public:
   virtual std::vector<SLinkBase *> getBaseLinks() override;
   virtual std::vector<SJointBase *> getBaseJoints() override;
@@ -48,6 +78,11 @@ public:
   virtual std::vector<physx::PxReal> getDriveTarget() const override;
 
   void prestep() override;
+  void updateLinkPoses() override;
+
+  /* qpos, qvel, then the root pose as position and quaternion (x, y, z, w) */
+  std::vector<physx::PxReal> packData();
+  void unpackData(std::vector<physx::PxReal> const &data);
 
   SKArticulation(SKArticulation const &) = delete;
   SKArticulation &operator=(SKArticulation const &) = delete;
@@ -55,6 +90,18 @@ public:
 
 private:
   SKArticulation(SScene *scene);
+
+  /** add a single-dof joint to the joint state and return its slot */
+  uint32_t allocateJointSlot();
+
+  /** fill the topologically sorted link data, called after all links are built */
+  void initSortedLinks(std::vector<int> const &sorted);
+
+  /** integrate drives of all joints in one pass over the joint state */
+  void integrateJointState(PxReal dt);
+
+  /** compute link poses into mSortedPoses from the root pose and current joint positions */
+  void computeLinkPoses();
 };
 
 } // namespace sapien
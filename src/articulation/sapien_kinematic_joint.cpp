@@ -1,5 +1,7 @@
 #include "sapien_kinematic_joint.h"
+#include "sapien_kinematic_articulation.h"
 #include "sapien_link.h"
+#include <algorithm>
 #include <spdlog/spdlog.h>
 
 namespace sapien {
@@ -8,64 +10,66 @@ SKJoint::SKJoint(SKArticulation *articulation, SKLink *parent, SKLink *child)
 
 SArticulationBase *SKJoint::getArticulation() const { return mArticulatoin; }
 
+SKJointSingleDof::SKJointSingleDof(SKArticulation *articulation, SKLink *parent, SKLink *child,
+                                   uint32_t slot)
+    : SKJoint(articulation, parent, child), mSlot(slot) {}
+
+std::vector<PxReal> SKJointSingleDof::getPos() const {
+  return {mArticulatoin->mJointState.pos[mSlot]};
+}
+
+std::vector<PxReal> SKJointSingleDof::getVel() const {
+  return {mArticulatoin->mJointState.vel[mSlot]};
+}
+
+std::vector<std::array<PxReal, 2>> SKJointSingleDof::getLimits() {
+  auto &state = mArticulatoin->mJointState;
+  return {{state.lower[mSlot], state.upper[mSlot]}};
+}
+
 void SKJointSingleDof::setLimits(const std::vector<std::array<PxReal, 2>> &limits) {
   if (limits.size() != 1) {
     spdlog::get("SAPIEN")->error("setLimits failed: argument does not match joint DOF");
   }
-  lowerLimit = limits[0][0];
-  upperLimit = limits[0][1];
+  auto &state = mArticulatoin->mJointState;
+  state.lower[mSlot] = limits[0][0];
+  state.upper[mSlot] = limits[0][1];
 }
 
 void SKJointSingleDof::setPos(const std::vector<PxReal> &v) {
   if (v.size() != 1) {
     spdlog::get("SAPIEN")->error("setPos failed: argument does not match joint DOF");
   }
-  pos = v[0];
-  if (pos < lowerLimit) {
-    pos = lowerLimit;
-  } else if (pos > upperLimit) {
-    pos = upperLimit;
-  }
+  auto &state = mArticulatoin->mJointState;
+  state.pos[mSlot] = std::clamp(v[0], state.lower[mSlot], state.upper[mSlot]);
 }
 
 void SKJointSingleDof::setVel(const std::vector<PxReal> &v) {
   if (v.size() != 1) {
     spdlog::get("SAPIEN")->error("setPos failed: argument does not match joint DOF");
   }
-  vel = v[0];
+  mArticulatoin->mJointState.vel[mSlot] = v[0];
 }
 
 void SKJointSingleDof::setDriveProperties(PxReal accStiffness, PxReal accDamping, PxReal vmax) {
-  stiffness = accStiffness;
-  damping = accDamping;
-  maxVel = vmax;
+  auto &state = mArticulatoin->mJointState;
+  state.stiffness[mSlot] = accStiffness;
+  state.damping[mSlot] = accDamping;
+  state.maxVel[mSlot] = vmax;
 }
 
 void SKJointSingleDof::setDriveTarget(std::vector<PxReal> const &p) {
   if (p.size() != 1) {
     spdlog::get("SAPIEN")->error("setDriveTarget failed: argument does not match joint DOF");
   }
-  targetPos = p[0];
+  mArticulatoin->mJointState.targetPos[mSlot] = p[0];
 }
 void SKJointSingleDof::setDriveVelocityTarget(std::vector<PxReal> const &v) {
   if (v.size() != 1) {
     spdlog::get("SAPIEN")->error(
         "setDriveVelocityTarget failed: argument does not match joint DOF");
   }
-  targetVel = v[0];
-}
-
-void SKJointSingleDof::updatePos(PxReal dt) {
-  acc = stiffness * (targetPos - pos) + damping * (targetVel - vel);
-  vel += acc * dt;
-  if (vel > maxVel) {
-    vel = maxVel;
-  } else if (vel < -maxVel) {
-    vel = -maxVel;
-  }
-
-  pos += vel * dt;
-  pos = std::clamp(pos, lowerLimit, upperLimit);
+  mArticulatoin->mJointState.targetVel[mSlot] = v[0];
 }
 
 void SKJointFixed::setLimits(const std::vector<std::array<physx::PxReal, 2>> &limits) {
@@ -87,11 +91,11 @@ void SKJointFixed::setVel(const std::vector<PxReal> &v) {
 }
 
 PxTransform SKJointRevolute::getJointPose() const {
-  return PxTransform({{0, 0, 0}, PxQuat(pos, {1, 0, 0})});
+  return PxTransform({{0, 0, 0}, PxQuat(mArticulatoin->mJointState.pos[mSlot], {1, 0, 0})});
 }
 
 PxTransform SKJointPrismatic::getJointPose() const {
-  return PxTransform({{pos, 0, 0}, PxIdentity});
+  return PxTransform({{mArticulatoin->mJointState.pos[mSlot], 0, 0}, PxIdentity});
 }
 
 } // namespace sapien
@@ -8,6 +8,7 @@ class SKArticulation;
 class SKJoint : public SJointBase {
   friend class LinkBuilder;
 
+protected:
   SKArticulation *mArticulatoin;
 
   PxTransform joint2parent;
@@ -34,9 +35,6 @@ public:
   inline PxTransform getChild2ParentTransform() const {
     return joint2parent * getJointPose() * child2joint;
   }
-
-  // update pos by vel
-  virtual void updatePos(PxReal dt) = 0;
   SArticulationBase *getArticulation() const override;
 
 public:
@@ -46,45 +44,35 @@ public:
   ~SKJoint() = default;
 };
 
+/** Single-dof kinematic joint
+ *
+ *  The joint state lives in the structure-of-arrays buffers of its articulation, this class
+ *  only holds the slot into those arrays.
+ */
 class SKJointSingleDof : public SKJoint {
 protected:
-  PxReal vel = 0;
-  PxReal pos = 0;
-  PxReal lowerLimit;
-  PxReal upperLimit;
-
-  PxReal targetPos = 0;
-  PxReal targetVel = 0;
-
-  PxReal stiffness = 0;
-  PxReal damping = 0;
-  PxReal maxVel = PX_MAX_F32;
-
-  PxReal acc = 0;
+  uint32_t mSlot;
 
 public:
-  SKJointSingleDof();
+  SKJointSingleDof(SKArticulation *articulation, SKLink *parent, SKLink *child, uint32_t slot);
+
+  inline uint32_t getSlot() const { return mSlot; }
 
   inline uint32_t getDof() const override { return 1; }
-  inline std::vector<PxReal> getPos() const override { return {pos}; }
-  inline std::vector<PxReal> getVel() const override { return {vel}; }
+  std::vector<PxReal> getPos() const override;
+  std::vector<PxReal> getVel() const override;
   void setPos(std::vector<PxReal> const &v) override;
   void setVel(std::vector<PxReal> const &v) override;
-  inline std::vector<std::array<PxReal, 2>> getLimits() override {
-    return {{lowerLimit, upperLimit}};
-  };
+  std::vector<std::array<PxReal, 2>> getLimits() override;
   void setLimits(std::vector<std::array<PxReal, 2>> const &limits) override;
 
   void setDriveProperties(PxReal accStiffness, PxReal accDamping, PxReal maxVel) override;
   void setDriveTarget(std::vector<PxReal> const &p) override;
   void setDriveVelocityTarget(std::vector<PxReal> const &v) override;
-  virtual void updatePos(PxReal dt) override;
 
   virtual inline PxArticulationJointType::Enum getType() const override {
     return PxArticulationJointType::eUNDEFINED;
   };
-
-  using SKJoint::SKJoint;
 };
 
 class SKJointRevolute : public SKJointSingleDof {
@@ -101,7 +89,7 @@ public:
 class SKJointPrismatic : public SKJointSingleDof {
 public:
   using SKJointSingleDof::SKJointSingleDof;
-  
+
   virtual inline PxArticulationJointType::Enum getType() const override {
     return PxArticulationJointType::ePRISMATIC;
   };
@@ -122,7 +110,6 @@ public:
   inline void setDriveProperties(PxReal accStiffness, PxReal accDamping, PxReal maxVel) override {}
   inline void setDriveTarget(std::vector<PxReal> const &p) override {}
   inline void setDriveVelocityTarget(std::vector<PxReal> const &v) override {}
-  inline void updatePos(PxReal dt) override{};
 
   inline PxTransform getJointPose() const override { return {{0, 0, 0}, PxIdentity}; }
 
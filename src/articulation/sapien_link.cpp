@@ -5,6 +5,7 @@ namespace sapien {
 
 PxArticulationLink *SLink::getPxActor() const { return mActor; }
 SArticulation *SLink::getArticulation() { return mArticulation; }
+PxTransform SLink::getPose() const { return mArticulation->getLinkPose(mIndex); }
 
 SLink::SLink(PxArticulationLink *actor, SArticulation *articulation, physx_id_t id, SScene *scene,
              std::vector<Renderer::IPxrRigidbody *> renderBodies,
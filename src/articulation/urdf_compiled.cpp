@@ -0,0 +1,246 @@
+#include "urdf_loader.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace sapien {
+namespace URDF {
+using namespace physx;
+
+static constexpr char kMagic[8] = {'S', 'A', 'P', 'I', 'E', 'N', 'U', 'D'};
+static constexpr uint32_t kVersion = 1;
+
+namespace {
+
+class Writer {
+  std::ostream &mOut;
+
+public:
+  explicit Writer(std::ostream &out) : mOut(out) {}
+
+  template <typename T> void pod(T const &value) {
+    mOut.write(reinterpret_cast<char const *>(&value), sizeof(T));
+  }
+
+  void string(std::string const &value) {
+    pod<uint32_t>(value.size());
+    mOut.write(value.data(), value.size());
+  }
+
+  template <typename T, typename F> void array(std::vector<T> const &values, F f) {
+    pod<uint32_t>(values.size());
+    for (auto &v : values) {
+      f(v);
+    }
+  }
+};
+
+class Reader {
+  // strings and arrays longer than this are treated as corruption when the stream size is unknown
+  static constexpr uint64_t kMaxLength = 1 << 24;
+
+  std::istream &mIn;
+  uint64_t mRemaining;
+
+  static uint64_t remainingSize(std::istream &in) {
+    auto start = in.tellg();
+    if (start != std::streampos(-1) && in.seekg(0, std::ios::end)) {
+      auto end = in.tellg();
+      in.seekg(start);
+      return static_cast<uint64_t>(end - start);
+    }
+    in.clear();
+    // memory buffers cannot seek but know what they hold
+    auto available = in.rdbuf()->in_avail();
+    return available > 0 ? static_cast<uint64_t>(available) : UINT64_MAX;
+  }
+
+  void consumed() { mRemaining -= std::min<uint64_t>(mIn.gcount(), mRemaining); }
+
+  /** fail the stream for lengths the remaining data cannot hold */
+  bool fits(uint64_t size) {
+    if (size > mRemaining || (mRemaining == UINT64_MAX && size > kMaxLength)) {
+      mIn.setstate(std::ios::failbit);
+    }
+    return good();
+  }
+
+public:
+  explicit Reader(std::istream &in) : mIn(in), mRemaining(remainingSize(in)) {}
+
+  inline bool good() const { return mIn.good(); }
+
+  template <typename T> T pod() {
+    T value{};
+    mIn.read(reinterpret_cast<char *>(&value), sizeof(T));
+    consumed();
+    return value;
+  }
+
+  std::string string() {
+    uint32_t size = pod<uint32_t>();
+    if (!fits(size)) {
+      return "";
+    }
+    std::string value(size, '\0');
+    mIn.read(value.data(), size);
+    consumed();
+    return value;
+  }
+
+  // every element takes at least one byte
+  template <typename T, typename F> void array(std::vector<T> &values, F f) {
+    uint32_t size = pod<uint32_t>();
+    if (!fits(size)) {
+      return;
+    }
+    for (uint32_t i = 0; i < size && good(); ++i) {
+      values.push_back(f());
+    }
+  }
+};
+
+} // namespace
+
+void CompiledRobot::serialize(std::ostream &out) const {
+  Writer w(out);
+  out.write(kMagic, sizeof(kMagic));
+  w.pod(kVersion);
+
+  w.array(links, [&](Link const &link) {
+    w.string(link.name);
+    w.string(link.jointName);
+    w.pod(link.parent);
+
+    w.pod(link.hasInertial);
+    w.pod(link.mass);
+    w.pod(link.inertialPose);
+    w.pod(link.inertia);
+
+    w.array(link.visuals, [&](Visual const &v) {
+      w.pod(v.type);
+      w.pod(v.pose);
+      w.pod(v.size);
+      w.pod(v.radius);
+      w.pod(v.halfLength);
+      w.pod(v.color);
+      w.string(v.filename);
+      w.string(v.name);
+    });
+    w.array(link.collisions, [&](Collision const &c) {
+      w.pod(c.type);
+      w.pod(c.index);
+      w.pod(c.pose);
+      w.pod(c.size);
+      w.pod(c.radius);
+      w.pod(c.halfLength);
+      w.string(c.filename);
+    });
+
+    w.pod(link.hasJoint);
+    w.pod(link.jointType);
+    w.array(link.limits, [&](std::array<PxReal, 2> const &l) { w.pod(l); });
+    w.pod(link.jointPoseInParent);
+    w.pod(link.jointPoseInChild);
+    w.pod(link.friction);
+    w.pod(link.damping);
+
+    w.array(link.collisionGroups, [&](uint32_t g) { w.pod(g); });
+  });
+
+  w.array(sensors, [&](SensorRecord const &s) {
+    w.string(s.type);
+    w.string(s.name);
+    w.string(s.linkName);
+    w.pod(s.localPose);
+    w.pod(s.width);
+    w.pod(s.height);
+    w.pod(s.fovx);
+    w.pod(s.fovy);
+    w.pod(s.near);
+    w.pod(s.far);
+  });
+}
+
+std::unique_ptr<CompiledRobot> CompiledRobot::deserialize(std::istream &in) {
+  char magic[sizeof(kMagic)];
+  in.read(magic, sizeof(magic));
+  if (!in.good() || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+    return nullptr;
+  }
+  Reader r(in);
+  if (r.pod<uint32_t>() != kVersion) {
+    return nullptr;
+  }
+
+  auto robot = std::make_unique<CompiledRobot>();
+  r.array(robot->links, [&]() {
+    Link link;
+    link.name = r.string();
+    link.jointName = r.string();
+    link.parent = r.pod<int>();
+
+    link.hasInertial = r.pod<bool>();
+    link.mass = r.pod<PxReal>();
+    link.inertialPose = r.pod<PxTransform>();
+    link.inertia = r.pod<PxVec3>();
+
+    r.array(link.visuals, [&]() {
+      Visual v;
+      v.type = r.pod<Visual::Type>();
+      v.pose = r.pod<PxTransform>();
+      v.size = r.pod<PxVec3>();
+      v.radius = r.pod<PxReal>();
+      v.halfLength = r.pod<PxReal>();
+      v.color = r.pod<PxVec3>();
+      v.filename = r.string();
+      v.name = r.string();
+      return v;
+    });
+    r.array(link.collisions, [&]() {
+      Collision c;
+      c.type = r.pod<Collision::Type>();
+      c.index = r.pod<uint32_t>();
+      c.pose = r.pod<PxTransform>();
+      c.size = r.pod<PxVec3>();
+      c.radius = r.pod<PxReal>();
+      c.halfLength = r.pod<PxReal>();
+      c.filename = r.string();
+      return c;
+    });
+
+    link.hasJoint = r.pod<bool>();
+    link.jointType = r.pod<uint32_t>();
+    r.array(link.limits, [&]() { return r.pod<std::array<PxReal, 2>>(); });
+    link.jointPoseInParent = r.pod<PxTransform>();
+    link.jointPoseInChild = r.pod<PxTransform>();
+    link.friction = r.pod<PxReal>();
+    link.damping = r.pod<PxReal>();
+
+    r.array(link.collisionGroups, [&]() { return r.pod<uint32_t>(); });
+    return link;
+  });
+
+  r.array(robot->sensors, [&]() {
+    SensorRecord s;
+    s.type = r.string();
+    s.name = r.string();
+    s.linkName = r.string();
+    s.localPose = r.pod<PxTransform>();
+    s.width = r.pod<uint32_t>();
+    s.height = r.pod<uint32_t>();
+    s.fovx = r.pod<float>();
+    s.fovy = r.pod<float>();
+    s.near = r.pod<float>();
+    s.far = r.pod<float>();
+    return s;
+  });
+
+  if (!r.good()) {
+    return nullptr;
+  }
+  return robot;
+}
+
+} // namespace URDF
+} // namespace sapien
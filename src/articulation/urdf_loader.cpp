@@ -1,11 +1,21 @@
 #include "urdf_loader.h"
 #include "articulation_builder.h"
+#include "asset_bundle.h"
+#include "mesh_cache.h"
+#include "mesh_manager.h"
 #include "sapien_articulation.h"
 #include "sapien_kinematic_articulation.h"
 #include "sapien_link.h"
 #include "sapien_scene.h"
+#include "simulation.h"
+#include "utils/file.hpp"
+#include <atomic>
 #include <eigen3/Eigen/Eigenvalues>
 #include <experimental/filesystem>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <unistd.h>
 
 namespace sapien {
 namespace URDF {
@@ -43,20 +53,30 @@ std::optional<std::string> findSRDF(const std::string &urdfName) {
   return {};
 }
 
-URDFLoader::URDFLoader(SScene *scene) : mScene(scene) {}
+URDFLoader::URDFLoader(SScene *scene)
+    : mScene(scene), mMeshManager(&scene->getSimulation()->getMeshManager()) {
+  static std::atomic<uint64_t> gLoaderCount{0};
+  mBundleScopeId = ++gLoaderCount;
+}
+
+URDFLoader::~URDFLoader() {
+  for (auto &scope : mBundleScopes) {
+    mMeshManager->releaseCooked(scope);
+    MeshCache::Get().removeBundled(scope);
+  }
+}
 
 struct LinkTreeNode {
   Link *link;
   Joint *joint;
   LinkTreeNode *parent;
   std::vector<LinkTreeNode *> children;
-  std::shared_ptr<LinkBuilder> linkBuilder = nullptr;
+  int index = -1;
 };
 
-std::tuple<std::shared_ptr<ArticulationBuilder>, std::vector<SensorRecord>>
-URDFLoader::parseRobotDescription(XMLDocument const &urdfDoc, XMLDocument const *srdfDoc,
-                                  const std::string &urdfFilename, bool isKinematic,
-                                  URDFConfig const &config) {
+std::shared_ptr<CompiledRobot>
+URDFLoader::compileRobotDescription(XMLDocument const &urdfDoc, XMLDocument const *srdfDoc,
+                                    const std::string &urdfFilename) {
   std::optional<SRDF::Robot> srdf;
   if (srdfDoc) {
     srdf = SRDF::Robot(*srdfDoc->RootElement());
@@ -74,11 +94,6 @@ URDFLoader::parseRobotDescription(XMLDocument const &urdfDoc, XMLDocument const
   std::map<std::string, LinkTreeNode *> linkName2treeNode;
   std::map<std::string, LinkTreeNode *> jointName2treeNode;
 
-  if (robot->link_array.size() >= 64 && !isKinematic) {
-    spdlog::get("SAPIEN")->error("cannot build dynamic articulation with more than 64 links");
-    return {nullptr, std::vector<SensorRecord>()};
-  }
-
   // process link
   for (const auto &link : robot->link_array) {
     std::string name = link->name;
@@ -106,11 +121,11 @@ URDFLoader::parseRobotDescription(XMLDocument const &urdfDoc, XMLDocument const
     std::string child = joint->child->link;
     if (linkName2treeNode.find(parent) == linkName2treeNode.end()) {
       spdlog::get("SAPIEN")->error("Failed to load URDF: parent of joint {} does not exist", name);
-      return {nullptr, std::vector<SensorRecord>()};
+      return nullptr;
     }
     if (linkName2treeNode.find(child) == linkName2treeNode.end()) {
       spdlog::get("SAPIEN")->error("Failed to load URDF: child of joint {} does not exist", name);
-      return {nullptr, std::vector<SensorRecord>()};
+      return nullptr;
     }
 
     LinkTreeNode *parentNode = linkName2treeNode[parent];
@@ -136,11 +151,11 @@ URDFLoader::parseRobotDescription(XMLDocument const &urdfDoc, XMLDocument const
   if (roots.size() > 1) {
     spdlog::get("SAPIEN")->error(
         "Failed to load URDF: multiple root nodes detected in a single URDF");
-    return {nullptr, std::vector<SensorRecord>()};
+    return nullptr;
   }
   if (roots.size() == 0) {
     spdlog::get("SAPIEN")->error("Failed to load URDF: no root node found");
-    return {nullptr, std::vector<SensorRecord>()};
+    return nullptr;
   }
   root = roots[0];
 
@@ -160,7 +175,7 @@ URDFLoader::parseRobotDescription(XMLDocument const &urdfDoc, XMLDocument const
     }
   }
 
-  auto builder = mScene->createArticulationBuilder();
+  auto compiled = std::make_shared<CompiledRobot>();
 
   stack = {root};
   while (!stack.empty()) {
@@ -170,16 +185,17 @@ URDFLoader::parseRobotDescription(XMLDocument const &urdfDoc, XMLDocument const
     const PxTransform tJoint2Parent =
         current->joint ? poseFromOrigin(*current->joint->origin, scale) : PxTransform(PxIdentity);
 
-    current->linkBuilder =
-        builder->createLinkBuilder(current->parent ? current->parent->linkBuilder : nullptr);
-    current->linkBuilder->setName(current->link->name);
-    current->linkBuilder->setJointName(current->joint ? current->joint->name : "");
-
-    auto currentLinkBuilder = current->linkBuilder;
+    current->index = compiled->links.size();
+    compiled->links.push_back({});
+    CompiledRobot::Link &currentLink = compiled->links.back();
+    currentLink.name = current->link->name;
+    currentLink.jointName = current->joint ? current->joint->name : "";
+    currentLink.parent = current->parent ? current->parent->index : -1;
 
     // inertial
     const Inertial &currentInertial = *current->link->inertial;
     const Inertia &currentInertia = *currentInertial.inertia;
+    currentLink.hasInertial = false;
     if (currentInertia.ixx == 0 && currentInertia.iyy == 0 && currentInertia.izz == 0 &&
         currentInertia.ixy == 0 && currentInertia.ixz == 0 && currentInertia.iyz == 0) {
       // in this case inertia is not correctly specified
@@ -231,10 +247,24 @@ URDFLoader::parseRobotDescription(XMLDocument const &urdfDoc, XMLDocument const
       }
 
       float scale3 = scale * scale * scale;
-      currentLinkBuilder->setMassAndInertia(currentInertial.mass->value * scale3, tInertia2Link,
-                                            {scale3 * eigs.x, scale3 * eigs.y, scale * eigs.z});
+      currentLink.hasInertial = true;
+      currentLink.mass = currentInertial.mass->value * scale3;
+      currentLink.inertialPose = tInertia2Link;
+      currentLink.inertia = {scale3 * eigs.x, scale3 * eigs.y, scale * eigs.z};
     }
 
+    auto addVisual = [&](CompiledRobot::Visual::Type type, PxTransform const &pose,
+                         PxVec3 const &size, PxReal radius, PxReal halfLength,
+                         PxVec3 const &color, std::string const &filename,
+                         std::string const &name) {
+      currentLink.visuals.push_back({type, pose, size, radius, halfLength, color, filename, name});
+    };
+    auto addCollision = [&](CompiledRobot::Collision::Type type, uint32_t index,
+                            PxTransform const &pose, PxVec3 const &size, PxReal radius,
+                            PxReal halfLength, std::string const &filename) {
+      currentLink.collisions.push_back({type, index, pose, size, radius, halfLength, filename});
+    };
+
     // visual
     for (const auto &visual : current->link->visual_array) {
       PxVec3 color = {1, 1, 1};
@@ -254,32 +284,32 @@ URDFLoader::parseRobotDescription(XMLDocument const &urdfDoc, XMLDocument const
       const PxTransform tVisual2Link = poseFromOrigin(*visual->origin, scale);
       switch (visual->geometry->type) {
       case Geometry::BOX:
-        currentLinkBuilder->addBoxVisual(tVisual2Link, visual->geometry->size * scale / 2.f, color,
-                                         visual->name);
+        addVisual(CompiledRobot::Visual::BOX, tVisual2Link, visual->geometry->size * scale / 2.f,
+                  0, 0, color, "", visual->name);
         break;
       case Geometry::CYLINDER:
         spdlog::get("SAPIEN")->error("Cylinder visual is not supported. Replaced with a capsule");
-        currentLinkBuilder->addCapsuleVisual(
-            tVisual2Link * PxTransform({{0, 0, 0}, PxQuat(1.57079633, {0, 1, 0})}),
-            visual->geometry->radius * scale,
-            std::max(0.f,
-                     visual->geometry->length * scale / 2.f - visual->geometry->radius * scale),
-            color, visual->name);
+        addVisual(CompiledRobot::Visual::CAPSULE,
+                  tVisual2Link * PxTransform({{0, 0, 0}, PxQuat(1.57079633, {0, 1, 0})}),
+                  PxVec3(0), visual->geometry->radius * scale,
+                  std::max(0.f, visual->geometry->length * scale / 2.f -
+                                    visual->geometry->radius * scale),
+                  color, "", visual->name);
         break;
       case Geometry::CAPSULE:
-        currentLinkBuilder->addCapsuleVisual(
-            tVisual2Link * PxTransform({{0, 0, 0}, PxQuat(1.57079633, {0, 1, 0})}),
-            visual->geometry->radius * scale, visual->geometry->length * scale / 2.f, color,
-            visual->name);
+        addVisual(CompiledRobot::Visual::CAPSULE,
+                  tVisual2Link * PxTransform({{0, 0, 0}, PxQuat(1.57079633, {0, 1, 0})}),
+                  PxVec3(0), visual->geometry->radius * scale,
+                  visual->geometry->length * scale / 2.f, color, "", visual->name);
         break;
       case Geometry::SPHERE:
-        currentLinkBuilder->addSphereVisual(tVisual2Link, visual->geometry->radius * scale, color,
-                                            visual->name);
+        addVisual(CompiledRobot::Visual::SPHERE, tVisual2Link, PxVec3(0),
+                  visual->geometry->radius * scale, 0, color, "", visual->name);
         break;
       case Geometry::MESH:
-        currentLinkBuilder->addVisualFromFile(getAbsPath(urdfFilename, visual->geometry->filename),
-                                              tVisual2Link, visual->geometry->scale * scale,
-                                              nullptr, visual->name);
+        addVisual(CompiledRobot::Visual::MESH, tVisual2Link, visual->geometry->scale * scale, 0,
+                  0, {1, 1, 1}, getAbsPath(urdfFilename, visual->geometry->filename),
+                  visual->name);
         break;
       }
     }
@@ -289,108 +319,79 @@ URDFLoader::parseRobotDescription(XMLDocument const &urdfDoc, XMLDocument const
          ++collision_idx) {
       const auto &collision = current->link->collision_array[collision_idx];
 
-      std::shared_ptr<SPhysicalMaterial> material;
-      float patchRadius;
-      float minPatchRadius;
-      float density;
-      auto it = config.link.find(current->link->name);
-      if (it != config.link.end()) {
-        auto it2 = it->second.shape.find(collision_idx);
-        if (it2 != it->second.shape.end()) {
-          material = it2->second.material;
-          patchRadius = it2->second.patchRadius;
-          minPatchRadius = it2->second.minPatchRadius;
-          density = it2->second.density;
-        } else {
-          material = it->second.material;
-          patchRadius = it->second.patchRadius;
-          minPatchRadius = it->second.minPatchRadius;
-          density = it->second.density;
-        }
-      } else {
-        patchRadius = 0.f;
-        minPatchRadius = 0.f;
-        material = config.material;
-        density = config.density;
-      }
-
       const PxTransform tCollision2Link = poseFromOrigin(*collision->origin, scale);
       // TODO: add physical material support (may require URDF extension)
       switch (collision->geometry->type) {
       case Geometry::BOX:
-        currentLinkBuilder->addBoxShape(tCollision2Link, collision->geometry->size * scale / 2.f,
-                                        material, density, patchRadius, minPatchRadius);
+        addCollision(CompiledRobot::Collision::BOX, collision_idx, tCollision2Link,
+                     collision->geometry->size * scale / 2.f, 0, 0, "");
         if (collisionIsVisual) {
-          currentLinkBuilder->addBoxVisual(
-              tCollision2Link, collision->geometry->size * scale / 2.f, PxVec3{1, 1, 1}, "");
+          addVisual(CompiledRobot::Visual::BOX, tCollision2Link,
+                    collision->geometry->size * scale / 2.f, 0, 0, PxVec3{1, 1, 1}, "", "");
         }
         break;
       case Geometry::CYLINDER:
         if (collision->geometry->length / 2.0f - collision->geometry->radius < 1e-4) {
           spdlog::get("SAPIEN")->error(
               "Cylinder collision is not supported. Replaced with a sphere");
-          currentLinkBuilder->addSphereShape(
-              tCollision2Link * PxTransform({{0, 0, 0}, PxQuat(1.57079633, {0, 1, 0})}),
-              collision->geometry->radius * scale, material, density, patchRadius, minPatchRadius);
+          addCollision(CompiledRobot::Collision::SPHERE, collision_idx,
+                       tCollision2Link * PxTransform({{0, 0, 0}, PxQuat(1.57079633, {0, 1, 0})}),
+                       PxVec3(0), collision->geometry->radius * scale, 0, "");
         } else {
           spdlog::get("SAPIEN")->error(
               "Cylinder collision is not supported. Replaced with a capsule");
-          currentLinkBuilder->addCapsuleShape(
-              tCollision2Link * PxTransform({{0, 0, 0}, PxQuat(1.57079633, {0, 1, 0})}),
-              collision->geometry->radius * scale,
-              std::max(0.f, collision->geometry->length * scale / 2.0f -
-                                collision->geometry->radius * scale),
-              material, density, patchRadius, minPatchRadius);
+          addCollision(CompiledRobot::Collision::CAPSULE, collision_idx,
+                       tCollision2Link * PxTransform({{0, 0, 0}, PxQuat(1.57079633, {0, 1, 0})}),
+                       PxVec3(0), collision->geometry->radius * scale,
+                       std::max(0.f, collision->geometry->length * scale / 2.0f -
+                                         collision->geometry->radius * scale),
+                       "");
         }
         if (collisionIsVisual) {
-          currentLinkBuilder->addCapsuleVisual(
-              tCollision2Link * PxTransform({{0, 0, 0}, PxQuat(1.57079633, {0, 1, 0})}),
-              collision->geometry->radius * scale,
-              std::max(0.f, collision->geometry->length * scale / 2.0f -
-                                collision->geometry->radius * scale),
-              PxVec3{1, 1, 1}, "");
+          addVisual(CompiledRobot::Visual::CAPSULE,
+                    tCollision2Link * PxTransform({{0, 0, 0}, PxQuat(1.57079633, {0, 1, 0})}),
+                    PxVec3(0), collision->geometry->radius * scale,
+                    std::max(0.f, collision->geometry->length * scale / 2.0f -
+                                      collision->geometry->radius * scale),
+                    PxVec3{1, 1, 1}, "", "");
         }
 
       case Geometry::CAPSULE:
-        currentLinkBuilder->addCapsuleShape(
-            tCollision2Link * PxTransform({{0, 0, 0}, PxQuat(1.57079633, {0, 1, 0})}),
-            collision->geometry->radius * scale, collision->geometry->length * scale / 2.0f,
-            material, density, patchRadius, minPatchRadius);
+        addCollision(CompiledRobot::Collision::CAPSULE, collision_idx,
+                     tCollision2Link * PxTransform({{0, 0, 0}, PxQuat(1.57079633, {0, 1, 0})}),
+                     PxVec3(0), collision->geometry->radius * scale,
+                     collision->geometry->length * scale / 2.0f, "");
         if (collisionIsVisual) {
-          currentLinkBuilder->addCapsuleVisual(
-              tCollision2Link * PxTransform({{0, 0, 0}, PxQuat(1.57079633, {0, 1, 0})}),
-              collision->geometry->radius * scale, collision->geometry->length * scale / 2.f,
-              PxVec3{1, 1, 1}, "");
+          addVisual(CompiledRobot::Visual::CAPSULE,
+                    tCollision2Link * PxTransform({{0, 0, 0}, PxQuat(1.57079633, {0, 1, 0})}),
+                    PxVec3(0), collision->geometry->radius * scale,
+                    collision->geometry->length * scale / 2.f, PxVec3{1, 1, 1}, "", "");
         }
         break;
       case Geometry::SPHERE:
-        currentLinkBuilder->addSphereShape(tCollision2Link, collision->geometry->radius * scale,
-                                           material, density, patchRadius, minPatchRadius);
+        addCollision(CompiledRobot::Collision::SPHERE, collision_idx, tCollision2Link,
+                     PxVec3(0), collision->geometry->radius * scale, 0, "");
         if (collisionIsVisual) {
-          currentLinkBuilder->addSphereVisual(tCollision2Link, collision->geometry->radius * scale,
-                                              PxVec3{1, 1, 1}, "");
+          addVisual(CompiledRobot::Visual::SPHERE, tCollision2Link, PxVec3(0),
+                    collision->geometry->radius * scale, 0, PxVec3{1, 1, 1}, "", "");
         }
         break;
       case Geometry::MESH:
-        if (multipleMeshesInOneFile) {
-          currentLinkBuilder->addMultipleConvexShapesFromFile(
-              getAbsPath(urdfFilename, collision->geometry->filename), tCollision2Link,
-              collision->geometry->scale * scale, material, density, patchRadius, minPatchRadius);
-        } else {
-          currentLinkBuilder->addConvexShapeFromFile(
-              getAbsPath(urdfFilename, collision->geometry->filename), tCollision2Link,
-              collision->geometry->scale * scale, material, density, patchRadius, minPatchRadius);
-        }
+        addCollision(multipleMeshesInOneFile ? CompiledRobot::Collision::MULTIPLE_CONVEX
+                                             : CompiledRobot::Collision::CONVEX,
+                     collision_idx, tCollision2Link, collision->geometry->scale * scale, 0, 0,
+                     getAbsPath(urdfFilename, collision->geometry->filename));
         if (collisionIsVisual) {
-          currentLinkBuilder->addVisualFromFile(
-              getAbsPath(urdfFilename, collision->geometry->filename), tCollision2Link,
-              collision->geometry->scale * scale, nullptr, "");
+          addVisual(CompiledRobot::Visual::MESH, tCollision2Link,
+                    collision->geometry->scale * scale, 0, 0, {1, 1, 1},
+                    getAbsPath(urdfFilename, collision->geometry->filename), "");
         }
         break;
       }
     }
 
     // joint
+    currentLink.hasJoint = false;
     if (current->joint) {
       PxReal friction = 0;
       PxReal damping = 0;
@@ -419,24 +420,25 @@ URDFLoader::parseRobotDescription(XMLDocument const &urdfDoc, XMLDocument const
       }
       const PxTransform tAxis2Parent = tJoint2Parent * tAxis2Joint;
 
+      currentLink.hasJoint = true;
+      currentLink.jointPoseInParent = tAxis2Parent;
+      currentLink.jointPoseInChild = tAxis2Joint;
+      currentLink.friction = friction;
+      currentLink.damping = damping;
+
       if (current->joint->type == "revolute") {
-        currentLinkBuilder->setJointProperties(
-            PxArticulationJointType::eREVOLUTE,
-            {{current->joint->limit->lower, current->joint->limit->upper}}, tAxis2Parent,
-            tAxis2Joint, friction, damping);
+        currentLink.jointType = PxArticulationJointType::eREVOLUTE;
+        currentLink.limits = {{current->joint->limit->lower, current->joint->limit->upper}};
       } else if (current->joint->type == "continuous") {
-        currentLinkBuilder->setJointProperties(
-            PxArticulationJointType::eREVOLUTE,
-            {{-std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity()}},
-            tAxis2Parent, tAxis2Joint, friction, damping);
+        currentLink.jointType = PxArticulationJointType::eREVOLUTE;
+        currentLink.limits = {
+            {-std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity()}};
       } else if (current->joint->type == "prismatic") {
-        currentLinkBuilder->setJointProperties(
-            PxArticulationJointType::ePRISMATIC,
-            {{current->joint->limit->lower * scale, current->joint->limit->upper * scale}},
-            tAxis2Parent, tAxis2Joint, friction, damping);
+        currentLink.jointType = PxArticulationJointType::ePRISMATIC;
+        currentLink.limits = {
+            {current->joint->limit->lower * scale, current->joint->limit->upper * scale}};
       } else if (current->joint->type == "fixed") {
-        currentLinkBuilder->setJointProperties(PxArticulationJointType::eFIX, {}, tAxis2Parent,
-                                               tAxis2Joint, friction, damping);
+        currentLink.jointType = PxArticulationJointType::eFIX;
       } else if (current->joint->type == "floating") {
         std::cerr << "Currently not supported: " + current->joint->type << std::endl;
         exit(1);
@@ -477,15 +479,13 @@ URDFLoader::parseRobotDescription(XMLDocument const &urdfDoc, XMLDocument const
           spdlog::get("SAPIEN")->critical("Collision group exhausted, please simplify the SRDF");
           throw std::runtime_error("Too many collision groups");
         }
-        l1->linkBuilder->addCollisionGroup(0, 0, groupCount, 0);
-        l2->linkBuilder->addCollisionGroup(0, 0, groupCount, 0);
+        compiled->links[l1->index].collisionGroups.push_back(groupCount);
+        compiled->links[l2->index].collisionGroups.push_back(groupCount);
       }
     }
     spdlog::get("SAPIEN")->info("SRDF: ignored {} pairs", groupCount);
   }
 
-  std::vector<SensorRecord> sensorRecords;
-
   for (auto &gazebo : robot->gazebo_array) {
     for (auto &sensor : gazebo->sensor_array) {
       switch (sensor->type) {
@@ -495,88 +495,306 @@ URDFLoader::parseRobotDescription(XMLDocument const &urdfDoc, XMLDocument const
       case Sensor::Type::CAMERA:
       case Sensor::Type::DEPTH:
 
-        sensorRecords.push_back(SensorRecord{
+        compiled->sensors.push_back(SensorRecord{
             "camera", sensor->name, gazebo->reference, poseFromOrigin(*sensor->origin, scale),
             sensor->camera->width, sensor->camera->height, sensor->camera->fovx,
             sensor->camera->fovy, sensor->camera->near, sensor->camera->far});
       }
     }
   }
-  return {std::move(builder), sensorRecords};
+  return compiled;
 }
 
-SArticulation *URDFLoader::load(const std::string &filename, URDFConfig const &config) {
-  if (filename.substr(filename.length() - 4) != std::string("urdf")) {
-    throw std::invalid_argument("Non-URDF file passed to URDF loader");
+std::shared_ptr<ArticulationBuilder>
+URDFLoader::buildFromCompiled(CompiledRobot const &robot, bool isKinematic,
+                              URDFConfig const &config) {
+  if (robot.links.size() >= 64 && !isKinematic) {
+    spdlog::get("SAPIEN")->error("cannot build dynamic articulation with more than 64 links");
+    return nullptr;
   }
-  auto srdfName = findSRDF(filename);
 
-  std::unique_ptr<XMLDocument> srdfDoc = nullptr;
-  if (srdfName) {
-    srdfDoc = std::make_unique<XMLDocument>();
-    if (srdfDoc->LoadFile(srdfName.value().c_str())) {
-      srdfDoc = nullptr;
-      spdlog::get("SAPIEN")->error("SRDF loading faild for {}", filename);
+  auto builder = mScene->createArticulationBuilder();
+  builder->setEnvironment(environment);
+  for (auto &link : robot.links) {
+    auto linkBuilder = builder->createLinkBuilder(link.parent);
+    linkBuilder->setName(link.name);
+    linkBuilder->setJointName(link.jointName);
+
+    if (link.hasInertial) {
+      linkBuilder->setMassAndInertia(link.mass, link.inertialPose, link.inertia);
+    }
+
+    for (auto &visual : link.visuals) {
+      switch (visual.type) {
+      case CompiledRobot::Visual::BOX:
+        linkBuilder->addBoxVisual(visual.pose, visual.size, visual.color, visual.name);
+        break;
+      case CompiledRobot::Visual::CAPSULE:
+        linkBuilder->addCapsuleVisual(visual.pose, visual.radius, visual.halfLength, visual.color,
+                                      visual.name);
+        break;
+      case CompiledRobot::Visual::SPHERE:
+        linkBuilder->addSphereVisual(visual.pose, visual.radius, visual.color, visual.name);
+        break;
+      case CompiledRobot::Visual::MESH:
+        linkBuilder->addVisualFromFile(visual.filename, visual.pose, visual.size, nullptr,
+                                       visual.name);
+        break;
+      }
+    }
+
+    for (auto &collision : link.collisions) {
+      std::shared_ptr<SPhysicalMaterial> material;
+      float patchRadius;
+      float minPatchRadius;
+      float density;
+      auto it = config.link.find(link.name);
+      if (it != config.link.end()) {
+        auto it2 = it->second.shape.find(collision.index);
+        if (it2 != it->second.shape.end()) {
+          material = it2->second.material;
+          patchRadius = it2->second.patchRadius;
+          minPatchRadius = it2->second.minPatchRadius;
+          density = it2->second.density;
+        } else {
+          material = it->second.material;
+          patchRadius = it->second.patchRadius;
+          minPatchRadius = it->second.minPatchRadius;
+          density = it->second.density;
+        }
+      } else {
+        patchRadius = 0.f;
+        minPatchRadius = 0.f;
+        material = config.material;
+        density = config.density;
+      }
+
+      switch (collision.type) {
+      case CompiledRobot::Collision::BOX:
+        linkBuilder->addBoxShape(collision.pose, collision.size, material, density, patchRadius,
+                                 minPatchRadius);
+        break;
+      case CompiledRobot::Collision::CAPSULE:
+        linkBuilder->addCapsuleShape(collision.pose, collision.radius, collision.halfLength,
+                                     material, density, patchRadius, minPatchRadius);
+        break;
+      case CompiledRobot::Collision::SPHERE:
+        linkBuilder->addSphereShape(collision.pose, collision.radius, material, density,
+                                    patchRadius, minPatchRadius);
+        break;
+      case CompiledRobot::Collision::CONVEX:
+        linkBuilder->addConvexShapeFromFile(collision.filename, collision.pose, collision.size,
+                                            material, density, patchRadius, minPatchRadius);
+        break;
+      case CompiledRobot::Collision::MULTIPLE_CONVEX:
+        linkBuilder->addMultipleConvexShapesFromFile(collision.filename, collision.pose,
+                                                     collision.size, material, density,
+                                                     patchRadius, minPatchRadius);
+        break;
+      }
+    }
+
+    if (link.hasJoint) {
+      linkBuilder->setJointProperties(
+          static_cast<PxArticulationJointType::Enum>(link.jointType), link.limits,
+          link.jointPoseInParent, link.jointPoseInChild, link.friction, link.damping);
+    }
+
+    for (uint32_t group : link.collisionGroups) {
+      linkBuilder->addCollisionGroup(0, 0, group, 0);
     }
   }
+  return builder;
+}
 
-  XMLDocument urdfDoc;
-  if (urdfDoc.LoadFile(filename.c_str())) {
-    spdlog::get("SAPIEN")->error("Failed to open URDF file: {}", filename);
-    return nullptr;
+static uint64_t hashBytes(uint64_t hash, void const *data, size_t size) {
+  // FNV-1a, stable across processes so it can name files in the compiled cache directory
+  auto bytes = static_cast<unsigned char const *>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
   }
+  return hash;
+}
 
-  auto [builder, records] = parseRobotDescription(urdfDoc, srdfDoc.get(), filename, false, config);
-  auto articulation = builder->build(fixRootLink);
+/* true if no mesh referenced by the robot was written after the given time */
+static bool meshesUnchangedSince(CompiledRobot const &robot, fs::file_time_type time) {
+  std::error_code ec;
+  auto unchanged = [&](std::string const &filename) {
+    if (filename.empty()) {
+      return true;
+    }
+    auto mtime = fs::last_write_time(filename, ec);
+    // files that are not on disk (e.g. bundle members) cannot be checked
+    return ec || mtime <= time;
+  };
+  for (auto &link : robot.links) {
+    for (auto &visual : link.visuals) {
+      if (!unchanged(visual.filename)) {
+        return false;
+      }
+    }
+    for (auto &collision : link.collisions) {
+      if (!unchanged(collision.filename)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
 
-  for (auto &record : records) {
-    if (record.type == "camera") {
-      std::vector<SLinkBase *> links = articulation->getBaseLinks();
+/* least recently used compiled robots, at most kCompiledRobotCapacity of them */
+static constexpr size_t kCompiledRobotCapacity = 64;
+struct CompiledRobotEntry {
+  std::shared_ptr<CompiledRobot> robot;
+  fs::file_time_type time;
+  std::list<uint64_t>::iterator order;
+};
+static std::mutex gCompiledRobotsLock;
+static std::map<uint64_t, CompiledRobotEntry> gCompiledRobots;
+static std::list<uint64_t> gCompiledRobotOrder;
+
+static std::shared_ptr<CompiledRobot> findCompiledRobot(uint64_t key) {
+  std::lock_guard<std::mutex> lock(gCompiledRobotsLock);
+  auto it = gCompiledRobots.find(key);
+  if (it == gCompiledRobots.end()) {
+    return nullptr;
+  }
+  if (!meshesUnchangedSince(*it->second.robot, it->second.time)) {
+    gCompiledRobotOrder.erase(it->second.order);
+    gCompiledRobots.erase(it);
+    return nullptr;
+  }
+  gCompiledRobotOrder.splice(gCompiledRobotOrder.begin(), gCompiledRobotOrder, it->second.order);
+  return it->second.robot;
+}
 
-      auto it = std::find_if(links.begin(), links.end(),
-                             [&](SLinkBase *link) { return link->getName() == record.linkName; });
+static void addCompiledRobot(uint64_t key, std::shared_ptr<CompiledRobot> robot,
+                             fs::file_time_type time) {
+  std::lock_guard<std::mutex> lock(gCompiledRobotsLock);
+  auto it = gCompiledRobots.find(key);
+  if (it != gCompiledRobots.end()) {
+    gCompiledRobotOrder.erase(it->second.order);
+    gCompiledRobots.erase(it);
+  }
+  gCompiledRobotOrder.push_front(key);
+  gCompiledRobots[key] = {robot, time, gCompiledRobotOrder.begin()};
+  while (gCompiledRobots.size() > kCompiledRobotCapacity) {
+    gCompiledRobots.erase(gCompiledRobotOrder.back());
+    gCompiledRobotOrder.pop_back();
+  }
+}
 
-      if (it == links.end()) {
-        spdlog::get("SAPIEN")->error("Failed to find the link to mount camera: ", record.linkName);
-        continue;
+std::shared_ptr<CompiledRobot> URDFLoader::loadCompiledRobot(const std::string &urdfString,
+                                                             const std::string &srdfString,
+                                                             const std::string &urdfFilename) {
+  // relative mesh paths are resolved against the URDF path, so it is part of the key; mesh
+  // files are checked against the compile time on every hit
+  std::string path = urdfFilename.empty() ? "" : fs::absolute(urdfFilename).string();
+  uint64_t key = 14695981039346656037ull;
+  for (auto const &str : {urdfString, srdfString, path}) {
+    uint64_t size = str.size();
+    key = hashBytes(key, &size, sizeof(size));
+    key = hashBytes(key, str.data(), str.size());
+  }
+  key = hashBytes(key, &scale, sizeof(scale));
+  key = hashBytes(key, &multipleMeshesInOneFile, sizeof(multipleMeshesInOneFile));
+  key = hashBytes(key, &collisionIsVisual, sizeof(collisionIsVisual));
+
+  std::string cacheFile;
+  if (useCompiledCache) {
+    if (auto compiled = findCompiledRobot(key)) {
+      return compiled;
+    }
+    if (!compiledCacheDirectory.empty()) {
+      std::ostringstream ss;
+      ss << std::hex << key << ".sapien_urdf";
+      cacheFile = (fs::path(compiledCacheDirectory) / ss.str()).string();
+      std::ifstream in(cacheFile, std::ios::binary);
+      if (in) {
+        std::error_code ec;
+        auto time = fs::last_write_time(cacheFile, ec);
+        std::shared_ptr<CompiledRobot> compiled = CompiledRobot::deserialize(in);
+        if (!compiled) {
+          spdlog::get("SAPIEN")->warn("Ignored invalid compiled URDF cache {}", cacheFile);
+        } else if (!ec && meshesUnchangedSince(*compiled, time)) {
+          addCompiledRobot(key, compiled, time);
+          return compiled;
+        }
       }
+    }
+  }
 
-      auto cam = mScene->addCamera(record.name, record.width, record.height, record.fovy,
-                                   record.near, record.far);
-      cam->setParent(*it);
-      cam->setLocalPose(record.localPose);
-      // mScene->addMountedCamera(record.name, *it, record.localPose, record.width, record.height,
-      //                          record.fovx, record.fovy, record.near, record.far);
+  auto compileTime = fs::file_time_type::clock::now();
+  XMLDocument urdfDoc;
+  if (urdfDoc.Parse(urdfString.c_str(), urdfString.length())) {
+    spdlog::get("SAPIEN")->error("Failed to parse URDF: {}",
+                                 urdfFilename.empty() ? "<string>" : urdfFilename);
+    return nullptr;
+  }
+
+  std::unique_ptr<XMLDocument> srdfDoc = nullptr;
+  if (!srdfString.empty()) {
+    srdfDoc = std::make_unique<XMLDocument>();
+    if (srdfDoc->Parse(srdfString.c_str(), srdfString.length())) {
+      srdfDoc = nullptr;
+      spdlog::get("SAPIEN")->error("SRDF loading faild for {}",
+                                   urdfFilename.empty() ? "<string>" : urdfFilename);
     }
   }
 
-  return articulation;
+  auto compiled = compileRobotDescription(urdfDoc, srdfDoc.get(), urdfFilename);
+  if (!compiled || !useCompiledCache) {
+    return compiled;
+  }
+
+  addCompiledRobot(key, compiled, compileTime);
+  if (!cacheFile.empty() && !writeFileAtomic(cacheFile, [&](std::string const &tmpFile) {
+        std::ofstream out(tmpFile, std::ios::binary);
+        compiled->serialize(out);
+        out.close();
+        return !out.fail();
+      })) {
+    spdlog::get("SAPIEN")->warn("Failed to save compiled URDF cache {}", cacheFile);
+  }
+  return compiled;
 }
 
-SKArticulation *URDFLoader::loadKinematic(const std::string &filename, URDFConfig const &config) {
+static std::optional<std::string> readTextFile(const std::string &filename) {
+  std::ifstream in(filename, std::ios::binary);
+  if (!in) {
+    return {};
+  }
+  std::ostringstream ss;
+  ss << in.rdbuf();
+  return ss.str();
+}
+
+std::shared_ptr<CompiledRobot> URDFLoader::loadCompiledRobotFromFile(const std::string &filename) {
   if (filename.substr(filename.length() - 4) != std::string("urdf")) {
     throw std::invalid_argument("Non-URDF file passed to URDF loader");
   }
-  auto srdfName = findSRDF(filename);
 
-  std::unique_ptr<XMLDocument> srdfDoc = nullptr;
-  if (srdfName) {
-    srdfDoc = std::make_unique<XMLDocument>();
-    if (srdfDoc->LoadFile(srdfName.value().c_str())) {
-      srdfDoc = nullptr;
+  std::string srdfString;
+  if (auto srdfName = findSRDF(filename)) {
+    if (auto content = readTextFile(srdfName.value())) {
+      srdfString = content.value();
+    } else {
       spdlog::get("SAPIEN")->error("SRDF loading faild for {}", filename);
     }
   }
 
-  XMLDocument urdfDoc;
-  if (urdfDoc.LoadFile(filename.c_str())) {
+  auto urdfString = readTextFile(filename);
+  if (!urdfString) {
     spdlog::get("SAPIEN")->error("Failed to open URDF file: {}", filename);
     return nullptr;
   }
 
-  auto [builder, records] = parseRobotDescription(urdfDoc, srdfDoc.get(), filename, true, config);
-  auto articulation = builder->buildKinematic();
+  return loadCompiledRobot(urdfString.value(), srdfString, filename);
+}
 
+void URDFLoader::mountSensors(SArticulationBase *articulation,
+                              std::vector<SensorRecord> const &records) {
   for (auto &record : records) {
     if (record.type == "camera") {
       std::vector<SLinkBase *> links = articulation->getBaseLinks();
@@ -595,74 +813,263 @@ SKArticulation *URDFLoader::loadKinematic(const std::string &filename, URDFConfi
       cam->setLocalPose(record.localPose);
     }
   }
+}
 
+SArticulation *URDFLoader::load(const std::string &filename, URDFConfig const &config) {
+  auto compiled = loadCompiledRobotFromFile(filename);
+  if (!compiled) {
+    return nullptr;
+  }
+  auto builder = buildFromCompiled(*compiled, false, config);
+  if (!builder) {
+    return nullptr;
+  }
+  auto articulation = builder->build(fixRootLink);
+  if (articulation) {
+    mountSensors(articulation, compiled->sensors);
+  }
+  return articulation;
+}
+
+SKArticulation *URDFLoader::loadKinematic(const std::string &filename, URDFConfig const &config) {
+  auto compiled = loadCompiledRobotFromFile(filename);
+  if (!compiled) {
+    return nullptr;
+  }
+  auto builder = buildFromCompiled(*compiled, true, config);
+  if (!builder) {
+    return nullptr;
+  }
+  auto articulation = builder->buildKinematic();
+  if (articulation) {
+    mountSensors(articulation, compiled->sensors);
+  }
   return articulation;
 }
 
 std::shared_ptr<ArticulationBuilder>
 URDFLoader::loadFileAsArticulationBuilder(const std::string &filename, URDFConfig const &config) {
-  if (filename.substr(filename.length() - 4) != std::string("urdf")) {
-    throw std::invalid_argument("Non-URDF file passed to URDF loader");
+  auto compiled = loadCompiledRobotFromFile(filename);
+  if (!compiled) {
+    return nullptr;
   }
-  auto srdfName = findSRDF(filename);
+  return buildFromCompiled(*compiled, true, config);
+}
 
-  std::unique_ptr<XMLDocument> srdfDoc = nullptr;
-  if (srdfName) {
-    srdfDoc = std::make_unique<XMLDocument>();
-    if (srdfDoc->LoadFile(srdfName.value().c_str())) {
-      srdfDoc = nullptr;
-      spdlog::get("SAPIEN")->error("SRDF loading faild for {}", filename);
+template <typename T>
+std::future<T *> URDFLoader::loadAsyncImpl(const std::string &filename, URDFConfig const &config,
+                                           bool isKinematic) {
+  auto promise = std::make_shared<std::promise<T *>>();
+  auto future = promise->get_future();
+  auto scene = mScene;
+  scene->runInBackground([=, loader = *this]() mutable {
+    std::shared_ptr<CompiledRobot> compiled;
+    std::shared_ptr<ArticulationBuilder> builder;
+    try {
+      compiled = loader.loadCompiledRobotFromFile(filename);
+      if (compiled) {
+        builder = loader.buildFromCompiled(*compiled, isKinematic, config);
+      }
+      if (builder) {
+        builder->prepare();
+      }
+    } catch (...) {
+      promise->set_exception(std::current_exception());
+      return;
     }
-  }
 
-  XMLDocument urdfDoc;
-  if (urdfDoc.LoadFile(filename.c_str())) {
-    spdlog::get("SAPIEN")->error("Failed to open URDF file: {}", filename);
-    return nullptr;
-  }
-  return std::move(
-      std::get<0>(parseRobotDescription(urdfDoc, srdfDoc.get(), filename, true, config)));
+    // PhysX insertion happens on the simulation thread between steps
+    scene->scheduleAtStep(
+        [=]() mutable {
+          try {
+            T *articulation = nullptr;
+            if (builder) {
+              if constexpr (std::is_same_v<T, SKArticulation>) {
+                articulation = builder->buildKinematic();
+              } else {
+                articulation = builder->build(loader.fixRootLink);
+              }
+            }
+            if (articulation) {
+              loader.mountSensors(articulation, compiled->sensors);
+            }
+            promise->set_value(articulation);
+          } catch (...) {
+            promise->set_exception(std::current_exception());
+          }
+        },
+        [=]() {
+          promise->set_exception(std::make_exception_ptr(
+              std::runtime_error("Scene was destroyed before the articulation was added")));
+        });
+  });
+  return future;
 }
 
-SArticulation *URDFLoader::loadFromXML(const std::string &URDFString,
-                                       const std::string &SRDFString, URDFConfig const &config) {
+std::future<SArticulation *> URDFLoader::loadAsync(const std::string &filename,
+                                                   URDFConfig const &config) {
+  return loadAsyncImpl<SArticulation>(filename, config, false);
+}
 
-  XMLDocument urdfDoc;
-  if (urdfDoc.Parse(URDFString.c_str(), URDFString.length())) {
-    spdlog::get("SAPIEN")->error("Failed to parse URDF string");
-    return nullptr;
-  }
+std::future<SKArticulation *> URDFLoader::loadKinematicAsync(const std::string &filename,
+                                                             URDFConfig const &config) {
+  return loadAsyncImpl<SKArticulation>(filename, config, true);
+}
 
-  std::unique_ptr<XMLDocument> srdfDoc = nullptr;
-  if (!SRDFString.empty()) {
-    srdfDoc = std::make_unique<XMLDocument>();
-    if (srdfDoc->Parse(SRDFString.c_str(), SRDFString.length())) {
-      spdlog::get("SAPIEN")->error("Failed parsing given SRDF string.");
+static const std::string kBundleConvexPrefix = "convex/";
+static const std::string kBundleConvexGroupPrefix = "convex_group/";
+static const std::string kBundleMeshPrefix = "mesh/";
+
+void URDFLoader::saveBundle(const std::string &filename, const std::string &bundleFilename) {
+  auto compiled = loadCompiledRobotFromFile(filename);
+  if (!compiled) {
+    throw std::runtime_error("Failed to load URDF for bundling: " + filename);
+  }
+  auto &meshManager = mScene->getSimulation()->getMeshManager();
+
+  AssetBundleWriter writer;
+  std::ostringstream robot;
+  compiled->serialize(robot);
+  writer.add("robot", robot.str());
+
+  for (auto &link : compiled->links) {
+    for (auto &collision : link.collisions) {
+      if (collision.type == CompiledRobot::Collision::CONVEX) {
+        std::string name = kBundleConvexPrefix + collision.filename;
+        if (writer.has(name)) {
+          continue;
+        }
+        auto mesh = meshManager.loadMesh(collision.filename);
+        if (!mesh) {
+          throw std::runtime_error("Failed to load collision mesh: " + collision.filename);
+        }
+        writer.add(name, meshManager.cookConvexMesh(mesh));
+      } else if (collision.type == CompiledRobot::Collision::MULTIPLE_CONVEX) {
+        std::string name = kBundleConvexGroupPrefix + collision.filename;
+        if (writer.has(name)) {
+          continue;
+        }
+        std::vector<std::string> cooked;
+        for (auto mesh : meshManager.loadMeshGroup(collision.filename)) {
+          if (mesh) {
+            cooked.push_back(meshManager.cookConvexMesh(mesh));
+          }
+        }
+        writer.add(name, MeshManager::packCookedMeshes(cooked));
+      }
+    }
+    for (auto &visual : link.visuals) {
+      if (visual.type != CompiledRobot::Visual::MESH) {
+        continue;
+      }
+      std::string name = kBundleMeshPrefix + visual.filename;
+      if (writer.has(name)) {
+        continue;
+      }
+      auto mesh = MeshCache::Get().load(visual.filename);
+      if (!mesh) {
+        spdlog::get("SAPIEN")->warn("Visual mesh is not bundled: {}", visual.filename);
+        continue;
+      }
+      std::ostringstream data;
+      mesh->serialize(data);
+      writer.add(name, data.str());
     }
   }
 
-  auto [builder, records] = parseRobotDescription(urdfDoc, srdfDoc.get(), "", false, config);
-  auto articulation = builder->build(fixRootLink);
-
-  for (auto &record : records) {
-    if (record.type == "camera") {
-      std::vector<SLinkBase *> links = articulation->getBaseLinks();
-
-      auto it = std::find_if(links.begin(), links.end(),
-                             [&](SLinkBase *link) { return link->getName() == record.linkName; });
+  writer.write(bundleFilename);
+}
 
-      if (it == links.end()) {
-        spdlog::get("SAPIEN")->error("Failed to find the link to mount camera: ", record.linkName);
+std::set<std::string> URDFLoader::registerBundleAssets(AssetBundle const &bundle,
+                                                       std::string const &scope) {
+  std::set<std::string> bundled;
+  for (auto &[name, data] : bundle.getEntries()) {
+    if (name.rfind(kBundleConvexPrefix, 0) == 0) {
+      std::string filename = name.substr(kBundleConvexPrefix.size());
+      if (mMeshManager->loadMeshFromCooked(scope + filename, data)) {
+        bundled.insert(filename);
+      }
+    } else if (name.rfind(kBundleConvexGroupPrefix, 0) == 0) {
+      std::vector<std::string_view> parts;
+      if (!MeshManager::unpackCookedMeshes(data, parts)) {
+        spdlog::get("SAPIEN")->error("Corrupted mesh group in bundle: {}", name);
         continue;
       }
+      std::string filename = name.substr(kBundleConvexGroupPrefix.size());
+      mMeshManager->loadMeshGroupFromCooked(scope + filename, parts);
+      bundled.insert(filename);
+    } else if (name.rfind(kBundleMeshPrefix, 0) == 0) {
+      MemoryStreamBuffer buffer(data);
+      std::istream in(&buffer);
+      if (auto mesh = DecodedMesh::deserialize(in)) {
+        std::string filename = name.substr(kBundleMeshPrefix.size());
+        mesh->filename = scope + filename;
+        MeshCache::Get().addBundled(mesh->filename, mesh);
+        bundled.insert(filename);
+      } else {
+        spdlog::get("SAPIEN")->error("Corrupted mesh in bundle: {}", name);
+      }
+    }
+  }
+  return bundled;
+}
 
-      auto cam = mScene->addCamera(record.name, record.width, record.height, record.fovy,
-                                   record.near, record.far);
-      cam->setParent(*it);
-      cam->setLocalPose(record.localPose);
+SArticulation *URDFLoader::loadBundle(const std::string &bundleFilename,
+                                      URDFConfig const &config) {
+  AssetBundle bundle(bundleFilename);
+  MemoryStreamBuffer buffer(bundle.get("robot"));
+  std::istream in(&buffer);
+  auto compiled = CompiledRobot::deserialize(in);
+  if (!compiled) {
+    spdlog::get("SAPIEN")->error("Bundle does not contain a compatible robot: {}",
+                                 bundleFilename);
+    return nullptr;
+  }
+
+  std::string scope = "bundle:" + std::to_string(mBundleScopeId) + ":" +
+                      fs::canonical(bundleFilename).string() + ":";
+  if (std::find(mBundleScopes.begin(), mBundleScopes.end(), scope) == mBundleScopes.end()) {
+    mBundleScopes.push_back(scope);
+  }
+  auto bundled = registerBundleAssets(bundle, scope);
+  for (auto &link : compiled->links) {
+    for (auto &collision : link.collisions) {
+      if (bundled.count(collision.filename)) {
+        collision.filename = scope + collision.filename;
+      }
+    }
+    for (auto &visual : link.visuals) {
+      if (bundled.count(visual.filename)) {
+        visual.filename = scope + visual.filename;
+      }
     }
   }
 
+  auto builder = buildFromCompiled(*compiled, false, config);
+  if (!builder) {
+    return nullptr;
+  }
+  auto articulation = builder->build(fixRootLink);
+  if (articulation) {
+    mountSensors(articulation, compiled->sensors);
+  }
+  return articulation;
+}
+
+SArticulation *URDFLoader::loadFromXML(const std::string &URDFString,
+                                       const std::string &SRDFString, URDFConfig const &config) {
+  auto compiled = loadCompiledRobot(URDFString, SRDFString, "");
+  if (!compiled) {
+    return nullptr;
+  }
+  auto builder = buildFromCompiled(*compiled, false, config);
+  if (!builder) {
+    return nullptr;
+  }
+  auto articulation = builder->build(fixRootLink);
+  if (articulation) {
+    mountSensors(articulation, compiled->sensors);
+  }
   return articulation;
 };
 
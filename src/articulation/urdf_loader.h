@@ -1,7 +1,10 @@
 #pragma once
 #include <PxPhysicsAPI.h>
+#include <array>
+#include <future>
 #include <iostream>
 #include <map>
+#include <set>
 #include <memory>
 #include <spdlog/spdlog.h>
 #include <sstream>
@@ -10,6 +13,8 @@
 #include <vector>
 
 namespace sapien {
+class AssetBundle;
+class MeshManager;
 class SScene;
 class SArticulation;
 class SKArticulation;
@@ -787,10 +792,74 @@ struct SensorRecord {
   float far;
 };
 
+/* Articulation description compiled from URDF and SRDF.
+ * Paths are resolved, scale is applied and inertia tensors are diagonalized, so building an
+ * articulation from it requires no XML parsing. URDFConfig is applied when building. */
+struct CompiledRobot {
+  struct Visual {
+    enum Type : uint32_t { BOX, CAPSULE, SPHERE, MESH } type;
+    physx::PxTransform pose;
+    physx::PxVec3 size; // half size for box, scale for mesh
+    physx::PxReal radius;
+    physx::PxReal halfLength;
+    physx::PxVec3 color;
+    std::string filename;
+    std::string name;
+  };
+
+  struct Collision {
+    enum Type : uint32_t { BOX, CAPSULE, SPHERE, CONVEX, MULTIPLE_CONVEX } type;
+    uint32_t index; // index of the <collision> in its link, used to look up URDFConfig
+    physx::PxTransform pose;
+    physx::PxVec3 size; // half size for box, scale for mesh
+    physx::PxReal radius;
+    physx::PxReal halfLength;
+    std::string filename;
+  };
+
+  struct Link {
+    std::string name;
+    std::string jointName;
+    int parent = -1;
+
+    bool hasInertial = false;
+    physx::PxReal mass = 0;
+    physx::PxTransform inertialPose{physx::PxIdentity};
+    physx::PxVec3 inertia{0};
+
+    std::vector<Visual> visuals;
+    std::vector<Collision> collisions;
+
+    bool hasJoint = false;
+    uint32_t jointType = physx::PxArticulationJointType::eFIX;
+    std::vector<std::array<physx::PxReal, 2>> limits;
+    physx::PxTransform jointPoseInParent{physx::PxIdentity};
+    physx::PxTransform jointPoseInChild{physx::PxIdentity};
+    physx::PxReal friction = 0;
+    physx::PxReal damping = 0;
+
+    std::vector<uint32_t> collisionGroups;
+  };
+
+  // parents always come before children
+  std::vector<Link> links;
+  std::vector<SensorRecord> sensors;
+
+  void serialize(std::ostream &out) const;
+  /* returns nullptr if the stream is not a compiled robot of the current format */
+  static std::unique_ptr<CompiledRobot> deserialize(std::istream &in);
+};
+
 class URDFLoader {
   SScene *mScene;
   std::string mUrdfString;
 
+  // bundle assets are registered under "bundle:<loader id>:<bundle path>:" and released with
+  // the loader, so they never shadow files loaded from disk or by other loaders
+  uint64_t mBundleScopeId;
+  std::vector<std::string> mBundleScopes;
+  MeshManager *mMeshManager;
+
 public:
   /* The base of the loaded articulation will be fixed */
   bool fixRootLink = true;
@@ -809,7 +878,23 @@ public:
   /* collision will be rendered along with visual */
   bool collisionIsVisual = false;
 
+  /* Environment slot of the scene the articulation is built into, -1 for shared */
+  int environment = -1;
+
+  /* Keep compiled descriptions in a process-wide cache keyed by URDF/SRDF content, file path,
+   * scale and loader flags, so loading the same URDF again skips XML parsing. The cache keeps
+   * the 64 most recently used descriptions; entries are dropped when a referenced mesh file is
+   * modified after compilation. */
+  bool useCompiledCache = false;
+
+  /* If not empty, compiled descriptions are also stored in this directory and shared with
+   * other processes */
+  std::string compiledCacheDirectory = "";
+
   explicit URDFLoader(SScene *scene);
+  URDFLoader(URDFLoader const &) = delete;
+  URDFLoader &operator=(URDFLoader const &) = delete;
+  ~URDFLoader();
 
   SArticulation *load(const std::string &filename, URDFConfig const &config = {});
 
@@ -823,11 +908,52 @@ public:
   std::shared_ptr<ArticulationBuilder>
   loadFileAsArticulationBuilder(const std::string &filename, URDFConfig const &config = {});
 
+  /* Parse the URDF, load collision meshes and preload render models on the simulation thread
+   * pool. The articulation is added to the scene at the start of the next step after loading
+   * finishes, which is when the future becomes ready. Loader options are captured at call
+   * time. If the scene is destroyed first, the future holds a std::runtime_error. */
+  std::future<SArticulation *> loadAsync(const std::string &filename,
+                                         URDFConfig const &config = {});
+
+  std::future<SKArticulation *> loadKinematicAsync(const std::string &filename,
+                                                   URDFConfig const &config = {});
+
+  /* Pack the compiled URDF, cooked convex collision meshes and decoded visual meshes into a
+   * single file. Loader options (scale, multiple collisions, collision as visual) are applied
+   * when bundling. */
+  void saveBundle(const std::string &filename, const std::string &bundleFilename);
+
+  /* Load an articulation from a bundle written by saveBundle. The bundle is memory mapped while
+   * loading: cooked collision meshes are created from the mapping and decoded visual meshes are
+   * copied out of it into the mesh cache. Textures are not bundled and are opened from their
+   * original paths. The meshes are only visible to this loader and are released with it;
+   * articulations already built keep theirs. */
+  SArticulation *loadBundle(const std::string &bundleFilename, URDFConfig const &config = {});
+
 private:
-  std::tuple<std::shared_ptr<ArticulationBuilder>, std::vector<SensorRecord>>
-  parseRobotDescription(XMLDocument const &urdfDoc, XMLDocument const *srdfDoc,
-                        const std::string &urdfFilename, bool isKinematic,
-                        URDFConfig const &config);
+  /* register the bundle meshes under the scope, returns the bundled filenames */
+  std::set<std::string> registerBundleAssets(AssetBundle const &bundle,
+                                             std::string const &scope);
+
+  template <typename T>
+  std::future<T *> loadAsyncImpl(const std::string &filename, URDFConfig const &config,
+                                 bool isKinematic);
+
+  std::shared_ptr<CompiledRobot> compileRobotDescription(XMLDocument const &urdfDoc,
+                                                         XMLDocument const *srdfDoc,
+                                                         const std::string &urdfFilename);
+
+  std::shared_ptr<CompiledRobot> loadCompiledRobot(const std::string &urdfString,
+                                                   const std::string &srdfString,
+                                                   const std::string &urdfFilename);
+
+  std::shared_ptr<CompiledRobot> loadCompiledRobotFromFile(const std::string &filename);
+
+  std::shared_ptr<ArticulationBuilder> buildFromCompiled(CompiledRobot const &robot,
+                                                         bool isKinematic,
+                                                         URDFConfig const &config);
+
+  void mountSensors(SArticulationBase *articulation, std::vector<SensorRecord> const &records);
 };
 
 } // namespace URDF
@@ -0,0 +1,143 @@
+#include "asset_bundle.h"
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace sapien {
+
+static constexpr char kMagic[8] = {'S', 'A', 'P', 'I', 'E', 'N', 'A', 'B'};
+static constexpr uint32_t kVersion = 2;
+static constexpr uint64_t kAlignment = 16;
+
+/* Layout:
+ *   magic[8] version:u32 count:u32
+ *   count x { nameSize:u32 name offset:u64 size:u64 }
+ *   entry contents at their (aligned) offsets from the start of the file
+ */
+
+AssetBundle::AssetBundle(std::string const &filename) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Failed to open asset bundle: " + filename);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    throw std::runtime_error("Failed to stat asset bundle: " + filename);
+  }
+  mSize = st.st_size;
+  void *data = mSize ? mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+  close(fd);
+  if (data == MAP_FAILED) {
+    throw std::runtime_error("Failed to map asset bundle: " + filename);
+  }
+  mData = data;
+
+  char const *begin = static_cast<char const *>(mData);
+  char const *end = begin + mSize;
+  char const *p = begin;
+  auto read = [&](void *dst, size_t size) {
+    if (p + size > end) {
+      throw std::runtime_error("Corrupted asset bundle: " + filename);
+    }
+    std::memcpy(dst, p, size);
+    p += size;
+  };
+
+  try {
+    char magic[sizeof(kMagic)];
+    uint32_t version, count;
+    read(magic, sizeof(magic));
+    read(&version, sizeof(version));
+    if (std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 || version != kVersion) {
+      throw std::runtime_error("Not a compatible asset bundle: " + filename);
+    }
+    read(&count, sizeof(count));
+    for (uint32_t i = 0; i < count; ++i) {
+      uint32_t nameSize;
+      uint64_t offset, size;
+      read(&nameSize, sizeof(nameSize));
+      std::string name(nameSize, '\0');
+      read(name.data(), nameSize);
+      read(&offset, sizeof(offset));
+      read(&size, sizeof(size));
+      if (offset > mSize || size > mSize - offset) {
+        throw std::runtime_error("Corrupted asset bundle: " + filename);
+      }
+      mEntries[name] = std::string_view(begin + offset, size);
+    }
+  } catch (...) {
+    munmap(mData, mSize);
+    throw;
+  }
+}
+
+AssetBundle::~AssetBundle() {
+  if (mData) {
+    munmap(mData, mSize);
+  }
+}
+
+std::string_view AssetBundle::get(std::string_view name) const {
+  auto it = mEntries.find(name);
+  if (it == mEntries.end()) {
+    return {};
+  }
+  return it->second;
+}
+
+void AssetBundleWriter::write(std::string const &filename) const {
+  uint64_t headerSize = sizeof(kMagic) + 2 * sizeof(uint32_t);
+  for (auto &[name, data] : mEntries) {
+    headerSize += sizeof(uint32_t) + name.size() + 2 * sizeof(uint64_t);
+  }
+
+  std::string tmp = filename + ".tmp" + std::to_string(getpid());
+  std::ofstream out(tmp, std::ios::binary);
+  if (!out) {
+    throw std::runtime_error("Failed to write asset bundle: " + filename);
+  }
+
+  out.write(kMagic, sizeof(kMagic));
+  uint32_t count = mEntries.size();
+  out.write(reinterpret_cast<char const *>(&kVersion), sizeof(kVersion));
+  out.write(reinterpret_cast<char const *>(&count), sizeof(count));
+
+  uint64_t offset = headerSize;
+  std::vector<uint64_t> offsets;
+  for (auto &[name, data] : mEntries) {
+    offset = (offset + kAlignment - 1) / kAlignment * kAlignment;
+    offsets.push_back(offset);
+    uint32_t nameSize = name.size();
+    uint64_t size = data.size();
+    out.write(reinterpret_cast<char const *>(&nameSize), sizeof(nameSize));
+    out.write(name.data(), nameSize);
+    out.write(reinterpret_cast<char const *>(&offset), sizeof(offset));
+    out.write(reinterpret_cast<char const *>(&size), sizeof(size));
+    offset += size;
+  }
+
+  uint64_t position = headerSize;
+  uint32_t i = 0;
+  for (auto &[name, data] : mEntries) {
+    std::string padding(offsets[i++] - position, '\0');
+    out.write(padding.data(), padding.size());
+    out.write(data.data(), data.size());
+    position += padding.size() + data.size();
+  }
+
+  out.close();
+  if (!out) {
+    std::filesystem::remove(tmp);
+    throw std::runtime_error("Failed to write asset bundle: " + filename);
+  }
+  std::filesystem::rename(tmp, filename);
+}
+
+} // namespace sapien
@@ -0,0 +1,59 @@
+#pragma once
+#include <map>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+namespace sapien {
+
+/** Read-only view of an asset bundle file mapped into memory
+ *
+ *  A bundle is a small index of named entries followed by their contents, each aligned to 16
+ *  bytes. Entries are returned as views into the mapping, which stays valid as long as the
+ *  bundle is alive.
+ */
+class AssetBundle {
+  void *mData{nullptr};
+  size_t mSize{0};
+  std::map<std::string, std::string_view, std::less<>> mEntries;
+
+public:
+  /** map the file, throws if it cannot be opened or is not a bundle */
+  explicit AssetBundle(std::string const &filename);
+  AssetBundle(AssetBundle const &) = delete;
+  AssetBundle &operator=(AssetBundle const &) = delete;
+  ~AssetBundle();
+
+  inline bool has(std::string_view name) const { return mEntries.find(name) != mEntries.end(); }
+
+  /** entry content, empty if there is no entry with this name */
+  std::string_view get(std::string_view name) const;
+
+  inline std::map<std::string, std::string_view, std::less<>> const &getEntries() const {
+    return mEntries;
+  }
+};
+
+/** Collects named entries and writes them as an asset bundle */
+class AssetBundleWriter {
+  std::map<std::string, std::string> mEntries;
+
+public:
+  inline void add(std::string const &name, std::string data) { mEntries[name] = std::move(data); }
+  inline bool has(std::string const &name) const { return mEntries.count(name); }
+
+  /** write to a temporary file and rename it into place */
+  void write(std::string const &filename) const;
+};
+
+/** std::istream buffer reading a memory range without copying it */
+class MemoryStreamBuffer : public std::streambuf {
+public:
+  explicit MemoryStreamBuffer(std::string_view data) {
+    char *begin = const_cast<char *>(data.data());
+    setg(begin, begin, begin + data.size());
+  }
+};
+
+} // namespace sapien
@@ -0,0 +1,294 @@
+#include "convex_decomposition.h"
+#include "utils/thread_pool.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <deque>
+#include <mutex>
+#include <unordered_set>
+
+namespace sapien {
+using namespace physx;
+
+namespace {
+
+struct VoxelGrid {
+  PxVec3 origin;
+  PxReal size;
+  int nx, ny, nz;
+
+  inline int index(int x, int y, int z) const { return x + nx * (y + ny * z); }
+  inline void coords(int i, int c[3]) const {
+    c[0] = i % nx;
+    c[1] = (i / nx) % ny;
+    c[2] = i / (nx * ny);
+  }
+  inline int count() const { return nx * ny * nz; }
+};
+
+/* Candidate cuts are scored on several threads. Hulls are cooked into a stream, which the
+ * cooking library allows concurrently, and only inserting the mesh into the physics object is
+ * serialized. */
+PxReal hullVolume(std::vector<PxVec3> const &points, PxCooking &cooking, PxPhysics &physics) {
+  if (points.size() < 4) {
+    return 0.f;
+  }
+  PxConvexMeshDesc desc;
+  desc.points.count = points.size();
+  desc.points.stride = sizeof(PxVec3);
+  desc.points.data = points.data();
+  desc.flags = PxConvexFlag::eCOMPUTE_CONVEX;
+  desc.vertexLimit = 256;
+  PxDefaultMemoryOutputStream buf;
+  if (!cooking.cookConvexMesh(desc, buf)) {
+    // flat or degenerate point set
+    return 0.f;
+  }
+  PxConvexMesh *mesh;
+  {
+    static std::mutex insertionLock;
+    std::lock_guard<std::mutex> lock(insertionLock);
+    PxDefaultMemoryInputData input(buf.getData(), buf.getSize());
+    mesh = physics.createConvexMesh(input);
+  }
+  if (!mesh) {
+    return 0.f;
+  }
+  PxReal mass;
+  PxMat33 inertia;
+  PxVec3 com;
+  mesh->getMassInformation(mass, inertia, com);
+  mesh->release();
+  return mass;
+}
+
+/* corners of the voxels on the boundary of a part, their hull contains the part */
+template <typename InPart>
+std::vector<PxVec3> boundaryCorners(VoxelGrid const &grid, std::vector<int> const &voxels,
+                                    InPart const &inPart) {
+  std::vector<PxVec3> points;
+  std::unordered_set<int64_t> seen;
+  int64_t cx = grid.nx + 1, cy = grid.ny + 1;
+  for (int v : voxels) {
+    int c[3];
+    grid.coords(v, c);
+    bool boundary = false;
+    for (int d = 0; d < 3 && !boundary; ++d) {
+      for (int s : {-1, 1}) {
+        int n[3] = {c[0], c[1], c[2]};
+        n[d] += s;
+        if (!inPart(grid.index(n[0], n[1], n[2]))) {
+          boundary = true;
+          break;
+        }
+      }
+    }
+    if (!boundary) {
+      continue;
+    }
+    for (int dz = 0; dz < 2; ++dz) {
+      for (int dy = 0; dy < 2; ++dy) {
+        for (int dx = 0; dx < 2; ++dx) {
+          int64_t key = (c[0] + dx) + cx * ((c[1] + dy) + cy * (c[2] + dz));
+          if (seen.insert(key).second) {
+            points.push_back(grid.origin + PxVec3(c[0] + dx, c[1] + dy, c[2] + dz) * grid.size);
+          }
+        }
+      }
+    }
+  }
+  return points;
+}
+
+} // namespace
+
+std::vector<std::vector<PxVec3>> decomposeConvex(std::vector<PxVec3> const &vertices,
+                                                 std::vector<PxU32> const &triangles,
+                                                 ConvexDecompositionConfig const &config,
+                                                 PxCooking &cooking, PxPhysics &physics) {
+  if (vertices.empty()) {
+    return {};
+  }
+  PxBounds3 bounds = PxBounds3::empty();
+  for (auto &v : vertices) {
+    bounds.include(v);
+  }
+  PxVec3 extents = bounds.getDimensions();
+  PxReal longest = extents.maxElement();
+  if (longest <= 0.f || triangles.size() < 3) {
+    return {vertices};
+  }
+
+  // grid with one empty voxel of padding on each side
+  VoxelGrid grid;
+  grid.size = longest / std::max(config.resolution, 1u);
+  grid.origin = bounds.minimum - PxVec3(grid.size);
+  grid.nx = static_cast<int>(std::ceil(extents.x / grid.size)) + 2;
+  grid.ny = static_cast<int>(std::ceil(extents.y / grid.size)) + 2;
+  grid.nz = static_cast<int>(std::ceil(extents.z / grid.size)) + 2;
+  auto voxelOf = [&](PxVec3 const &p) {
+    PxVec3 q = (p - grid.origin) / grid.size;
+    int x = std::clamp(static_cast<int>(q.x), 1, grid.nx - 2);
+    int y = std::clamp(static_cast<int>(q.y), 1, grid.ny - 2);
+    int z = std::clamp(static_cast<int>(q.z), 1, grid.nz - 2);
+    return grid.index(x, y, z);
+  };
+
+  // surface voxels from points sampled on the triangles at half voxel spacing
+  enum : uint8_t { kEmpty, kSurface, kOutside };
+  std::vector<uint8_t> state(grid.count(), kEmpty);
+  std::vector<PxVec3> samples;
+  std::vector<int> sampleVoxels;
+  for (size_t t = 0; t + 2 < triangles.size(); t += 3) {
+    PxVec3 a = vertices[triangles[t]];
+    PxVec3 b = vertices[triangles[t + 1]];
+    PxVec3 c = vertices[triangles[t + 2]];
+    PxReal edge = std::max({(b - a).magnitude(), (c - a).magnitude(), (c - b).magnitude()});
+    int n = std::max(1, static_cast<int>(std::ceil(2.f * edge / grid.size)));
+    for (int i = 0; i <= n; ++i) {
+      for (int j = 0; i + j <= n; ++j) {
+        PxVec3 p = a + (b - a) * (PxReal(i) / n) + (c - a) * (PxReal(j) / n);
+        int v = voxelOf(p);
+        state[v] = kSurface;
+        samples.push_back(p);
+        sampleVoxels.push_back(v);
+      }
+    }
+  }
+
+  // flood fill the outside, everything else is solid
+  std::deque<int> queue{0};
+  state[0] = kOutside;
+  while (!queue.empty()) {
+    int v = queue.front();
+    queue.pop_front();
+    int c[3];
+    grid.coords(v, c);
+    for (int d = 0; d < 3; ++d) {
+      for (int s : {-1, 1}) {
+        int n[3] = {c[0], c[1], c[2]};
+        n[d] += s;
+        if (n[0] < 0 || n[1] < 0 || n[2] < 0 || n[0] >= grid.nx || n[1] >= grid.ny ||
+            n[2] >= grid.nz) {
+          continue;
+        }
+        int ni = grid.index(n[0], n[1], n[2]);
+        if (state[ni] == kEmpty) {
+          state[ni] = kOutside;
+          queue.push_back(ni);
+        }
+      }
+    }
+  }
+
+  std::vector<int> label(grid.count(), -1);
+  std::vector<std::vector<int>> parts(1);
+  for (int v = 0; v < grid.count(); ++v) {
+    if (state[v] != kOutside) {
+      label[v] = 0;
+      parts[0].push_back(v);
+    }
+  }
+
+  PxReal voxelVolume = grid.size * grid.size * grid.size;
+  auto concavity = [&](std::vector<int> const &voxels, auto const &inPart) {
+    PxReal hull = hullVolume(boundaryCorners(grid, voxels, inPart), cooking, physics);
+    return std::max(0.f, hull - voxels.size() * voxelVolume);
+  };
+
+  std::vector<PxReal> concavities = {
+      concavity(parts[0], [&](int v) { return label[v] == 0; })};
+  PxReal threshold = config.maxConcavity * hullVolume(vertices, cooking, physics);
+
+  while (parts.size() < config.maxConvexHulls) {
+    int worst = std::max_element(concavities.begin(), concavities.end()) - concavities.begin();
+    if (concavities[worst] <= threshold) {
+      break;
+    }
+    auto &voxels = parts[worst];
+
+    int lo[3] = {grid.nx, grid.ny, grid.nz}, hi[3] = {0, 0, 0};
+    for (int v : voxels) {
+      int c[3];
+      grid.coords(v, c);
+      for (int d = 0; d < 3; ++d) {
+        lo[d] = std::min(lo[d], c[d]);
+        hi[d] = std::max(hi[d], c[d]);
+      }
+    }
+
+    // candidate planes: voxels with coordinate < cut go to the first half
+    std::vector<std::pair<int, int>> candidates;
+    for (int d = 0; d < 3; ++d) {
+      int span = hi[d] - lo[d] + 1;
+      int last = -1;
+      for (uint32_t k = 1; k <= config.planeSamples; ++k) {
+        int cut = lo[d] + static_cast<int>(span * k / (config.planeSamples + 1));
+        if (cut > lo[d] && cut <= hi[d] && cut != last) {
+          candidates.push_back({d, cut});
+          last = cut;
+        }
+      }
+    }
+    if (candidates.empty()) {
+      // a single voxel wide part cannot be cut
+      concavities[worst] = 0.f;
+      continue;
+    }
+
+    std::vector<PxReal> costs(candidates.size());
+    std::vector<std::array<PxReal, 2>> halves(candidates.size());
+    parallelFor(defaultThreadPool(), candidates.size(), 1, [&](size_t i, size_t) {
+      int d = candidates[i].first, cut = candidates[i].second;
+      std::vector<int> sides[2];
+      for (int v : voxels) {
+        int c[3];
+        grid.coords(v, c);
+        sides[c[d] < cut ? 0 : 1].push_back(v);
+      }
+      for (int s = 0; s < 2; ++s) {
+        halves[i][s] = concavity(sides[s], [&](int v) {
+          if (label[v] != worst) {
+            return false;
+          }
+          int c[3];
+          grid.coords(v, c);
+          return (c[d] < cut ? 0 : 1) == s;
+        });
+      }
+      costs[i] = halves[i][0] + halves[i][1];
+    });
+
+    uint32_t best = std::min_element(costs.begin(), costs.end()) - costs.begin();
+    int d = candidates[best].first, cut = candidates[best].second;
+    std::vector<int> first, second;
+    for (int v : voxels) {
+      int c[3];
+      grid.coords(v, c);
+      (c[d] < cut ? first : second).push_back(v);
+    }
+    int newLabel = parts.size();
+    for (int v : second) {
+      label[v] = newLabel;
+    }
+    parts[worst] = std::move(first);
+    concavities[worst] = halves[best][0];
+    parts.push_back(std::move(second));
+    concavities.push_back(halves[best][1]);
+  }
+
+  // final hulls from the surface samples of each part, voxel corners for interior parts
+  std::vector<std::vector<PxVec3>> result(parts.size());
+  for (size_t i = 0; i < samples.size(); ++i) {
+    result[label[sampleVoxels[i]]].push_back(samples[i]);
+  }
+  for (size_t p = 0; p < parts.size(); ++p) {
+    if (result[p].size() < 4) {
+      int l = p;
+      result[p] = boundaryCorners(grid, parts[p], [&](int v) { return label[v] == l; });
+    }
+  }
+  return result;
+}
+
+} // namespace sapien
@@ -0,0 +1,35 @@
+#pragma once
+#include <PxPhysicsAPI.h>
+#include <vector>
+
+namespace sapien {
+
+struct ConvexDecompositionConfig {
+  /* voxels along the longest side of the mesh bounding box */
+  uint32_t resolution = 32;
+
+  /* upper bound on the number of convex parts */
+  uint32_t maxConvexHulls = 16;
+
+  /* stop splitting when every part's hull exceeds its voxels by less than this fraction of the
+   * hull volume of the whole mesh */
+  float maxConcavity = 0.01f;
+
+  /* candidate cutting planes per axis */
+  uint32_t planeSamples = 8;
+};
+
+/** Approximate convex decomposition of a closed triangle mesh
+ *
+ *  The mesh is voxelized and recursively cut by axis-aligned planes, always splitting the part
+ *  whose convex hull covers the most empty space, at the plane minimizing the summed
+ *  concavity of both halves. Candidate planes are evaluated on several threads. Returns the
+ *  points of each part; their convex hulls approximate the mesh.
+ */
+std::vector<std::vector<physx::PxVec3>>
+decomposeConvex(std::vector<physx::PxVec3> const &vertices,
+                std::vector<physx::PxU32> const &triangles,
+                ConvexDecompositionConfig const &config, physx::PxCooking &cooking,
+                physx::PxPhysics &physics);
+
+} // namespace sapien
@@ -0,0 +1,726 @@
+#include "depth_processor.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+namespace sapien {
+
+static constexpr uint16_t kCostSentinel = 0x7fff;
+
+template <typename F>
+void StereoDepthProcessor::parallelFor(size_t count, size_t grain, F const &fn) {
+  sapien::parallelFor(mThreadPool, count, grain, fn);
+}
+
+StereoDepthProcessor::StereoDepthProcessor(
+    uint32_t width, uint32_t height, Eigen::Matrix3f const &leftIntrinsic,
+    Eigen::Matrix3f const &rightIntrinsic, Eigen::Matrix4f const &leftExtrinsic,
+    Eigen::Matrix4f const &rightExtrinsic, uint32_t mainWidth, uint32_t mainHeight,
+    Eigen::Matrix3f const &mainIntrinsic, Eigen::Matrix4f const &mainExtrinsic,
+    StereoDepthConfig const &config, uint32_t threadCount)
+    : mWidth(width), mHeight(height), mMainWidth(mainWidth), mMainHeight(mainHeight),
+      mIntrinsic(leftIntrinsic), mRightIntrinsic(rightIntrinsic),
+      mMainIntrinsic(mainIntrinsic), mConfig(config),
+      mThreadPool(threadCount ? threadCount : std::thread::hardware_concurrency()) {
+  if (width == 0 || height == 0 || mainWidth == 0 || mainHeight == 0) {
+    throw std::invalid_argument("stereo depth: image size must not be 0");
+  }
+  if (config.maxDisparity == 0 || config.maxDisparity % 16 != 0) {
+    throw std::invalid_argument("stereo depth: max disparity must be a positive multiple of 16");
+  }
+  if (config.censusSize != 3 && config.censusSize != 5 && config.censusSize != 7) {
+    throw std::invalid_argument("stereo depth: census size must be 3, 5 or 7");
+  }
+  // aggregated costs of 8 paths must fit 16 bits
+  if (config.penalty1 >= config.penalty2 || config.penalty2 > 8000) {
+    throw std::invalid_argument("stereo depth: penalties must satisfy p1 < p2 <= 8000");
+  }
+  if (config.medianSize != 0 && (config.medianSize % 2 == 0 || config.medianSize > 7)) {
+    throw std::invalid_argument("stereo depth: median size must be 0, 3, 5 or 7");
+  }
+
+  // right camera in the left camera frame
+  Eigen::Matrix4f leftFromRight = leftExtrinsic * rightExtrinsic.inverse();
+  if (!leftFromRight.block<3, 3>(0, 0).isApprox(Eigen::Matrix3f::Identity(), 1e-5f)) {
+    throw std::invalid_argument("stereo depth: extrinsics contain rotation");
+  }
+  Eigen::Vector3f t = leftFromRight.block<3, 1>(0, 3);
+  if (t.y() * t.y() + t.z() * t.z() >= 2e-4f) {
+    throw std::invalid_argument("stereo depth: extrinsics contain translation off the x axis");
+  }
+  if (t.x() <= 0.f) {
+    throw std::invalid_argument("stereo depth: the right camera must be on the +x side");
+  }
+  mBaseline = t.x();
+  mRectifyRight = !rightIntrinsic.isApprox(leftIntrinsic);
+  mMainFromLeft = mainExtrinsic * leftExtrinsic.inverse();
+}
+
+std::vector<float> StereoDepthProcessor::compute(std::vector<uint8_t> const &left,
+                                                 std::vector<uint8_t> const &right) {
+  std::vector<float> disparity;
+  if (mConfig.useNoise) {
+    uint64_t seed = mConfig.seed + 2 * mFrame++;
+    disparity = computeDisparity(addNoise(left, seed), addNoise(right, seed + 1));
+  } else {
+    disparity = computeDisparity(left, right);
+  }
+
+  auto depth = disparityToDepth(disparity);
+  uint32_t width = mWidth, height = mHeight;
+  if (mConfig.registerDepth) {
+    depth = registerDepth(depth);
+    width = mMainWidth;
+    height = mMainHeight;
+    if (mConfig.medianSize) {
+      depth = medianFilter(depth, width, height);
+    }
+  }
+  for (auto &z : depth) {
+    if (z < mConfig.minDepth || z > mConfig.maxDepth) {
+      z = 0.f;
+    }
+  }
+  return depth;
+}
+
+//========= IR noise =========//
+
+static std::vector<float> resizeBilinear(std::vector<float> const &src, uint32_t srcWidth,
+                                         uint32_t srcHeight, uint32_t width, uint32_t height) {
+  std::vector<float> dst(static_cast<size_t>(width) * height);
+  float sx = static_cast<float>(srcWidth) / width;
+  float sy = static_cast<float>(srcHeight) / height;
+  for (uint32_t y = 0; y < height; ++y) {
+    float fy = std::clamp((y + 0.5f) * sy - 0.5f, 0.f, srcHeight - 1.f);
+    uint32_t y0 = static_cast<uint32_t>(fy);
+    uint32_t y1 = std::min(y0 + 1, srcHeight - 1);
+    float wy = fy - y0;
+    for (uint32_t x = 0; x < width; ++x) {
+      float fx = std::clamp((x + 0.5f) * sx - 0.5f, 0.f, srcWidth - 1.f);
+      uint32_t x0 = static_cast<uint32_t>(fx);
+      uint32_t x1 = std::min(x0 + 1, srcWidth - 1);
+      float wx = fx - x0;
+      float top = src[y0 * srcWidth + x0] * (1 - wx) + src[y0 * srcWidth + x1] * wx;
+      float bottom = src[y1 * srcWidth + x0] * (1 - wx) + src[y1 * srcWidth + x1] * wx;
+      dst[y * width + x] = top * (1 - wy) + bottom * wy;
+    }
+  }
+  return dst;
+}
+
+static void gaussianBlur(std::vector<float> &image, uint32_t width, uint32_t height,
+                         uint32_t size, float sigma) {
+  int half = size / 2;
+  std::vector<float> kernel(2 * half + 1);
+  float sum = 0.f;
+  for (int i = -half; i <= half; ++i) {
+    kernel[i + half] = std::exp(-0.5f * i * i / (sigma * sigma));
+    sum += kernel[i + half];
+  }
+  for (auto &k : kernel) {
+    k /= sum;
+  }
+  auto clampX = [width](int x) { return std::clamp(x, 0, static_cast<int>(width) - 1); };
+  auto clampY = [height](int y) { return std::clamp(y, 0, static_cast<int>(height) - 1); };
+
+  std::vector<float> tmp(image.size());
+  for (int y = 0; y < static_cast<int>(height); ++y) {
+    for (int x = 0; x < static_cast<int>(width); ++x) {
+      float v = 0.f;
+      for (int i = -half; i <= half; ++i) {
+        v += kernel[i + half] * image[y * width + clampX(x + i)];
+      }
+      tmp[y * width + x] = v;
+    }
+  }
+  for (int y = 0; y < static_cast<int>(height); ++y) {
+    for (int x = 0; x < static_cast<int>(width); ++x) {
+      float v = 0.f;
+      for (int i = -half; i <= half; ++i) {
+        v += kernel[i + half] * tmp[clampY(y + i) * width + x];
+      }
+      image[y * width + x] = v;
+    }
+  }
+}
+
+std::vector<uint8_t> StereoDepthProcessor::addNoise(std::vector<uint8_t> const &image,
+                                                    uint64_t seed) {
+  if (image.size() != static_cast<size_t>(mWidth) * mHeight) {
+    throw std::invalid_argument("stereo depth: IR image size does not match the cameras");
+  }
+  std::vector<float> values(image.begin(), image.end());
+
+  if (mConfig.noiseScale > 0.f) {
+    // resample through a smaller image to emulate soft intensity
+    uint32_t w = std::max(1u, static_cast<uint32_t>(mWidth * mConfig.noiseScale));
+    uint32_t h = std::max(1u, static_cast<uint32_t>(mHeight * mConfig.noiseScale));
+    auto small = resizeBilinear(values, mWidth, mHeight, w, h);
+    if (mConfig.noiseBlurSize > 0) {
+      gaussianBlur(small, w, h, mConfig.noiseBlurSize, mConfig.noiseBlurSigma);
+    }
+    values = resizeBilinear(small, w, h, mWidth, mHeight);
+    for (auto &v : values) {
+      v = std::round(std::clamp(v, 0.f, 255.f));
+    }
+  }
+
+  // every block of rows has its own generator so the noise does not depend on threads
+  constexpr uint32_t rowsPerBlock = 16;
+  std::vector<uint8_t> result(image.size());
+  parallelFor(mHeight, rowsPerBlock, [&](size_t rowBegin, size_t rowEnd) {
+    std::mt19937_64 rng(seed * 0x9e3779b97f4a7c15ull + rowBegin / rowsPerBlock);
+    std::gamma_distribution<float> speckle(mConfig.speckleShape, mConfig.speckleScale);
+    std::normal_distribution<float> gaussian(mConfig.gaussianMu, mConfig.gaussianSigma);
+    for (size_t i = rowBegin * mWidth; i < rowEnd * mWidth; ++i) {
+      float v = values[i] * speckle(rng) + gaussian(rng);
+      result[i] = static_cast<uint8_t>(std::clamp(v, 0.f, 255.f));
+    }
+  });
+  return result;
+}
+
+//========= matching =========//
+
+std::vector<uint8_t> StereoDepthProcessor::rectifyRight(std::vector<uint8_t> const &image) {
+  // pure translation along x: resample the right image into the left intrinsics
+  Eigen::Matrix3f map = mRightIntrinsic * mIntrinsic.inverse();
+  std::vector<uint8_t> result(image.size());
+  parallelFor(mHeight, 16, [&](size_t rowBegin, size_t rowEnd) {
+    for (size_t y = rowBegin; y < rowEnd; ++y) {
+      for (size_t x = 0; x < mWidth; ++x) {
+        Eigen::Vector3f p = map * Eigen::Vector3f(x, y, 1.f);
+        float u = p.x() / p.z(), v = p.y() / p.z();
+        int u0 = static_cast<int>(std::floor(u)), v0 = static_cast<int>(std::floor(v));
+        if (u0 < 0 || v0 < 0 || u0 + 1 >= static_cast<int>(mWidth) ||
+            v0 + 1 >= static_cast<int>(mHeight)) {
+          result[y * mWidth + x] = 0;
+          continue;
+        }
+        float wu = u - u0, wv = v - v0;
+        auto at = [&](int xx, int yy) { return static_cast<float>(image[yy * mWidth + xx]); };
+        float value = (at(u0, v0) * (1 - wu) + at(u0 + 1, v0) * wu) * (1 - wv) +
+                      (at(u0, v0 + 1) * (1 - wu) + at(u0 + 1, v0 + 1) * wu) * wv;
+        result[y * mWidth + x] = static_cast<uint8_t>(value + 0.5f);
+      }
+    }
+  });
+  return result;
+}
+
+void StereoDepthProcessor::census(std::vector<uint8_t> const &image, std::vector<uint64_t> &out) {
+  int half = mConfig.censusSize / 2;
+  int width = mWidth, height = mHeight;
+  out.assign(image.size(), 0);
+  // bits in row-major window order, set where the neighbor is not darker than the center
+  parallelFor(mHeight, 16, [&](size_t rowBegin, size_t rowEnd) {
+    int yBegin = std::max(static_cast<int>(rowBegin), half);
+    int yEnd = std::min(static_cast<int>(rowEnd), height - half);
+    for (int y = yBegin; y < yEnd; ++y) {
+      uint8_t const *center = &image[y * width];
+      uint64_t *bits = &out[y * width];
+      // one window offset at a time so the loop over the row is vectorized
+      for (int v = -half; v <= half; ++v) {
+        for (int u = -half; u <= half; ++u) {
+          if (u == 0 && v == 0) {
+            continue;
+          }
+          uint8_t const *neighbor = &image[(y + v) * width + u];
+          for (int x = half; x < width - half; ++x) {
+            bits[x] = (bits[x] << 1) | (neighbor[x] >= center[x]);
+          }
+        }
+      }
+    }
+  });
+}
+
+//========= kernels =========//
+// The x86-64 baseline has neither popcnt nor the 16 bit min reductions of SSE4.1, so the
+// kernels are also compiled for newer CPUs and picked at runtime.
+
+/** costs of one row, the maximum cost where x - d is outside the image */
+__attribute__((always_inline)) static inline void costRow(uint64_t const *left,
+                                                         uint64_t const *right, uint8_t *cost,
+                                                         uint32_t width, uint32_t disparities,
+                                                         uint8_t maxCost) {
+  for (uint32_t x = 0; x < width; ++x) {
+    uint8_t *pixelCost = cost + static_cast<size_t>(x) * disparities;
+    uint32_t valid = std::min(x + 1, disparities);
+    for (uint32_t d = 0; d < valid; ++d) {
+      pixelCost[d] = static_cast<uint8_t>(std::popcount(left[x] ^ right[x - d]));
+    }
+    std::fill(pixelCost + valid, pixelCost + disparities, maxCost);
+  }
+}
+
+/** first pixel of a path, returns the minimum of its costs */
+template <bool Accumulate>
+__attribute__((always_inline)) static inline uint16_t
+pathStart(uint8_t const *__restrict cost, uint16_t *__restrict current, uint16_t *__restrict sum,
+          uint32_t disparities) {
+  uint16_t minCurrent = kCostSentinel;
+  for (size_t d = 0; d < disparities; ++d) {
+    uint16_t value = cost[d];
+    current[d] = value;
+    sum[d] = Accumulate ? sum[d] + value : value;
+    minCurrent = value < minCurrent ? value : minCurrent;
+  }
+  return minCurrent;
+}
+
+/** next pixel of a path, returns the minimum of its costs
+ *
+ *  previous holds disparities + 2 costs with sentinels on both ends. Plain 16 bit selects on
+ *  unaliased pointers and a 64 bit index let the compiler vectorize the disparity loop.
+ */
+template <bool Accumulate>
+__attribute__((always_inline)) static inline uint16_t
+pathStep(uint8_t const *__restrict cost, uint16_t const *__restrict previous,
+         uint16_t minPrevious, uint16_t *__restrict current, uint16_t *__restrict sum,
+         uint32_t disparities, uint16_t p1, uint16_t p2) {
+  uint16_t jump = minPrevious + p2;
+  uint16_t minCurrent = kCostSentinel;
+  for (size_t d = 0; d < disparities; ++d) {
+    uint16_t side = (previous[d] < previous[d + 2] ? previous[d] : previous[d + 2]) + p1;
+    uint16_t best = previous[d + 1] < side ? previous[d + 1] : side;
+    best = best < jump ? best : jump;
+    uint16_t value = cost[d] + best - minPrevious;
+    current[d] = value;
+    sum[d] = Accumulate ? sum[d] + value : value;
+    minCurrent = value < minCurrent ? value : minCurrent;
+  }
+  return minCurrent;
+}
+
+/** both horizontal paths of a row, overwriting its sums; the buffers hold disparities + 2 */
+__attribute__((always_inline)) static inline void
+horizontalRow(uint8_t const *cost, uint16_t *sum, uint16_t *previous, uint16_t *current,
+              uint32_t width, uint32_t disparities, uint16_t p1, uint16_t p2) {
+  uint16_t minPrevious = pathStart<false>(cost, previous + 1, sum, disparities);
+  for (uint32_t x = 1; x < width; ++x) {
+    size_t offset = static_cast<size_t>(x) * disparities;
+    minPrevious = pathStep<false>(cost + offset, previous, minPrevious, current + 1,
+                                  sum + offset, disparities, p1, p2);
+    std::swap(previous, current);
+  }
+  size_t last = static_cast<size_t>(width - 1) * disparities;
+  minPrevious = pathStart<true>(cost + last, previous + 1, sum + last, disparities);
+  for (uint32_t x = width - 1; x-- > 0;) {
+    size_t offset = static_cast<size_t>(x) * disparities;
+    minPrevious = pathStep<true>(cost + offset, previous, minPrevious, current + 1, sum + offset,
+                                 disparities, p1, p2);
+    std::swap(previous, current);
+  }
+}
+
+/** paths entering columns [xBegin, xEnd) of a row from the previous row, path k from column
+ *  x - dxs[k]; path costs of a row are stored per path and column with disparities + 2 entries,
+ *  previous is null for the first row */
+__attribute__((always_inline)) static inline void
+verticalRow(uint8_t const *cost, uint16_t *sum, uint16_t const *previous,
+            uint16_t const *previousMin, uint16_t *current, uint16_t *currentMin, int const *dxs,
+            uint32_t paths, uint32_t xBegin, uint32_t xEnd, uint32_t width, uint32_t disparities,
+            uint16_t p1, uint16_t p2) {
+  size_t stride = disparities + 2;
+  for (uint32_t x = xBegin; x < xEnd; ++x) {
+    size_t offset = static_cast<size_t>(x) * disparities;
+    for (uint32_t k = 0; k < paths; ++k) {
+      int px = static_cast<int>(x) - dxs[k];
+      size_t slot = k * width + x;
+      if (!previous || px < 0 || px >= static_cast<int>(width)) {
+        currentMin[slot] =
+            pathStart<true>(cost + offset, current + slot * stride + 1, sum + offset, disparities);
+      } else {
+        size_t from = k * width + px;
+        currentMin[slot] = pathStep<true>(cost + offset, previous + from * stride,
+                                          previousMin[from], current + slot * stride + 1,
+                                          sum + offset, disparities, p1, p2);
+      }
+    }
+  }
+}
+
+/** best disparity of each left pixel of a row, -1 where not unique, and the best disparity of
+ *  each right pixel over the left pixels matching it */
+__attribute__((always_inline)) static inline void
+selectRow(uint16_t const *sum, uint32_t width, uint32_t disparities, uint32_t uniqueness,
+          int *best, uint16_t *__restrict minRight, uint16_t *__restrict right) {
+  std::fill(minRight, minRight + width, UINT16_MAX);
+  for (size_t x = 0; x < width; ++x) {
+    uint16_t const *__restrict cost = sum + x * disparities;
+    size_t valid = std::min<size_t>(x + 1, disparities);
+    uint16_t minCost = UINT16_MAX;
+    for (size_t d = 0; d < valid; ++d) {
+      minCost = cost[d] < minCost ? cost[d] : minCost;
+    }
+    size_t bestD = std::find(cost, cost + valid, minCost) - cost;
+
+    // unique when no disparity beyond the neighbors comes within the ratio
+    uint16_t minOther = UINT16_MAX;
+    for (size_t d = 0; d + 1 < bestD; ++d) {
+      minOther = cost[d] < minOther ? cost[d] : minOther;
+    }
+    for (size_t d = bestD + 2; d < valid; ++d) {
+      minOther = cost[d] < minOther ? cost[d] : minOther;
+    }
+    best[x] = minOther * (100 - uniqueness) < minCost * 100u ? -1 : static_cast<int>(bestD);
+
+    // right pixel j is matched by disparity x - j, the smallest disparity wins ties
+    for (size_t j = x + 1 - valid; j <= x; ++j) {
+      uint16_t value = cost[x - j];
+      bool better = value < minRight[j];
+      minRight[j] = better ? value : minRight[j];
+      right[j] = better ? static_cast<uint16_t>(x - j) : right[j];
+    }
+  }
+}
+
+__attribute__((target("popcnt"))) static void
+costRowPopcnt(uint64_t const *left, uint64_t const *right, uint8_t *cost, uint32_t width,
+              uint32_t disparities, uint8_t maxCost) {
+  costRow(left, right, cost, width, disparities, maxCost);
+}
+
+static void costRowDefault(uint64_t const *left, uint64_t const *right, uint8_t *cost,
+                           uint32_t width, uint32_t disparities, uint8_t maxCost) {
+  costRow(left, right, cost, width, disparities, maxCost);
+}
+
+__attribute__((target("avx2"))) static void
+horizontalRowAVX2(uint8_t const *cost, uint16_t *sum, uint16_t *previous, uint16_t *current,
+                  uint32_t width, uint32_t disparities, uint16_t p1, uint16_t p2) {
+  horizontalRow(cost, sum, previous, current, width, disparities, p1, p2);
+}
+
+static void horizontalRowDefault(uint8_t const *cost, uint16_t *sum, uint16_t *previous,
+                                 uint16_t *current, uint32_t width, uint32_t disparities,
+                                 uint16_t p1, uint16_t p2) {
+  horizontalRow(cost, sum, previous, current, width, disparities, p1, p2);
+}
+
+__attribute__((target("avx2"))) static void
+verticalRowAVX2(uint8_t const *cost, uint16_t *sum, uint16_t const *previous,
+                uint16_t const *previousMin, uint16_t *current, uint16_t *currentMin,
+                int const *dxs, uint32_t paths, uint32_t xBegin, uint32_t xEnd, uint32_t width,
+                uint32_t disparities, uint16_t p1, uint16_t p2) {
+  verticalRow(cost, sum, previous, previousMin, current, currentMin, dxs, paths, xBegin, xEnd,
+              width, disparities, p1, p2);
+}
+
+static void verticalRowDefault(uint8_t const *cost, uint16_t *sum, uint16_t const *previous,
+                               uint16_t const *previousMin, uint16_t *current,
+                               uint16_t *currentMin, int const *dxs, uint32_t paths,
+                               uint32_t xBegin, uint32_t xEnd, uint32_t width,
+                               uint32_t disparities, uint16_t p1, uint16_t p2) {
+  verticalRow(cost, sum, previous, previousMin, current, currentMin, dxs, paths, xBegin, xEnd,
+              width, disparities, p1, p2);
+}
+
+__attribute__((target("avx2"))) static void selectRowAVX2(uint16_t const *sum, uint32_t width,
+                                                         uint32_t disparities, uint32_t uniqueness,
+                                                         int *best, uint16_t *minRight,
+                                                         uint16_t *right) {
+  selectRow(sum, width, disparities, uniqueness, best, minRight, right);
+}
+
+static void selectRowDefault(uint16_t const *sum, uint32_t width, uint32_t disparities,
+                             uint32_t uniqueness, int *best, uint16_t *minRight,
+                             uint16_t *right) {
+  selectRow(sum, width, disparities, uniqueness, best, minRight, right);
+}
+
+//========= aggregation =========//
+
+void StereoDepthProcessor::computeCost() {
+  static bool const hasPopcnt = __builtin_cpu_supports("popcnt");
+  auto row = hasPopcnt ? costRowPopcnt : costRowDefault;
+
+  uint32_t disparities = mConfig.maxDisparity;
+  uint8_t maxCost = mConfig.censusSize * mConfig.censusSize - 1;
+  size_t rowSize = static_cast<size_t>(mWidth) * disparities;
+  mCost.resize(rowSize * mHeight);
+  parallelFor(mHeight, 8, [&](size_t rowBegin, size_t rowEnd) {
+    for (size_t y = rowBegin; y < rowEnd; ++y) {
+      row(&mCensusLeft[y * mWidth], &mCensusRight[y * mWidth], &mCost[y * rowSize], mWidth,
+          disparities, maxCost);
+    }
+  });
+}
+
+void StereoDepthProcessor::aggregateHorizontal() {
+  static bool const hasAVX2 = __builtin_cpu_supports("avx2");
+  auto row = hasAVX2 ? horizontalRowAVX2 : horizontalRowDefault;
+
+  uint32_t disparities = mConfig.maxDisparity;
+  size_t rowSize = static_cast<size_t>(mWidth) * disparities;
+  parallelFor(mHeight, 8, [&](size_t rowBegin, size_t rowEnd) {
+    std::vector<uint16_t> previous(disparities + 2, kCostSentinel);
+    std::vector<uint16_t> current(disparities + 2, kCostSentinel);
+    for (size_t y = rowBegin; y < rowEnd; ++y) {
+      row(&mCost[y * rowSize], &mAggregated[y * rowSize], previous.data(), current.data(),
+          mWidth, disparities, mConfig.penalty1, mConfig.penalty2);
+    }
+  });
+}
+
+void StereoDepthProcessor::aggregateVertical(int dy) {
+  static bool const hasAVX2 = __builtin_cpu_supports("avx2");
+  auto row = hasAVX2 ? verticalRowAVX2 : verticalRowDefault;
+
+  // paths of direction (dx, dy), rows are visited in order and split into column ranges
+  std::vector<int> dxs = {0};
+  if (mConfig.eightPaths) {
+    dxs.insert(dxs.end(), {1, -1});
+  }
+  uint32_t paths = dxs.size();
+  uint32_t disparities = mConfig.maxDisparity;
+  size_t rowSize = static_cast<size_t>(mWidth) * disparities;
+  size_t bufferSize = paths * mWidth * static_cast<size_t>(disparities + 2);
+  std::vector<uint16_t> previous(bufferSize, kCostSentinel), current(bufferSize, kCostSentinel);
+  std::vector<uint16_t> previousMin(paths * mWidth), currentMin(paths * mWidth);
+  size_t columns = std::max<size_t>(32, (mWidth + mThreadPool.size() - 1) / mThreadPool.size());
+
+  for (uint32_t i = 0; i < mHeight; ++i) {
+    size_t y = dy > 0 ? i : mHeight - 1 - i;
+    parallelFor(mWidth, columns, [&](size_t xBegin, size_t xEnd) {
+      row(&mCost[y * rowSize], &mAggregated[y * rowSize], i ? previous.data() : nullptr,
+          previousMin.data(), current.data(), currentMin.data(), dxs.data(), paths, xBegin,
+          xEnd, mWidth, disparities, mConfig.penalty1, mConfig.penalty2);
+    });
+    std::swap(previous, current);
+    std::swap(previousMin, currentMin);
+  }
+}
+
+std::vector<float> StereoDepthProcessor::selectDisparity() {
+  static bool const hasAVX2 = __builtin_cpu_supports("avx2");
+  auto row = hasAVX2 ? selectRowAVX2 : selectRowDefault;
+
+  uint32_t disparities = mConfig.maxDisparity;
+  int maxDiff = mConfig.maxLeftRightDiff;
+  size_t rowSize = static_cast<size_t>(mWidth) * disparities;
+  std::vector<float> result(static_cast<size_t>(mWidth) * mHeight, -1.f);
+
+  parallelFor(mHeight, 8, [&](size_t rowBegin, size_t rowEnd) {
+    std::vector<int> best(mWidth);
+    std::vector<uint16_t> minRight(mWidth);
+    std::vector<uint16_t> right(mWidth);
+    for (size_t y = rowBegin; y < rowEnd; ++y) {
+      row(&mAggregated[y * rowSize], mWidth, disparities, mConfig.uniquenessRatio, best.data(),
+          minRight.data(), right.data());
+
+      for (uint32_t x = 0; x < mWidth; ++x) {
+        int d = best[x];
+        if (d < 0) {
+          continue;
+        }
+        if (maxDiff >= 0 && std::abs(right[x - d] - d) > maxDiff) {
+          continue;
+        }
+        float disparity = d;
+        uint16_t const *sum = &mAggregated[(y * mWidth + x) * disparities];
+        if (d > 0 && d + 1 < static_cast<int>(std::min(x + 1, disparities))) {
+          // parabola through the neighboring costs
+          int denominator = std::max(sum[d - 1] + sum[d + 1] - 2 * sum[d], 1);
+          disparity += (sum[d - 1] - sum[d + 1]) / (2.f * denominator);
+        }
+        result[y * mWidth + x] = disparity;
+      }
+    }
+  });
+  return result;
+}
+
+void StereoDepthProcessor::filterSpeckles(std::vector<float> &disparity) const {
+  int width = mWidth, height = mHeight;
+  std::vector<int32_t> label(disparity.size(), 0);
+  std::vector<uint8_t> speckle(1, 0); // by label, label 0 is unvisited
+  std::vector<uint32_t> stack;
+  std::vector<uint32_t> region;
+
+  for (uint32_t start = 0; start < disparity.size(); ++start) {
+    if (disparity[start] < 0.f || label[start]) {
+      continue;
+    }
+    int32_t current = speckle.size();
+    region.clear();
+    stack.push_back(start);
+    label[start] = current;
+    while (!stack.empty()) {
+      uint32_t p = stack.back();
+      stack.pop_back();
+      region.push_back(p);
+      int x = p % width, y = p / width;
+      auto visit = [&](int nx, int ny) {
+        if (nx < 0 || ny < 0 || nx >= width || ny >= height) {
+          return;
+        }
+        uint32_t q = ny * width + nx;
+        if (!label[q] && disparity[q] >= 0.f &&
+            std::abs(disparity[q] - disparity[p]) <= mConfig.speckleRange) {
+          label[q] = current;
+          stack.push_back(q);
+        }
+      };
+      visit(x - 1, y);
+      visit(x + 1, y);
+      visit(x, y - 1);
+      visit(x, y + 1);
+    }
+    speckle.push_back(region.size() <= mConfig.speckleWindowSize);
+  }
+  for (size_t i = 0; i < disparity.size(); ++i) {
+    if (label[i] && speckle[label[i]]) {
+      disparity[i] = -1.f;
+    }
+  }
+}
+
+std::vector<float> StereoDepthProcessor::computeDisparity(std::vector<uint8_t> const &left,
+                                                          std::vector<uint8_t> const &right) {
+  size_t size = static_cast<size_t>(mWidth) * mHeight;
+  if (left.size() != size || right.size() != size) {
+    throw std::invalid_argument("stereo depth: IR image size does not match the cameras");
+  }
+  census(left, mCensusLeft);
+  census(mRectifyRight ? rectifyRight(right) : right, mCensusRight);
+  computeCost();
+
+  // the horizontal paths initialize the sums
+  mAggregated.resize(size * mConfig.maxDisparity);
+  aggregateHorizontal();
+  aggregateVertical(1);
+  aggregateVertical(-1);
+
+  auto disparity = selectDisparity();
+  if (mConfig.speckleWindowSize > 0) {
+    filterSpeckles(disparity);
+  }
+  return disparity;
+}
+
+//========= depth =========//
+
+std::vector<float>
+StereoDepthProcessor::disparityToDepth(std::vector<float> const &disparity) const {
+  float scale = mIntrinsic(0, 0) * mBaseline;
+  std::vector<float> depth(disparity.size());
+  for (size_t i = 0; i < disparity.size(); ++i) {
+    depth[i] = disparity[i] >= 1.f ? scale / disparity[i] : 0.f;
+  }
+  return depth;
+}
+
+std::vector<float> StereoDepthProcessor::registerDepth(std::vector<float> const &depth) {
+  Eigen::Matrix3f leftInverse = mIntrinsic.inverse();
+  Eigen::Matrix3f rotation = mMainFromLeft.block<3, 3>(0, 0);
+  Eigen::Vector3f translation = mMainFromLeft.block<3, 1>(0, 3);
+  int width = mMainWidth, height = mMainHeight;
+
+  // positive floats order like their bits, so a z-buffer can use integer atomics
+  std::vector<uint32_t> zbuffer(static_cast<size_t>(width) * height, 0x7f800000);
+  auto write = [&](int u, int v, uint32_t bits) {
+    if (u < 0 || v < 0 || u >= width || v >= height) {
+      return;
+    }
+    std::atomic_ref<uint32_t> target(zbuffer[v * width + u]);
+    uint32_t old = target.load(std::memory_order_relaxed);
+    while (bits < old && !target.compare_exchange_weak(old, bits, std::memory_order_relaxed)) {
+    }
+  };
+
+  parallelFor(mHeight, 16, [&](size_t rowBegin, size_t rowEnd) {
+    for (size_t y = rowBegin; y < rowEnd; ++y) {
+      for (size_t x = 0; x < mWidth; ++x) {
+        float z = depth[y * mWidth + x];
+        if (z <= 0.f) {
+          continue;
+        }
+        Eigen::Vector3f p = rotation * (leftInverse * Eigen::Vector3f(x, y, 1.f) * z) +
+                            translation;
+        if (p.z() <= 0.f) {
+          continue;
+        }
+        Eigen::Vector3f uv = mMainIntrinsic * p;
+        float u = uv.x() / uv.z(), v = uv.y() / uv.z();
+        uint32_t bits = std::bit_cast<uint32_t>(p.z());
+        // dilate to the 4 pixels around the projection to avoid holes when upsampling
+        int u0 = static_cast<int>(std::floor(u)), v0 = static_cast<int>(std::floor(v));
+        write(u0, v0, bits);
+        write(u0 + 1, v0, bits);
+        write(u0, v0 + 1, bits);
+        write(u0 + 1, v0 + 1, bits);
+      }
+    }
+  });
+
+  std::vector<float> result(zbuffer.size());
+  for (size_t i = 0; i < zbuffer.size(); ++i) {
+    result[i] = zbuffer[i] == 0x7f800000 ? 0.f : std::bit_cast<float>(zbuffer[i]);
+  }
+  return result;
+}
+
+/** comparators of Batcher's odd-even merge sort, n is a power of 2 */
+static std::vector<std::pair<uint32_t, uint32_t>> sortingNetwork(uint32_t n) {
+  std::vector<std::pair<uint32_t, uint32_t>> result;
+  for (uint32_t p = 1; p < n; p <<= 1) {
+    for (uint32_t k = p; k >= 1; k >>= 1) {
+      for (uint32_t j = k % p; j + k < n; j += 2 * k) {
+        for (uint32_t i = 0; i < std::min(k, n - j - k); ++i) {
+          if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+            result.push_back({i + j, i + j + k});
+          }
+        }
+      }
+    }
+  }
+  return result;
+}
+
+std::vector<float> StereoDepthProcessor::medianFilter(std::vector<float> const &image,
+                                                      uint32_t width, uint32_t height) {
+  int half = mConfig.medianSize / 2;
+  uint32_t count = mConfig.medianSize * mConfig.medianSize;
+  uint32_t n = std::bit_ceil(count);
+  auto network = sortingNetwork(n);
+
+  std::vector<float> result(image.size());
+  parallelFor(height, 16, [&](size_t rowBegin, size_t rowEnd) {
+    // window element k of every pixel of the row is in row k of the buffer, so the network
+    // runs as element-wise min and max over rows; padding sorts to the end
+    std::vector<float> window(static_cast<size_t>(n) * width);
+    for (int y = rowBegin; y < static_cast<int>(rowEnd); ++y) {
+      float *element = window.data();
+      // replicated border
+      for (int v = -half; v <= half; ++v) {
+        float const *source = &image[std::clamp(y + v, 0, static_cast<int>(height) - 1) * width];
+        for (int u = -half; u <= half; ++u, element += width) {
+          for (int x = 0; x < static_cast<int>(width); ++x) {
+            element[x] = source[std::clamp(x + u, 0, static_cast<int>(width) - 1)];
+          }
+        }
+      }
+      std::fill(element, window.data() + window.size(), std::numeric_limits<float>::infinity());
+
+      for (auto [i, j] : network) {
+        float *__restrict a = &window[i * width];
+        float *__restrict b = &window[j * width];
+        for (uint32_t x = 0; x < width; ++x) {
+          float low = std::min(a[x], b[x]);
+          b[x] = std::max(a[x], b[x]);
+          a[x] = low;
+        }
+      }
+      std::copy_n(&window[count / 2 * width], width, &result[y * width]);
+    }
+  });
+  return result;
+}
+
+} // namespace sapien
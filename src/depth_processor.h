@@ -0,0 +1,119 @@
+#pragma once
+#include "utils/thread_pool.hpp"
+#include <eigen3/Eigen/Eigen>
+#include <limits>
+#include <vector>
+
+namespace sapien {
+
+/** Parameters of the simulated stereo depth sensor, defaults match ActiveLightSensor */
+struct StereoDepthConfig {
+  bool useNoise = false;         // simulate IR noise before matching
+  float noiseScale = 0.f;        // downsampling factor emulating soft intensity, 0: off
+  uint32_t noiseBlurSize = 0;    // gaussian blur kernel size at the downsampled size, 0: off
+  float noiseBlurSigma = 0.03f;  // gaussian blur sigma
+  float speckleShape = 398.12f;  // shape of the multiplicative gamma speckle noise
+  float speckleScale = 2.54e-3f; // scale of the multiplicative gamma speckle noise
+  float gaussianMu = -0.231f;    // mean of the additive gaussian noise
+  float gaussianSigma = 0.83f;   // sigma of the additive gaussian noise
+  uint64_t seed = 0;             // noise seed, advanced by every frame
+
+  uint32_t censusSize = 7;       // census window, 3, 5 or 7
+  uint32_t maxDisparity = 128;   // number of disparities searched, a multiple of 16
+  bool eightPaths = true;        // aggregate 8 directions, 4 (horizontal and vertical) otherwise
+  uint32_t penalty1 = 10;        // SGM penalty for disparity changes of 1
+  uint32_t penalty2 = 120;       // SGM penalty for larger disparity changes
+  uint32_t uniquenessRatio = 10; // percent margin of the best cost over other disparities
+  int32_t maxLeftRightDiff = 1;  // left-right check tolerance in pixels, negative: off
+  uint32_t speckleWindowSize = 100; // disparity regions up to this size are removed, 0: off
+  float speckleRange = 1.f;         // disparity step that separates speckle regions
+
+  bool registerDepth = true;     // reproject depth into the main camera
+  uint32_t medianSize = 5;       // median filter on the registered depth, 0: off
+  float minDepth = 0.f;          // smaller depth is set to 0
+  float maxDepth = std::numeric_limits<float>::infinity(); // larger depth is set to 0
+};
+
+/** Depth of an active stereo sensor from a pair of IR images
+ *
+ *  Native port of sensor/depth_processor.py: IR noise, rectification, semi-global matching
+ *  on census costs with uniqueness, left-right and speckle checks, conversion to depth and
+ *  registration into the main (color) camera followed by a median filter. Cameras use the
+ *  OpenCV convention; extrinsics map world to camera. The IR cameras must differ by a
+ *  translation along their x axis, the right camera on the +x side.
+ *
+ *  Paths are aggregated in three sweeps like OpenCV's full mode: horizontal paths per row, then
+ *  the downward and upward paths row by row. Rows, or the columns of a row, are split over the
+ *  processor's threads and the result does not depend on the thread count. Buffers are kept
+ *  between frames; the costs take 3 bytes per pixel and disparity.
+ */
+class StereoDepthProcessor {
+  uint32_t mWidth, mHeight;         // IR images
+  uint32_t mMainWidth, mMainHeight; // registered depth
+  Eigen::Matrix3f mIntrinsic;       // left, shared by both rectified images
+  Eigen::Matrix3f mRightIntrinsic;
+  bool mRectifyRight;
+  Eigen::Matrix3f mMainIntrinsic;
+  Eigen::Matrix4f mMainFromLeft;
+  float mBaseline;
+  StereoDepthConfig mConfig;
+  uint64_t mFrame{0};
+
+  ThreadPool mThreadPool;
+
+  std::vector<uint64_t> mCensusLeft, mCensusRight;
+  std::vector<uint8_t> mCost;        // height x width x disparities
+  std::vector<uint16_t> mAggregated; // height x width x disparities
+
+public:
+  StereoDepthProcessor(uint32_t width, uint32_t height, Eigen::Matrix3f const &leftIntrinsic,
+                       Eigen::Matrix3f const &rightIntrinsic,
+                       Eigen::Matrix4f const &leftExtrinsic, Eigen::Matrix4f const &rightExtrinsic,
+                       uint32_t mainWidth, uint32_t mainHeight,
+                       Eigen::Matrix3f const &mainIntrinsic, Eigen::Matrix4f const &mainExtrinsic,
+                       StereoDepthConfig const &config = {}, uint32_t threadCount = 0);
+
+  inline StereoDepthConfig const &getConfig() const { return mConfig; }
+  inline uint32_t getWidth() const { return mWidth; }
+  inline uint32_t getHeight() const { return mHeight; }
+  inline uint32_t getOutputWidth() const { return mConfig.registerDepth ? mMainWidth : mWidth; }
+  inline uint32_t getOutputHeight() const {
+    return mConfig.registerDepth ? mMainHeight : mHeight;
+  }
+
+  /** Depth in the main camera, or the left camera without registration, 0 where invalid
+   *
+   *  Images are 8 bit, row major, width x height of the IR cameras.
+   */
+  std::vector<float> compute(std::vector<uint8_t> const &left, std::vector<uint8_t> const &right);
+
+  // stages of compute
+
+  /** speckle and gaussian noise, with the soft intensity resampling when noiseScale is set */
+  std::vector<uint8_t> addNoise(std::vector<uint8_t> const &image, uint64_t seed);
+
+  /** disparity of the left image in pixels, -1 where invalid */
+  std::vector<float> computeDisparity(std::vector<uint8_t> const &left,
+                                      std::vector<uint8_t> const &right);
+
+  /** depth along the left camera axis, 0 where the disparity is below 1 */
+  std::vector<float> disparityToDepth(std::vector<float> const &disparity) const;
+
+  /** reproject left camera depth into the main camera, keeping the closest depth per pixel */
+  std::vector<float> registerDepth(std::vector<float> const &depth);
+
+private:
+  std::vector<uint8_t> rectifyRight(std::vector<uint8_t> const &image);
+  void census(std::vector<uint8_t> const &image, std::vector<uint64_t> &out);
+  void computeCost();
+  void aggregateHorizontal();
+  void aggregateVertical(int dy);
+  std::vector<float> selectDisparity();
+  void filterSpeckles(std::vector<float> &disparity) const;
+  std::vector<float> medianFilter(std::vector<float> const &image, uint32_t width,
+                                  uint32_t height);
+
+  template <typename F> void parallelFor(size_t count, size_t grain, F const &fn);
+};
+
+} // namespace sapien
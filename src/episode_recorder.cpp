@@ -0,0 +1,372 @@
+#include "episode_recorder.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <spdlog/spdlog.h>
+#include <zlib.h>
+
+namespace sapien {
+using namespace physx;
+
+static constexpr char kMagic[8] = {'S', 'A', 'P', 'I', 'E', 'N', 'E', 'P'};
+static constexpr uint32_t kVersion = 1;
+
+// quantized values per object: position xyz, index of the largest quaternion component, the
+// other three components and visibility
+static constexpr uint32_t kFields = 8;
+static constexpr float kQuaternionScale = 32767.f * 1.41421356f;
+
+static void writeVarint(std::string &out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+static uint64_t readVarint(char const *&p, char const *end) {
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (p == end) {
+      throw std::runtime_error("corrupted episode chunk");
+    }
+    uint8_t byte = static_cast<uint8_t>(*p++);
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return value;
+    }
+  }
+  throw std::runtime_error("corrupted episode chunk");
+}
+
+static inline uint64_t zigzag(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+static inline int64_t unzigzag(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+static void quantize(PxTransform const &pose, float visibility, float precision, int32_t *out) {
+  out[0] = static_cast<int32_t>(std::lround(pose.p.x / precision));
+  out[1] = static_cast<int32_t>(std::lround(pose.p.y / precision));
+  out[2] = static_cast<int32_t>(std::lround(pose.p.z / precision));
+
+  // smallest three: q and -q are the same rotation, so the largest component is made positive
+  // and recovered from the unit norm
+  PxQuat q = pose.q.getNormalized();
+  float c[4] = {q.x, q.y, q.z, q.w};
+  int largest = 0;
+  for (int i = 1; i < 4; ++i) {
+    if (std::abs(c[i]) > std::abs(c[largest])) {
+      largest = i;
+    }
+  }
+  float sign = c[largest] < 0.f ? -1.f : 1.f;
+  out[3] = largest;
+  for (int i = 0, j = 4; i < 4; ++i) {
+    if (i != largest) {
+      out[j++] = static_cast<int32_t>(std::lround(sign * c[i] * kQuaternionScale));
+    }
+  }
+  out[7] = static_cast<int32_t>(std::lround(PxClamp(visibility, 0.f, 1.f) * 255.f));
+}
+
+static PxTransform dequantize(int32_t const *in, float precision, float &visibility) {
+  PxVec3 p(in[0] * precision, in[1] * precision, in[2] * precision);
+  int largest = std::clamp(in[3], 0, 3);
+  float c[4];
+  float sum = 0.f;
+  for (int i = 0, j = 4; i < 4; ++i) {
+    if (i != largest) {
+      c[i] = in[j++] / kQuaternionScale;
+      sum += c[i] * c[i];
+    }
+  }
+  c[largest] = std::sqrt(std::max(0.f, 1.f - sum));
+  visibility = in[7] / 255.f;
+  return {p, PxQuat(c[0], c[1], c[2], c[3]).getNormalized()};
+}
+
+template <typename T> static void writeValue(std::ostream &out, T const &value) {
+  out.write(reinterpret_cast<char const *>(&value), sizeof(T));
+}
+
+template <typename T> static T readValue(std::istream &in) {
+  T value{};
+  in.read(reinterpret_cast<char *>(&value), sizeof(T));
+  return value;
+}
+
+//========== Recorder ==========//
+EpisodeRecorder::EpisodeRecorder(std::string const &filename, float positionPrecision,
+                                 uint32_t chunkSize)
+    : mPrecision(positionPrecision), mChunkSize(std::max(chunkSize, 1u)),
+      mFile(filename, std::ios::binary) {
+  if (positionPrecision <= 0.f) {
+    throw std::invalid_argument("position precision must be positive");
+  }
+  if (!mFile) {
+    throw std::runtime_error("failed to open episode file " + filename);
+  }
+  mFile.write(kMagic, sizeof(kMagic));
+  writeValue(mFile, kVersion);
+  writeValue(mFile, mPrecision);
+  mWriter = std::make_unique<ThreadPool>(1);
+}
+
+EpisodeRecorder::~EpisodeRecorder() { close(); }
+
+void EpisodeRecorder::record(EpisodeFrame const &frame) {
+  if (!mWriter) {
+    throw std::runtime_error("failed to record frame: episode is closed");
+  }
+  if (frame.poses.size() != frame.ids.size() || frame.visibility.size() != frame.ids.size()) {
+    throw std::invalid_argument("failed to record frame: mismatched object arrays");
+  }
+
+  // the first frame of a chunk is coded against zero so chunks decode independently
+  bool key = mChunkFrames == 0;
+  bool idsChanged = key || frame.ids != mPreviousIds;
+  bool camerasChanged = key || frame.cameraPoses.size() * kFields != mPreviousCameras.size();
+
+  writeVarint(mChunk, idsChanged);
+  if (idsChanged) {
+    writeVarint(mChunk, frame.ids.size());
+    int64_t previousId = 0;
+    for (uint32_t id : frame.ids) {
+      writeVarint(mChunk, zigzag(static_cast<int64_t>(id) - previousId));
+      previousId = id;
+    }
+    mPreviousIds = frame.ids;
+    mPrevious.assign(frame.ids.size() * kFields, 0);
+  }
+  writeVarint(mChunk, frame.cameraPoses.size());
+  if (camerasChanged) {
+    mPreviousCameras.assign(frame.cameraPoses.size() * kFields, 0);
+  }
+
+  int32_t values[kFields];
+  for (size_t i = 0; i < frame.ids.size(); ++i) {
+    quantize(frame.poses[i], frame.visibility[i], mPrecision, values);
+    for (uint32_t f = 0; f < kFields; ++f) {
+      int32_t &previous = mPrevious[i * kFields + f];
+      writeVarint(mChunk, zigzag(static_cast<int64_t>(values[f]) - previous));
+      previous = values[f];
+    }
+  }
+  for (size_t i = 0; i < frame.cameraPoses.size(); ++i) {
+    quantize(frame.cameraPoses[i], 1.f, mPrecision, values);
+    for (uint32_t f = 0; f < kFields; ++f) {
+      int32_t &previous = mPreviousCameras[i * kFields + f];
+      writeVarint(mChunk, zigzag(static_cast<int64_t>(values[f]) - previous));
+      previous = values[f];
+    }
+  }
+
+  mFrameCount += 1;
+  mChunkFrames += 1;
+  if (mChunkFrames == mChunkSize) {
+    flushChunk();
+  }
+}
+
+void EpisodeRecorder::flushChunk() {
+  if (!mChunkFrames) {
+    return;
+  }
+  uint32_t firstFrame = mFrameCount - mChunkFrames;
+  uint32_t frameCount = mChunkFrames;
+  mWriter->submit([this, chunk = std::move(mChunk), firstFrame, frameCount]() {
+    uLongf compressedSize = compressBound(chunk.size());
+    std::vector<Bytef> compressed(compressedSize);
+    if (compress2(compressed.data(), &compressedSize,
+                  reinterpret_cast<Bytef const *>(chunk.data()), chunk.size(),
+                  Z_DEFAULT_COMPRESSION) != Z_OK) {
+      spdlog::get("SAPIEN")->error("Failed to compress episode chunk, frames {} to {} are lost",
+                                   firstFrame, firstFrame + frameCount);
+      return;
+    }
+    uint64_t offset = mFile.tellp();
+    mFile.write(reinterpret_cast<char const *>(compressed.data()), compressedSize);
+    mIndex.push_back({offset, static_cast<uint32_t>(compressedSize),
+                      static_cast<uint32_t>(chunk.size()), firstFrame, frameCount});
+  });
+  mChunk = {};
+  mChunkFrames = 0;
+}
+
+void EpisodeRecorder::close() {
+  if (!mWriter) {
+    return;
+  }
+  flushChunk();
+  mWriter->submit([this]() {
+    uint64_t indexOffset = mFile.tellp();
+    writeValue(mFile, static_cast<uint32_t>(mIndex.size()));
+    for (auto &chunk : mIndex) {
+      writeValue(mFile, chunk.offset);
+      writeValue(mFile, chunk.compressedSize);
+      writeValue(mFile, chunk.size);
+      writeValue(mFile, chunk.firstFrame);
+      writeValue(mFile, chunk.frameCount);
+    }
+    writeValue(mFile, indexOffset);
+    mFile.write(kMagic, sizeof(kMagic));
+  });
+  mWriter.reset(); // waits for the pending chunks
+  mFile.close();
+}
+
+//========== Replayer ==========//
+EpisodeReplayer::EpisodeReplayer(std::string const &filename)
+    : mFile(filename, std::ios::binary) {
+  if (!mFile) {
+    throw std::runtime_error("failed to open episode file " + filename);
+  }
+  char magic[sizeof(kMagic)];
+  mFile.read(magic, sizeof(magic));
+  if (!mFile || std::memcmp(magic, kMagic, sizeof(kMagic))) {
+    throw std::runtime_error(filename + " is not an episode file");
+  }
+  if (readValue<uint32_t>(mFile) != kVersion) {
+    throw std::runtime_error("unsupported episode file version in " + filename);
+  }
+  mPrecision = readValue<float>(mFile);
+
+  mFile.seekg(-static_cast<std::streamoff>(sizeof(uint64_t) + sizeof(kMagic)), std::ios::end);
+  auto indexOffset = readValue<uint64_t>(mFile);
+  mFile.read(magic, sizeof(magic));
+  if (!mFile || std::memcmp(magic, kMagic, sizeof(kMagic))) {
+    throw std::runtime_error(filename + " is incomplete, the recorder was not closed");
+  }
+  mFile.seekg(indexOffset);
+  uint32_t count = readValue<uint32_t>(mFile);
+  for (uint32_t i = 0; i < count; ++i) {
+    EpisodeChunkInfo chunk;
+    chunk.offset = readValue<uint64_t>(mFile);
+    chunk.compressedSize = readValue<uint32_t>(mFile);
+    chunk.size = readValue<uint32_t>(mFile);
+    chunk.firstFrame = readValue<uint32_t>(mFile);
+    chunk.frameCount = readValue<uint32_t>(mFile);
+    mIndex.push_back(chunk);
+  }
+  if (!mFile) {
+    throw std::runtime_error("corrupted episode index in " + filename);
+  }
+  if (!mIndex.empty()) {
+    mFrameCount = mIndex.back().firstFrame + mIndex.back().frameCount;
+  }
+}
+
+void EpisodeReplayer::loadChunk(uint32_t chunk) {
+  auto &info = mIndex[chunk];
+  std::vector<Bytef> compressed(info.compressedSize);
+  mFile.clear();
+  mFile.seekg(info.offset);
+  mFile.read(reinterpret_cast<char *>(compressed.data()), compressed.size());
+  std::string data(info.size, '\0');
+  uLongf size = info.size;
+  if (!mFile || uncompress(reinterpret_cast<Bytef *>(data.data()), &size, compressed.data(),
+                           compressed.size()) != Z_OK) {
+    throw std::runtime_error("corrupted episode chunk");
+  }
+
+  mFrames.clear();
+  mFrames.reserve(info.frameCount);
+  std::vector<int32_t> previous;
+  std::vector<int32_t> previousCameras;
+  char const *p = data.data();
+  char const *end = p + size;
+  int32_t values[kFields];
+  for (uint32_t frameIndex = 0; frameIndex < info.frameCount; ++frameIndex) {
+    EpisodeFrame frame;
+    if (readVarint(p, end)) {
+      uint64_t count = readVarint(p, end);
+      int64_t id = 0;
+      for (uint64_t i = 0; i < count; ++i) {
+        id += unzigzag(readVarint(p, end));
+        frame.ids.push_back(static_cast<uint32_t>(id));
+      }
+      previous.assign(count * kFields, 0);
+    } else {
+      frame.ids = mFrames.back().ids;
+    }
+    uint64_t cameraCount = readVarint(p, end);
+    if (frameIndex == 0 || cameraCount * kFields != previousCameras.size()) {
+      previousCameras.assign(cameraCount * kFields, 0);
+    }
+
+    frame.poses.resize(frame.ids.size());
+    frame.visibility.resize(frame.ids.size());
+    for (size_t i = 0; i < frame.ids.size(); ++i) {
+      for (uint32_t f = 0; f < kFields; ++f) {
+        int32_t &v = previous[i * kFields + f];
+        v = static_cast<int32_t>(v + unzigzag(readVarint(p, end)));
+        values[f] = v;
+      }
+      frame.poses[i] = dequantize(values, mPrecision, frame.visibility[i]);
+    }
+    frame.cameraPoses.resize(cameraCount);
+    for (size_t i = 0; i < cameraCount; ++i) {
+      for (uint32_t f = 0; f < kFields; ++f) {
+        int32_t &v = previousCameras[i * kFields + f];
+        v = static_cast<int32_t>(v + unzigzag(readVarint(p, end)));
+        values[f] = v;
+      }
+      float visibility;
+      frame.cameraPoses[i] = dequantize(values, mPrecision, visibility);
+    }
+    mFrames.push_back(std::move(frame));
+  }
+  mLoadedChunk = chunk;
+}
+
+EpisodeFrame const &EpisodeReplayer::getFrame(uint32_t index) {
+  if (index >= mFrameCount) {
+    throw std::out_of_range("invalid frame index");
+  }
+  auto it = std::upper_bound(
+      mIndex.begin(), mIndex.end(), index,
+      [](uint32_t i, EpisodeChunkInfo const &c) { return i < c.firstFrame; });
+  uint32_t chunk = static_cast<uint32_t>(it - mIndex.begin()) - 1;
+  if (static_cast<int>(chunk) != mLoadedChunk) {
+    loadChunk(chunk);
+  }
+  return mFrames[index - mIndex[chunk].firstFrame];
+}
+
+void EpisodeReplayer::bind(std::vector<Renderer::IPxrRigidbody *> const &bodies) {
+  mBodies.clear();
+  for (auto body : bodies) {
+    if (body) {
+      mBodies[body->getSegmentationId()].push_back(body);
+    }
+  }
+}
+
+void EpisodeReplayer::bindCameras(std::vector<Renderer::ICamera *> const &cameras) {
+  mCameras = cameras;
+}
+
+void EpisodeReplayer::apply(uint32_t index) {
+  auto &frame = getFrame(index);
+  for (size_t i = 0; i < frame.ids.size(); ++i) {
+    auto it = mBodies.find(frame.ids[i]);
+    if (it == mBodies.end()) {
+      continue;
+    }
+    for (auto body : it->second) {
+      body->update(frame.poses[i]);
+      body->setVisibility(frame.visibility[i]);
+    }
+  }
+  size_t cameraCount = std::min(mCameras.size(), frame.cameraPoses.size());
+  for (size_t i = 0; i < cameraCount; ++i) {
+    if (mCameras[i]) {
+      mCameras[i]->setPose(frame.cameraPoses[i]);
+    }
+  }
+}
+
+} // namespace sapien
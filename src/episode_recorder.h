@@ -0,0 +1,116 @@
+#pragma once
+#include "renderer/render_interface.h"
+#include "utils/thread_pool.hpp"
+#include <PxPhysicsAPI.h>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sapien {
+
+/** Render state of one frame
+ *
+ *  Objects are actors and links, keyed by id; their render bodies carry the same id as
+ *  segmentation id. Camera poses are renderer camera poses in the order of the scene cameras.
+ */
+struct EpisodeFrame {
+  std::vector<uint32_t> ids;
+  std::vector<physx::PxTransform> poses;
+  std::vector<float> visibility;
+  std::vector<physx::PxTransform> cameraPoses;
+};
+
+/** Location of a chunk of frames in an episode file */
+struct EpisodeChunkInfo {
+  uint64_t offset;
+  uint32_t compressedSize;
+  uint32_t size;
+  uint32_t firstFrame;
+  uint32_t frameCount;
+};
+
+/** Writes frames to a compressed episode file
+ *
+ *  Positions are quantized to a fixed precision and rotations are stored as the three smallest
+ *  quaternion components. Every value is delta coded against the previous frame of its chunk
+ *  as a zigzag varint, so objects at rest cost a few bytes before compression. Full chunks are
+ *  deflated and appended by a background thread; closing the recorder writes the chunk index
+ *  used by EpisodeReplayer to seek.
+ */
+class EpisodeRecorder {
+  float mPrecision;
+  uint32_t mChunkSize;
+
+  // owned by the writer thread after construction
+  std::ofstream mFile;
+  std::vector<EpisodeChunkInfo> mIndex;
+  std::unique_ptr<ThreadPool> mWriter;
+
+  std::string mChunk; // encoded frames of the open chunk
+  uint32_t mChunkFrames{0};
+  uint32_t mFrameCount{0};
+  std::vector<uint32_t> mPreviousIds;
+  std::vector<int32_t> mPrevious; // quantized values of the previous frame in the chunk
+  std::vector<int32_t> mPreviousCameras;
+
+public:
+  /** positionPrecision is the quantization step in meters */
+  explicit EpisodeRecorder(std::string const &filename, float positionPrecision = 1e-4f,
+                           uint32_t chunkSize = 256);
+  EpisodeRecorder(EpisodeRecorder const &) = delete;
+  EpisodeRecorder &operator=(EpisodeRecorder const &) = delete;
+  ~EpisodeRecorder();
+
+  void record(EpisodeFrame const &frame);
+
+  /** flush the open chunk, write the index and wait for the file to be complete */
+  void close();
+
+  inline uint32_t getFrameCount() const { return mFrameCount; }
+
+private:
+  void flushChunk();
+};
+
+/** Reads an episode file and drives render bodies and cameras from it
+ *
+ *  A chunk is decoded as a whole the first time one of its frames is requested and kept until
+ *  a frame of another chunk is requested.
+ */
+class EpisodeReplayer {
+  std::ifstream mFile;
+  float mPrecision;
+  std::vector<EpisodeChunkInfo> mIndex;
+  uint32_t mFrameCount{0};
+
+  int mLoadedChunk{-1};
+  std::vector<EpisodeFrame> mFrames;
+
+  std::map<uint32_t, std::vector<Renderer::IPxrRigidbody *>> mBodies;
+  std::vector<Renderer::ICamera *> mCameras;
+
+public:
+  /** throws if the file cannot be opened or is not a complete episode */
+  explicit EpisodeReplayer(std::string const &filename);
+
+  inline uint32_t getFrameCount() const { return mFrameCount; }
+  inline uint32_t getChunkCount() const { return mIndex.size(); }
+
+  EpisodeFrame const &getFrame(uint32_t index);
+
+  /** bodies driven by apply, matched to recorded objects by segmentation id */
+  void bind(std::vector<Renderer::IPxrRigidbody *> const &bodies);
+
+  /** cameras driven by apply, matched to recorded cameras by order */
+  void bindCameras(std::vector<Renderer::ICamera *> const &cameras);
+
+  /** set bound bodies and cameras to a frame */
+  void apply(uint32_t index);
+
+private:
+  void loadChunk(uint32_t chunk);
+};
+
+} // namespace sapien
@@ -4,12 +4,23 @@
 namespace sapien {
 using namespace physx;
 
+/* environment slots of a scene are stored in the high 16 bits of word3, 0 is shared by all */
+inline PxU32 environmentFilterBits(int environment) {
+  return environment < 0 ? 0 : static_cast<PxU32>(environment + 1) << 16;
+}
+
 inline PxFilterFlags
 TypeAffinityIgnoreFilterShader(PxFilterObjectAttributes attributes0, PxFilterData filterData0,
                                PxFilterObjectAttributes attributes1, PxFilterData filterData1,
                                PxPairFlags &pairFlags, const void *constantBlock,
                                PxU32 constantBlockSize) {
 
+  PxU32 env0 = filterData0.word3 >> 16;
+  PxU32 env1 = filterData1.word3 >> 16;
+  if (env0 && env1 && env0 != env1) {
+    return PxFilterFlag::eKILL;
+  }
+
   if (PxFilterObjectIsTrigger(attributes0) || PxFilterObjectIsTrigger(attributes1)) {
     pairFlags = PxPairFlag::eTRIGGER_DEFAULT;
     return PxFilterFlag::eDEFAULT;
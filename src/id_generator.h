@@ -7,6 +7,8 @@ using physx_id_t = uint32_t;
 class IDGenerator {
 public:
   inline physx_id_t next() { return _id++; }
+  /** ids below this one have been handed out */
+  inline physx_id_t peek() const { return _id; }
 
   inline IDGenerator() : _id(1) {}
 
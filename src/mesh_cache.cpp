@@ -0,0 +1,339 @@
+#include "mesh_cache.h"
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <cmath>
+#include <iostream>
+#include <spdlog/spdlog.h>
+
+namespace sapien {
+namespace fs = std::filesystem;
+
+std::vector<physx::PxVec3> DecodedMesh::getVertices() const {
+  std::vector<physx::PxVec3> vertices;
+  for (auto &submesh : submeshes) {
+    for (size_t i = 0; i + 2 < submesh.positions.size(); i += 3) {
+      vertices.push_back(
+          {submesh.positions[i], submesh.positions[i + 1], submesh.positions[i + 2]});
+    }
+  }
+  return vertices;
+}
+
+std::vector<physx::PxU32> DecodedMesh::getTriangles() const {
+  std::vector<physx::PxU32> triangles;
+  uint32_t vertexCount = 0;
+  for (auto &submesh : submeshes) {
+    for (uint32_t index : submesh.indices) {
+      triangles.push_back(index + vertexCount);
+    }
+    vertexCount += submesh.positions.size() / 3;
+  }
+  return triangles;
+}
+
+size_t DecodedMesh::getByteSize() const {
+  size_t size = sizeof(DecodedMesh) + filename.size();
+  for (auto &submesh : submeshes) {
+    size += sizeof(Submesh) +
+            (submesh.positions.size() + submesh.normals.size() + submesh.uvs.size()) *
+                sizeof(float) +
+            submesh.indices.size() * sizeof(uint32_t);
+  }
+  return size;
+}
+
+template <typename T> static void writeArray(std::ostream &out, std::vector<T> const &values) {
+  uint32_t size = values.size();
+  out.write(reinterpret_cast<char const *>(&size), sizeof(size));
+  out.write(reinterpret_cast<char const *>(values.data()), size * sizeof(T));
+}
+
+template <typename T> static bool readArray(std::istream &in, std::vector<T> &values) {
+  uint32_t size = 0;
+  in.read(reinterpret_cast<char *>(&size), sizeof(size));
+  if (!in.good()) {
+    return false;
+  }
+  values.resize(size);
+  in.read(reinterpret_cast<char *>(values.data()), size * sizeof(T));
+  return in.good();
+}
+
+static void writeString(std::ostream &out, std::string const &value) {
+  writeArray(out, std::vector<char>(value.begin(), value.end()));
+}
+
+static bool readString(std::istream &in, std::string &value) {
+  std::vector<char> chars;
+  if (!readArray(in, chars)) {
+    return false;
+  }
+  value = std::string(chars.begin(), chars.end());
+  return true;
+}
+
+void DecodedMesh::serialize(std::ostream &out) const {
+  writeString(out, filename);
+  uint32_t count = submeshes.size();
+  out.write(reinterpret_cast<char const *>(&count), sizeof(count));
+  for (auto &submesh : submeshes) {
+    writeArray(out, submesh.positions);
+    writeArray(out, submesh.normals);
+    writeArray(out, submesh.uvs);
+    writeArray(out, submesh.indices);
+    out.write(reinterpret_cast<char const *>(&submesh.materialIndex),
+              sizeof(submesh.materialIndex));
+    out.write(reinterpret_cast<char const *>(submesh.baseColor.data()),
+              sizeof(submesh.baseColor));
+    out.write(reinterpret_cast<char const *>(submesh.emission.data()), sizeof(submesh.emission));
+    float factors[3] = {submesh.specular, submesh.roughness, submesh.metallic};
+    out.write(reinterpret_cast<char const *>(factors), sizeof(factors));
+    writeString(out, submesh.diffuseTexture);
+    writeString(out, submesh.roughnessTexture);
+    writeString(out, submesh.metallicTexture);
+    writeString(out, submesh.normalTexture);
+    writeString(out, submesh.emissionTexture);
+  }
+}
+
+std::shared_ptr<DecodedMesh> DecodedMesh::deserialize(std::istream &in) {
+  auto mesh = std::make_shared<DecodedMesh>();
+  if (!readString(in, mesh->filename)) {
+    return nullptr;
+  }
+  uint32_t count = 0;
+  in.read(reinterpret_cast<char *>(&count), sizeof(count));
+  for (uint32_t i = 0; i < count && in.good(); ++i) {
+    Submesh submesh;
+    if (!readArray(in, submesh.positions) || !readArray(in, submesh.normals) ||
+        !readArray(in, submesh.uvs) || !readArray(in, submesh.indices)) {
+      return nullptr;
+    }
+    in.read(reinterpret_cast<char *>(&submesh.materialIndex), sizeof(submesh.materialIndex));
+    in.read(reinterpret_cast<char *>(submesh.baseColor.data()), sizeof(submesh.baseColor));
+    in.read(reinterpret_cast<char *>(submesh.emission.data()), sizeof(submesh.emission));
+    float factors[3];
+    in.read(reinterpret_cast<char *>(factors), sizeof(factors));
+    submesh.specular = factors[0];
+    submesh.roughness = factors[1];
+    submesh.metallic = factors[2];
+    if (!readString(in, submesh.diffuseTexture) || !readString(in, submesh.roughnessTexture) ||
+        !readString(in, submesh.metallicTexture) || !readString(in, submesh.normalTexture) ||
+        !readString(in, submesh.emissionTexture)) {
+      return nullptr;
+    }
+    mesh->submeshes.push_back(std::move(submesh));
+  }
+  if (!in.good()) {
+    return nullptr;
+  }
+  return mesh;
+}
+
+// same mapping as the svulkan2 model loader
+static float shininessToRoughness(float shininess) {
+  if (shininess <= 5.f) {
+    return 1.f;
+  }
+  if (shininess >= 1605.f) {
+    return 0.f;
+  }
+  return 1.f - std::sqrt(shininess - 5.f) / 40.f;
+}
+
+static std::shared_ptr<DecodedMesh> decodeMeshFile(std::string const &filename) {
+  Assimp::Importer importer;
+  // smooth normals are only generated when missing and do not split vertices
+  uint32_t flags =
+      aiProcess_Triangulate | aiProcess_PreTransformVertices | aiProcess_GenSmoothNormals;
+  importer.SetPropertyInteger(AI_CONFIG_PP_PTV_ADD_ROOT_TRANSFORMATION, 1);
+
+  const aiScene *scene = importer.ReadFile(filename, flags);
+  if (!scene) {
+    spdlog::get("SAPIEN")->error(importer.GetErrorString());
+    return nullptr;
+  }
+
+  fs::path directory = fs::path(filename).parent_path();
+  auto result = std::make_shared<DecodedMesh>();
+  result->filename = filename;
+  for (uint32_t i = 0; i < scene->mNumMeshes; ++i) {
+    auto mesh = scene->mMeshes[i];
+    DecodedMesh::Submesh submesh;
+    submesh.materialIndex = mesh->mMaterialIndex;
+    if (mesh->mMaterialIndex < scene->mNumMaterials) {
+      auto material = scene->mMaterials[mesh->mMaterialIndex];
+      aiColor4D color;
+      if (material->Get(AI_MATKEY_COLOR_DIFFUSE, color) == AI_SUCCESS) {
+        submesh.baseColor = {color.r, color.g, color.b, 1.f};
+      }
+      float opacity;
+      if (material->Get(AI_MATKEY_OPACITY, opacity) == AI_SUCCESS) {
+        submesh.baseColor[3] = opacity;
+      }
+      if (material->Get(AI_MATKEY_COLOR_EMISSIVE, color) == AI_SUCCESS) {
+        submesh.emission = {color.r, color.g, color.b, 1.f};
+      }
+      if (material->Get(AI_MATKEY_COLOR_SPECULAR, color) == AI_SUCCESS) {
+        submesh.specular = (color.r + color.g + color.b) / 3.f;
+      }
+      float shininess;
+      if (material->Get(AI_MATKEY_SHININESS, shininess) == AI_SUCCESS) {
+        submesh.roughness = shininessToRoughness(shininess);
+      }
+#ifdef AI_MATKEY_METALLIC_FACTOR
+      material->Get(AI_MATKEY_METALLIC_FACTOR, submesh.metallic);
+#endif
+
+      auto texture = [&](aiTextureType type, std::string &result) {
+        aiString path;
+        if (material->GetTextureCount(type) > 0 &&
+            material->GetTexture(type, 0, &path) == AI_SUCCESS) {
+          result = (directory / path.C_Str()).string();
+        }
+      };
+      texture(aiTextureType_DIFFUSE, submesh.diffuseTexture);
+      texture(aiTextureType_DIFFUSE_ROUGHNESS, submesh.roughnessTexture);
+      texture(aiTextureType_METALNESS, submesh.metallicTexture);
+      texture(aiTextureType_NORMALS, submesh.normalTexture);
+      texture(aiTextureType_EMISSIVE, submesh.emissionTexture);
+    }
+    submesh.positions.reserve(mesh->mNumVertices * 3);
+    submesh.normals.reserve(mesh->mNumVertices * 3);
+    submesh.uvs.reserve(mesh->mNumVertices * 2);
+    for (uint32_t v = 0; v < mesh->mNumVertices; ++v) {
+      auto vertex = mesh->mVertices[v];
+      submesh.positions.insert(submesh.positions.end(), {vertex.x, vertex.y, vertex.z});
+      if (mesh->HasNormals()) {
+        auto normal = mesh->mNormals[v];
+        submesh.normals.insert(submesh.normals.end(), {normal.x, normal.y, normal.z});
+      } else {
+        submesh.normals.insert(submesh.normals.end(), {0.f, 0.f, 0.f});
+      }
+      if (mesh->HasTextureCoords(0)) {
+        auto uv = mesh->mTextureCoords[0][v];
+        submesh.uvs.insert(submesh.uvs.end(), {uv.x, uv.y});
+      } else {
+        submesh.uvs.insert(submesh.uvs.end(), {0.f, 0.f});
+      }
+    }
+    for (uint32_t f = 0; f < mesh->mNumFaces; ++f) {
+      for (uint32_t j = 0; j + 2 < mesh->mFaces[f].mNumIndices; ++j) {
+        submesh.indices.push_back(mesh->mFaces[f].mIndices[j]);
+        submesh.indices.push_back(mesh->mFaces[f].mIndices[j + 1]);
+        submesh.indices.push_back(mesh->mFaces[f].mIndices[j + 2]);
+      }
+    }
+    result->submeshes.push_back(std::move(submesh));
+  }
+  return result;
+}
+
+MeshCache &MeshCache::Get() {
+  static MeshCache cache;
+  return cache;
+}
+
+std::shared_ptr<DecodedMesh const> MeshCache::load(std::string const &filename) {
+  if (auto mesh = getBundled(filename)) {
+    return mesh;
+  }
+
+  std::error_code ec;
+  std::string fullPath = fs::canonical(filename, ec);
+  if (ec) {
+    spdlog::get("SAPIEN")->error("File not found: {}", filename);
+    return nullptr;
+  }
+  auto mtime = fs::last_write_time(fullPath, ec);
+
+  {
+    std::lock_guard<std::mutex> lock(mLock);
+    auto it = mEntries.find(fullPath);
+    if (it != mEntries.end()) {
+      if (it->second.mtime == mtime) {
+        it->second.lastUse = ++mClock;
+        return it->second.mesh;
+      }
+      // the file changed, do not keep the old data around
+      mSize -= it->second.size;
+      mEntries.erase(it);
+    }
+  }
+
+  // decode outside the lock so different files load in parallel
+  auto mesh = decodeMeshFile(fullPath);
+  if (!mesh) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(mLock);
+  auto &entry = mEntries[fullPath];
+  if (entry.mesh && entry.mtime == mtime) {
+    // decoded concurrently by another thread
+    entry.lastUse = ++mClock;
+    return entry.mesh;
+  }
+  mSize -= entry.mesh ? entry.size : 0;
+  entry = {mtime, mesh, mesh->getByteSize(), ++mClock};
+  mSize += entry.size;
+  evict(fullPath);
+  return mesh;
+}
+
+void MeshCache::evict(std::string const &keep) {
+  while (mSize > mCapacity) {
+    auto oldest = mEntries.end();
+    for (auto it = mEntries.begin(); it != mEntries.end(); ++it) {
+      if (it->first != keep &&
+          (oldest == mEntries.end() || it->second.lastUse < oldest->second.lastUse)) {
+        oldest = it;
+      }
+    }
+    if (oldest == mEntries.end()) {
+      break;
+    }
+    mSize -= oldest->second.size;
+    mEntries.erase(oldest);
+  }
+}
+
+void MeshCache::setCapacity(size_t bytes) {
+  std::lock_guard<std::mutex> lock(mLock);
+  mCapacity = bytes;
+  evict("");
+}
+
+size_t MeshCache::getSize() {
+  std::lock_guard<std::mutex> lock(mLock);
+  return mSize;
+}
+
+void MeshCache::addBundled(std::string const &name, std::shared_ptr<DecodedMesh const> mesh) {
+  std::lock_guard<std::mutex> lock(mLock);
+  mBundled[name] = mesh;
+}
+
+std::shared_ptr<DecodedMesh const> MeshCache::getBundled(std::string const &name) {
+  std::lock_guard<std::mutex> lock(mLock);
+  auto it = mBundled.find(name);
+  return it == mBundled.end() ? nullptr : it->second;
+}
+
+void MeshCache::removeBundled(std::string const &prefix) {
+  std::lock_guard<std::mutex> lock(mLock);
+  auto it = mBundled.lower_bound(prefix);
+  while (it != mBundled.end() && it->first.rfind(prefix, 0) == 0) {
+    it = mBundled.erase(it);
+  }
+}
+
+void MeshCache::clear() {
+  std::lock_guard<std::mutex> lock(mLock);
+  mEntries.clear();
+  mBundled.clear();
+  mSize = 0;
+}
+
+} // namespace sapien
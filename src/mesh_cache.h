@@ -0,0 +1,102 @@
+#pragma once
+#include <PxPhysicsAPI.h>
+#include <array>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace sapien {
+
+/** Mesh file decoded by Assimp with node transforms applied and faces triangulated */
+struct DecodedMesh {
+  struct Submesh {
+    std::vector<float> positions; // 3 per vertex
+    std::vector<float> normals;   // 3 per vertex, zero if the file has none
+    std::vector<float> uvs;       // 2 per vertex (first channel, Assimp convention)
+    std::vector<uint32_t> indices;
+    uint32_t materialIndex;
+
+    // submesh material, read the way the svulkan2 model loader reads it
+    // textures are absolute paths, empty if none
+    std::array<float, 4> baseColor{1.f, 1.f, 1.f, 1.f};
+    std::array<float, 4> emission{0.f, 0.f, 0.f, 1.f};
+    float specular{0.f};
+    float roughness{1.f};
+    float metallic{0.f};
+    std::string diffuseTexture;
+    std::string roughnessTexture;
+    std::string metallicTexture;
+    std::string normalTexture;
+    std::string emissionTexture;
+  };
+
+  std::string filename; // canonical path
+  std::vector<Submesh> submeshes;
+
+  /** all submesh positions concatenated */
+  std::vector<physx::PxVec3> getVertices() const;
+
+  /** all submesh triangles concatenated, indexing into getVertices */
+  std::vector<physx::PxU32> getTriangles() const;
+
+  /** approximate host memory held by the decoded data */
+  size_t getByteSize() const;
+
+  void serialize(std::ostream &out) const;
+  static std::shared_ptr<DecodedMesh> deserialize(std::istream &in);
+};
+
+/** Process-wide cache of decoded mesh files, shared by collision cooking and render backends
+ *
+ *  Entries are keyed by canonical path and dropped when the file modification time changes.
+ *  Least recently used entries are evicted once the decoded data exceeds the capacity;
+ *  meshes already handed out stay alive with their users. Thread safe.
+ */
+class MeshCache {
+  struct Entry {
+    std::filesystem::file_time_type mtime;
+    std::shared_ptr<DecodedMesh const> mesh;
+    size_t size;
+    uint64_t lastUse;
+  };
+  std::mutex mLock;
+  std::map<std::string, Entry> mEntries;
+  size_t mCapacity{512ul << 20};
+  size_t mSize{0};
+  uint64_t mClock{0};
+  std::map<std::string, std::shared_ptr<DecodedMesh const>> mBundled;
+
+public:
+  static MeshCache &Get();
+
+  /** decode the file or return the cached copy, nullptr if the file cannot be imported
+   *
+   *  Meshes added by addBundled are returned without touching the file system.
+   */
+  std::shared_ptr<DecodedMesh const> load(std::string const &filename);
+
+  /** register a mesh read from an asset bundle under a name scoped to the bundle */
+  void addBundled(std::string const &name, std::shared_ptr<DecodedMesh const> mesh);
+
+  /** mesh registered by addBundled, nullptr if there is none */
+  std::shared_ptr<DecodedMesh const> getBundled(std::string const &name);
+
+  /** drop the bundled meshes whose names start with the prefix */
+  void removeBundled(std::string const &prefix);
+
+  void clear();
+
+  /** bytes of decoded data kept by the cache, 512 MiB by default */
+  void setCapacity(size_t bytes);
+  inline size_t getCapacity() const { return mCapacity; }
+  size_t getSize();
+
+private:
+  MeshCache() = default;
+  void evict(std::string const &keep);
+};
+
+} // namespace sapien
@@ -1,15 +1,21 @@
 #include "mesh_manager.h"
+#include "mesh_cache.h"
+#include "mesh_simplification.h"
 #include "simulation.h"
+#include "utils/file.hpp"
+#include "utils/thread_pool.hpp"
 #include <assimp/Exporter.hpp>
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
+#include <algorithm>
+#include <cstring>
 #include <experimental/filesystem>
 #include <fstream>
 #include <iostream>
-#include <set>
 #include <spdlog/spdlog.h>
 #include <sstream>
+#include <tuple>
 
 namespace sapien {
 namespace fs = std::filesystem;
@@ -158,60 +164,20 @@ void exportMeshToFile(PxConvexMesh *pxMesh, const std::string &filename) {
 }
 
 static std::vector<PxVec3> getVerticesFromMeshFile(const std::string &filename) {
-  std::vector<PxVec3> vertices;
-  Assimp::Importer importer;
-  uint32_t flags = aiProcess_Triangulate | aiProcess_PreTransformVertices;
-  importer.SetPropertyInteger(AI_CONFIG_PP_PTV_ADD_ROOT_TRANSFORMATION, 1);
-
-  const aiScene *scene = importer.ReadFile(filename, flags);
-
-  if (!scene) {
-    spdlog::get("SAPIEN")->error(importer.GetErrorString());
+  auto mesh = MeshCache::Get().load(filename);
+  if (!mesh) {
     return {};
   }
-
-  for (uint32_t i = 0; i < scene->mNumMeshes; ++i) {
-    auto mesh = scene->mMeshes[i];
-    for (uint32_t v = 0; v < mesh->mNumVertices; ++v) {
-      auto vertex = mesh->mVertices[v];
-      vertices.push_back({vertex.x, vertex.y, vertex.z});
-    }
-  }
-  return vertices;
+  return mesh->getVertices();
 }
 
 static std::tuple<std::vector<PxVec3>, std::vector<PxU32>>
 getVerticesAndTrianglesFromMeshFile(const std::string &filename) {
-  std::vector<PxVec3> vertices;
-  std::vector<PxU32> triangles;
-  Assimp::Importer importer;
-  uint32_t flags = aiProcess_Triangulate | aiProcess_PreTransformVertices;
-  importer.SetPropertyInteger(AI_CONFIG_PP_PTV_ADD_ROOT_TRANSFORMATION, 1);
-
-  const aiScene *scene = importer.ReadFile(filename, flags);
-
-  if (!scene) {
-    spdlog::get("SAPIEN")->error(importer.GetErrorString());
+  auto mesh = MeshCache::Get().load(filename);
+  if (!mesh) {
     return {};
   }
-
-  uint32_t vertexCount = 0;
-  for (uint32_t i = 0; i < scene->mNumMeshes; ++i) {
-    auto mesh = scene->mMeshes[i];
-    for (uint32_t v = 0; v < mesh->mNumVertices; ++v) {
-      auto vertex = mesh->mVertices[v];
-      vertices.push_back({vertex.x, vertex.y, vertex.z});
-    }
-    for (uint32_t f = 0; f < mesh->mNumFaces; ++f) {
-      for (uint32_t j = 0; j + 2 < mesh->mFaces[f].mNumIndices; ++j) {
-        triangles.push_back(mesh->mFaces[f].mIndices[j] + vertexCount);
-        triangles.push_back(mesh->mFaces[f].mIndices[j + 1] + vertexCount);
-        triangles.push_back(mesh->mFaces[f].mIndices[j + 2] + vertexCount);
-      }
-    }
-    vertexCount += mesh->mNumVertices;
-  }
-  return {vertices, triangles};
+  return {mesh->getVertices(), mesh->getTriangles()};
 }
 
 MeshManager::MeshManager(Simulation *simulation) : mSimulation(simulation) {}
@@ -223,33 +189,41 @@ void MeshManager::setCacheSuffix(const std::string &filename) {
   mCacheSuffix = filename;
 }
 
-std::string MeshManager::getCachedFilenameNonConvex(const std::string &filename) {
-  return filename + mCacheSuffixNonConvex;
+static std::string simplifiedSuffix(uint32_t maxTriangles) {
+  return maxTriangles ? ".s" + std::to_string(maxTriangles) : "";
 }
 
-std::string MeshManager::getCachedFilename(const std::string &filename) {
-  return filename + mCacheSuffix;
+std::string MeshManager::getCachedFilenameNonConvex(const std::string &filename,
+                                                    uint32_t maxTriangles) {
+  return filename + simplifiedSuffix(maxTriangles) + mCacheSuffixNonConvex;
+}
+
+std::string MeshManager::getCachedFilename(const std::string &filename, uint32_t maxTriangles) {
+  return filename + simplifiedSuffix(maxTriangles) + mCacheSuffix;
 }
 
 physx::PxTriangleMesh *MeshManager::loadNonConvexMesh(const std::string &filename, bool useCache,
-                                                      bool saveCache) {
+                                                      bool saveCache, uint32_t maxTriangles) {
 
   if (!fs::is_regular_file(filename)) {
     spdlog::get("SAPIEN")->error("File not found: {}", filename);
     return nullptr;
   }
 
-  std::string fullPath = fs::canonical(filename);
-  auto it = mNonConvexMeshRegistry.find(fullPath);
-  if (it != mNonConvexMeshRegistry.end()) {
-    spdlog::get("SAPIEN")->info("Using loaded mesh: {}", filename);
-    return it->second.mesh;
+  std::string fullPath = std::string(fs::canonical(filename)) + simplifiedSuffix(maxTriangles);
+  {
+    std::lock_guard<std::mutex> lock(mRegistryLock);
+    auto it = mNonConvexMeshRegistry.find(fullPath);
+    if (it != mNonConvexMeshRegistry.end()) {
+      spdlog::get("SAPIEN")->info("Using loaded mesh: {}", filename);
+      return it->second.mesh;
+    }
   }
 
   bool cacheDidLoad = false;
   std::string fileToLoad = filename;
   if (useCache) {
-    std::string cachedFilename = getCachedFilenameNonConvex(filename);
+    std::string cachedFilename = getCachedFilenameNonConvex(filename, maxTriangles);
     if (fs::is_regular_file(cachedFilename)) {
       fileToLoad = cachedFilename;
       saveCache = false; // no need to save cache if it is loaded
@@ -259,6 +233,9 @@ physx::PxTriangleMesh *MeshManager::loadNonConvexMesh(const std::string &filenam
 
   PxTriangleMeshDesc meshDesc;
   auto [vertices, triangles] = getVerticesAndTrianglesFromMeshFile(fileToLoad);
+  if (maxTriangles && !cacheDidLoad) {
+    simplifyMesh(vertices, triangles, maxTriangles);
+  }
   meshDesc.points.count = vertices.size();
   meshDesc.points.stride = sizeof(PxVec3);
   meshDesc.points.data = vertices.data();
@@ -280,37 +257,57 @@ physx::PxTriangleMesh *MeshManager::loadNonConvexMesh(const std::string &filenam
                               mesh->getNbTriangles(), filename);
 
   if (saveCache) {
-    std::string cachedFilename = getCachedFilenameNonConvex(filename);
-    exportNonConvexMeshToFile(mesh, cachedFilename);
-    spdlog::get("SAPIEN")->info("Saved non-convex cache file: {}", cachedFilename);
+    std::string cachedFilename = getCachedFilenameNonConvex(filename, maxTriangles);
+    if (writeFileAtomic(cachedFilename, [&](std::string const &tmpFile) {
+          exportNonConvexMeshToFile(mesh, tmpFile);
+          return fs::is_regular_file(tmpFile);
+        })) {
+      spdlog::get("SAPIEN")->info("Saved non-convex cache file: {}", cachedFilename);
+    }
   }
 
-  mNonConvexMeshRegistry[fullPath] = {/* cached */ cacheDidLoad || saveCache,
-                                      /* filename */ fullPath,
-                                      /* mesh */ mesh};
-
-  return mesh;
+  std::lock_guard<std::mutex> lock(mRegistryLock);
+  auto [it, inserted] =
+      mNonConvexMeshRegistry.insert({fullPath, {/* cached */ cacheDidLoad || saveCache,
+                                                /* filename */ fullPath,
+                                                /* mesh */ mesh}});
+  if (!inserted) {
+    // loaded concurrently by another thread
+    mesh->release();
+  }
+  return it->second.mesh;
 }
 
 physx::PxConvexMesh *MeshManager::loadMesh(const std::string &filename, bool useCache,
-                                           bool saveCache) {
+                                           bool saveCache, uint32_t maxTriangles) {
+  {
+    // meshes loaded from bundles are registered under names that do not exist on disk
+    std::lock_guard<std::mutex> lock(mRegistryLock);
+    auto it = mMeshRegistry.find(filename + simplifiedSuffix(maxTriangles));
+    if (it != mMeshRegistry.end()) {
+      return it->second.mesh;
+    }
+  }
 
   if (!fs::is_regular_file(filename)) {
     spdlog::get("SAPIEN")->error("File not found: {}", filename);
     return nullptr;
   }
 
-  std::string fullPath = fs::canonical(filename);
-  auto it = mMeshRegistry.find(fullPath);
-  if (it != mMeshRegistry.end()) {
-    spdlog::get("SAPIEN")->info("Using loaded mesh: {}", filename);
-    return it->second.mesh;
+  std::string fullPath = std::string(fs::canonical(filename)) + simplifiedSuffix(maxTriangles);
+  {
+    std::lock_guard<std::mutex> lock(mRegistryLock);
+    auto it = mMeshRegistry.find(fullPath);
+    if (it != mMeshRegistry.end()) {
+      spdlog::get("SAPIEN")->info("Using loaded mesh: {}", filename);
+      return it->second.mesh;
+    }
   }
 
   bool cacheDidLoad = false;
   std::string fileToLoad = filename;
   if (useCache) {
-    std::string cachedFilename = getCachedFilename(filename);
+    std::string cachedFilename = getCachedFilename(filename, maxTriangles);
     if (fs::is_regular_file(cachedFilename)) {
       fileToLoad = cachedFilename;
       saveCache = false; // no need to save cache if it is loaded
@@ -318,7 +315,16 @@ physx::PxConvexMesh *MeshManager::loadMesh(const std::string &filename, bool use
     }
   }
 
-  std::vector<PxVec3> vertices = getVerticesFromMeshFile(fileToLoad);
+  std::vector<PxVec3> vertices;
+  if (maxTriangles && !cacheDidLoad) {
+    // fewer hull candidates, at most the 255 a cooked hull may keep; the cooked hull is then
+    // cached like any other
+    std::vector<PxU32> triangles;
+    std::tie(vertices, triangles) = getVerticesAndTrianglesFromMeshFile(fileToLoad);
+    simplifyMesh(vertices, triangles, maxTriangles, 255);
+  } else {
+    vertices = getVerticesFromMeshFile(fileToLoad);
+  }
   PxConvexMeshDesc convexDesc;
   convexDesc.points.count = vertices.size();
   convexDesc.points.stride = sizeof(PxVec3);
@@ -339,63 +345,124 @@ physx::PxConvexMesh *MeshManager::loadMesh(const std::string &filename, bool use
                               std::to_string(convexMesh->getNbVertices()), filename);
 
   if (saveCache) {
-    std::string cachedFilename = getCachedFilename(filename);
-    exportMeshToFile(convexMesh, cachedFilename);
-    spdlog::get("SAPIEN")->info("Saved cache file: {}", cachedFilename);
+    std::string cachedFilename = getCachedFilename(filename, maxTriangles);
+    if (writeFileAtomic(cachedFilename, [&](std::string const &tmpFile) {
+          exportMeshToFile(convexMesh, tmpFile);
+          return fs::is_regular_file(tmpFile);
+        })) {
+      spdlog::get("SAPIEN")->info("Saved cache file: {}", cachedFilename);
+    }
   }
 
-  mMeshRegistry[fullPath] = {/* cached */ cacheDidLoad || saveCache, /* filename */ fullPath,
-                             /* mesh */ convexMesh};
-
-  return convexMesh;
+  std::lock_guard<std::mutex> lock(mRegistryLock);
+  auto [it, inserted] = mMeshRegistry.insert(
+      {fullPath,
+       {/* cached */ cacheDidLoad || saveCache, /* filename */ fullPath, /* mesh */ convexMesh}});
+  if (!inserted) {
+    // loaded concurrently by another thread
+    convexMesh->release();
+  }
+  return it->second.mesh;
 }
 
 std::vector<std::vector<int>> splitMesh(aiMesh *mesh) {
-  // build adjacency list
+  // union-find over vertices, joined along face edges
   spdlog::get("SAPIEN")->info("splitting mesh with {} vertices", mesh->mNumVertices);
-  std::vector<std::set<int>> adj(mesh->mNumVertices);
+  std::vector<int> parent(mesh->mNumVertices);
+  for (uint32_t i = 0; i < mesh->mNumVertices; ++i) {
+    parent[i] = i;
+  }
+  auto find = [&](int v) {
+    while (parent[v] != v) {
+      parent[v] = parent[parent[v]]; // path halving
+      v = parent[v];
+    }
+    return v;
+  };
   for (uint32_t i = 0; i < mesh->mNumFaces; ++i) {
-    for (uint32_t j = 0; j < mesh->mFaces[i].mNumIndices; ++j) {
-      uint32_t a = mesh->mFaces[i].mIndices[j];
-      uint32_t b = mesh->mFaces[i].mIndices[(j + 1) % mesh->mFaces[i].mNumIndices];
-      adj[a].insert(b);
-      adj[b].insert(a);
+    auto &face = mesh->mFaces[i];
+    if (face.mNumIndices == 0) {
+      continue;
+    }
+    int a = find(face.mIndices[0]);
+    for (uint32_t j = 1; j < face.mNumIndices; ++j) {
+      int b = find(face.mIndices[j]);
+      if (a != b) {
+        // attach to the smaller root so groups are ordered by their first vertex
+        if (a > b) {
+          std::swap(a, b);
+        }
+        parent[b] = a;
+      }
     }
   }
 
   std::vector<std::vector<int>> groups;
-  std::vector<int> visited(mesh->mNumVertices, 0);
+  std::vector<int> groupIndex(mesh->mNumVertices, -1);
   for (uint32_t i = 0; i < mesh->mNumVertices; ++i) {
-    if (visited[i]) {
-      continue;
+    int root = find(i);
+    if (groupIndex[root] < 0) {
+      groupIndex[root] = groups.size();
+      groups.emplace_back();
     }
+    groups[groupIndex[root]].push_back(i);
+  }
+  return groups;
+}
 
-    // new group
-    groups.emplace_back();
-    groups.back().push_back(i);
-
-    // traverse group
-    visited[i] = 1;
-    std::vector<int> q;
-    q.push_back(i);
-    while (!q.empty()) {
-      int n = q.back();
-      q.pop_back();
-      for (auto m : adj[n]) {
-        if (!visited[m]) {
-          visited[m] = 1;
-          groups.back().push_back(m);
-          q.push_back(m);
-        }
-      }
+std::string MeshManager::packCookedMeshes(std::vector<std::string> const &cooked) {
+  std::string data;
+  uint32_t count = cooked.size();
+  data.append(reinterpret_cast<char const *>(&count), sizeof(count));
+  for (auto &c : cooked) {
+    uint64_t size = c.size();
+    data.append(reinterpret_cast<char const *>(&size), sizeof(size));
+    data.append(c);
+  }
+  return data;
+}
+
+bool MeshManager::unpackCookedMeshes(std::string_view data,
+                                     std::vector<std::string_view> &cooked) {
+  char const *p = data.data();
+  char const *end = data.data() + data.size();
+  uint32_t count;
+  if (data.size() < sizeof(count)) {
+    return false;
+  }
+  std::memcpy(&count, p, sizeof(count));
+  p += sizeof(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    uint64_t size;
+    if (static_cast<size_t>(end - p) < sizeof(size)) {
+      return false;
+    }
+    std::memcpy(&size, p, sizeof(size));
+    p += sizeof(size);
+    if (static_cast<uint64_t>(end - p) < size) {
+      return false;
     }
+    cooked.emplace_back(p, size);
+    p += size;
   }
+  return true;
+}
 
-  return groups;
+std::string MeshManager::getCachedFilenameGroup(const std::string &filename) {
+  return filename + mCacheSuffixGroup;
 }
 
-std::vector<PxConvexMesh *> MeshManager::loadMeshGroup(const std::string &filename) {
+std::vector<PxConvexMesh *> MeshManager::loadMeshGroup(const std::string &filename,
+                                                       bool useCache, bool saveCache) {
   std::vector<PxConvexMesh *> meshes;
+  {
+    // meshes loaded from bundles are registered under names that do not exist on disk
+    std::lock_guard<std::mutex> lock(mRegistryLock);
+    auto it = mMeshGroupRegistry.find(filename);
+    if (it != mMeshGroupRegistry.end()) {
+      return it->second.meshes;
+    }
+  }
 
   if (!fs::is_regular_file(filename)) {
     spdlog::get("SAPIEN")->error("File not found: {}", filename);
@@ -403,65 +470,361 @@ std::vector<PxConvexMesh *> MeshManager::loadMeshGroup(const std::string &filena
   }
 
   std::string fullPath = fs::canonical(filename);
-  auto it = mMeshGroupRegistry.find(fullPath);
-  if (it != mMeshGroupRegistry.end()) {
-    spdlog::get("SAPIEN")->info("Using loaded mesh group: {}", filename);
-    for (PxConvexMesh *mesh : it->second.meshes) {
-      meshes.push_back(mesh);
+  {
+    std::lock_guard<std::mutex> lock(mRegistryLock);
+    auto it = mMeshGroupRegistry.find(fullPath);
+    if (it != mMeshGroupRegistry.end()) {
+      spdlog::get("SAPIEN")->info("Using loaded mesh group: {}", filename);
+      for (PxConvexMesh *mesh : it->second.meshes) {
+        meshes.push_back(mesh);
+      }
+      return meshes;
     }
-    return meshes;
   }
 
-  // import obj using assimp
-  Assimp::Importer importer;
-  importer.SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS,
-                              aiComponent_NORMALS | aiComponent_TEXCOORDS | aiComponent_COLORS |
-                                  aiComponent_TANGENTS_AND_BITANGENTS | aiComponent_MATERIALS |
-                                  aiComponent_TEXTURES);
+  // cooked pieces of the whole group, valid while newer than the source file
+  std::string cachedFilename = getCachedFilenameGroup(filename);
+  std::error_code ec;
+  if (useCache && fs::is_regular_file(cachedFilename) &&
+      fs::last_write_time(cachedFilename, ec) >= fs::last_write_time(filename, ec)) {
+    std::ifstream in(cachedFilename, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::vector<std::string_view> cooked;
+    if (unpackCookedMeshes(data, cooked)) {
+      for (auto &c : cooked) {
+        PxDefaultMemoryInputData input(reinterpret_cast<PxU8 *>(const_cast<char *>(c.data())),
+                                       c.size());
+        meshes.push_back(mSimulation->mPhysicsSDK->createConvexMesh(input));
+      }
+    }
+    if (!cooked.empty() && std::all_of(meshes.begin(), meshes.end(), [](auto m) { return m; })) {
+      spdlog::get("SAPIEN")->info("Loaded {} convex pieces from cache file: {}", meshes.size(),
+                                  cachedFilename);
+      saveCache = false;
+    } else {
+      // stale format or different PhysX version
+      spdlog::get("SAPIEN")->warn("Ignoring invalid cache file: {}", cachedFilename);
+      for (auto mesh : meshes) {
+        if (mesh) {
+          mesh->release();
+        }
+      }
+      meshes.clear();
+    }
+  }
 
-  uint32_t flags =
-      aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_RemoveComponent;
+  if (meshes.empty()) {
+    // import obj using assimp
+    Assimp::Importer importer;
+    importer.SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS,
+                                aiComponent_NORMALS | aiComponent_TEXCOORDS |
+                                    aiComponent_COLORS | aiComponent_TANGENTS_AND_BITANGENTS |
+                                    aiComponent_MATERIALS | aiComponent_TEXTURES);
+
+    uint32_t flags =
+        aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_RemoveComponent;
+
+    const aiScene *scene = importer.ReadFile(filename, flags);
+    if (!scene) {
+      spdlog::get("SAPIEN")->error(importer.GetErrorString());
+      return meshes;
+    }
 
-  const aiScene *scene = importer.ReadFile(filename, flags);
-  if (!scene) {
-    spdlog::get("SAPIEN")->error(importer.GetErrorString());
-    return meshes;
+    spdlog::get("SAPIEN")->info("Found {} meshes", scene->mNumMeshes);
+    std::vector<std::vector<PxVec3>> pieces;
+    for (uint32_t i = 0; i < scene->mNumMeshes; ++i) {
+      auto mesh = scene->mMeshes[i];
+      auto vertexGroups = splitMesh(mesh);
+
+      spdlog::get("SAPIEN")->info("Decomposed mesh {} into {} components", i + 1,
+                                  vertexGroups.size());
+      for (auto &g : vertexGroups) {
+        spdlog::get("SAPIEN")->info("vertex count: {}", g.size());
+        std::vector<PxVec3> vertices;
+        vertices.reserve(g.size());
+        for (auto v : g) {
+          auto vertex = mesh->mVertices[v];
+          vertices.push_back({vertex.x, vertex.y, vertex.z});
+        }
+        pieces.push_back(std::move(vertices));
+      }
+    }
+
+    // cooking is independent per piece, the cooking library is thread safe
+    std::vector<std::string> cooked(pieces.size());
+    parallelFor(defaultThreadPool(), pieces.size(), 1, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        PxConvexMeshDesc convexDesc;
+        convexDesc.points.count = pieces[i].size();
+        convexDesc.points.stride = sizeof(PxVec3);
+        convexDesc.points.data = pieces[i].data();
+        convexDesc.flags = PxConvexFlag::eCOMPUTE_CONVEX; // | PxConvexFlag::eSHIFT_VERTICES;
+        convexDesc.vertexLimit = 256;
+
+        PxDefaultMemoryOutputStream buf;
+        PxConvexMeshCookingResult::Enum result;
+        if (!mSimulation->mCooking->cookConvexMesh(convexDesc, buf, &result)) {
+          spdlog::get("SAPIEN")->error("Failed to cook a mesh from file: {}", filename);
+          continue;
+        }
+        cooked[i] = std::string(reinterpret_cast<char const *>(buf.getData()), buf.getSize());
+      }
+    });
+
+    bool complete = true;
+    for (auto &c : cooked) {
+      if (c.empty()) {
+        complete = false;
+        meshes.push_back(nullptr);
+        continue;
+      }
+      PxDefaultMemoryInputData input(reinterpret_cast<PxU8 *>(c.data()), c.size());
+      meshes.push_back(mSimulation->mPhysicsSDK->createConvexMesh(input));
+    }
+
+    if (saveCache && complete && writeFileAtomic(cachedFilename, packCookedMeshes(cooked))) {
+      spdlog::get("SAPIEN")->info("Saved cache file: {}", cachedFilename);
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mRegistryLock);
+  auto [it, inserted] = mMeshGroupRegistry.insert({fullPath, {fullPath, meshes}});
+  if (!inserted) {
+    // loaded concurrently by another thread
+    for (auto mesh : meshes) {
+      if (mesh) {
+        mesh->release();
+      }
+    }
+  }
+  return it->second.meshes;
+}
+
+static uint64_t hashBytes(uint64_t hash, void const *data, size_t size) {
+  // FNV-1a, stable across processes so it can name cache files
+  auto bytes = static_cast<unsigned char const *>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+std::vector<PxConvexMesh *>
+MeshManager::loadDecomposedMesh(const std::string &filename,
+                                ConvexDecompositionConfig const &config, bool useCache,
+                                bool saveCache) {
+  std::error_code ec;
+  std::string fullPath = fs::canonical(filename, ec);
+  if (ec) {
+    spdlog::get("SAPIEN")->error("File not found: {}", filename);
+    return {};
+  }
+  auto mtime = fs::last_write_time(fullPath, ec);
+  uint64_t configHash = hashBytes(14695981039346656037ull, &config.resolution,
+                                  sizeof(config.resolution));
+  configHash = hashBytes(configHash, &config.maxConvexHulls, sizeof(config.maxConvexHulls));
+  configHash = hashBytes(configHash, &config.maxConcavity, sizeof(config.maxConcavity));
+  configHash = hashBytes(configHash, &config.planeSamples, sizeof(config.planeSamples));
+  std::string fileKey = fullPath + ":" + std::to_string(configHash);
+
+  std::string key;
+  {
+    std::lock_guard<std::mutex> lock(mRegistryLock);
+    auto it = mDecomposedFileKeys.find(fileKey);
+    if (it != mDecomposedFileKeys.end() && it->second.mtime == mtime) {
+      key = it->second.key;
+      auto mesh = mDecomposedMeshRegistry.find(key);
+      if (mesh != mDecomposedMeshRegistry.end()) {
+        spdlog::get("SAPIEN")->info("Using decomposed mesh: {}", filename);
+        return mesh->second.meshes;
+      }
+    }
+  }
+
+  if (key.empty()) {
+    // identical files share decompositions, so key them by content
+    std::ifstream file(fullPath, std::ios::binary);
+    if (!file) {
+      spdlog::get("SAPIEN")->error("File not found: {}", filename);
+      return {};
+    }
+    std::string content((std::istreambuf_iterator<char>(file)),
+                        std::istreambuf_iterator<char>());
+    uint64_t hash = hashBytes(14695981039346656037ull, content.data(), content.size());
+    hash = hashBytes(hash, &configHash, sizeof(configHash));
+    std::stringstream ss;
+    ss << std::hex << hash;
+    key = ss.str();
+
+    std::lock_guard<std::mutex> lock(mRegistryLock);
+    mDecomposedFileKeys[fileKey] = {mtime, key};
+    auto it = mDecomposedMeshRegistry.find(key);
+    if (it != mDecomposedMeshRegistry.end()) {
+      spdlog::get("SAPIEN")->info("Using decomposed mesh: {}", filename);
+      return it->second.meshes;
+    }
   }
 
-  spdlog::get("SAPIEN")->info("Found {} meshes", scene->mNumMeshes);
-  for (uint32_t i = 0; i < scene->mNumMeshes; ++i) {
-    auto mesh = scene->mMeshes[i];
-    auto vertexGroups = splitMesh(mesh);
+  std::string cachedFilename = mDecompositionCacheDirectory.empty()
+                                   ? filename + ".decomp_" + key + ".bin"
+                                   : (fs::path(mDecompositionCacheDirectory) /
+                                      (key + ".decomp.bin"))
+                                         .string();
 
-    spdlog::get("SAPIEN")->info("Decomposed mesh {} into {} components", i + 1,
-                                vertexGroups.size());
-    for (auto &g : vertexGroups) {
-      spdlog::get("SAPIEN")->info("vertex count: {}", g.size());
-      std::vector<PxVec3> vertices;
-      for (auto v : g) {
-        auto vertex = mesh->mVertices[v];
-        vertices.push_back({vertex.x, vertex.y, vertex.z});
+  std::vector<PxConvexMesh *> meshes;
+  std::vector<std::string> cooked;
+  auto createMeshes = [&]() {
+    for (auto &c : cooked) {
+      PxDefaultMemoryInputData input(reinterpret_cast<PxU8 *>(c.data()), c.size());
+      if (PxConvexMesh *mesh = mSimulation->mPhysicsSDK->createConvexMesh(input)) {
+        meshes.push_back(mesh);
+      }
+    }
+    if (meshes.size() == cooked.size()) {
+      return true;
+    }
+    for (auto mesh : meshes) {
+      mesh->release();
+    }
+    meshes.clear();
+    return false;
+  };
+
+  if (useCache && fs::is_regular_file(cachedFilename)) {
+    std::ifstream in(cachedFilename, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::vector<std::string_view> parts;
+    if (unpackCookedMeshes(data, parts)) {
+      for (auto &p : parts) {
+        cooked.emplace_back(p);
       }
+    }
+    if (!cooked.empty() && createMeshes()) {
+      saveCache = false;
+    } else {
+      // stale format or different PhysX version
+      spdlog::get("SAPIEN")->warn("Ignoring invalid cache file: {}", cachedFilename);
+      cooked.clear();
+    }
+  }
+
+  if (meshes.empty()) {
+    auto mesh = MeshCache::Get().load(filename);
+    if (!mesh) {
+      return {};
+    }
+    auto parts = decomposeConvex(mesh->getVertices(), mesh->getTriangles(), config,
+                                 *mSimulation->mCooking, *mSimulation->mPhysicsSDK);
+    spdlog::get("SAPIEN")->info("Decomposed {} into {} convex parts", filename, parts.size());
+    for (auto &points : parts) {
       PxConvexMeshDesc convexDesc;
-      convexDesc.points.count = vertices.size();
+      convexDesc.points.count = points.size();
       convexDesc.points.stride = sizeof(PxVec3);
-      convexDesc.points.data = vertices.data();
-      convexDesc.flags = PxConvexFlag::eCOMPUTE_CONVEX; // | PxConvexFlag::eSHIFT_VERTICES;
+      convexDesc.points.data = points.data();
+      convexDesc.flags = PxConvexFlag::eCOMPUTE_CONVEX;
       convexDesc.vertexLimit = 256;
-
       PxDefaultMemoryOutputStream buf;
-      PxConvexMeshCookingResult::Enum result;
-      if (!mSimulation->mCooking->cookConvexMesh(convexDesc, buf, &result)) {
-        spdlog::get("SAPIEN")->error("Failed to cook a mesh from file: {}", filename);
+      if (!mSimulation->mCooking->cookConvexMesh(convexDesc, buf)) {
+        spdlog::get("SAPIEN")->warn("Skipping degenerate convex part of {}", filename);
+        continue;
       }
-      PxDefaultMemoryInputData input(buf.getData(), buf.getSize());
-      PxConvexMesh *convexMesh = mSimulation->mPhysicsSDK->createConvexMesh(input);
-      meshes.push_back(convexMesh);
+      cooked.emplace_back(reinterpret_cast<char const *>(buf.getData()), buf.getSize());
+    }
+    if (!createMeshes()) {
+      spdlog::get("SAPIEN")->error("Failed to create decomposed meshes: {}", filename);
+      return {};
+    }
+  }
+
+  if (saveCache && !meshes.empty() &&
+      writeFileAtomic(cachedFilename, packCookedMeshes(cooked))) {
+    spdlog::get("SAPIEN")->info("Saved cache file: {}", cachedFilename);
+  }
+
+  std::lock_guard<std::mutex> lock(mRegistryLock);
+  auto [it, inserted] = mDecomposedMeshRegistry.insert({key, {filename, meshes}});
+  if (!inserted) {
+    // loaded concurrently by another thread
+    for (auto mesh : meshes) {
+      mesh->release();
     }
   }
+  return it->second.meshes;
+}
+
+std::string MeshManager::cookConvexMesh(PxConvexMesh *mesh) {
+  // the hull of the hull vertices is the mesh itself
+  PxConvexMeshDesc convexDesc;
+  convexDesc.points.count = mesh->getNbVertices();
+  convexDesc.points.stride = sizeof(PxVec3);
+  convexDesc.points.data = mesh->getVertices();
+  convexDesc.flags = PxConvexFlag::eCOMPUTE_CONVEX;
+  convexDesc.vertexLimit = 256;
+
+  PxDefaultMemoryOutputStream buf;
+  if (!mSimulation->mCooking->cookConvexMesh(convexDesc, buf)) {
+    throw std::runtime_error("Failed to cook convex mesh");
+  }
+  return std::string(reinterpret_cast<char const *>(buf.getData()), buf.getSize());
+}
 
-  mMeshGroupRegistry[fullPath] = {fullPath, meshes};
-  return meshes;
+PxConvexMesh *MeshManager::loadMeshFromCooked(const std::string &filename,
+                                              std::string_view data) {
+  std::lock_guard<std::mutex> lock(mRegistryLock);
+  auto it = mMeshRegistry.find(filename);
+  if (it != mMeshRegistry.end()) {
+    return it->second.mesh;
+  }
+  PxDefaultMemoryInputData input(
+      reinterpret_cast<PxU8 *>(const_cast<char *>(data.data())), data.size());
+  PxConvexMesh *mesh = mSimulation->mPhysicsSDK->createConvexMesh(input);
+  if (!mesh) {
+    spdlog::get("SAPIEN")->error("Failed to create cooked mesh: {}", filename);
+    return nullptr;
+  }
+  mMeshRegistry[filename] = {/* cached */ true, /* filename */ filename, /* mesh */ mesh};
+  return mesh;
+}
+
+std::vector<PxConvexMesh *>
+MeshManager::loadMeshGroupFromCooked(const std::string &filename,
+                                     std::vector<std::string_view> const &data) {
+  std::lock_guard<std::mutex> lock(mRegistryLock);
+  auto it = mMeshGroupRegistry.find(filename);
+  if (it != mMeshGroupRegistry.end()) {
+    return it->second.meshes;
+  }
+  MeshGroupRecord record;
+  record.filename = filename;
+  for (auto &d : data) {
+    PxDefaultMemoryInputData input(reinterpret_cast<PxU8 *>(const_cast<char *>(d.data())),
+                                   d.size());
+    if (PxConvexMesh *mesh = mSimulation->mPhysicsSDK->createConvexMesh(input)) {
+      record.meshes.push_back(mesh);
+    } else {
+      spdlog::get("SAPIEN")->error("Failed to create part of cooked mesh group: {}", filename);
+    }
+  }
+  mMeshGroupRegistry[filename] = record;
+  return record.meshes;
+}
+
+void MeshManager::releaseCooked(std::string const &prefix) {
+  std::lock_guard<std::mutex> lock(mRegistryLock);
+  // shapes keep their own references, so meshes in use stay alive
+  for (auto it = mMeshRegistry.lower_bound(prefix);
+       it != mMeshRegistry.end() && it->first.rfind(prefix, 0) == 0;) {
+    it->second.mesh->release();
+    it = mMeshRegistry.erase(it);
+  }
+  for (auto it = mMeshGroupRegistry.lower_bound(prefix);
+       it != mMeshGroupRegistry.end() && it->first.rfind(prefix, 0) == 0;) {
+    for (auto mesh : it->second.meshes) {
+      mesh->release();
+    }
+    it = mMeshGroupRegistry.erase(it);
+  }
 }
 
 } // namespace sapien
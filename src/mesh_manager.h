@@ -1,8 +1,12 @@
 #pragma once
+#include "convex_decomposition.h"
 #include <PxPhysicsAPI.h>
+#include <filesystem>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace sapien {
@@ -29,28 +33,75 @@ class MeshManager {
 private:
   std::string mCacheSuffix = ".convex.stl";
   std::string mCacheSuffixNonConvex = ".nonconvex.stl";
+  std::string mCacheSuffixGroup = ".convex_group.bin";
+  std::string mDecompositionCacheDirectory = "";
 
   Simulation *mSimulation;
+
+  // loading functions may be called from asset loading threads
+  std::mutex mRegistryLock;
   std::map<std::string, NonConvexMeshRecord> mNonConvexMeshRegistry;
   std::map<std::string, MeshRecord> mMeshRegistry;
   std::map<std::string, MeshGroupRecord> mMeshGroupRegistry;
+  std::map<std::string, MeshGroupRecord> mDecomposedMeshRegistry;
+
+  // content keys of decomposed files by canonical path and config, valid while the file is
+  // unmodified, so repeated loads skip reading and hashing the file
+  struct DecomposedFileKey {
+    std::filesystem::file_time_type mtime;
+    std::string key;
+  };
+  std::map<std::string, DecomposedFileKey> mDecomposedFileKeys;
 
 public:
   explicit MeshManager(Simulation *simulation);
 
+  /* A nonzero maxTriangles decimates the mesh to at most that many triangles before cooking.
+   * Simplified meshes are registered and cached separately for each budget. */
   physx::PxTriangleMesh *loadNonConvexMesh(const std::string &filename, bool useCache = true,
-                                           bool saveCache = true);
+                                           bool saveCache = true, uint32_t maxTriangles = 0);
 
   physx::PxConvexMesh *loadMesh(const std::string &filename, bool useCache = true,
-                                bool saveCache = true);
+                                bool saveCache = true, uint32_t maxTriangles = 0);
+
+  /* Split the file into connected components and cook each as a convex mesh. The cooked
+   * pieces are cached in a single file next to the mesh. */
+  std::vector<physx::PxConvexMesh *> loadMeshGroup(const std::string &filename,
+                                                   bool useCache = true, bool saveCache = true);
 
-  std::vector<physx::PxConvexMesh *> loadMeshGroup(const std::string &filename);
+  /* Approximate convex decomposition of a non-convex mesh, usable by dynamic actors. Results
+   * are cached on disk by a hash of the file content and the config, so each asset is
+   * decomposed once. */
+  std::vector<physx::PxConvexMesh *>
+  loadDecomposedMesh(const std::string &filename, ConvexDecompositionConfig const &config = {},
+                     bool useCache = true, bool saveCache = true);
+
+  /* Asset bundles store cooked convex meshes. Meshes created from cooked data are registered
+   * under the given name, which the URDF loader scopes to the bundle, so later loads of that
+   * name skip the file system. releaseCooked drops the registrations under a scope. */
+  std::string cookConvexMesh(physx::PxConvexMesh *mesh);
+  static std::string packCookedMeshes(std::vector<std::string> const &cooked);
+  static bool unpackCookedMeshes(std::string_view data, std::vector<std::string_view> &cooked);
+  physx::PxConvexMesh *loadMeshFromCooked(const std::string &filename, std::string_view data);
+  std::vector<physx::PxConvexMesh *>
+  loadMeshGroupFromCooked(const std::string &filename, std::vector<std::string_view> const &data);
+  void releaseCooked(std::string const &prefix);
 
 public:
   // cache config
 
   void setCacheSuffix(const std::string &filename);
-  std::string getCachedFilename(const std::string &filename);
-  std::string getCachedFilenameNonConvex(const std::string &filename);
+  std::string getCachedFilename(const std::string &filename, uint32_t maxTriangles = 0);
+  std::string getCachedFilenameNonConvex(const std::string &filename, uint32_t maxTriangles = 0);
+  std::string getCachedFilenameGroup(const std::string &filename);
+
+  /* Directory for decomposition caches, shared by identical files. If empty, caches are
+   * stored next to each mesh file. */
+  inline void setDecompositionCacheDirectory(std::string const &dir) {
+    mDecompositionCacheDirectory = dir;
+  }
+  inline std::string getDecompositionCacheDirectory() const {
+    return mDecompositionCacheDirectory;
+  }
 };
 } // namespace sapien
@@ -0,0 +1,340 @@
+#include "mesh_simplification.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <queue>
+#include <unordered_map>
+
+namespace sapien {
+using namespace physx;
+
+namespace {
+
+/* symmetric 4x4 matrix: a2 ab ac ad b2 bc bd c2 cd d2 */
+struct Quadric {
+  std::array<double, 10> q{};
+
+  static Quadric Plane(double a, double b, double c, double d, double w) {
+    Quadric r;
+    r.q = {a * a, a * b, a * c, a * d, b * b, b * c, b * d, c * c, c * d, d * d};
+    for (auto &x : r.q) {
+      x *= w;
+    }
+    return r;
+  }
+
+  Quadric &operator+=(Quadric const &other) {
+    for (int i = 0; i < 10; ++i) {
+      q[i] += other.q[i];
+    }
+    return *this;
+  }
+
+  double error(PxVec3 const &v) const {
+    double x = v.x, y = v.y, z = v.z;
+    return q[0] * x * x + 2 * q[1] * x * y + 2 * q[2] * x * z + 2 * q[3] * x + q[4] * y * y +
+           2 * q[5] * y * z + 2 * q[6] * y + q[7] * z * z + 2 * q[8] * z + q[9];
+  }
+
+  /* point minimizing the error, false if the system is singular */
+  bool optimum(PxVec3 &out) const {
+    double a00 = q[0], a01 = q[1], a02 = q[2], a11 = q[4], a12 = q[5], a22 = q[7];
+    double b0 = -q[3], b1 = -q[6], b2 = -q[8];
+    double c00 = a11 * a22 - a12 * a12;
+    double c01 = a02 * a12 - a01 * a22;
+    double c02 = a01 * a12 - a02 * a11;
+    double det = a00 * c00 + a01 * c01 + a02 * c02;
+    if (std::abs(det) < 1e-12) {
+      return false;
+    }
+    double c11 = a00 * a22 - a02 * a02;
+    double c12 = a01 * a02 - a00 * a12;
+    double c22 = a00 * a11 - a01 * a01;
+    out = PxVec3((c00 * b0 + c01 * b1 + c02 * b2) / det, (c01 * b0 + c11 * b1 + c12 * b2) / det,
+                 (c02 * b0 + c12 * b1 + c22 * b2) / det);
+    return true;
+  }
+};
+
+struct Collapse {
+  double cost;
+  uint32_t u, v;
+  uint32_t versionU, versionV;
+  PxVec3 target;
+  bool operator>(Collapse const &other) const { return cost > other.cost; }
+};
+
+} // namespace
+
+void simplifyMesh(std::vector<PxVec3> &vertices, std::vector<PxU32> &triangles,
+                  uint32_t targetTriangles, uint32_t targetVertices) {
+  // weld identical positions, formats like STL store every face separately
+  std::vector<PxVec3> positions;
+  std::vector<std::array<uint32_t, 3>> faces;
+  {
+    struct Hash {
+      size_t operator()(std::array<uint32_t, 3> const &k) const {
+        return (size_t(k[0]) * 73856093) ^ (size_t(k[1]) * 19349663) ^ (size_t(k[2]) * 83492791);
+      }
+    };
+    std::unordered_map<std::array<uint32_t, 3>, uint32_t, Hash> welded;
+    std::vector<uint32_t> remap(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+      // adding zero turns -0 into +0 so both weld
+      PxVec3 p = vertices[i] + PxVec3(0.f);
+      std::array<uint32_t, 3> key;
+      std::memcpy(key.data(), &p, sizeof(key));
+      auto [it, inserted] = welded.insert({key, static_cast<uint32_t>(positions.size())});
+      if (inserted) {
+        positions.push_back(p);
+      }
+      remap[i] = it->second;
+    }
+    for (size_t t = 0; t + 2 < triangles.size(); t += 3) {
+      std::array<uint32_t, 3> f = {remap[triangles[t]], remap[triangles[t + 1]],
+                                   remap[triangles[t + 2]]};
+      if (f[0] != f[1] && f[1] != f[2] && f[0] != f[2]) {
+        faces.push_back(f);
+      }
+    }
+  }
+  uint32_t nv = positions.size();
+  uint32_t vertexCount = 0;
+  {
+    std::vector<bool> used(nv, false);
+    for (auto &face : faces) {
+      for (uint32_t i : face) {
+        vertexCount += !used[i];
+        used[i] = true;
+      }
+    }
+  }
+  auto overBudget = [&](uint32_t faceCount, uint32_t vertexCount) {
+    return (targetTriangles && faceCount > targetTriangles) ||
+           (targetVertices && vertexCount > targetVertices);
+  };
+  if (!overBudget(faces.size(), vertexCount)) {
+    return;
+  }
+
+  std::vector<Quadric> quadrics(nv);
+  std::vector<std::vector<uint32_t>> vertexFaces(nv);
+  std::unordered_map<uint64_t, uint32_t> edgeCount;
+  auto edgeKey = [](uint32_t a, uint32_t b) {
+    return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+  };
+  for (uint32_t f = 0; f < faces.size(); ++f) {
+    auto &face = faces[f];
+    PxVec3 n = (positions[face[1]] - positions[face[0]])
+                   .cross(positions[face[2]] - positions[face[0]]);
+    double area = n.magnitude() * 0.5;
+    n.normalizeSafe();
+    auto plane = Quadric::Plane(n.x, n.y, n.z, -n.dot(positions[face[0]]), area);
+    for (int i = 0; i < 3; ++i) {
+      quadrics[face[i]] += plane;
+      vertexFaces[face[i]].push_back(f);
+      edgeCount[edgeKey(face[i], face[(i + 1) % 3])]++;
+    }
+  }
+
+  // keep open boundaries in place with planes perpendicular to their faces
+  for (uint32_t f = 0; f < faces.size(); ++f) {
+    auto &face = faces[f];
+    PxVec3 n = (positions[face[1]] - positions[face[0]])
+                   .cross(positions[face[2]] - positions[face[0]])
+                   .getNormalized();
+    for (int i = 0; i < 3; ++i) {
+      uint32_t a = face[i], b = face[(i + 1) % 3];
+      if (edgeCount[edgeKey(a, b)] != 1) {
+        continue;
+      }
+      PxVec3 e = positions[b] - positions[a];
+      PxVec3 m = e.cross(n).getNormalized();
+      auto plane =
+          Quadric::Plane(m.x, m.y, m.z, -m.dot(positions[a]), 1000. * e.magnitudeSquared());
+      quadrics[a] += plane;
+      quadrics[b] += plane;
+    }
+  }
+
+  std::vector<uint32_t> versions(nv, 0);
+  std::vector<bool> vertexRemoved(nv, false);
+  std::vector<bool> faceRemoved(faces.size(), false);
+  std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> heap;
+
+  auto pushEdge = [&](uint32_t u, uint32_t v) {
+    Quadric q = quadrics[u];
+    q += quadrics[v];
+    PxVec3 target;
+    if (!q.optimum(target)) {
+      target = (positions[u] + positions[v]) * 0.5f;
+      for (auto &p : {positions[u], positions[v]}) {
+        if (q.error(p) < q.error(target)) {
+          target = p;
+        }
+      }
+    }
+    heap.push({q.error(target), u, v, versions[u], versions[v], target});
+  };
+  for (auto &[key, count] : edgeCount) {
+    pushEdge(key >> 32, key & 0xffffffff);
+  }
+
+  // rejects collapses that flip a face around vertex a when it moves to target
+  auto flips = [&](uint32_t a, uint32_t b, PxVec3 const &target) {
+    for (uint32_t f : vertexFaces[a]) {
+      auto &face = faces[f];
+      if (faceRemoved[f] || face[0] == b || face[1] == b || face[2] == b) {
+        continue;
+      }
+      PxVec3 p[3] = {positions[face[0]], positions[face[1]], positions[face[2]]};
+      PxVec3 before = (p[1] - p[0]).cross(p[2] - p[0]);
+      for (int i = 0; i < 3; ++i) {
+        if (face[i] == a) {
+          p[i] = target;
+        }
+      }
+      PxVec3 after = (p[1] - p[0]).cross(p[2] - p[0]);
+      if (before.dot(after) <= 0.f) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  // vertices sharing a face with a, sorted
+  auto ring = [&](uint32_t a) {
+    std::vector<uint32_t> result;
+    for (uint32_t f : vertexFaces[a]) {
+      if (faceRemoved[f]) {
+        continue;
+      }
+      for (uint32_t i : faces[f]) {
+        if (i != a) {
+          result.push_back(i);
+        }
+      }
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+  };
+
+  // edges opposite to a in its faces, sorted
+  auto oppositeEdges = [&](uint32_t a) {
+    std::vector<uint64_t> result;
+    for (uint32_t f : vertexFaces[a]) {
+      if (faceRemoved[f]) {
+        continue;
+      }
+      auto &face = faces[f];
+      for (int i = 0; i < 3; ++i) {
+        if (face[i] == a) {
+          result.push_back(edgeKey(face[(i + 1) % 3], face[(i + 2) % 3]));
+        }
+      }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+  };
+
+  // link condition: the links of a and b only share the apexes of the faces on edge ab, and
+  // no edge. Otherwise the collapse pinches the surface into a non-manifold edge or folds a
+  // tetrahedron flat.
+  auto linkCondition = [&](uint32_t a, uint32_t b) {
+    auto ringA = ring(a), ringB = ring(b);
+    std::vector<uint32_t> common;
+    std::set_intersection(ringA.begin(), ringA.end(), ringB.begin(), ringB.end(),
+                          std::back_inserter(common));
+    uint32_t apexes = 0;
+    for (uint32_t f : vertexFaces[a]) {
+      auto &face = faces[f];
+      apexes += !faceRemoved[f] && (face[0] == b || face[1] == b || face[2] == b);
+    }
+    if (common.size() != apexes) {
+      return false;
+    }
+    auto edgesA = oppositeEdges(a), edgesB = oppositeEdges(b);
+    std::vector<uint64_t> commonEdges;
+    std::set_intersection(edgesA.begin(), edgesA.end(), edgesB.begin(), edgesB.end(),
+                          std::back_inserter(commonEdges));
+    return commonEdges.empty();
+  };
+
+  uint32_t faceCount = faces.size();
+  while (overBudget(faceCount, vertexCount) && !heap.empty()) {
+    Collapse c = heap.top();
+    heap.pop();
+    if (vertexRemoved[c.u] || vertexRemoved[c.v] || versions[c.u] != c.versionU ||
+        versions[c.v] != c.versionV) {
+      continue;
+    }
+    if (!linkCondition(c.u, c.v) || flips(c.u, c.v, c.target) || flips(c.v, c.u, c.target)) {
+      continue;
+    }
+
+    // merge v into u
+    positions[c.u] = c.target;
+    quadrics[c.u] += quadrics[c.v];
+    vertexRemoved[c.v] = true;
+    vertexCount--;
+    versions[c.u]++;
+    for (uint32_t f : vertexFaces[c.v]) {
+      if (faceRemoved[f]) {
+        continue;
+      }
+      auto &face = faces[f];
+      if (face[0] == c.u || face[1] == c.u || face[2] == c.u) {
+        faceRemoved[f] = true;
+        faceCount--;
+        continue;
+      }
+      for (auto &i : face) {
+        if (i == c.v) {
+          i = c.u;
+        }
+      }
+      vertexFaces[c.u].push_back(f);
+    }
+    vertexFaces[c.v].clear();
+
+    auto &uFaces = vertexFaces[c.u];
+    uFaces.erase(std::remove_if(uFaces.begin(), uFaces.end(),
+                                [&](uint32_t f) { return faceRemoved[f]; }),
+                 uFaces.end());
+    std::vector<uint32_t> neighbors;
+    for (uint32_t f : uFaces) {
+      for (uint32_t i : faces[f]) {
+        if (i != c.u) {
+          neighbors.push_back(i);
+        }
+      }
+    }
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+    for (uint32_t n : neighbors) {
+      pushEdge(c.u, n);
+    }
+  }
+
+  // compact
+  std::vector<uint32_t> remap(nv, UINT32_MAX);
+  vertices.clear();
+  triangles.clear();
+  for (uint32_t f = 0; f < faces.size(); ++f) {
+    if (faceRemoved[f]) {
+      continue;
+    }
+    for (uint32_t i : faces[f]) {
+      if (remap[i] == UINT32_MAX) {
+        remap[i] = vertices.size();
+        vertices.push_back(positions[i]);
+      }
+      triangles.push_back(remap[i]);
+    }
+  }
+}
+
+} // namespace sapien
@@ -0,0 +1,18 @@
+#pragma once
+#include <PxPhysicsAPI.h>
+#include <vector>
+
+namespace sapien {
+
+/** Quadric error edge-collapse decimation (Garland and Heckbert)
+ *
+ *  Identical vertex positions are welded first. Edges are collapsed in order of quadric error
+ *  until at most targetTriangles triangles and targetVertices vertices remain, 0 meaning no
+ *  limit. Collapses that flip a face or fail the link condition (which would pinch the surface
+ *  into a non-manifold edge) are rejected and open boundaries are weighted to stay in place.
+ *  Vertices and triangles are replaced by the compacted result.
+ */
+void simplifyMesh(std::vector<physx::PxVec3> &vertices, std::vector<physx::PxU32> &triangles,
+                  uint32_t targetTriangles, uint32_t targetVertices = 0);
+
+} // namespace sapien
@@ -0,0 +1,231 @@
+#include "point_cloud_builder.h"
+#include "sapien_camera.h"
+#include <algorithm>
+#include <cmath>
+#include <latch>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace sapien {
+
+static constexpr uint32_t kRowsPerTask = 32;
+// fixed so the output order does not depend on the thread count
+static constexpr uint32_t kPartitions = 64;
+
+PointCloudBuilder::PointCloudBuilder(uint32_t threadCount)
+    : mThreadPool(threadCount ? threadCount : std::thread::hardware_concurrency()) {}
+
+void PointCloudBuilder::setDepthRange(float minDepth, float maxDepth) {
+  if (minDepth < 0.f || maxDepth < minDepth) {
+    throw std::invalid_argument("invalid depth range");
+  }
+  mMinDepth = minDepth;
+  mMaxDepth = maxDepth;
+}
+
+void PointCloudBuilder::setVoxelSize(float size) {
+  if (size < 0.f) {
+    throw std::invalid_argument("voxel size must not be negative");
+  }
+  mVoxelSize = size;
+}
+
+void PointCloudBuilder::setSegmentationFilter(std::vector<uint32_t> ids, uint32_t level) {
+  if (level > 1) {
+    throw std::invalid_argument("segmentation level must be 0 (visual) or 1 (actor)");
+  }
+  std::sort(ids.begin(), ids.end());
+  mSegmentationIds = std::move(ids);
+  mSegmentationLevel = level;
+}
+
+namespace {
+struct CameraImages {
+  uint32_t width, height;
+  physx::PxTransform pose;
+  std::vector<float> position;
+  std::vector<float> color;
+  std::vector<uint32_t> segmentation;
+};
+} // namespace
+
+PointCloud PointCloudBuilder::build(std::vector<SCamera *> const &cameras, bool withColor,
+                                    bool withLabel) {
+  bool filter = !mSegmentationIds.empty();
+
+  // downloads wait for the GPU, fetch them before splitting the work
+  std::vector<CameraImages> images;
+  images.reserve(cameras.size());
+  for (auto cam : cameras) {
+    auto renderCam = cam->getRendererCamera();
+    CameraImages image{renderCam->getWidth(), renderCam->getHeight(), renderCam->getPose()};
+    image.position = renderCam->getFloatImage("Position");
+    if (withColor) {
+      image.color = renderCam->getFloatImage("Color");
+    }
+    if (withLabel || filter) {
+      image.segmentation = renderCam->getUintImage("Segmentation");
+    }
+    images.push_back(std::move(image));
+  }
+
+  struct Task {
+    uint32_t camera, rowBegin, rowEnd;
+    PointCloud cloud;
+  };
+  std::vector<Task> tasks;
+  for (uint32_t c = 0; c < images.size(); ++c) {
+    for (uint32_t row = 0; row < images[c].height; row += kRowsPerTask) {
+      tasks.push_back({c, row, std::min(row + kRowsPerTask, images[c].height), {}});
+    }
+  }
+
+  std::latch done(tasks.size());
+  for (auto &task : tasks) {
+    mThreadPool.submit([&, this]() {
+      auto &image = images[task.camera];
+      auto &cloud = task.cloud;
+      for (size_t i = size_t(task.rowBegin) * image.width; i < size_t(task.rowEnd) * image.width;
+           ++i) {
+        float const *p = &image.position[4 * i];
+        float depth = -p[2];
+        // the fourth channel is the depth buffer value, 1 for background
+        if (p[3] >= 1.f || depth < mMinDepth || depth > mMaxDepth) {
+          continue;
+        }
+        uint32_t label = filter || withLabel ? image.segmentation[4 * i + mSegmentationLevel] : 0;
+        if (filter && !std::binary_search(mSegmentationIds.begin(), mSegmentationIds.end(),
+                                          label)) {
+          continue;
+        }
+        auto world = image.pose.transform(physx::PxVec3(p[0], p[1], p[2]));
+        cloud.points.insert(cloud.points.end(), {world.x, world.y, world.z});
+        if (withColor) {
+          float const *c = &image.color[4 * i];
+          cloud.colors.insert(cloud.colors.end(), {c[0], c[1], c[2]});
+        }
+        if (withLabel) {
+          cloud.labels.push_back(label);
+        }
+      }
+      done.count_down();
+    });
+  }
+  done.wait();
+
+  PointCloud result;
+  for (auto &task : tasks) {
+    auto &cloud = task.cloud;
+    result.points.insert(result.points.end(), cloud.points.begin(), cloud.points.end());
+    result.colors.insert(result.colors.end(), cloud.colors.begin(), cloud.colors.end());
+    result.labels.insert(result.labels.end(), cloud.labels.begin(), cloud.labels.end());
+  }
+
+  if (mVoxelSize > 0.f) {
+    return downsample(result, withColor, withLabel);
+  }
+  return result;
+}
+
+/** 21 bits per axis, voxels within 2^20 steps of the origin get unique keys */
+static inline uint64_t voxelKey(float const *p, float inverseSize) {
+  auto axis = [inverseSize](float v) {
+    return static_cast<uint64_t>(static_cast<int64_t>(std::floor(v * inverseSize))) & 0x1fffff;
+  };
+  return (axis(p[0]) << 42) | (axis(p[1]) << 21) | axis(p[2]);
+}
+
+static inline uint64_t mixKey(uint64_t key) {
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdull;
+  key ^= key >> 33;
+  return key;
+}
+
+PointCloud PointCloudBuilder::downsample(PointCloud const &cloud, bool withColor,
+                                         bool withLabel) {
+  size_t count = cloud.size();
+  uint32_t threads = mThreadPool.size();
+  float inverseSize = 1.f / mVoxelSize;
+
+  // each thread sorts its slice of points into one bucket per partition; a voxel belongs to
+  // exactly one partition, so partitions are merged independently
+  std::vector<std::vector<std::vector<uint32_t>>> buckets(
+      threads, std::vector<std::vector<uint32_t>>(kPartitions));
+  std::vector<uint64_t> keys(count);
+  {
+    std::latch done(threads);
+    for (uint32_t t = 0; t < threads; ++t) {
+      mThreadPool.submit([&, t]() {
+        size_t begin = count * t / threads;
+        size_t end = count * (t + 1) / threads;
+        for (size_t i = begin; i < end; ++i) {
+          keys[i] = voxelKey(&cloud.points[3 * i], inverseSize);
+          buckets[t][mixKey(keys[i]) % kPartitions].push_back(i);
+        }
+        done.count_down();
+      });
+    }
+    done.wait();
+  }
+
+  struct Voxel {
+    double sum[6]{};
+    uint32_t count{0};
+    uint32_t label{0};
+  };
+  std::vector<std::vector<Voxel>> partitions(kPartitions);
+  {
+    std::latch done(kPartitions);
+    for (uint32_t part = 0; part < kPartitions; ++part) {
+      mThreadPool.submit([&, part]() {
+        auto &voxels = partitions[part];
+        std::unordered_map<uint64_t, uint32_t> index;
+        // slices are visited in order, so points arrive in their original order
+        for (uint32_t t = 0; t < threads; ++t) {
+          for (uint32_t i : buckets[t][part]) {
+            auto [it, inserted] = index.try_emplace(keys[i], voxels.size());
+            if (inserted) {
+              voxels.emplace_back();
+              if (withLabel) {
+                voxels.back().label = cloud.labels[i];
+              }
+            }
+            auto &voxel = voxels[it->second];
+            for (int k = 0; k < 3; ++k) {
+              voxel.sum[k] += cloud.points[3 * i + k];
+            }
+            if (withColor) {
+              for (int k = 0; k < 3; ++k) {
+                voxel.sum[3 + k] += cloud.colors[3 * i + k];
+              }
+            }
+            voxel.count += 1;
+          }
+        }
+        done.count_down();
+      });
+    }
+    done.wait();
+  }
+
+  PointCloud result;
+  for (auto &voxels : partitions) {
+    for (auto &voxel : voxels) {
+      for (int k = 0; k < 3; ++k) {
+        result.points.push_back(static_cast<float>(voxel.sum[k] / voxel.count));
+      }
+      if (withColor) {
+        for (int k = 3; k < 6; ++k) {
+          result.colors.push_back(static_cast<float>(voxel.sum[k] / voxel.count));
+        }
+      }
+      if (withLabel) {
+        result.labels.push_back(voxel.label);
+      }
+    }
+  }
+  return result;
+}
+
+} // namespace sapien
@@ -0,0 +1,65 @@
+#pragma once
+#include "utils/thread_pool.hpp"
+#include <limits>
+#include <vector>
+
+namespace sapien {
+class SCamera;
+
+/** Points fused from several cameras, one entry per point in each array */
+struct PointCloud {
+  std::vector<float> points;     // world space xyz
+  std::vector<float> colors;     // rgb, empty unless requested
+  std::vector<uint32_t> labels;  // segmentation id, empty unless requested
+
+  inline size_t size() const { return points.size() / 3; }
+};
+
+/** Turns Position images of several cameras into one world space point cloud
+ *
+ *  Pixels are kept when their depth along the view axis lies in the depth range and, when ids
+ *  are given, their segmentation id is one of them. With a voxel size, points are merged on a
+ *  hash grid: each voxel becomes the mean position and color of its points and the label of
+ *  its first point in camera and pixel order. Both steps run on the builder's threads and the
+ *  result does not depend on the thread count.
+ */
+class PointCloudBuilder {
+  float mMinDepth{0.f};
+  float mMaxDepth{std::numeric_limits<float>::infinity()};
+  float mVoxelSize{0.f};
+  std::vector<uint32_t> mSegmentationIds; // sorted
+  uint32_t mSegmentationLevel{1};         // 0 for visual ids, 1 for actor ids
+
+  ThreadPool mThreadPool;
+
+public:
+  /** threadCount 0 uses all hardware threads */
+  explicit PointCloudBuilder(uint32_t threadCount = 0);
+
+  void setDepthRange(float minDepth, float maxDepth);
+  inline float getMinDepth() const { return mMinDepth; }
+  inline float getMaxDepth() const { return mMaxDepth; }
+
+  /** 0 disables downsampling */
+  void setVoxelSize(float size);
+  inline float getVoxelSize() const { return mVoxelSize; }
+
+  /** ids to keep, empty keeps every pixel; level 0 filters and labels by visual id and level 1
+   *  by actor id */
+  void setSegmentationFilter(std::vector<uint32_t> ids, uint32_t level = 1);
+  inline std::vector<uint32_t> const &getSegmentationIds() const { return mSegmentationIds; }
+  inline uint32_t getSegmentationLevel() const { return mSegmentationLevel; }
+
+  /** Fuse the latest pictures of the cameras
+   *
+   *  The pictures must contain Position, and Color or Segmentation when colors, labels or a
+   *  segmentation filter are used.
+   */
+  PointCloud build(std::vector<SCamera *> const &cameras, bool withColor = false,
+                   bool withLabel = false);
+
+private:
+  PointCloud downsample(PointCloud const &cloud, bool withColor, bool withLabel);
+};
+
+} // namespace sapien
@@ -0,0 +1,183 @@
+#include "cpu_renderer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace sapien {
+namespace Renderer {
+using namespace physx;
+
+static constexpr uint32_t kRowsPerTask = 8;
+
+CpuCamera::CpuCamera(uint32_t width, uint32_t height, float fovy, float near, float far,
+                     CpuScene *scene)
+    : mWidth(width), mHeight(height), mScene(scene), mNear(near), mFar(far) {
+  mFy = height / 2.f / std::tan(fovy / 2.f);
+  mFx = mFy;
+  mCx = width / 2.f;
+  mCy = height / 2.f;
+  mSkew = 0.f;
+
+  size_t pixels = static_cast<size_t>(width) * height;
+  mColor.resize(4 * pixels);
+  mAlbedo.resize(4 * pixels);
+  mNormal.resize(4 * pixels);
+  mPosition.resize(4 * pixels);
+  mSegmentation.resize(4 * pixels);
+}
+
+void CpuCamera::setPerspectiveCameraParameters(float near, float far, float fx, float fy,
+                                               float cx, float cy, float skew) {
+  mNear = near;
+  mFar = far;
+  mFx = fx;
+  mFy = fy;
+  mCx = cx;
+  mCy = cy;
+  mSkew = skew;
+}
+
+void CpuCamera::takePicture() {
+  auto snapshot = mScene->snapshot();
+
+  std::vector<ShadingLight> lights;
+  if (mScene->getParentRenderer()->getLighting()) {
+    for (auto &light : mScene->getLights()) {
+      if (auto l = dynamic_cast<CpuPointLight *>(light.get())) {
+        lights.push_back({ShadingLight::ePOINT, l->getPosition(), {}, l->getColor(), 0.f, 0.f});
+      } else if (auto l = dynamic_cast<CpuDirectionalLight *>(light.get())) {
+        lights.push_back({ShadingLight::eDIRECTIONAL, {}, l->getDirection().getNormalized(),
+                          l->getColor(), 0.f, 0.f});
+      } else if (auto l = dynamic_cast<CpuSpotLight *>(light.get())) {
+        lights.push_back({ShadingLight::eSPOT, l->getPosition(), l->getDirection().getNormalized(),
+                          l->getColor(), std::cos(l->getFovInner() / 2.f),
+                          std::cos(l->getFov() / 2.f)});
+      }
+    }
+  }
+
+  // rows are independent, split them over the renderer threads; the calling thread helps, so
+  // this is safe from a task running on the same pool
+  parallelFor(mScene->getParentRenderer()->getThreadPool(), mHeight, kRowsPerTask,
+              [&](size_t begin, size_t end) { renderRows(snapshot, lights, begin, end); });
+}
+
+void CpuCamera::renderRows(CpuSceneSnapshot const &snapshot,
+                           std::vector<ShadingLight> const &lights, uint32_t rowBegin,
+                           uint32_t rowEnd) {
+  bool lighting = mScene->getParentRenderer()->getLighting();
+  auto ambient = mScene->getAmbientLight();
+  PxVec3 ambientColor{ambient[0], ambient[1], ambient[2]};
+
+  for (uint32_t y = rowBegin; y < rowEnd; ++y) {
+    for (uint32_t x = 0; x < mWidth; ++x) {
+      size_t p = 4 * (static_cast<size_t>(y) * mWidth + x);
+
+      // pixel center in the OpenGL camera frame at unit depth, so hit distance is depth
+      float yc = (y + 0.5f - mCy) / mFy;
+      float xc = (x + 0.5f - mCx - mSkew * yc) / mFx;
+      PxVec3 cameraDirection{xc, -yc, -1.f};
+      CpuRay ray(mPose.p, mPose.q.rotate(cameraDirection));
+
+      CpuHit hit{mFar, 0, 0.f, 0.f};
+      int index = snapshot.empty() ? -1 : snapshot.intersect(ray, mNear, hit);
+      if (index < 0) {
+        std::fill_n(&mColor[p], 4, 0.f);
+        std::fill_n(&mAlbedo[p], 4, 0.f);
+        std::fill_n(&mNormal[p], 4, 0.f);
+        mPosition[p] = mPosition[p + 1] = mPosition[p + 2] = 0.f;
+        mPosition[p + 3] = 1.f;
+        std::fill_n(&mSegmentation[p], 4, 0u);
+        continue;
+      }
+
+      auto &instance = snapshot.getInstance(index);
+      PxVec3 normal =
+          instance.pose.rotate(instance.mesh->getNormal(hit).multiply(instance.invScale))
+              .getNormalized();
+      if (normal.dot(ray.direction) > 0.f) {
+        normal = -normal; // surfaces are two sided
+      }
+      PxVec3 position = ray.origin + ray.direction * hit.t;
+
+      auto &albedo = instance.color;
+      PxVec3 shade{1.f, 1.f, 1.f};
+      if (lighting) {
+        shade = ambientColor;
+        for (auto &light : lights) {
+          PxVec3 l;
+          float intensity = 1.f;
+          if (light.type == ShadingLight::eDIRECTIONAL) {
+            l = -light.direction;
+          } else {
+            l = light.position - position;
+            float d2 = l.magnitudeSquared();
+            l /= std::sqrt(d2);
+            intensity = 1.f / d2;
+            if (light.type == ShadingLight::eSPOT) {
+              float c = -l.dot(light.direction);
+              float width = std::max(light.cosInner - light.cosOuter, 1e-6f);
+              intensity *= PxClamp((c - light.cosOuter) / width, 0.f, 1.f);
+            }
+          }
+          shade += light.color * (intensity * std::max(normal.dot(l), 0.f));
+        }
+      }
+
+      mColor[p] = albedo[0] * shade.x;
+      mColor[p + 1] = albedo[1] * shade.y;
+      mColor[p + 2] = albedo[2] * shade.z;
+      mColor[p + 3] = albedo[3];
+      std::copy(albedo.begin(), albedo.end(), &mAlbedo[p]);
+
+      PxVec3 cameraNormal = mPose.q.rotateInv(normal);
+      mNormal[p] = cameraNormal.x;
+      mNormal[p + 1] = cameraNormal.y;
+      mNormal[p + 2] = cameraNormal.z;
+      mNormal[p + 3] = 0.f;
+
+      PxVec3 cameraPosition = cameraDirection * hit.t;
+      mPosition[p] = cameraPosition.x;
+      mPosition[p + 1] = cameraPosition.y;
+      mPosition[p + 2] = cameraPosition.z;
+      // depth buffer value in [0, 1] as written by the Vulkan renderer
+      mPosition[p + 3] = mFar * (hit.t - mNear) / (hit.t * (mFar - mNear));
+
+      mSegmentation[p] = instance.uniqueId;
+      mSegmentation[p + 1] = instance.segmentationId;
+      mSegmentation[p + 2] = 0;
+      mSegmentation[p + 3] = 0;
+    }
+  }
+}
+
+std::vector<float> CpuCamera::getFloatImage(std::string const &name) {
+  if (name == "Color") {
+    return mColor;
+  }
+  if (name == "Albedo") {
+    return mAlbedo;
+  }
+  if (name == "Normal") {
+    return mNormal;
+  }
+  if (name == "Position") {
+    return mPosition;
+  }
+  if (name == "Depth") {
+    // positive distance along the view axis, 0 where nothing is hit
+    std::vector<float> depth(mPosition.size() / 4);
+    convertPositionToDepth(mPosition.data(), depth.data(), depth.size());
+    return depth;
+  }
+  throw std::invalid_argument("Unrecognized image name " + name);
+}
+
+std::vector<uint32_t> CpuCamera::getUintImage(std::string const &name) {
+  if (name == "Segmentation") {
+    return mSegmentation;
+  }
+  throw std::invalid_argument("Unrecognized image name " + name);
+}
+
+} // namespace Renderer
+} // namespace sapien
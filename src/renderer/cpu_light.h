@@ -0,0 +1,110 @@
+#pragma once
+#include "render_interface.h"
+#include <cmath>
+
+namespace sapien {
+namespace Renderer {
+
+/** Lights of the CPU renderer, plain parameter holders read at render time
+ *
+ *  Directions follow the Vulkan renderer: a light points along -z of its pose. Shadow
+ *  parameters are stored but shadows are not rendered.
+ */
+class CpuLightBase {
+protected:
+  physx::PxTransform mPose{physx::PxIdentity};
+  physx::PxVec3 mColor{1.f, 1.f, 1.f};
+  bool mShadowEnabled{false};
+  float mShadowNear{0.1f};
+  float mShadowFar{10.f};
+
+  inline physx::PxVec3 direction() const { return mPose.q.rotate({0.f, 0.f, -1.f}); }
+  inline void setDirectionRotation(physx::PxVec3 direction) {
+    physx::PxVec3 from{0.f, 0.f, -1.f};
+    physx::PxVec3 to = direction.getNormalized();
+    physx::PxVec3 axis = from.cross(to);
+    float c = from.dot(to);
+    if (axis.magnitudeSquared() < 1e-12f) {
+      mPose.q = c > 0 ? physx::PxQuat(physx::PxIdentity)
+                      : physx::PxQuat(physx::PxPi, physx::PxVec3{1.f, 0.f, 0.f});
+      return;
+    }
+    mPose.q = physx::PxQuat(std::acos(physx::PxClamp(c, -1.f, 1.f)), axis.getNormalized());
+  }
+};
+
+class CpuPointLight : public IPointLight, public CpuLightBase {
+public:
+  inline physx::PxTransform getPose() const override { return mPose; }
+  inline void setPose(physx::PxTransform const &transform) override { mPose = transform; }
+  inline physx::PxVec3 getColor() const override { return mColor; }
+  inline void setColor(physx::PxVec3 color) override { mColor = color; }
+  inline bool getShadowEnabled() const override { return mShadowEnabled; }
+  inline void setShadowEnabled(bool enabled) override { mShadowEnabled = enabled; }
+  inline physx::PxVec3 getPosition() const override { return mPose.p; }
+  inline void setPosition(physx::PxVec3 position) override { mPose.p = position; }
+  inline void setShadowParameters(float near, float far) override {
+    mShadowNear = near;
+    mShadowFar = far;
+  }
+  inline float getShadowNear() const override { return mShadowNear; }
+  inline float getShadowFar() const override { return mShadowFar; }
+};
+
+class CpuDirectionalLight : public IDirectionalLight, public CpuLightBase {
+  float mShadowHalfSize{10.f};
+
+public:
+  inline physx::PxTransform getPose() const override { return mPose; }
+  inline void setPose(physx::PxTransform const &transform) override { mPose = transform; }
+  inline physx::PxVec3 getColor() const override { return mColor; }
+  inline void setColor(physx::PxVec3 color) override { mColor = color; }
+  inline bool getShadowEnabled() const override { return mShadowEnabled; }
+  inline void setShadowEnabled(bool enabled) override { mShadowEnabled = enabled; }
+  inline physx::PxVec3 getDirection() const override { return direction(); }
+  inline void setDirection(physx::PxVec3 direction) override {
+    setDirectionRotation(direction);
+  }
+  inline void setShadowParameters(float halfSize, float near, float far) override {
+    mShadowHalfSize = halfSize;
+    mShadowNear = near;
+    mShadowFar = far;
+  }
+  inline float getShadowHalfSize() const override { return mShadowHalfSize; }
+  inline float getShadowNear() const override { return mShadowNear; }
+  inline float getShadowFar() const override { return mShadowFar; }
+};
+
+class CpuSpotLight : public ISpotLight, public CpuLightBase {
+  float mFov{1.f};
+  float mFovInner{1.f};
+
+public:
+  inline physx::PxTransform getPose() const override { return mPose; }
+  inline void setPose(physx::PxTransform const &transform) override { mPose = transform; }
+  inline physx::PxVec3 getColor() const override { return mColor; }
+  inline void setColor(physx::PxVec3 color) override { mColor = color; }
+  inline bool getShadowEnabled() const override { return mShadowEnabled; }
+  inline void setShadowEnabled(bool enabled) override { mShadowEnabled = enabled; }
+  inline physx::PxVec3 getPosition() const override { return mPose.p; }
+  inline void setPosition(physx::PxVec3 position) override { mPose.p = position; }
+  inline physx::PxVec3 getDirection() const override { return direction(); }
+  inline void setDirection(physx::PxVec3 direction) override {
+    setDirectionRotation(direction);
+  }
+  inline void setShadowParameters(float near, float far) override {
+    mShadowNear = near;
+    mShadowFar = far;
+  }
+
+  inline void setFov(float fov) override { mFov = fov; }
+  inline float getFov() const override { return mFov; }
+  inline void setFovInner(float fov) { mFovInner = fov; }
+  inline float getFovInner() const { return mFovInner; }
+
+  inline float getShadowNear() const override { return mShadowNear; }
+  inline float getShadowFar() const override { return mShadowFar; }
+};
+
+} // namespace Renderer
+} // namespace sapien
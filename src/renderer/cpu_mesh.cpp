@@ -0,0 +1,276 @@
+#include "cpu_mesh.h"
+#include <algorithm>
+#include <cmath>
+
+namespace sapien {
+namespace Renderer {
+using namespace physx;
+
+static constexpr uint32_t kLeafSize = 4;
+static constexpr uint32_t kStackSize = 64;
+
+float intersectBounds(PxBounds3 const &bounds, CpuRay const &ray, float tMax) {
+  float t0 = 0.f;
+  float t1 = tMax;
+  for (int i = 0; i < 3; ++i) {
+    float tNear = (bounds.minimum[i] - ray.origin[i]) * ray.invDirection[i];
+    float tFar = (bounds.maximum[i] - ray.origin[i]) * ray.invDirection[i];
+    if (tNear > tFar) {
+      std::swap(tNear, tFar);
+    }
+    // NaN from 0 * inf (origin on a slab with a parallel ray) keeps the previous bound
+    t0 = tNear > t0 ? tNear : t0;
+    t1 = tFar < t1 ? tFar : t1;
+    if (t0 > t1) {
+      return -1.f;
+    }
+  }
+  return t0;
+}
+
+CpuMesh::CpuMesh(std::vector<PxVec3> positions, std::vector<PxVec3> normals,
+                 std::vector<uint32_t> indices)
+    : mPositions(std::move(positions)), mNormals(std::move(normals)),
+      mIndices(std::move(indices)) {
+  if (mNormals.size() != mPositions.size()) {
+    mNormals.clear();
+  } else if (std::all_of(mNormals.begin(), mNormals.end(),
+                         [](PxVec3 const &n) { return n.isZero(); })) {
+    // decoded files without normals come with zero normals
+    mNormals.clear();
+  }
+  build();
+}
+
+std::shared_ptr<CpuMesh> CpuMesh::Create(std::vector<float> const &positions,
+                                         std::vector<float> const &normals,
+                                         std::vector<uint32_t> const &indices) {
+  std::vector<PxVec3> p(positions.size() / 3);
+  std::vector<PxVec3> n(normals.size() / 3);
+  for (size_t i = 0; i < p.size(); ++i) {
+    p[i] = {positions[3 * i], positions[3 * i + 1], positions[3 * i + 2]};
+  }
+  for (size_t i = 0; i < n.size(); ++i) {
+    n[i] = {normals[3 * i], normals[3 * i + 1], normals[3 * i + 2]};
+  }
+  return std::make_shared<CpuMesh>(std::move(p), std::move(n), indices);
+}
+
+void CpuMesh::build() {
+  uint32_t triangleCount = mIndices.size() / 3;
+  mIndices.resize(triangleCount * 3);
+  mTriangles.resize(triangleCount);
+  std::vector<PxVec3> centroids(triangleCount);
+  for (uint32_t i = 0; i < triangleCount; ++i) {
+    mTriangles[i] = i;
+    centroids[i] = (mPositions[mIndices[3 * i]] + mPositions[mIndices[3 * i + 1]] +
+                    mPositions[mIndices[3 * i + 2]]) /
+                   3.f;
+  }
+  mNodes.clear();
+  if (triangleCount) {
+    mNodes.reserve(2 * triangleCount / kLeafSize + 1);
+    buildNode(0, triangleCount, centroids);
+  }
+}
+
+uint32_t CpuMesh::buildNode(uint32_t first, uint32_t count,
+                            std::vector<PxVec3> const &centroids) {
+  uint32_t index = mNodes.size();
+  mNodes.push_back({PxBounds3::empty(), first, count});
+
+  PxBounds3 bounds = PxBounds3::empty();
+  PxBounds3 centroidBounds = PxBounds3::empty();
+  for (uint32_t i = first; i < first + count; ++i) {
+    uint32_t t = mTriangles[i];
+    bounds.include(mPositions[mIndices[3 * t]]);
+    bounds.include(mPositions[mIndices[3 * t + 1]]);
+    bounds.include(mPositions[mIndices[3 * t + 2]]);
+    centroidBounds.include(centroids[t]);
+  }
+  mNodes[index].bounds = bounds;
+
+  PxVec3 extent = centroidBounds.getDimensions();
+  int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+  if (count <= kLeafSize || extent[axis] <= 0.f) {
+    return index;
+  }
+
+  // median split along the longest centroid axis
+  uint32_t half = count / 2;
+  std::nth_element(
+      mTriangles.begin() + first, mTriangles.begin() + first + half,
+      mTriangles.begin() + first + count,
+      [&](uint32_t a, uint32_t b) { return centroids[a][axis] < centroids[b][axis]; });
+  buildNode(first, half, centroids);
+  uint32_t right = buildNode(first + half, count - half, centroids);
+  mNodes[index].first = right;
+  mNodes[index].count = 0;
+  return index;
+}
+
+bool CpuMesh::intersect(CpuRay const &ray, float tMin, CpuHit &hit) const {
+  if (mNodes.empty() || intersectBounds(mNodes[0].bounds, ray, hit.t) < 0.f) {
+    return false;
+  }
+
+  bool found = false;
+  std::pair<uint32_t, float> stack[kStackSize];
+  uint32_t size = 0;
+  stack[size++] = {0, 0.f};
+  while (size) {
+    auto [index, entry] = stack[--size];
+    if (entry > hit.t) {
+      continue;
+    }
+    auto &node = mNodes[index];
+    if (node.count) {
+      for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+        uint32_t t = mTriangles[i];
+        // Moller-Trumbore
+        PxVec3 const &p0 = mPositions[mIndices[3 * t]];
+        PxVec3 e1 = mPositions[mIndices[3 * t + 1]] - p0;
+        PxVec3 e2 = mPositions[mIndices[3 * t + 2]] - p0;
+        PxVec3 p = ray.direction.cross(e2);
+        float det = e1.dot(p);
+        if (std::abs(det) < 1e-12f) {
+          continue;
+        }
+        float invDet = 1.f / det;
+        PxVec3 s = ray.origin - p0;
+        float u = s.dot(p) * invDet;
+        if (u < 0.f || u > 1.f) {
+          continue;
+        }
+        PxVec3 q = s.cross(e1);
+        float v = ray.direction.dot(q) * invDet;
+        if (v < 0.f || u + v > 1.f) {
+          continue;
+        }
+        float d = e2.dot(q) * invDet;
+        if (d > tMin && d < hit.t) {
+          hit = {d, t, u, v};
+          found = true;
+        }
+      }
+      continue;
+    }
+
+    uint32_t left = index + 1;
+    uint32_t right = node.first;
+    float dl = intersectBounds(mNodes[left].bounds, ray, hit.t);
+    float dr = intersectBounds(mNodes[right].bounds, ray, hit.t);
+    // push the farther child first so the nearer one is visited first
+    if (dl >= 0.f && dr >= 0.f) {
+      if (dl < dr) {
+        stack[size++] = {right, dr};
+        stack[size++] = {left, dl};
+      } else {
+        stack[size++] = {left, dl};
+        stack[size++] = {right, dr};
+      }
+    } else if (dl >= 0.f) {
+      stack[size++] = {left, dl};
+    } else if (dr >= 0.f) {
+      stack[size++] = {right, dr};
+    }
+  }
+  return found;
+}
+
+PxVec3 CpuMesh::getNormal(CpuHit const &hit) const {
+  uint32_t i0 = mIndices[3 * hit.triangle];
+  uint32_t i1 = mIndices[3 * hit.triangle + 1];
+  uint32_t i2 = mIndices[3 * hit.triangle + 2];
+  if (!mNormals.empty()) {
+    PxVec3 n = mNormals[i0] * (1.f - hit.u - hit.v) + mNormals[i1] * hit.u + mNormals[i2] * hit.v;
+    if (!n.isZero()) {
+      return n.getNormalized();
+    }
+  }
+  return (mPositions[i1] - mPositions[i0])
+      .cross(mPositions[i2] - mPositions[i0])
+      .getNormalized();
+}
+
+std::shared_ptr<CpuMesh> CpuMesh::CreateCube() {
+  std::vector<PxVec3> positions;
+  std::vector<PxVec3> normals;
+  std::vector<uint32_t> indices;
+  for (int axis = 0; axis < 3; ++axis) {
+    for (float sign : {1.f, -1.f}) {
+      PxVec3 n(0.f);
+      n[axis] = sign;
+      PxVec3 u(0.f);
+      u[(axis + 1) % 3] = 1.f;
+      PxVec3 v = n.cross(u);
+      uint32_t base = positions.size();
+      for (auto [a, b] : {std::pair{-1.f, -1.f}, {1.f, -1.f}, {1.f, 1.f}, {-1.f, 1.f}}) {
+        positions.push_back(n + u * a + v * b);
+        normals.push_back(n);
+      }
+      indices.insert(indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+    }
+  }
+  return std::make_shared<CpuMesh>(std::move(positions), std::move(normals), std::move(indices));
+}
+
+std::shared_ptr<CpuMesh> CpuMesh::CreateUVSphere(uint32_t segments, uint32_t rings) {
+  std::vector<PxVec3> positions;
+  std::vector<uint32_t> indices;
+  for (uint32_t r = 0; r <= rings; ++r) {
+    float phi = PxPi * r / rings;
+    for (uint32_t s = 0; s <= segments; ++s) {
+      float theta = 2.f * PxPi * s / segments;
+      positions.push_back(
+          {std::sin(phi) * std::cos(theta), std::sin(phi) * std::sin(theta), std::cos(phi)});
+    }
+  }
+  for (uint32_t r = 0; r < rings; ++r) {
+    for (uint32_t s = 0; s < segments; ++s) {
+      uint32_t i0 = r * (segments + 1) + s;
+      uint32_t i1 = i0 + segments + 1;
+      indices.insert(indices.end(), {i0, i1, i0 + 1, i0 + 1, i1, i1 + 1});
+    }
+  }
+  auto normals = positions;
+  return std::make_shared<CpuMesh>(std::move(positions), std::move(normals), std::move(indices));
+}
+
+std::shared_ptr<CpuMesh> CpuMesh::CreateCapsule(float radius, float halfLength,
+                                                uint32_t segments, uint32_t halfRings) {
+  std::vector<PxVec3> positions;
+  std::vector<PxVec3> normals;
+  std::vector<uint32_t> indices;
+  // rings from the +x pole to the -x pole, the two middle rings bound the cylinder
+  uint32_t rings = 2 * halfRings + 1;
+  for (uint32_t r = 0; r <= rings; ++r) {
+    uint32_t k = r <= halfRings ? r : r - 1;
+    float phi = 0.5f * PxPi * k / halfRings;
+    float offset = r <= halfRings ? halfLength : -halfLength;
+    for (uint32_t s = 0; s <= segments; ++s) {
+      float theta = 2.f * PxPi * s / segments;
+      PxVec3 n(std::cos(phi), std::sin(phi) * std::cos(theta), std::sin(phi) * std::sin(theta));
+      positions.push_back(n * radius + PxVec3(offset, 0.f, 0.f));
+      normals.push_back(n);
+    }
+  }
+  for (uint32_t r = 0; r < rings; ++r) {
+    for (uint32_t s = 0; s < segments; ++s) {
+      uint32_t i0 = r * (segments + 1) + s;
+      uint32_t i1 = i0 + segments + 1;
+      indices.insert(indices.end(), {i0, i0 + 1, i1, i0 + 1, i1 + 1, i1});
+    }
+  }
+  return std::make_shared<CpuMesh>(std::move(positions), std::move(normals), std::move(indices));
+}
+
+std::shared_ptr<CpuMesh> CpuMesh::CreateYZPlane() {
+  std::vector<PxVec3> positions = {{0, -1, -1}, {0, 1, -1}, {0, 1, 1}, {0, -1, 1}};
+  std::vector<PxVec3> normals(4, {1, 0, 0});
+  std::vector<uint32_t> indices = {0, 1, 2, 0, 2, 3};
+  return std::make_shared<CpuMesh>(std::move(positions), std::move(normals), std::move(indices));
+}
+
+} // namespace Renderer
+} // namespace sapien
@@ -0,0 +1,82 @@
+#pragma once
+#include <PxPhysicsAPI.h>
+#include <memory>
+#include <vector>
+
+namespace sapien {
+namespace Renderer {
+
+struct CpuRay {
+  physx::PxVec3 origin;
+  physx::PxVec3 direction; // not normalized, hit distances are in units of its length
+  physx::PxVec3 invDirection;
+
+  CpuRay(physx::PxVec3 const &o, physx::PxVec3 const &d)
+      : origin(o), direction(d), invDirection(1.f / d.x, 1.f / d.y, 1.f / d.z) {}
+};
+
+struct CpuHit {
+  float t;
+  uint32_t triangle;
+  float u, v; // barycentric coordinates of vertex 1 and 2
+};
+
+/** Triangle mesh with a bounding volume hierarchy in its local frame
+ *
+ *  Immutable after construction, so one mesh is shared by all bodies and scenes using it.
+ */
+class CpuMesh {
+  struct Node {
+    physx::PxBounds3 bounds;
+    uint32_t first; // first triangle for leaves, right child for inner nodes
+    uint32_t count; // 0 for inner nodes, the left child follows its parent
+  };
+
+  std::vector<physx::PxVec3> mPositions;
+  std::vector<physx::PxVec3> mNormals; // empty if the mesh has none
+  std::vector<uint32_t> mIndices;
+  std::vector<uint32_t> mTriangles; // triangle order referenced by the leaves
+  std::vector<Node> mNodes;
+
+public:
+  CpuMesh(std::vector<physx::PxVec3> positions, std::vector<physx::PxVec3> normals,
+          std::vector<uint32_t> indices);
+
+  static std::shared_ptr<CpuMesh> Create(std::vector<float> const &positions,
+                                         std::vector<float> const &normals,
+                                         std::vector<uint32_t> const &indices);
+
+  /** unit cube [-1, 1]^3 */
+  static std::shared_ptr<CpuMesh> CreateCube();
+  /** unit sphere */
+  static std::shared_ptr<CpuMesh> CreateUVSphere(uint32_t segments, uint32_t rings);
+  /** capsule along x */
+  static std::shared_ptr<CpuMesh> CreateCapsule(float radius, float halfLength, uint32_t segments,
+                                                uint32_t halfRings);
+  /** square [-1, 1]^2 in the yz plane facing +x */
+  static std::shared_ptr<CpuMesh> CreateYZPlane();
+
+  inline physx::PxBounds3 getBounds() const {
+    return mNodes.empty() ? physx::PxBounds3::empty() : mNodes[0].bounds;
+  }
+  inline std::vector<physx::PxVec3> const &getPositions() const { return mPositions; }
+  inline std::vector<physx::PxVec3> const &getNormals() const { return mNormals; }
+  inline std::vector<uint32_t> const &getIndices() const { return mIndices; }
+
+  /** closest hit with t in (tMin, hit.t), hit.t must be initialized to the maximum distance */
+  bool intersect(CpuRay const &ray, float tMin, CpuHit &hit) const;
+
+  /** interpolated vertex normal, or the face normal if the mesh has no normals */
+  physx::PxVec3 getNormal(CpuHit const &hit) const;
+
+private:
+  void build();
+  uint32_t buildNode(uint32_t first, uint32_t count,
+                     std::vector<physx::PxVec3> const &centroids);
+};
+
+/** slab test, returns the entry distance or a negative value on miss */
+float intersectBounds(physx::PxBounds3 const &bounds, CpuRay const &ray, float tMax);
+
+} // namespace Renderer
+} // namespace sapien
@@ -0,0 +1,70 @@
+#include "cpu_renderer.h"
+#include <algorithm>
+#include <filesystem>
+#include <thread>
+
+namespace sapien {
+namespace Renderer {
+
+CpuRenderer::CpuRenderer(uint32_t threadCount, bool lighting)
+    : mLighting(lighting),
+      mThreadPool(threadCount ? threadCount : std::thread::hardware_concurrency()) {}
+
+CpuScene *CpuRenderer::createScene(std::string const &name) {
+  mScenes.push_back(std::make_unique<CpuScene>(this, name));
+  return mScenes.back().get();
+}
+
+void CpuRenderer::removeScene(IPxrScene *scene) {
+  mScenes.erase(std::remove_if(mScenes.begin(), mScenes.end(),
+                               [scene](auto &s) { return scene == s.get(); }),
+                mScenes.end());
+}
+
+std::shared_ptr<IPxrMaterial> CpuRenderer::createMaterial() {
+  return std::make_shared<PxrMaterial>();
+}
+
+void CpuRenderer::preloadModel(std::string const &filename) {
+  if (MeshCache::Get().getBundled(filename) || std::filesystem::exists(filename)) {
+    getModelFromFile(filename);
+  }
+}
+
+CpuRenderer::DecodedModel CpuRenderer::getModelFromFile(std::string const &filename) {
+  auto decoded = MeshCache::Get().load(filename);
+  if (!decoded) {
+    return {};
+  }
+
+  std::lock_guard<std::mutex> lock(mMeshLock);
+  auto &model = mDecodedModels[decoded->filename];
+  model.lastUse = ++mDecodedModelClock;
+  if (model.source.lock() == decoded) {
+    return model;
+  }
+
+  // new file or changed on disk
+  model.source = decoded;
+  model.meshes.clear();
+  model.baseColors.clear();
+  for (auto &submesh : decoded->submeshes) {
+    model.meshes.push_back(CpuMesh::Create(submesh.positions, submesh.normals, submesh.indices));
+    model.baseColors.push_back(submesh.baseColor);
+  }
+  DecodedModel result = model;
+
+  while (mDecodedModels.size() > kDecodedModelCapacity) {
+    auto oldest = mDecodedModels.begin();
+    for (auto it = mDecodedModels.begin(); it != mDecodedModels.end(); ++it) {
+      if (it->second.lastUse < oldest->second.lastUse) {
+        oldest = it;
+      }
+    }
+    mDecodedModels.erase(oldest);
+  }
+  return result;
+}
+
+} // namespace Renderer
+} // namespace sapien
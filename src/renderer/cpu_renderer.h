@@ -0,0 +1,298 @@
+#pragma once
+#include "cpu_light.h"
+#include "cpu_mesh.h"
+#include "mesh_cache.h"
+#include "renderer/render_interface.h"
+#include "utils/thread_pool.hpp"
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace sapien {
+namespace Renderer {
+class CpuRenderer;
+class CpuRigidbody;
+class CpuCamera;
+class CpuScene;
+
+class CpuRenderShape : public IPxrRenderShape {
+  std::shared_ptr<CpuMesh const> mMesh;
+  std::shared_ptr<IPxrMaterial> mMaterial;
+
+public:
+  inline CpuRenderShape(std::shared_ptr<CpuMesh const> mesh,
+                        std::shared_ptr<IPxrMaterial> material)
+      : mMesh(mesh), mMaterial(material) {}
+
+  [[nodiscard]] std::shared_ptr<RenderMeshGeometry> getGeometry() const override;
+  [[nodiscard]] inline std::shared_ptr<IPxrMaterial> getMaterial() const override {
+    return mMaterial;
+  }
+
+  inline CpuMesh const &getMesh() const { return *mMesh; }
+};
+
+class CpuRigidbody : public IPxrRigidbody {
+  std::string mName{};
+  CpuScene *mParentScene = nullptr;
+  physx::PxTransform mInitialPose = {{0, 0, 0}, physx::PxIdentity};
+  physx::PxTransform mPose = {{0, 0, 0}, physx::PxIdentity};
+  std::vector<std::shared_ptr<CpuRenderShape>> mShapes;
+
+  uint32_t mUniqueId{0};
+  uint32_t mSegmentationId{0};
+  bool mVisible{true};
+
+  physx::PxGeometryType::Enum mType;
+  physx::PxVec3 mScale;
+
+public:
+  CpuRigidbody(CpuScene *scene, std::vector<std::shared_ptr<CpuRenderShape>> shapes,
+               physx::PxGeometryType::Enum type, physx::PxVec3 scale);
+  CpuRigidbody(CpuRigidbody const &other) = delete;
+  CpuRigidbody &operator=(CpuRigidbody const &other) = delete;
+
+  inline void setName(std::string const &name) override {
+    mName = name;
+    notifyChange(mUniqueId);
+  };
+  inline std::string getName() const override { return mName; };
+
+  inline void setUniqueId(uint32_t uniqueId) override {
+    auto previousId = mUniqueId;
+    mUniqueId = uniqueId;
+    notifyChange(previousId);
+  }
+  inline uint32_t getUniqueId() const override { return mUniqueId; }
+  inline void setSegmentationId(uint32_t segmentationId) override {
+    mSegmentationId = segmentationId;
+  }
+  inline uint32_t getSegmentationId() const override { return mSegmentationId; }
+  void setSegmentationCustomData(const std::vector<float> &customData) override;
+  void setInitialPose(const physx::PxTransform &transform) override;
+  inline physx::PxTransform getInitialPose() const override { return mInitialPose; };
+  void update(const physx::PxTransform &transform) override;
+
+  void setVisibility(float visibility) override;
+  void setVisible(bool visible) override;
+  void setRenderMode(uint32_t mode) override;
+
+  void destroy() override;
+
+  physx::PxGeometryType::Enum getType() const override { return mType; }
+  physx::PxVec3 getScale() const override { return mScale; }
+
+  std::vector<std::shared_ptr<IPxrRenderShape>> getRenderShapes() override;
+
+  /** world pose of the mesh frame, scale is applied in the mesh frame */
+  inline physx::PxTransform getPose() const { return mPose; }
+  inline bool isVisible() const { return mVisible; }
+  inline std::vector<std::shared_ptr<CpuRenderShape>> const &getShapes() const { return mShapes; }
+};
+
+/** Render shapes placed in the world at one instant with a hierarchy over their bounds */
+class CpuSceneSnapshot {
+public:
+  struct Instance {
+    CpuMesh const *mesh;
+    physx::PxTransform pose;
+    physx::PxVec3 invScale;
+    physx::PxBounds3 bounds; // world space
+    std::array<float, 4> color;
+    uint32_t uniqueId;
+    uint32_t segmentationId;
+  };
+
+private:
+  struct Node {
+    physx::PxBounds3 bounds;
+    uint32_t first; // first instance for leaves, right child for inner nodes
+    uint32_t count; // 0 for inner nodes, the left child follows its parent
+  };
+  std::vector<Instance> mInstances;
+  std::vector<uint32_t> mOrder;
+  std::vector<Node> mNodes;
+
+public:
+  explicit CpuSceneSnapshot(std::vector<Instance> instances);
+
+  /** closest hit in world space, returns the instance index or -1 on miss */
+  int intersect(CpuRay const &ray, float tMin, CpuHit &hit) const;
+
+  inline Instance const &getInstance(uint32_t index) const { return mInstances[index]; }
+  inline bool empty() const { return mInstances.empty(); }
+
+private:
+  uint32_t buildNode(uint32_t first, uint32_t count);
+};
+
+class CpuScene : public IPxrScene {
+  CpuRenderer *mParentRenderer;
+  std::vector<std::unique_ptr<CpuRigidbody>> mBodies;
+  std::vector<std::unique_ptr<CpuCamera>> mCameras;
+  std::vector<std::unique_ptr<ILight>> mLights;
+  std::string mName;
+  std::array<float, 3> mAmbientLight{0.f, 0.f, 0.f};
+
+  std::shared_ptr<CpuMesh> mCubeMesh{};
+  std::shared_ptr<CpuMesh> mSphereMesh{};
+  std::shared_ptr<CpuMesh> mPlaneMesh{};
+
+public:
+  CpuScene(CpuRenderer *parent, std::string const &name);
+
+  inline std::string getName() { return mName; }
+
+  // IPxrScene
+  using IPxrScene::addRigidbody;
+  IPxrRigidbody *addRigidbody(const std::string &meshFile, const physx::PxVec3 &scale) override;
+
+  IPxrRigidbody *addRigidbody(const std::string &meshFile, const physx::PxVec3 &scale,
+                              std::shared_ptr<IPxrMaterial> material) override;
+
+  IPxrRigidbody *addRigidbody(physx::PxGeometryType::Enum type, const physx::PxVec3 &scale,
+                              std::shared_ptr<IPxrMaterial> material) override;
+
+  IPxrRigidbody *addRigidbody(std::vector<physx::PxVec3> const &vertices,
+                              std::vector<physx::PxVec3> const &normals,
+                              std::vector<uint32_t> const &indices, const physx::PxVec3 &scale,
+                              std::shared_ptr<IPxrMaterial> material) override;
+
+  void removeRigidbody(IPxrRigidbody *body) override;
+
+  ICamera *addCamera(uint32_t width, uint32_t height, float fovy, float near, float far,
+                     std::string const &shaderDir = "") override;
+
+  void removeCamera(ICamera *camera) override;
+  std::vector<ICamera *> getCameras() override;
+
+  void destroy() override;
+
+  void setAmbientLight(std::array<float, 3> const &color) override { mAmbientLight = color; }
+  std::array<float, 3> getAmbientLight() const override { return mAmbientLight; }
+  IPointLight *addPointLight(std::array<float, 3> const &position,
+                             std::array<float, 3> const &color, bool enableShadow,
+                             float shadowNear, float shadowFar) override;
+  IDirectionalLight *addDirectionalLight(std::array<float, 3> const &direction,
+                                         std::array<float, 3> const &color, bool enableShadow,
+                                         std::array<float, 3> const &position, float shadowScale,
+                                         float shadowNear, float shadowFar) override;
+  ISpotLight *addSpotLight(std::array<float, 3> const &position,
+                           std::array<float, 3> const &direction, float fovInner, float fovOuter,
+                           std::array<float, 3> const &color, bool enableShadow,
+                           float shadowNear, float shadowFar) override;
+  void removeLight(ILight *light) override;
+
+  inline CpuRenderer *getParentRenderer() const { return mParentRenderer; }
+  inline std::vector<std::unique_ptr<ILight>> const &getLights() const { return mLights; }
+
+  /** snapshot of the visible shapes at their current poses */
+  CpuSceneSnapshot snapshot() const;
+
+private:
+  IPxrRigidbody *addBody(std::vector<std::shared_ptr<CpuRenderShape>> shapes,
+                         physx::PxGeometryType::Enum type, physx::PxVec3 const &scale);
+};
+
+/** Multithreaded ray tracer for headless machines without Vulkan
+ *
+ *  Produces the Color (unlit albedo or Lambert shading without shadows), Albedo, Normal,
+ *  Position, Depth and Segmentation targets. Textures, transparency and environment maps are
+ *  not supported.
+ */
+class CpuRenderer : public IPxrRenderer {
+  std::vector<std::unique_ptr<CpuScene>> mScenes;
+  bool mLighting;
+  ThreadPool mThreadPool;
+
+public:
+  /** meshes built from a decoded file, one per submesh, with their material base colors */
+  struct DecodedModel {
+    std::weak_ptr<DecodedMesh const> source;
+    std::vector<std::shared_ptr<CpuMesh>> meshes;
+    std::vector<std::array<float, 4>> baseColors;
+    uint64_t lastUse;
+  };
+
+private:
+  // by canonical path, the least recently used models are dropped past the capacity
+  static constexpr size_t kDecodedModelCapacity = 256;
+  std::mutex mMeshLock;
+  std::map<std::string, DecodedModel> mDecodedModels;
+  uint64_t mDecodedModelClock{0};
+
+public:
+  /** threadCount 0 uses all hardware threads, lighting false renders unlit base colors */
+  explicit CpuRenderer(uint32_t threadCount = 0, bool lighting = true);
+
+  CpuScene *createScene(std::string const &name) override;
+  void removeScene(IPxrScene *scene) override;
+  std::shared_ptr<IPxrMaterial> createMaterial() override;
+  void preloadModel(std::string const &filename) override;
+
+  /** meshes and base colors of a file, decoded through the shared MeshCache */
+  DecodedModel getModelFromFile(std::string const &filename);
+
+  inline bool getLighting() const { return mLighting; }
+  inline ThreadPool &getThreadPool() { return mThreadPool; }
+};
+
+class CpuCamera : public ICamera {
+  /** light parameters gathered once per picture */
+  struct ShadingLight {
+    enum Type { ePOINT, eDIRECTIONAL, eSPOT } type;
+    physx::PxVec3 position;
+    physx::PxVec3 direction;
+    physx::PxVec3 color;
+    float cosInner, cosOuter;
+  };
+
+  uint32_t mWidth, mHeight;
+  CpuScene *mScene;
+  physx::PxTransform mPose{physx::PxIdentity}; // OpenGL convention, looking at -z
+
+  float mNear, mFar;
+  float mFx, mFy, mCx, mCy, mSkew;
+
+  std::vector<float> mColor;    // 4 per pixel
+  std::vector<float> mAlbedo;   // 4 per pixel
+  std::vector<float> mNormal;   // 4 per pixel, camera space
+  std::vector<float> mPosition; // 4 per pixel, camera space xyz and depth buffer value
+  std::vector<uint32_t> mSegmentation; // 4 per pixel, visual id and actor id
+
+public:
+  CpuCamera(uint32_t width, uint32_t height, float fovy, float near, float far, CpuScene *scene);
+
+  inline uint32_t getWidth() const override { return mWidth; };
+  inline uint32_t getHeight() const override { return mHeight; };
+
+  [[nodiscard]] inline float getPrincipalPointX() const override { return mCx; }
+  [[nodiscard]] inline float getPrincipalPointY() const override { return mCy; }
+  [[nodiscard]] inline float getFocalX() const override { return mFx; }
+  [[nodiscard]] inline float getFocalY() const override { return mFy; }
+  [[nodiscard]] inline float getNear() const override { return mNear; }
+  [[nodiscard]] inline float getFar() const override { return mFar; }
+  [[nodiscard]] inline float getSkew() const override { return mSkew; }
+
+  void setPerspectiveCameraParameters(float near, float far, float fx, float fy, float cx,
+                                      float cy, float skew) override;
+
+  void takePicture() override;
+
+  std::vector<float> getFloatImage(std::string const &name) override;
+  std::vector<uint32_t> getUintImage(std::string const &name) override;
+  inline std::vector<float> getDepthImage() override { return getFloatImage("Depth"); }
+
+  inline IPxrScene *getScene() override { return mScene; }
+
+  // ISensor
+  inline physx::PxTransform getPose() const override { return mPose; }
+  inline void setPose(physx::PxTransform const &pose) override { mPose = pose; }
+
+private:
+  void renderRows(CpuSceneSnapshot const &snapshot, std::vector<ShadingLight> const &lights,
+                  uint32_t rowBegin, uint32_t rowEnd);
+};
+
+} // namespace Renderer
+} // namespace sapien
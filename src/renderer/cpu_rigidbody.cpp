@@ -0,0 +1,62 @@
+#include "cpu_renderer.h"
+
+namespace sapien {
+namespace Renderer {
+
+std::shared_ptr<RenderMeshGeometry> CpuRenderShape::getGeometry() const {
+  auto mesh = std::make_shared<RenderMeshGeometry>();
+  for (auto &p : mMesh->getPositions()) {
+    mesh->vertices.insert(mesh->vertices.end(), {p.x, p.y, p.z});
+  }
+  for (auto &n : mMesh->getNormals()) {
+    mesh->normals.insert(mesh->normals.end(), {n.x, n.y, n.z});
+  }
+  mesh->indices = mMesh->getIndices();
+  return mesh;
+}
+
+CpuRigidbody::CpuRigidbody(CpuScene *scene, std::vector<std::shared_ptr<CpuRenderShape>> shapes,
+                           physx::PxGeometryType::Enum type, physx::PxVec3 scale)
+    : mParentScene(scene), mShapes(std::move(shapes)), mType(type), mScale(scale) {}
+
+void CpuRigidbody::setSegmentationCustomData(const std::vector<float> &customData) {
+  if (customData.size() != 16) {
+    throw std::runtime_error("object custom data must contain 16 float numbers");
+  }
+  // the CPU renderer has no shader reading custom data
+}
+
+void CpuRigidbody::setInitialPose(const physx::PxTransform &transform) {
+  mInitialPose = transform;
+  update({{0, 0, 0}, physx::PxIdentity});
+}
+
+void CpuRigidbody::update(const physx::PxTransform &transform) {
+  mPose = transform * mInitialPose;
+}
+
+void CpuRigidbody::setVisibility(float visibility) {
+  // no transparency, any visibility above 0 renders opaque
+  mVisible = visibility > 0.f;
+}
+
+void CpuRigidbody::setVisible(bool visible) { mVisible = visible; }
+
+void CpuRigidbody::setRenderMode(uint32_t mode) {
+  if (mode == 0 || mode == 2) {
+    setVisible(true);
+    return;
+  }
+  if (mode == 1) {
+    setVisible(false);
+  }
+}
+
+void CpuRigidbody::destroy() { mParentScene->removeRigidbody(this); }
+
+std::vector<std::shared_ptr<IPxrRenderShape>> CpuRigidbody::getRenderShapes() {
+  return {mShapes.begin(), mShapes.end()};
+}
+
+} // namespace Renderer
+} // namespace sapien
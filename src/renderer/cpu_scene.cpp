@@ -0,0 +1,282 @@
+#include "cpu_renderer.h"
+#include <algorithm>
+#include <filesystem>
+
+namespace sapien {
+namespace Renderer {
+using namespace physx;
+
+static constexpr uint32_t kStackSize = 64;
+
+CpuSceneSnapshot::CpuSceneSnapshot(std::vector<Instance> instances)
+    : mInstances(std::move(instances)) {
+  mOrder.resize(mInstances.size());
+  for (uint32_t i = 0; i < mOrder.size(); ++i) {
+    mOrder[i] = i;
+  }
+  if (!mInstances.empty()) {
+    mNodes.reserve(2 * mInstances.size());
+    buildNode(0, mInstances.size());
+  }
+}
+
+uint32_t CpuSceneSnapshot::buildNode(uint32_t first, uint32_t count) {
+  uint32_t index = mNodes.size();
+  mNodes.push_back({PxBounds3::empty(), first, count});
+
+  PxBounds3 bounds = PxBounds3::empty();
+  PxBounds3 centers = PxBounds3::empty();
+  for (uint32_t i = first; i < first + count; ++i) {
+    bounds.include(mInstances[mOrder[i]].bounds);
+    centers.include(mInstances[mOrder[i]].bounds.getCenter());
+  }
+  mNodes[index].bounds = bounds;
+
+  PxVec3 extent = centers.getDimensions();
+  int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+  if (count <= 2 || extent[axis] <= 0.f) {
+    return index;
+  }
+
+  uint32_t half = count / 2;
+  std::nth_element(mOrder.begin() + first, mOrder.begin() + first + half,
+                   mOrder.begin() + first + count, [&](uint32_t a, uint32_t b) {
+                     return mInstances[a].bounds.getCenter()[axis] <
+                            mInstances[b].bounds.getCenter()[axis];
+                   });
+  buildNode(first, half);
+  uint32_t right = buildNode(first + half, count - half);
+  mNodes[index].first = right;
+  mNodes[index].count = 0;
+  return index;
+}
+
+int CpuSceneSnapshot::intersect(CpuRay const &ray, float tMin, CpuHit &hit) const {
+  if (mNodes.empty()) {
+    return -1;
+  }
+
+  int result = -1;
+  uint32_t stack[kStackSize];
+  uint32_t size = 0;
+  stack[size++] = 0;
+  while (size) {
+    auto &node = mNodes[stack[--size]];
+    if (intersectBounds(node.bounds, ray, hit.t) < 0.f) {
+      continue;
+    }
+    if (!node.count) {
+      stack[size++] = node.first;
+      stack[size++] = &node - mNodes.data() + 1;
+      continue;
+    }
+    for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+      auto &instance = mInstances[mOrder[i]];
+      // trace in the mesh frame, the hit distance is unchanged by the affine map
+      CpuRay local(instance.pose.transformInv(ray.origin).multiply(instance.invScale),
+                   instance.pose.rotateInv(ray.direction).multiply(instance.invScale));
+      if (instance.mesh->intersect(local, tMin, hit)) {
+        result = mOrder[i];
+      }
+    }
+  }
+  return result;
+}
+
+CpuScene::CpuScene(CpuRenderer *renderer, std::string const &name)
+    : mParentRenderer(renderer), mName(name) {}
+
+CpuSceneSnapshot CpuScene::snapshot() const {
+  std::vector<CpuSceneSnapshot::Instance> instances;
+  for (auto &body : mBodies) {
+    if (!body->isVisible()) {
+      continue;
+    }
+    PxTransform pose = body->getPose();
+    PxVec3 scale = body->getScale();
+    if (body->getType() == PxGeometryType::eCAPSULE) {
+      scale = {1.f, 1.f, 1.f}; // capsule meshes are built at their size
+    }
+    PxVec3 invScale(1.f / scale.x, 1.f / scale.y, 1.f / scale.z);
+    PxMat33 basis = PxMat33(pose.q) * PxMat33::createDiagonal(scale);
+    for (auto &shape : body->getShapes()) {
+      auto &mesh = shape->getMesh();
+      PxBounds3 local = mesh.getBounds();
+      if (local.isEmpty()) {
+        continue;
+      }
+      PxBounds3 bounds = PxBounds3::transformFast(basis, local);
+      bounds.minimum += pose.p;
+      bounds.maximum += pose.p;
+      auto material = shape->getMaterial();
+      instances.push_back({&mesh, pose, invScale, bounds,
+                           material ? material->getBaseColor() : std::array{1.f, 1.f, 1.f, 1.f},
+                           body->getUniqueId(), body->getSegmentationId()});
+    }
+  }
+  return CpuSceneSnapshot(std::move(instances));
+}
+
+IPxrRigidbody *CpuScene::addBody(std::vector<std::shared_ptr<CpuRenderShape>> shapes,
+                                 PxGeometryType::Enum type, PxVec3 const &scale) {
+  mBodies.push_back(std::make_unique<CpuRigidbody>(this, std::move(shapes), type, scale));
+  return mBodies.back().get();
+}
+
+IPxrRigidbody *CpuScene::addRigidbody(const std::string &meshFile, const PxVec3 &scale) {
+  std::vector<std::shared_ptr<CpuRenderShape>> shapes;
+  auto model = mParentRenderer->getModelFromFile(meshFile);
+  // only base colors of the file materials are used
+  for (size_t i = 0; i < model.meshes.size(); ++i) {
+    auto mat = mParentRenderer->createMaterial();
+    mat->setBaseColor(model.baseColors[i]);
+    shapes.push_back(std::make_shared<CpuRenderShape>(model.meshes[i], mat));
+  }
+  return addBody(std::move(shapes), PxGeometryType::eTRIANGLEMESH, scale);
+}
+
+IPxrRigidbody *CpuScene::addRigidbody(const std::string &meshFile, const PxVec3 &scale,
+                                      std::shared_ptr<IPxrMaterial> material) {
+  if (!material) {
+    return addRigidbody(meshFile, scale);
+  }
+  std::vector<std::shared_ptr<CpuRenderShape>> shapes;
+  for (auto mesh : mParentRenderer->getModelFromFile(meshFile).meshes) {
+    shapes.push_back(std::make_shared<CpuRenderShape>(mesh, material));
+  }
+  return addBody(std::move(shapes), PxGeometryType::eTRIANGLEMESH, scale);
+}
+
+IPxrRigidbody *CpuScene::addRigidbody(PxGeometryType::Enum type, const PxVec3 &scale,
+                                      std::shared_ptr<IPxrMaterial> material) {
+  if (!material) {
+    material = mParentRenderer->createMaterial();
+  }
+  std::shared_ptr<CpuMesh> mesh;
+  switch (type) {
+  case PxGeometryType::eBOX:
+    if (!mCubeMesh) {
+      mCubeMesh = CpuMesh::CreateCube();
+    }
+    mesh = mCubeMesh;
+    break;
+  case PxGeometryType::eSPHERE:
+    if (!mSphereMesh) {
+      mSphereMesh = CpuMesh::CreateUVSphere(32, 16);
+    }
+    mesh = mSphereMesh;
+    break;
+  case PxGeometryType::ePLANE:
+    if (!mPlaneMesh) {
+      mPlaneMesh = CpuMesh::CreateYZPlane();
+    }
+    mesh = mPlaneMesh;
+    break;
+  case PxGeometryType::eCAPSULE:
+    mesh = CpuMesh::CreateCapsule(scale.y, scale.x, 32, 8);
+    break;
+  default:
+    throw std::runtime_error("Failed to add rigidbody: unsupported render body type");
+  }
+  return addBody({std::make_shared<CpuRenderShape>(mesh, material)}, type, scale);
+}
+
+IPxrRigidbody *CpuScene::addRigidbody(std::vector<PxVec3> const &vertices,
+                                      std::vector<PxVec3> const &normals,
+                                      std::vector<uint32_t> const &indices, const PxVec3 &scale,
+                                      std::shared_ptr<IPxrMaterial> material) {
+  if (!material) {
+    material = mParentRenderer->createMaterial();
+  }
+  auto mesh = std::make_shared<CpuMesh>(vertices, normals, indices);
+  return addBody({std::make_shared<CpuRenderShape>(mesh, material)},
+                 PxGeometryType::eTRIANGLEMESH, scale);
+}
+
+void CpuScene::removeRigidbody(IPxrRigidbody *body) {
+  mBodies.erase(std::remove_if(mBodies.begin(), mBodies.end(),
+                               [body](auto &b) { return body == b.get(); }),
+                mBodies.end());
+}
+
+ICamera *CpuScene::addCamera(uint32_t width, uint32_t height, float fovy, float near, float far,
+                             std::string const &shaderDir) {
+  if (shaderDir.length()) {
+    spdlog::get("SAPIEN")->warn("The CPU renderer does not use shaders, {} is ignored",
+                                shaderDir);
+  }
+  mCameras.push_back(std::make_unique<CpuCamera>(width, height, fovy, near, far, this));
+  return mCameras.back().get();
+}
+
+void CpuScene::removeCamera(ICamera *camera) {
+  mCameras.erase(std::remove_if(mCameras.begin(), mCameras.end(),
+                                [camera](auto &c) { return camera == c.get(); }),
+                 mCameras.end());
+}
+
+std::vector<ICamera *> CpuScene::getCameras() {
+  std::vector<ICamera *> cams;
+  for (auto &cam : mCameras) {
+    cams.push_back(cam.get());
+  }
+  return cams;
+}
+
+void CpuScene::destroy() { mParentRenderer->removeScene(this); }
+
+IPointLight *CpuScene::addPointLight(std::array<float, 3> const &position,
+                                     std::array<float, 3> const &color, bool enableShadow,
+                                     float shadowNear, float shadowFar) {
+  auto light = std::make_unique<CpuPointLight>();
+  light->setPosition({position[0], position[1], position[2]});
+  light->setColor({color[0], color[1], color[2]});
+  light->setShadowEnabled(enableShadow);
+  light->setShadowParameters(shadowNear, shadowFar);
+  auto result = light.get();
+  mLights.push_back(std::move(light));
+  return result;
+}
+
+IDirectionalLight *CpuScene::addDirectionalLight(std::array<float, 3> const &direction,
+                                                 std::array<float, 3> const &color,
+                                                 bool enableShadow,
+                                                 std::array<float, 3> const &position,
+                                                 float shadowScale, float shadowNear,
+                                                 float shadowFar) {
+  auto light = std::make_unique<CpuDirectionalLight>();
+  light->setPose(PxTransform({position[0], position[1], position[2]}));
+  light->setDirection({direction[0], direction[1], direction[2]});
+  light->setColor({color[0], color[1], color[2]});
+  light->setShadowEnabled(enableShadow);
+  light->setShadowParameters(shadowScale, shadowNear, shadowFar);
+  auto result = light.get();
+  mLights.push_back(std::move(light));
+  return result;
+}
+
+ISpotLight *CpuScene::addSpotLight(std::array<float, 3> const &position,
+                                   std::array<float, 3> const &direction, float fovInner,
+                                   float fovOuter, std::array<float, 3> const &color,
+                                   bool enableShadow, float shadowNear, float shadowFar) {
+  auto light = std::make_unique<CpuSpotLight>();
+  light->setPosition({position[0], position[1], position[2]});
+  light->setDirection({direction[0], direction[1], direction[2]});
+  light->setFov(fovOuter);
+  light->setFovInner(fovInner);
+  light->setColor({color[0], color[1], color[2]});
+  light->setShadowEnabled(enableShadow);
+  light->setShadowParameters(shadowNear, shadowFar);
+  auto result = light.get();
+  mLights.push_back(std::move(light));
+  return result;
+}
+
+void CpuScene::removeLight(ILight *light) {
+  mLights.erase(std::remove_if(mLights.begin(), mLights.end(),
+                               [light](auto &l) { return light == l.get(); }),
+                mLights.end());
+}
+
+} // namespace Renderer
+} // namespace sapien
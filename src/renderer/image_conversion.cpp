@@ -0,0 +1,124 @@
+#include "image_conversion.h"
+#include "utils/thread_pool.hpp"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SAPIEN_X86_F16C
+#endif
+
+namespace sapien {
+namespace Renderer {
+
+// images smaller than this many pixels are converted on the calling thread
+static constexpr size_t kBlockSize = 1 << 15;
+
+/** run fn(begin, end) over blocks of [0, count) on the shared pool */
+template <typename F> static void parallelFor(size_t count, F const &fn) {
+  sapien::parallelFor(defaultThreadPool(), count, kBlockSize, fn);
+}
+
+static inline uint8_t unormToByte(float value) {
+  return static_cast<uint8_t>(std::clamp(value, 0.f, 1.f) * 255.f + 0.5f);
+}
+
+void convertRGBAFloatToRGB8(float const *src, uint8_t *dst, size_t pixelCount) {
+  parallelFor(pixelCount, [=](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      dst[3 * i + 0] = unormToByte(src[4 * i + 0]);
+      dst[3 * i + 1] = unormToByte(src[4 * i + 1]);
+      dst[3 * i + 2] = unormToByte(src[4 * i + 2]);
+    }
+  });
+}
+
+void convertBGRA8ToRGB8(uint8_t const *src, uint8_t *dst, size_t pixelCount) {
+  parallelFor(pixelCount, [=](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      dst[3 * i + 0] = src[4 * i + 2];
+      dst[3 * i + 1] = src[4 * i + 1];
+      dst[3 * i + 2] = src[4 * i + 0];
+    }
+  });
+}
+
+void convertBGRA8ToRGBAFloat(uint8_t const *src, float *dst, size_t pixelCount) {
+  parallelFor(pixelCount, [=](size_t begin, size_t end) {
+    constexpr float scale = 1.f / 255.f;
+    for (size_t i = begin; i < end; ++i) {
+      dst[4 * i + 0] = src[4 * i + 2] * scale;
+      dst[4 * i + 1] = src[4 * i + 1] * scale;
+      dst[4 * i + 2] = src[4 * i + 0] * scale;
+      dst[4 * i + 3] = src[4 * i + 3] * scale;
+    }
+  });
+}
+
+static inline uint16_t floatToHalf(float value) {
+  uint32_t x;
+  std::memcpy(&x, &value, 4);
+  uint32_t sign = (x >> 16) & 0x8000;
+  uint32_t abs = x & 0x7fffffff;
+
+  if (abs >= 0x47800000) {
+    // too large for half, infinity or nan
+    return sign | (abs > 0x7f800000 ? 0x7e00 : 0x7c00);
+  }
+  if (abs < 0x38800000) {
+    // half subnormal or zero: adding 0.5 aligns the half mantissa with the float mantissa and
+    // lets the float unit round it
+    float f;
+    std::memcpy(&f, &abs, 4);
+    f += 0.5f;
+    uint32_t bits;
+    std::memcpy(&bits, &f, 4);
+    return sign | (bits - 0x3f000000);
+  }
+  // rebias the exponent and round to nearest even
+  uint32_t odd = (abs >> 13) & 1;
+  abs += 0xc8000fff + odd;
+  return sign | (abs >> 13);
+}
+
+#ifdef SAPIEN_X86_F16C
+__attribute__((target("avx,f16c"))) static void floatToHalfF16C(float const *src, uint16_t *dst,
+                                                                 size_t count) {
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m128i half = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), half);
+  }
+  for (; i < count; ++i) {
+    dst[i] = floatToHalf(src[i]);
+  }
+}
+#endif
+
+void convertFloatToHalf(float const *src, uint16_t *dst, size_t count) {
+#ifdef SAPIEN_X86_F16C
+  static bool const hasF16C = __builtin_cpu_supports("f16c") && __builtin_cpu_supports("avx");
+  if (hasF16C) {
+    parallelFor(count, [=](size_t begin, size_t end) {
+      floatToHalfF16C(src + begin, dst + begin, end - begin);
+    });
+    return;
+  }
+#endif
+  parallelFor(count, [=](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      dst[i] = floatToHalf(src[i]);
+    }
+  });
+}
+
+void convertPositionToDepth(float const *src, float *dst, size_t pixelCount) {
+  parallelFor(pixelCount, [=](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      dst[i] = src[4 * i + 3] < 1.f ? -src[4 * i + 2] : 0.f;
+    }
+  });
+}
+
+} // namespace Renderer
+} // namespace sapien
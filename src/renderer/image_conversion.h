@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace sapien {
+namespace Renderer {
+
+/** Pixel format conversions applied to downloaded images
+ *
+ *  Large images are split into blocks converted on a shared pool of worker threads. The loops
+ *  are written to be vectorized by the compiler; half conversion uses F16C when the CPU has it.
+ */
+
+/** float RGBA to packed RGB with 8 bits per channel, values are clamped to [0, 1] */
+void convertRGBAFloatToRGB8(float const *src, uint8_t *dst, size_t pixelCount);
+
+/** Kuafu BGRA 8 bit to packed RGB 8 bit */
+void convertBGRA8ToRGB8(uint8_t const *src, uint8_t *dst, size_t pixelCount);
+
+/** Kuafu BGRA 8 bit to float RGBA in [0, 1] */
+void convertBGRA8ToRGBAFloat(uint8_t const *src, float *dst, size_t pixelCount);
+
+/** float to IEEE half precision bits, rounding to nearest even */
+void convertFloatToHalf(float const *src, uint16_t *dst, size_t count);
+
+/** camera space Position (XYZ-D) to positive depth along the view axis, 0 for background */
+void convertPositionToDepth(float const *src, float *dst, size_t pixelCount);
+
+} // namespace Renderer
+} // namespace sapien
@@ -69,20 +69,26 @@ void KuafuCamera::takePicture() {
 std::vector<float> KuafuCamera::getFloatImage(std::string const &name) {
   if (name == "Color") {
     auto rgba = pParentScene->pKRenderer->downloadLatestFrame(pKCamera);
-    size_t size = rgba.size();
-    std::vector<float> ret(size);
+    std::vector<float> ret(rgba.size());
     // Kuafu is BGRA
-    for (size_t i = 0; i < size / 4; i++) {
-      ret[4 * i + 0] = static_cast<float>(rgba[4 * i + 2]) / 255;
-      ret[4 * i + 1] = static_cast<float>(rgba[4 * i + 1]) / 255;
-      ret[4 * i + 2] = static_cast<float>(rgba[4 * i + 0]) / 255;
-      ret[4 * i + 3] = static_cast<float>(rgba[4 * i + 3]) / 255;
-    }
+    convertBGRA8ToRGBAFloat(rgba.data(), ret.data(), rgba.size() / 4);
     return ret;
   }
   throw std::invalid_argument("Unrecognized image name " + name);
 };
 
+std::vector<uint8_t> KuafuCamera::getColorRGB8() {
+  // the frame is already 8 bit, skip the float round trip
+  auto rgba = pParentScene->pKRenderer->downloadLatestFrame(pKCamera);
+  std::vector<uint8_t> ret(rgba.size() / 4 * 3);
+  convertBGRA8ToRGB8(rgba.data(), ret.data(), rgba.size() / 4);
+  return ret;
+}
+
+std::vector<float> KuafuCamera::getDepthImage() {
+  throw std::invalid_argument("Depth image is not supported.");
+}
+
 std::vector<uint32_t> KuafuCamera::getUintImage(std::string const &name) {
   throw std::invalid_argument("Integer image is not supported.");
 };
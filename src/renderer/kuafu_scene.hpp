@@ -46,6 +46,8 @@ public:
 
   std::vector<float> getFloatImage(std::string const &name) override;
   std::vector<uint32_t> getUintImage(std::string const &name) override;
+  std::vector<uint8_t> getColorRGB8() override;
+  std::vector<float> getDepthImage() override;
 
   // ISensor
 
@@ -80,7 +82,10 @@ public:
   KuafuRigidBody(KuafuRigidBody const &other) = delete;
   KuafuRigidBody &operator=(KuafuRigidBody const &other) = delete;
 
-  inline void setName(std::string const &name) override { mName = name; };
+  inline void setName(std::string const &name) override {
+    mName = name;
+    notifyChange(mUniqueId);
+  };
   [[nodiscard]] inline std::string getName() const override { return mName; };
 
   inline void setUniqueId(uint32_t uniqueId) override{
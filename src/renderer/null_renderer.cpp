@@ -0,0 +1,340 @@
+#include "null_renderer.h"
+#include "mesh_cache.h"
+#include <algorithm>
+#include <cmath>
+
+namespace sapien {
+namespace Renderer {
+using namespace physx;
+
+//========== Rigidbody ==========//
+NullRigidbody::NullRigidbody(NullScene *scene, uint32_t index, NullVisualSource source)
+    : mParentScene(scene), mIndex(index), mSource(std::move(source)) {}
+
+void NullRigidbody::update(const PxTransform &transform) {
+  mParentScene->setPose(mIndex, transform);
+}
+
+void NullRigidbody::setVisibility(float visibility) {
+  mParentScene->setVisibility(mIndex, visibility);
+}
+
+void NullRigidbody::setVisible(bool visible) {
+  mParentScene->setVisibility(mIndex, visible ? 1.f : 0.f);
+}
+
+void NullRigidbody::destroy() { mParentScene->removeRigidbody(this); }
+
+std::vector<std::shared_ptr<IPxrRenderShape>> NullRigidbody::getRenderShapes() {
+  switch (mSource.type) {
+  case NullVisualSource::eMESH:
+    return {std::make_shared<NullRenderShape>(mSource.mesh, mSource.material)};
+  case NullVisualSource::ePRIMITIVE:
+    return {std::make_shared<NullRenderShape>(nullptr, mSource.material)};
+  case NullVisualSource::eFILE:
+    break;
+  }
+
+  std::vector<std::shared_ptr<IPxrRenderShape>> shapes;
+  auto decoded = mSource.bundled ? mSource.bundled : MeshCache::Get().load(mSource.filename);
+  if (!decoded) {
+    return shapes;
+  }
+  for (auto &submesh : decoded->submeshes) {
+    auto geometry = std::make_shared<RenderMeshGeometry>();
+    geometry->vertices = submesh.positions;
+    geometry->normals = submesh.normals;
+    geometry->uvs = submesh.uvs;
+    geometry->indices = submesh.indices;
+    auto material = mSource.material;
+    if (!material) {
+      material = std::make_shared<PxrMaterial>();
+      material->setBaseColor(submesh.baseColor);
+    }
+    shapes.push_back(std::make_shared<NullRenderShape>(geometry, material));
+  }
+  return shapes;
+}
+
+//========== Camera ==========//
+NullCamera::NullCamera(uint32_t width, uint32_t height, float fovy, float near, float far,
+                       NullScene *scene)
+    : mWidth(width), mHeight(height), mScene(scene), mNear(near), mFar(far) {
+  mFy = height / 2.f / std::tan(fovy / 2.f);
+  mFx = mFy;
+  mCx = width / 2.f;
+  mCy = height / 2.f;
+  mSkew = 0.f;
+}
+
+void NullCamera::setPerspectiveCameraParameters(float near, float far, float fx, float fy,
+                                                float cx, float cy, float skew) {
+  mNear = near;
+  mFar = far;
+  mFx = fx;
+  mFy = fy;
+  mCx = cx;
+  mCy = cy;
+  mSkew = skew;
+}
+
+std::vector<float> NullCamera::getFloatImage(std::string const &name) {
+  throw std::runtime_error("NullRenderer does not produce images");
+}
+
+std::vector<uint32_t> NullCamera::getUintImage(std::string const &name) {
+  throw std::runtime_error("NullRenderer does not produce images");
+}
+
+IPxrScene *NullCamera::getScene() { return mScene; }
+
+//========== Scene ==========//
+NullScene::NullScene(std::string const &name) : mName(name) {}
+
+IPxrRigidbody *NullScene::addBody(NullVisualSource source) {
+  uint32_t index = mBodies.size();
+  mBodies.push_back(std::make_unique<NullRigidbody>(this, index, std::move(source)));
+  mPoses.push_back({{0, 0, 0}, PxIdentity});
+  mVisibility.push_back(1.f);
+  return mBodies.back().get();
+}
+
+IPxrRigidbody *NullScene::addRigidbody(const std::string &meshFile, const PxVec3 &scale) {
+  return addRigidbody(meshFile, scale, nullptr);
+}
+
+IPxrRigidbody *NullScene::addRigidbody(const std::string &meshFile, const PxVec3 &scale,
+                                       std::shared_ptr<IPxrMaterial> material) {
+  // bundled meshes are released with their loader, so keep them with the body
+  return addBody({NullVisualSource::eFILE, meshFile, PxGeometryType::eTRIANGLEMESH, nullptr,
+                  scale, material, MeshCache::Get().getBundled(meshFile)});
+}
+
+IPxrRigidbody *NullScene::addRigidbody(PxGeometryType::Enum type, const PxVec3 &scale,
+                                       std::shared_ptr<IPxrMaterial> material) {
+  switch (type) {
+  case PxGeometryType::eBOX:
+  case PxGeometryType::eSPHERE:
+  case PxGeometryType::ePLANE:
+  case PxGeometryType::eCAPSULE:
+    break;
+  default:
+    spdlog::get("SAPIEN")->error("Failed to add Rigidbody: unimplemented shape");
+    return nullptr;
+  }
+  if (!material) {
+    material = std::make_shared<PxrMaterial>();
+  }
+  return addBody({NullVisualSource::ePRIMITIVE, "", type, nullptr, scale, material});
+}
+
+IPxrRigidbody *NullScene::addRigidbody(std::vector<PxVec3> const &vertices,
+                                       std::vector<PxVec3> const &normals,
+                                       std::vector<uint32_t> const &indices,
+                                       const PxVec3 &scale,
+                                       std::shared_ptr<IPxrMaterial> material) {
+  auto mesh = std::make_shared<RenderMeshGeometry>();
+  for (auto &v : vertices) {
+    mesh->vertices.insert(mesh->vertices.end(), {v.x, v.y, v.z});
+  }
+  for (auto &n : normals) {
+    mesh->normals.insert(mesh->normals.end(), {n.x, n.y, n.z});
+  }
+  mesh->indices = indices;
+  if (!material) {
+    material = std::make_shared<PxrMaterial>();
+  }
+  return addBody(
+      {NullVisualSource::eMESH, "", PxGeometryType::eTRIANGLEMESH, mesh, scale, material});
+}
+
+void NullScene::removeRigidbody(IPxrRigidbody *body) {
+  auto b = dynamic_cast<NullRigidbody *>(body);
+  if (!b || b->getIndex() >= mBodies.size() || mBodies[b->getIndex()].get() != b) {
+    return;
+  }
+  uint32_t index = b->getIndex();
+  mVisibility[index] = 0.f;
+  mBodies[index].reset();
+}
+
+ICamera *NullScene::addCamera(uint32_t width, uint32_t height, float fovy, float near, float far,
+                              std::string const &shaderDir) {
+  mCameras.push_back(std::make_unique<NullCamera>(width, height, fovy, near, far, this));
+  return mCameras.back().get();
+}
+
+void NullScene::removeCamera(ICamera *camera) {
+  mCameras.erase(std::remove_if(mCameras.begin(), mCameras.end(),
+                                [camera](auto &c) { return camera == c.get(); }),
+                 mCameras.end());
+}
+
+std::vector<ICamera *> NullScene::getCameras() {
+  std::vector<ICamera *> cams;
+  for (auto &cam : mCameras) {
+    cams.push_back(cam.get());
+  }
+  return cams;
+}
+
+IPointLight *NullScene::addPointLight(std::array<float, 3> const &position,
+                                      std::array<float, 3> const &color, bool enableShadow,
+                                      float shadowNear, float shadowFar) {
+  auto light = std::make_unique<CpuPointLight>();
+  light->setPosition({position[0], position[1], position[2]});
+  light->setColor({color[0], color[1], color[2]});
+  light->setShadowEnabled(enableShadow);
+  light->setShadowParameters(shadowNear, shadowFar);
+  auto result = light.get();
+  mLights.push_back(std::move(light));
+  return result;
+}
+
+IDirectionalLight *NullScene::addDirectionalLight(
+    std::array<float, 3> const &direction, std::array<float, 3> const &color, bool enableShadow,
+    std::array<float, 3> const &position, float shadowScale, float shadowNear, float shadowFar) {
+  auto light = std::make_unique<CpuDirectionalLight>();
+  light->setPose({{position[0], position[1], position[2]}, PxIdentity});
+  light->setDirection({direction[0], direction[1], direction[2]});
+  light->setColor({color[0], color[1], color[2]});
+  light->setShadowEnabled(enableShadow);
+  light->setShadowParameters(shadowScale, shadowNear, shadowFar);
+  auto result = light.get();
+  mLights.push_back(std::move(light));
+  return result;
+}
+
+ISpotLight *NullScene::addSpotLight(std::array<float, 3> const &position,
+                                    std::array<float, 3> const &direction, float fovInner,
+                                    float fovOuter, std::array<float, 3> const &color,
+                                    bool enableShadow, float shadowNear, float shadowFar) {
+  auto light = std::make_unique<CpuSpotLight>();
+  light->setPosition({position[0], position[1], position[2]});
+  light->setDirection({direction[0], direction[1], direction[2]});
+  light->setFovInner(fovInner);
+  light->setFov(fovOuter);
+  light->setColor({color[0], color[1], color[2]});
+  light->setShadowEnabled(enableShadow);
+  light->setShadowParameters(shadowNear, shadowFar);
+  auto result = light.get();
+  mLights.push_back(std::move(light));
+  return result;
+}
+
+void NullScene::removeLight(ILight *light) {
+  mLights.erase(std::remove_if(mLights.begin(), mLights.end(),
+                               [light](auto &l) { return light == l.get(); }),
+                mLights.end());
+}
+
+void NullScene::updateRender() {
+  if (mRecording) {
+    mFrames.push_back({mPoses, mVisibility});
+  }
+}
+
+void NullScene::destroy() {
+  mBodies.clear();
+  mPoses.clear();
+  mVisibility.clear();
+  mCameras.clear();
+  mLights.clear();
+  mFrames.clear();
+}
+
+std::vector<IPxrRigidbody *> NullScene::instantiate(IPxrScene &target) const {
+  target.setAmbientLight(mAmbientLight);
+  for (auto &light : mLights) {
+    auto color = light->getColor();
+    if (auto l = dynamic_cast<CpuPointLight *>(light.get())) {
+      auto p = l->getPosition();
+      target.addPointLight({p.x, p.y, p.z}, {color.x, color.y, color.z}, l->getShadowEnabled(),
+                           l->getShadowNear(), l->getShadowFar());
+    } else if (auto l = dynamic_cast<CpuDirectionalLight *>(light.get())) {
+      auto d = l->getDirection();
+      auto p = l->getPose().p;
+      target.addDirectionalLight({d.x, d.y, d.z}, {color.x, color.y, color.z},
+                                 l->getShadowEnabled(), {p.x, p.y, p.z},
+                                 l->getShadowHalfSize(), l->getShadowNear(), l->getShadowFar());
+    } else if (auto l = dynamic_cast<CpuSpotLight *>(light.get())) {
+      auto p = l->getPosition();
+      auto d = l->getDirection();
+      target.addSpotLight({p.x, p.y, p.z}, {d.x, d.y, d.z}, l->getFovInner(), l->getFov(),
+                          {color.x, color.y, color.z}, l->getShadowEnabled(),
+                          l->getShadowNear(), l->getShadowFar());
+    }
+  }
+
+  std::vector<IPxrRigidbody *> bodies(mBodies.size(), nullptr);
+  for (uint32_t i = 0; i < mBodies.size(); ++i) {
+    if (!mBodies[i]) {
+      continue;
+    }
+    auto &source = mBodies[i]->getSource();
+    IPxrRigidbody *body{};
+    switch (source.type) {
+    case NullVisualSource::eFILE:
+      body = source.material ? target.addRigidbody(source.filename, source.scale, source.material)
+                             : target.addRigidbody(source.filename, source.scale);
+      break;
+    case NullVisualSource::ePRIMITIVE:
+      body = target.addRigidbody(source.geometry, source.scale, source.material);
+      break;
+    case NullVisualSource::eMESH: {
+      auto &m = *source.mesh;
+      std::vector<PxVec3> vertices(m.vertices.size() / 3);
+      std::vector<PxVec3> normals(m.normals.size() / 3);
+      for (size_t v = 0; v < vertices.size(); ++v) {
+        vertices[v] = {m.vertices[3 * v], m.vertices[3 * v + 1], m.vertices[3 * v + 2]};
+      }
+      for (size_t v = 0; v < normals.size(); ++v) {
+        normals[v] = {m.normals[3 * v], m.normals[3 * v + 1], m.normals[3 * v + 2]};
+      }
+      body = target.addRigidbody(vertices, normals, m.indices, source.scale, source.material);
+      break;
+    }
+    }
+    if (!body) {
+      continue;
+    }
+    body->setName(mBodies[i]->getName());
+    body->setUniqueId(mBodies[i]->getUniqueId());
+    body->setSegmentationId(mBodies[i]->getSegmentationId());
+    body->setInitialPose(mBodies[i]->getInitialPose());
+    body->setRenderMode(mBodies[i]->getRenderMode());
+    body->setVisibility(mVisibility[i]);
+    body->update(mPoses[i]);
+    bodies[i] = body;
+  }
+  return bodies;
+}
+
+void NullScene::applyFrame(Frame const &frame, std::vector<IPxrRigidbody *> const &bodies) {
+  size_t count = std::min(bodies.size(), frame.poses.size());
+  for (size_t i = 0; i < count; ++i) {
+    if (bodies[i]) {
+      bodies[i]->update(frame.poses[i]);
+      bodies[i]->setVisibility(frame.visibility[i]);
+    }
+  }
+}
+
+//========== Renderer ==========//
+NullScene *NullRenderer::createScene(std::string const &name) {
+  mScenes.push_back(std::make_unique<NullScene>(name));
+  return mScenes.back().get();
+}
+
+void NullRenderer::removeScene(IPxrScene *scene) {
+  mScenes.erase(std::remove_if(mScenes.begin(), mScenes.end(),
+                               [scene](auto &s) { return scene == s.get(); }),
+                mScenes.end());
+}
+
+std::shared_ptr<IPxrMaterial> NullRenderer::createMaterial() {
+  return std::make_shared<PxrMaterial>();
+}
+
+} // namespace Renderer
+} // namespace sapien
@@ -0,0 +1,243 @@
+#pragma once
+#include "cpu_light.h"
+#include "mesh_cache.h"
+#include "renderer/render_interface.h"
+#include <memory>
+
+namespace sapien {
+namespace Renderer {
+class NullScene;
+
+/** How a body was added to the scene, enough to add it again to another renderer */
+struct NullVisualSource {
+  enum Type { eFILE, ePRIMITIVE, eMESH } type;
+  std::string filename;                          // eFILE
+  physx::PxGeometryType::Enum geometry;          // ePRIMITIVE, eTRIANGLEMESH otherwise
+  std::shared_ptr<RenderMeshGeometry const> mesh; // eMESH, vertices, normals and indices only
+  physx::PxVec3 scale;
+  std::shared_ptr<IPxrMaterial> material; // null for files drawn with their own materials
+  std::shared_ptr<DecodedMesh const> bundled; // eFILE from an asset bundle, kept with the body
+};
+
+class NullRenderShape : public IPxrRenderShape {
+  std::shared_ptr<RenderMeshGeometry const> mGeometry;
+  std::shared_ptr<IPxrMaterial> mMaterial;
+
+public:
+  inline NullRenderShape(std::shared_ptr<RenderMeshGeometry const> geometry,
+                         std::shared_ptr<IPxrMaterial> material)
+      : mGeometry(geometry), mMaterial(material) {}
+
+  [[nodiscard]] inline std::shared_ptr<RenderMeshGeometry> getGeometry() const override {
+    return mGeometry ? std::make_shared<RenderMeshGeometry>(*mGeometry) : nullptr;
+  }
+  [[nodiscard]] inline std::shared_ptr<IPxrMaterial> getMaterial() const override {
+    return mMaterial;
+  }
+};
+
+/** Body handle of the null renderer, its pose and visibility live in the scene arrays */
+class NullRigidbody : public IPxrRigidbody {
+  std::string mName{};
+  NullScene *mParentScene;
+  uint32_t mIndex;
+  NullVisualSource mSource;
+  physx::PxTransform mInitialPose = {{0, 0, 0}, physx::PxIdentity};
+
+  uint32_t mUniqueId{0};
+  uint32_t mSegmentationId{0};
+  uint32_t mRenderMode{0};
+
+public:
+  NullRigidbody(NullScene *scene, uint32_t index, NullVisualSource source);
+  NullRigidbody(NullRigidbody const &other) = delete;
+  NullRigidbody &operator=(NullRigidbody const &other) = delete;
+
+  inline void setName(std::string const &name) override {
+    mName = name;
+    notifyChange(mUniqueId);
+  };
+  inline std::string getName() const override { return mName; };
+
+  inline void setUniqueId(uint32_t uniqueId) override {
+    auto previousId = mUniqueId;
+    mUniqueId = uniqueId;
+    notifyChange(previousId);
+  }
+  inline uint32_t getUniqueId() const override { return mUniqueId; }
+  inline void setSegmentationId(uint32_t segmentationId) override {
+    mSegmentationId = segmentationId;
+  }
+  inline uint32_t getSegmentationId() const override { return mSegmentationId; }
+  inline void setSegmentationCustomData(const std::vector<float> &customData) override {}
+  inline void setInitialPose(const physx::PxTransform &transform) override {
+    mInitialPose = transform;
+  }
+  inline physx::PxTransform getInitialPose() const override { return mInitialPose; };
+  void update(const physx::PxTransform &transform) override;
+
+  void setVisibility(float visibility) override;
+  void setVisible(bool visible) override;
+  inline void setRenderMode(uint32_t mode) override { mRenderMode = mode; }
+  inline uint32_t getRenderMode() const { return mRenderMode; }
+
+  void destroy() override;
+
+  physx::PxGeometryType::Enum getType() const override { return mSource.geometry; }
+  physx::PxVec3 getScale() const override { return mSource.scale; }
+
+  /** mesh files are decoded through the MeshCache on request */
+  std::vector<std::shared_ptr<IPxrRenderShape>> getRenderShapes() override;
+
+  inline uint32_t getIndex() const { return mIndex; }
+  inline NullVisualSource const &getSource() const { return mSource; }
+};
+
+class NullCamera : public ICamera {
+  uint32_t mWidth, mHeight;
+  NullScene *mScene;
+  physx::PxTransform mPose{physx::PxIdentity};
+  float mNear, mFar;
+  float mFx, mFy, mCx, mCy, mSkew;
+
+public:
+  NullCamera(uint32_t width, uint32_t height, float fovy, float near, float far,
+             NullScene *scene);
+
+  inline uint32_t getWidth() const override { return mWidth; };
+  inline uint32_t getHeight() const override { return mHeight; };
+
+  [[nodiscard]] inline float getPrincipalPointX() const override { return mCx; }
+  [[nodiscard]] inline float getPrincipalPointY() const override { return mCy; }
+  [[nodiscard]] inline float getFocalX() const override { return mFx; }
+  [[nodiscard]] inline float getFocalY() const override { return mFy; }
+  [[nodiscard]] inline float getNear() const override { return mNear; }
+  [[nodiscard]] inline float getFar() const override { return mFar; }
+  [[nodiscard]] inline float getSkew() const override { return mSkew; }
+
+  void setPerspectiveCameraParameters(float near, float far, float fx, float fy, float cx,
+                                      float cy, float skew) override;
+
+  inline void takePicture() override {}
+  std::vector<float> getFloatImage(std::string const &name) override;
+  std::vector<uint32_t> getUintImage(std::string const &name) override;
+
+  IPxrScene *getScene() override;
+
+  inline physx::PxTransform getPose() const override { return mPose; }
+  inline void setPose(physx::PxTransform const &pose) override { mPose = pose; }
+};
+
+/** Scene that records what would be drawn without drawing it
+ *
+ *  Bodies occupy stable slots; the actor pose passed to update and the visibility of slot i
+ *  are stored at index i of two flat arrays. Removed bodies leave an empty slot so recorded
+ *  frames stay aligned with the body list.
+ */
+class NullScene : public IPxrScene {
+public:
+  struct Frame {
+    std::vector<physx::PxTransform> poses;
+    std::vector<float> visibility;
+  };
+
+private:
+  std::string mName;
+  std::vector<std::unique_ptr<NullRigidbody>> mBodies; // null for removed slots
+  std::vector<physx::PxTransform> mPoses;
+  std::vector<float> mVisibility;
+
+  std::vector<std::unique_ptr<NullCamera>> mCameras;
+  std::vector<std::unique_ptr<ILight>> mLights;
+  std::array<float, 3> mAmbientLight{0.f, 0.f, 0.f};
+
+  bool mRecording{false};
+  std::vector<Frame> mFrames;
+
+public:
+  explicit NullScene(std::string const &name);
+
+  inline std::string getName() { return mName; }
+
+  // IPxrScene
+  using IPxrScene::addRigidbody;
+  IPxrRigidbody *addRigidbody(const std::string &meshFile, const physx::PxVec3 &scale) override;
+  IPxrRigidbody *addRigidbody(const std::string &meshFile, const physx::PxVec3 &scale,
+                              std::shared_ptr<IPxrMaterial> material) override;
+  IPxrRigidbody *addRigidbody(physx::PxGeometryType::Enum type, const physx::PxVec3 &scale,
+                              std::shared_ptr<IPxrMaterial> material) override;
+  IPxrRigidbody *addRigidbody(std::vector<physx::PxVec3> const &vertices,
+                              std::vector<physx::PxVec3> const &normals,
+                              std::vector<uint32_t> const &indices, const physx::PxVec3 &scale,
+                              std::shared_ptr<IPxrMaterial> material) override;
+  void removeRigidbody(IPxrRigidbody *body) override;
+
+  ICamera *addCamera(uint32_t width, uint32_t height, float fovy, float near, float far,
+                     std::string const &shaderDir = "") override;
+  void removeCamera(ICamera *camera) override;
+  std::vector<ICamera *> getCameras() override;
+
+  void setAmbientLight(std::array<float, 3> const &color) override { mAmbientLight = color; }
+  std::array<float, 3> getAmbientLight() const override { return mAmbientLight; }
+  IPointLight *addPointLight(std::array<float, 3> const &position,
+                             std::array<float, 3> const &color, bool enableShadow,
+                             float shadowNear, float shadowFar) override;
+  IDirectionalLight *addDirectionalLight(std::array<float, 3> const &direction,
+                                         std::array<float, 3> const &color, bool enableShadow,
+                                         std::array<float, 3> const &position, float shadowScale,
+                                         float shadowNear, float shadowFar) override;
+  ISpotLight *addSpotLight(std::array<float, 3> const &position,
+                           std::array<float, 3> const &direction, float fovInner, float fovOuter,
+                           std::array<float, 3> const &color, bool enableShadow,
+                           float shadowNear, float shadowFar) override;
+  void removeLight(ILight *light) override;
+
+  /** appends the current poses and visibility to the frames while recording */
+  void updateRender() override;
+
+  void destroy() override;
+
+  // body arrays, indexed by slot
+  inline std::vector<std::unique_ptr<NullRigidbody>> const &getBodies() const { return mBodies; }
+  inline std::vector<physx::PxTransform> const &getPoses() const { return mPoses; }
+  inline std::vector<float> const &getVisibility() const { return mVisibility; }
+  inline std::vector<std::unique_ptr<ILight>> const &getLights() const { return mLights; }
+
+  inline void setPose(uint32_t index, physx::PxTransform const &pose) { mPoses[index] = pose; }
+  inline void setVisibility(uint32_t index, float visibility) { mVisibility[index] = visibility; }
+
+  // in-memory episode
+  inline void setRecording(bool recording) { mRecording = recording; }
+  inline bool isRecording() const { return mRecording; }
+  inline std::vector<Frame> const &getFrames() const { return mFrames; }
+  inline void clearFrames() { mFrames.clear(); }
+
+  /** add every live body, the ambient light and the lights to another scene
+   *
+   *  Returns the new bodies by slot, null for removed slots, to be passed to applyFrame.
+   */
+  std::vector<IPxrRigidbody *> instantiate(IPxrScene &target) const;
+
+  /** set the bodies returned by instantiate to a recorded frame */
+  static void applyFrame(Frame const &frame, std::vector<IPxrRigidbody *> const &bodies);
+
+private:
+  IPxrRigidbody *addBody(NullVisualSource source);
+};
+
+/** Renderer for headless runs that keeps mesh references, materials and poses only
+ *
+ *  No file is decoded and no image is produced. Scenes can record episodes in memory and
+ *  instantiate their bodies in a real renderer for replay.
+ */
+class NullRenderer : public IPxrRenderer {
+  std::vector<std::unique_ptr<NullScene>> mScenes;
+
+public:
+  NullScene *createScene(std::string const &name) override;
+  void removeScene(IPxrScene *scene) override;
+  std::shared_ptr<IPxrMaterial> createMaterial() override;
+};
+
+} // namespace Renderer
+} // namespace sapien
@@ -1,4 +1,5 @@
 #pragma once
+#include "image_conversion.h"
 #include <PxPhysicsAPI.h>
 #include <array>
 #include <dlpack/dlpack.h>
@@ -265,6 +266,30 @@ public:
   virtual std::vector<float> getFloatImage(std::string const &name) = 0;
   virtual std::vector<uint32_t> getUintImage(std::string const &name) = 0;
 
+  /** Color as packed RGB with 8 bits per channel */
+  virtual std::vector<uint8_t> getColorRGB8() {
+    auto color = getFloatImage("Color");
+    std::vector<uint8_t> ret(color.size() / 4 * 3);
+    convertRGBAFloatToRGB8(color.data(), ret.data(), color.size() / 4);
+    return ret;
+  }
+
+  /** float image as IEEE half precision bits */
+  virtual std::vector<uint16_t> getHalfImage(std::string const &name) {
+    auto image = getFloatImage(name);
+    std::vector<uint16_t> ret(image.size());
+    convertFloatToHalf(image.data(), ret.data(), image.size());
+    return ret;
+  }
+
+  /** positive distance along the view axis, 0 where nothing is rendered */
+  virtual std::vector<float> getDepthImage() {
+    auto position = getFloatImage("Position");
+    std::vector<float> ret(position.size() / 4);
+    convertPositionToDepth(position.data(), ret.data(), ret.size());
+    return ret;
+  }
+
   // return new DLManagedTensor
   virtual DLManagedTensor *getDLImage(std::string const &name) {
     throw std::runtime_error("dlpack is not implemented in this renderer");
@@ -333,6 +358,9 @@ public:
 
 class IPxrRigidbody {
 public:
+  /** called after setUniqueId or setName with the id the body had before */
+  using ChangeCallback = std::function<void(IPxrRigidbody *body, uint32_t previousId)>;
+
   virtual void setName(std::string const &name) = 0;
   virtual std::string getName() const = 0;
 
@@ -372,6 +400,19 @@ public:
   virtual physx::PxVec3 getScale() const {
     throw std::runtime_error("getScale is not implemented");
   }
+
+  /** used by the scene that owns the body to keep its segmentation tables current */
+  inline void setChangeCallback(ChangeCallback callback) { mChangeCallback = std::move(callback); }
+
+protected:
+  inline void notifyChange(uint32_t previousId) {
+    if (mChangeCallback) {
+      mChangeCallback(this, previousId);
+    }
+  }
+
+private:
+  ChangeCallback mChangeCallback;
 };
 
 class IPxrScene {
@@ -476,6 +517,10 @@ public:
     throw std::runtime_error("Texture creation is not supported.");
   }
 
+  /* Load a mesh file into the renderer's resource cache so adding it to a scene later does not
+   * block on file I/O. May be called from asset loading threads. */
+  virtual void preloadModel(std::string const &filename) {}
+
   virtual ~IPxrRenderer() = default;
 };
 
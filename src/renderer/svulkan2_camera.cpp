@@ -1,26 +1,33 @@
 #include "svulkan2_renderer.h"
+#include <algorithm>
 
 namespace sapien {
 namespace Renderer {
 
 SVulkan2Camera::SVulkan2Camera(uint32_t width, uint32_t height, float fovy, float near, float far,
-                               SVulkan2Scene *scene, std::string const &shaderDir)
-    : mWidth(width), mHeight(height), mScene(scene) {
+                               SVulkan2Scene *scene, std::string const &shaderDir,
+                               std::shared_ptr<SVulkan2SharedRenderer> shared)
+    : mWidth(width), mHeight(height), mScene(scene), mShared(shared) {
   auto context = mScene->getParentRenderer()->mContext;
-  auto config = std::make_shared<svulkan2::RendererConfig>();
-  config->culling = mScene->getParentRenderer()->mCullMode;
-  config->colorFormat = vk::Format::eR32G32B32A32Sfloat;
-  config->depthFormat = vk::Format::eD32Sfloat;
-  config->shaderDir = shaderDir;
+  if (mShared) {
+    mRenderer = mShared->renderer;
+    mShared->users += 1;
+  } else {
+    auto config = std::make_shared<svulkan2::RendererConfig>();
+    config->culling = mScene->getParentRenderer()->mCullMode;
+    config->colorFormat = vk::Format::eR32G32B32A32Sfloat;
+    config->depthFormat = vk::Format::eD32Sfloat;
+    config->shaderDir = shaderDir;
 
-  mRenderer = std::make_unique<svulkan2::renderer::Renderer>(context, config);
-  mRenderer->resize(width, height);
+    mRenderer = std::make_shared<svulkan2::renderer::Renderer>(context, config);
+    mRenderer->resize(width, height);
+    mRenderer->setScene(*scene->getScene());
+  }
 
   mCamera = &mScene->getScene()->addCamera();
   mCamera->setPerspectiveParameters(near, far, fovy, width, height);
   mCommandBuffer = context->createCommandBuffer();
   mFence = context->getDevice().createFenceUnique({vk::FenceCreateFlagBits::eSignaled});
-  mRenderer->setScene(*scene->getScene());
 }
 
 float SVulkan2Camera::getPrincipalPointX() const { return mCamera->getCx(); }
@@ -36,16 +43,41 @@ void SVulkan2Camera::setPerspectiveCameraParameters(float near, float far, float
   mCamera->setPerspectiveParameters(near, far, fx, fy, cx, cy, mWidth, mHeight, skew);
 }
 
+SVulkan2Camera::~SVulkan2Camera() {
+  // in-flight copies still write to the readback buffers
+  for (auto &slot : mReadbackSlots) {
+    if (slot.submitted) {
+      waitForReadback(slot);
+    }
+  }
+  if (mShared) {
+    mShared->users -= 1;
+    if (mShared->lastUser == this) {
+      mShared->lastUser = nullptr;
+      mShared->lastFence = vk::Fence{};
+    }
+  }
+}
+
 void SVulkan2Camera::takePicture() {
-  auto context = mScene->getParentRenderer()->mContext;
-  auto result = context->getDevice().waitForFences(mFence.get(), VK_TRUE, UINT64_MAX);
-  if (result != vk::Result::eSuccess) {
-    throw std::runtime_error("take picture failed: wait for fence failed");
+  if (mShared) {
+    // the targets belong to the next camera once this picture is done
+    takePictureAsync({});
+    return;
   }
-  context->getDevice().resetFences(mFence.get());
+  waitForIdle();
+  mScene->getParentRenderer()->mContext->getDevice().resetFences(mFence.get());
   mRenderer->render(*mCamera, {}, {}, {}, mFence.get());
 }
 
+void SVulkan2Camera::waitForIdle() {
+  waitForFence();
+  auto &latest = mReadbackSlots[mLatestReadback];
+  if (latest.submitted) {
+    waitForReadback(latest);
+  }
+}
+
 void SVulkan2Camera::waitForFence() {
   auto result = mScene->getParentRenderer()->mContext->getDevice().waitForFences(
       mFence.get(), VK_TRUE, UINT64_MAX);
@@ -54,16 +86,213 @@ void SVulkan2Camera::waitForFence() {
   }
 }
 
+void SVulkan2Camera::waitForSharedRenderer() {
+  if (!mShared || !mShared->lastUser || mShared->lastUser == this) {
+    return;
+  }
+  auto result = mScene->getParentRenderer()->mContext->getDevice().waitForFences(
+      mShared->lastFence, VK_TRUE, UINT64_MAX);
+  if (result != vk::Result::eSuccess) {
+    throw std::runtime_error("take picture failed: wait for fence failed");
+  }
+}
+
+void SVulkan2Camera::waitForReadback(ReadbackSlot &slot) {
+  auto result = mScene->getParentRenderer()->mContext->getDevice().waitForFences(
+      slot.fence.get(), VK_TRUE, UINT64_MAX);
+  if (result != vk::Result::eSuccess) {
+    throw std::runtime_error("take picture failed: wait for fence failed");
+  }
+}
+
+static uint32_t getFormatChannels(vk::Format format) {
+  switch (format) {
+  case vk::Format::eR32G32B32A32Sfloat:
+  case vk::Format::eR32G32B32A32Uint:
+  case vk::Format::eR8G8B8A8Unorm:
+    return 4;
+  case vk::Format::eD32Sfloat:
+    return 1;
+  default:
+    throw std::runtime_error("failed to read back render target: unsupported format");
+  }
+}
+
+static uint32_t getFormatChannelSize(vk::Format format) {
+  return format == vk::Format::eR8G8B8A8Unorm ? 1 : 4;
+}
+
+static bool isReadbackFormat(vk::Format format) {
+  return format == vk::Format::eR32G32B32A32Sfloat || format == vk::Format::eR32G32B32A32Uint ||
+         format == vk::Format::eR8G8B8A8Unorm || format == vk::Format::eD32Sfloat;
+}
+
+/** bytes per pixel, formats svulkan2 does not use for cameras count as 4 bytes */
+static uint32_t getFormatSize(vk::Format format) {
+  if (isReadbackFormat(format)) {
+    return getFormatChannels(format) * getFormatChannelSize(format);
+  }
+  if (format == vk::Format::eR16G16B16A16Sfloat) {
+    return 8;
+  }
+  return 4;
+}
+
+void SVulkan2Camera::takePictureAsync(std::vector<std::string> const &names) {
+  auto context = mScene->getParentRenderer()->mContext;
+  auto device = context->getDevice();
+
+  // the renderer records into one command buffer, so the previous picture has to finish first
+  waitForIdle();
+  waitForSharedRenderer();
+
+  uint32_t index = 1 - mLatestReadback;
+  auto &slot = mReadbackSlots[index];
+  if (!slot.commandBuffer) {
+    slot.commandBuffer = context->createCommandBuffer();
+    slot.fence = device.createFenceUnique({vk::FenceCreateFlagBits::eSignaled});
+    slot.renderSemaphore = device.createSemaphoreUnique({});
+  }
+  device.resetFences(slot.fence.get());
+  slot.submitted = false;
+
+  if (mShared && mShared->scene != mScene->getScene()) {
+    mRenderer->setScene(*mScene->getScene());
+    mShared->scene = mScene->getScene();
+  }
+  mRenderer->render(*mCamera, {}, {}, {slot.renderSemaphore.get()}, {});
+
+  // targets exist once the renderer has rendered
+  std::vector<std::string> targetNames = names;
+  if (targetNames.empty()) {
+    for (auto &name : mRenderer->getRenderTargetNames()) {
+      if (isReadbackFormat(mRenderer->getRenderTarget(name)->getFormat())) {
+        targetNames.push_back(name);
+      }
+    }
+  }
+  for (auto it = slot.targets.begin(); it != slot.targets.end();) {
+    if (std::find(targetNames.begin(), targetNames.end(), it->first) == targetNames.end()) {
+      it = slot.targets.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  slot.commandBuffer->begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+  for (auto &name : targetNames) {
+    auto target = mRenderer->getRenderTarget(name);
+    auto format = target->getFormat();
+    uint32_t width = target->getWidth();
+    uint32_t height = target->getHeight();
+    size_t size = static_cast<size_t>(width) * height * getFormatChannels(format) *
+                  getFormatChannelSize(format);
+
+    auto &readback = slot.targets[name];
+    if (!readback.buffer || readback.format != format || readback.width != width ||
+        readback.height != height) {
+      readback.buffer.reset();
+      readback.buffer = std::make_shared<svulkan2::core::Buffer>(
+          context, size, vk::BufferUsageFlagBits::eTransferDst, VMA_MEMORY_USAGE_GPU_TO_CPU);
+      readback.data = readback.buffer->map();
+      readback.format = format;
+      readback.width = width;
+      readback.height = height;
+    }
+    target->recordCopyToBuffer(slot.commandBuffer.get(), readback.buffer->getVulkanBuffer(), 0,
+                               size, {0, 0, 0}, {width, height, 1});
+  }
+  slot.commandBuffer->end();
+
+  vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eTransfer;
+  vk::SubmitInfo info(1, &slot.renderSemaphore.get(), &waitStage, 1, &slot.commandBuffer.get());
+  context->getQueue().submit(info, slot.fence.get());
+  slot.submitted = true;
+  mLatestReadback = index;
+  if (mShared) {
+    mShared->lastUser = this;
+    mShared->lastFence = slot.fence.get();
+  }
+}
+
+SVulkan2Camera::HostImage SVulkan2Camera::getImageAsync(std::string const &name) {
+  auto &slot = mReadbackSlots[mLatestReadback];
+  if (!slot.submitted) {
+    throw std::runtime_error("failed to get image: takePictureAsync has not been called");
+  }
+  auto it = slot.targets.find(name);
+  if (it == slot.targets.end()) {
+    throw std::runtime_error("failed to get image: " + name +
+                             " was not requested by the latest takePictureAsync");
+  }
+  waitForReadback(slot);
+  auto &readback = it->second;
+  return {readback.data, readback.format, readback.width, readback.height,
+          getFormatChannels(readback.format), readback.buffer};
+}
+
+std::vector<uint8_t> SVulkan2Camera::getColorRGB8Async() {
+  auto image = getImageAsync("Color");
+  if (image.format != vk::Format::eR32G32B32A32Sfloat) {
+    throw std::runtime_error("failed to convert image: Color is not a float RGBA target");
+  }
+  size_t pixelCount = static_cast<size_t>(image.width) * image.height;
+  std::vector<uint8_t> ret(pixelCount * 3);
+  convertRGBAFloatToRGB8(static_cast<float const *>(image.data), ret.data(), pixelCount);
+  return ret;
+}
+
+std::vector<uint16_t> SVulkan2Camera::getHalfImageAsync(std::string const &name) {
+  auto image = getImageAsync(name);
+  if (image.format != vk::Format::eR32G32B32A32Sfloat &&
+      image.format != vk::Format::eD32Sfloat) {
+    throw std::runtime_error("failed to convert image: " + name + " is not a float target");
+  }
+  size_t count = static_cast<size_t>(image.width) * image.height * image.channels;
+  std::vector<uint16_t> ret(count);
+  convertFloatToHalf(static_cast<float const *>(image.data), ret.data(), count);
+  return ret;
+}
+
+std::vector<float> SVulkan2Camera::getDepthImageAsync() {
+  auto image = getImageAsync("Position");
+  if (image.format != vk::Format::eR32G32B32A32Sfloat) {
+    throw std::runtime_error("failed to convert image: Position is not a float RGBA target");
+  }
+  size_t pixelCount = static_cast<size_t>(image.width) * image.height;
+  std::vector<float> ret(pixelCount);
+  convertPositionToDepth(static_cast<float const *>(image.data), ret.data(), pixelCount);
+  return ret;
+}
+
 std::vector<std::string> SVulkan2Camera::getRenderTargetNames() {
   return mRenderer->getRenderTargetNames();
 }
 
 std::vector<float> SVulkan2Camera::getFloatImage(std::string const &name) {
+  if (mShared) {
+    auto image = getImageAsync(name);
+    if (image.format != vk::Format::eR32G32B32A32Sfloat &&
+        image.format != vk::Format::eD32Sfloat) {
+      throw std::runtime_error("failed to get image: " + name + " is not a float target");
+    }
+    auto data = static_cast<float const *>(image.data);
+    return {data, data + static_cast<size_t>(image.width) * image.height * image.channels};
+  }
   waitForFence();
   return std::get<0>(mRenderer->download<float>(name));
 }
 
 std::vector<uint32_t> SVulkan2Camera::getUintImage(std::string const &textureName) {
+  if (mShared) {
+    auto image = getImageAsync(textureName);
+    if (image.format != vk::Format::eR32G32B32A32Uint) {
+      throw std::runtime_error("failed to get image: " + textureName +
+                               " is not an integer target");
+    }
+    auto data = static_cast<uint32_t const *>(image.data);
+    return {data, data + static_cast<size_t>(image.width) * image.height * image.channels};
+  }
   waitForFence();
   return std::get<0>(mRenderer->download<uint32_t>(textureName));
 }
@@ -75,6 +304,10 @@ static void deleter(DLManagedTensor *self) {
 }
 
 DLManagedTensor *SVulkan2Camera::getDLImage(std::string const &name) {
+  if (mShared) {
+    throw std::runtime_error(
+        "failed to get tensor: the render targets are shared, use get_dl_tensor_async");
+  }
   auto [buffer, sizes, format] = mRenderer->transferToCuda(name);
 
   long size = sizes[0] * sizes[1];
@@ -132,6 +365,25 @@ DLManagedTensor *SVulkan2Camera::getDLImage(std::string const &name) {
   return tensor;
 }
 
+SVulkan2CameraMemoryStats SVulkan2Camera::getMemoryStats() {
+  SVulkan2CameraMemoryStats stats{mScene->getName(), 0, 0, 0, mShared ? mShared->users : 1};
+  auto cameras = mScene->getCameras();
+  stats.cameraIndex = std::find(cameras.begin(), cameras.end(), this) - cameras.begin();
+  // render targets are created by the first picture
+  for (auto &name : mRenderer->getRenderTargetNames()) {
+    auto target = mRenderer->getRenderTarget(name);
+    stats.renderTargetBytes += static_cast<uint64_t>(target->getWidth()) * target->getHeight() *
+                               getFormatSize(target->getFormat());
+  }
+  for (auto &slot : mReadbackSlots) {
+    for (auto &[name, readback] : slot.targets) {
+      stats.readbackBytes += static_cast<uint64_t>(readback.width) * readback.height *
+                             getFormatSize(readback.format);
+    }
+  }
+  return stats;
+}
+
 glm::mat4 SVulkan2Camera::getModelMatrix() const { return mCamera->computeWorldModelMatrix(); }
 glm::mat4 SVulkan2Camera::getProjectionMatrix() const { return mCamera->getProjectionMatrix(); }
 
@@ -1,5 +1,6 @@
 #include "svulkan2_renderer.h"
 #include "svulkan2_material.h"
+#include <filesystem>
 #include <svulkan2/resource/material.h>
 
 namespace sapien {
@@ -57,8 +58,49 @@ SVulkan2Scene *SVulkan2Renderer::createScene(std::string const &name) {
   return mScenes.back().get();
 }
 
+std::vector<SVulkan2CameraMemoryStats> SVulkan2Renderer::getCameraMemoryStats() {
+  std::vector<SVulkan2CameraMemoryStats> stats;
+  for (auto &scene : mScenes) {
+    for (auto camera : scene->getCameras()) {
+      stats.push_back(static_cast<SVulkan2Camera *>(camera)->getMemoryStats());
+    }
+  }
+  return stats;
+}
+
+std::shared_ptr<SVulkan2SharedRenderer>
+SVulkan2Renderer::getSharedRenderer(std::string const &shaderDir, uint32_t width,
+                                    uint32_t height) {
+  auto config = std::make_shared<svulkan2::RendererConfig>();
+  config->culling = mCullMode;
+  config->colorFormat = vk::Format::eR32G32B32A32Sfloat;
+  config->depthFormat = vk::Format::eD32Sfloat;
+  config->shaderDir = shaderDir;
+
+  // renderers whose cameras are all gone
+  std::erase_if(mSharedRenderers, [](auto const &entry) { return entry.second.expired(); });
+
+  auto &entry =
+      mSharedRenderers[{shaderDir, config->colorFormat, config->depthFormat, width, height}];
+  if (auto shared = entry.lock()) {
+    return shared;
+  }
+  auto shared = std::make_shared<SVulkan2SharedRenderer>();
+  shared->renderer = std::make_shared<svulkan2::renderer::Renderer>(mContext, config);
+  shared->renderer->resize(width, height);
+  entry = shared;
+  return shared;
+}
+
 void SVulkan2Renderer::removeScene(IPxrScene *scene) {
   mContext->getDevice().waitIdle(); // wait for all render tasks to finish
+  // a shared renderer still bound to the scene is bound again before it renders
+  for (auto &[key, entry] : mSharedRenderers) {
+    auto shared = entry.lock();
+    if (shared && shared->scene == static_cast<SVulkan2Scene *>(scene)->getScene()) {
+      shared->scene = nullptr;
+    }
+  }
   mScenes.erase(std::remove_if(mScenes.begin(), mScenes.end(),
                                [scene](auto &s) { return scene == s.get(); }),
                 mScenes.end());
@@ -107,5 +149,58 @@ SVulkan2Renderer::createTexture(std::string_view filename, uint32_t mipLevels,
   return std::make_shared<SVulkan2Texture>(texture);
 }
 
+void SVulkan2Renderer::preloadModel(std::string const &filename) {
+  if (!std::filesystem::exists(filename)) {
+    return;
+  }
+  // the resource manager caches models by filename, so scenes reuse the loaded model
+  mContext->getResourceManager()->CreateModelFromFile(filename)->loadAsync().get();
+}
+
+SVulkan2Renderer::DecodedModel &
+SVulkan2Renderer::getDecodedModel(std::shared_ptr<DecodedMesh const> const &decoded) {
+  auto &model = mDecodedModels[decoded->filename];
+  model.lastUse = ++mDecodedModelClock;
+  if (model.source.lock() == decoded) {
+    return model;
+  }
+
+  // new file or changed on disk
+  model.source = decoded;
+  model.meshes.clear();
+  for (auto &submesh : decoded->submeshes) {
+    // svulkan2 imports with flipped UVs
+    std::vector<float> uvs = submesh.uvs;
+    for (size_t i = 1; i < uvs.size(); i += 2) {
+      uvs[i] = 1.f - uvs[i];
+    }
+    auto mesh = svulkan2::resource::SVMesh::Create(submesh.positions, submesh.indices);
+    mesh->setVertexAttribute("normal", submesh.normals);
+    mesh->setVertexAttribute("uv", uvs);
+    model.meshes.push_back(mesh);
+  }
+
+  while (mDecodedModels.size() > kDecodedModelCapacity) {
+    auto oldest = mDecodedModels.begin();
+    for (auto it = mDecodedModels.begin(); it != mDecodedModels.end(); ++it) {
+      if (it->second.lastUse < oldest->second.lastUse) {
+        oldest = it;
+      }
+    }
+    mDecodedModels.erase(oldest);
+  }
+  return model;
+}
+
+std::vector<std::shared_ptr<svulkan2::resource::SVMesh>>
+SVulkan2Renderer::getMeshesFromFile(std::string const &filename) {
+  auto decoded = MeshCache::Get().load(filename);
+  if (!decoded) {
+    return {};
+  }
+  std::lock_guard<std::mutex> lock(mMeshLock);
+  return getDecodedModel(decoded).meshes;
+}
+
 } // namespace Renderer
 } // namespace sapien
@@ -1,8 +1,14 @@
 #pragma once
+#include "mesh_cache.h"
 #include "renderer/render_interface.h"
 #include "svulkan2_light.h"
 #include "svulkan2_material.h"
+#include <map>
 #include <memory>
+#include <mutex>
+#include <array>
+#include <tuple>
+#include <svulkan2/core/buffer.h>
 #include <svulkan2/core/context.h>
 #include <svulkan2/renderer/renderer.h>
 #include <svulkan2/scene/scene.h>
@@ -39,7 +45,10 @@ public:
 
   SVulkan2Rigidbody &operator=(SVulkan2Rigidbody const &other) = delete;
 
-  inline void setName(std::string const &name) override { mName = name; };
+  inline void setName(std::string const &name) override {
+    mName = name;
+    notifyChange(mUniqueId);
+  };
   std::string getName() const override { return mName; };
 
   void setUniqueId(uint32_t uniqueId) override;
@@ -72,6 +81,34 @@ public:
   inline SVulkan2Scene *getScene() const { return mParentScene; }
 };
 
+/** svulkan2 renderer whose pipelines and render targets are used by cameras in turn
+ *
+ *  Cameras of different scenes may share it; it is bound to the scene of the camera that
+ *  renders, and svulkan2 rebuilds its object bindings at the first render after a switch.
+ */
+struct SVulkan2SharedRenderer {
+  std::shared_ptr<svulkan2::renderer::Renderer> renderer;
+  svulkan2::scene::Scene *scene{nullptr}; // scene the renderer is bound to
+  uint32_t users{0};
+  // the camera that rendered last and the fence signaled once its targets are copied out
+  SVulkan2Camera *lastUser{nullptr};
+  vk::Fence lastFence{};
+};
+
+/** Render memory of one camera
+ *
+ *  Shared render targets are reported by every camera using them. A sharing camera copies
+ *  every readable target after each picture into one of two alternating sets of host buffers,
+ *  so its readback memory is twice the size of all its targets.
+ */
+struct SVulkan2CameraMemoryStats {
+  std::string sceneName;
+  uint32_t cameraIndex;
+  uint64_t renderTargetBytes; // device memory of the render targets
+  uint64_t readbackBytes;     // host-visible copies of the render targets
+  uint32_t sharingCameras;    // cameras using the same render targets, 1 if not shared
+};
+
 class SVulkan2Scene : public IPxrScene {
   SVulkan2Renderer *mParentRenderer;
   std::unique_ptr<svulkan2::scene::Scene> mScene;
@@ -157,6 +194,26 @@ public:
 private:
   static std::string gDefaultSpvDir;
   std::vector<std::unique_ptr<SVulkan2Scene>> mScenes;
+  bool mShareCameraTargets{false};
+
+  // GPU meshes built from the shared decoded mesh cache, one per submesh, by canonical path
+  struct DecodedModel {
+    std::weak_ptr<DecodedMesh const> source;
+    std::vector<std::shared_ptr<svulkan2::resource::SVMesh>> meshes;
+    uint64_t lastUse;
+  };
+  static constexpr size_t kDecodedModelCapacity = 256;
+  std::mutex mMeshLock;
+  std::map<std::string, DecodedModel> mDecodedModels;
+  uint64_t mDecodedModelClock{0};
+
+  DecodedModel &getDecodedModel(std::shared_ptr<DecodedMesh const> const &decoded);
+
+  // renderers of sharing cameras across scenes, by shader directory, color and depth format,
+  // width and height
+  std::map<std::tuple<std::string, vk::Format, vk::Format, uint32_t, uint32_t>,
+           std::weak_ptr<SVulkan2SharedRenderer>>
+      mSharedRenderers;
 
 public:
   static void setLogLevel(std::string const &level);
@@ -172,21 +229,81 @@ public:
   createTexture(std::string_view filename, uint32_t mipLevels = 1,
                 IPxrTexture::FilterMode::Enum filterMode = {},
                 IPxrTexture::AddressMode::Enum addressMode = {}) override;
+
+  void preloadModel(std::string const &filename) override;
+
+  /** meshes of a file without its materials, decoded through the shared MeshCache
+   *
+   *  Used for visuals whose material replaces the materials of the file, which svulkan2's
+   *  loader imports otherwise. Meshes are shared by every body created from the same file
+   *  version. The renderer keeps them for the 256 most recently used files.
+   */
+  std::vector<std::shared_ptr<svulkan2::resource::SVMesh>>
+  getMeshesFromFile(std::string const &filename);
+
+  /** Cameras created afterwards share one svulkan2 renderer per shader directory, formats and
+   *  resolution, across scenes. They render in turn and copy all their targets to host memory
+   *  after each picture, see SVulkan2CameraMemoryStats.
+   */
+  inline void setShareCameraTargets(bool share) { mShareCameraTargets = share; }
+  inline bool getShareCameraTargets() const { return mShareCameraTargets; }
+
+  /** renderer for sharing cameras, created on the first request for its config */
+  std::shared_ptr<SVulkan2SharedRenderer>
+  getSharedRenderer(std::string const &shaderDir, uint32_t width, uint32_t height);
+
+  /** memory of every camera, by scene and camera order */
+  std::vector<SVulkan2CameraMemoryStats> getCameraMemoryStats();
 };
 
 class SVulkan2Camera : public ICamera {
   uint32_t mWidth, mHeight;
   SVulkan2Scene *mScene;
-  std::unique_ptr<svulkan2::renderer::Renderer> mRenderer;
+  std::shared_ptr<svulkan2::renderer::Renderer> mRenderer;
+  std::shared_ptr<SVulkan2SharedRenderer> mShared; // null when the renderer is not shared
   // physx::PxTransform mInitialPose;
   svulkan2::scene::Camera *mCamera;
 
   vk::UniqueCommandBuffer mCommandBuffer;
   vk::UniqueFence mFence;
 
+  /** persistently mapped host copy of a render target, shared with the views handed out */
+  struct Readback {
+    std::shared_ptr<svulkan2::core::Buffer> buffer;
+    void *data;
+    vk::Format format;
+    uint32_t width, height;
+  };
+  /** resources of one asynchronous picture */
+  struct ReadbackSlot {
+    vk::UniqueCommandBuffer commandBuffer;
+    vk::UniqueFence fence;
+    vk::UniqueSemaphore renderSemaphore;
+    std::map<std::string, Readback> targets;
+    bool submitted{false};
+  };
+  std::array<ReadbackSlot, 2> mReadbackSlots;
+  uint32_t mLatestReadback{1};
+
   void waitForFence();
+  void waitForReadback(ReadbackSlot &slot);
+  /** wait until the previous picture is rendered and copied */
+  void waitForIdle();
+  void waitForSharedRenderer();
 
 public:
+  /** view of a render target copied by takePictureAsync
+   *
+   *  buffer keeps the memory mapped after the camera is gone. The camera copies into the same
+   *  buffer again two pictures later, which overwrites what the view shows.
+   */
+  struct HostImage {
+    void const *data;
+    vk::Format format;
+    uint32_t width, height, channels;
+    std::shared_ptr<svulkan2::core::Buffer> buffer;
+  };
+
   inline uint32_t getWidth() const override { return mWidth; };
   inline uint32_t getHeight() const override { return mHeight; };
 
@@ -201,11 +318,35 @@ public:
   void setPerspectiveCameraParameters(float near, float far, float fx, float fy, float cx,
                                       float cy, float skew) override;
 
+  /** shared is null for a camera with its own renderer */
   SVulkan2Camera(uint32_t width, uint32_t height, float fovy, float near, float far,
-                 SVulkan2Scene *scene, std::string const &shaderDir);
+                 SVulkan2Scene *scene, std::string const &shaderDir,
+                 std::shared_ptr<SVulkan2SharedRenderer> shared = nullptr);
+
+  SVulkan2Camera(SVulkan2Camera const &) = delete;
+  SVulkan2Camera &operator=(SVulkan2Camera const &) = delete;
+  ~SVulkan2Camera();
 
   void takePicture() override;
 
+  /** Render and copy the named targets into host-visible buffers, returning once submitted
+   *
+   *  The call first waits for the previous picture of this camera to render and copy, since the
+   *  renderer reuses its command buffer and render targets; only the latest picture runs while
+   *  the caller continues. Pictures alternate between two sets of buffers, so the images of one
+   *  picture stay valid while the next one renders and are overwritten by the picture after
+   *  it. Empty names copy every target that can be read back.
+   */
+  void takePictureAsync(std::vector<std::string> const &names);
+
+  /** mapped image of the latest takePictureAsync, waits for its copy to finish */
+  HostImage getImageAsync(std::string const &name);
+
+  /** conversions of the latest takePictureAsync, read straight from the mapped buffers */
+  std::vector<uint8_t> getColorRGB8Async();
+  std::vector<uint16_t> getHalfImageAsync(std::string const &name);
+  std::vector<float> getDepthImageAsync();
+
   std::vector<std::string> getRenderTargetNames();
 
   std::vector<float> getFloatImage(std::string const &name) override;
@@ -228,6 +369,10 @@ public:
   std::string getMode() const;
 
   inline svulkan2::renderer::Renderer *getInternalRenderer() const { return mRenderer.get(); }
+
+  /** a shared camera takes every picture asynchronously and reads images from the copies */
+  inline bool isShared() const { return mShared != nullptr; }
+  SVulkan2CameraMemoryStats getMemoryStats();
 };
 
 } // namespace Renderer
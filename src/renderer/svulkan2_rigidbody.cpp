@@ -11,12 +11,14 @@ SVulkan2Rigidbody::SVulkan2Rigidbody(SVulkan2Scene *scene,
     : mParentScene(scene), mObjects(objects), mType(type), mScale(scale) {}
 
 void SVulkan2Rigidbody::setUniqueId(uint32_t uniqueId) {
+  auto previousId = mUniqueId;
   mUniqueId = uniqueId;
   for (auto obj : mObjects) {
     auto seg = obj->getSegmentation();
     seg[0] = uniqueId;
     obj->setSegmentation(seg);
   }
+  notifyChange(previousId);
 }
 
 uint32_t SVulkan2Rigidbody::getUniqueId() const { return mUniqueId; }
@@ -1,4 +1,5 @@
 #include "svulkan2_renderer.h"
+#include <filesystem>
 
 namespace sapien {
 namespace Renderer {
@@ -97,6 +98,7 @@ IPxrRigidbody *SVulkan2Scene::addRigidbody(const std::string &meshFile,
     return mBodies.back().get();
   }
 
+  // svulkan2 imports the materials of the file, including embedded textures and transparency
   auto model = mParentRenderer->mContext->getResourceManager()->CreateModelFromFile(meshFile);
   std::vector<svulkan2::scene::Object *> objects2;
   auto &obj = mScene->addObject(model);
@@ -115,24 +117,17 @@ IPxrRigidbody *SVulkan2Scene::addRigidbody(const std::string &meshFile, const ph
 
   auto mat = std::dynamic_pointer_cast<SVulkan2Material>(material);
 
-  if (!std::filesystem::exists(meshFile)) {
-    mBodies.push_back(
-        std::make_unique<SVulkan2Rigidbody>(this, std::vector<svulkan2::scene::Object *>{},
-                                            physx::PxGeometryType::eTRIANGLEMESH, scale));
-    return mBodies.back().get();
-  }
-  auto model = mParentRenderer->mContext->getResourceManager()->CreateModelFromFile(meshFile);
-  model->loadAsync().get();
-
+  // only geometry is needed, so share the decoded file with collision loading
   std::vector<std::shared_ptr<svulkan2::resource::SVShape>> shapes;
-  for (auto s : model->getShapes()) {
-    auto shape = svulkan2::resource::SVShape::Create(s->mesh, mat->getMaterial());
-    shapes.push_back(shape);
+  for (auto mesh : mParentRenderer->getMeshesFromFile(meshFile)) {
+    shapes.push_back(svulkan2::resource::SVShape::Create(mesh, mat->getMaterial()));
   }
-  auto &obj = mScene->addObject(svulkan2::resource::SVModel::FromData(shapes));
-  obj.setScale({scale.x, scale.y, scale.z});
   std::vector<svulkan2::scene::Object *> objects2;
-  objects2.push_back(&obj);
+  if (!shapes.empty()) {
+    auto &obj = mScene->addObject(svulkan2::resource::SVModel::FromData(shapes));
+    obj.setScale({scale.x, scale.y, scale.z});
+    objects2.push_back(&obj);
+  }
   mBodies.push_back(std::make_unique<SVulkan2Rigidbody>(
       this, objects2, physx::PxGeometryType::eTRIANGLEMESH, scale));
   return mBodies.back().get();
@@ -275,7 +270,11 @@ void SVulkan2Scene::removeRigidbody(IPxrRigidbody *body) {
 ICamera *SVulkan2Scene::addCamera(uint32_t width, uint32_t height, float fovy, float near,
                                   float far, std::string const &shaderDir) {
   std::string shader = shaderDir.length() ? shaderDir : gDefaultCameraShaderDirectory;
-  auto cam = std::make_unique<SVulkan2Camera>(width, height, fovy, near, far, this, shader);
+  auto shared = mParentRenderer->getShareCameraTargets()
+                    ? mParentRenderer->getSharedRenderer(shader, width, height)
+                    : nullptr;
+  auto cam =
+      std::make_unique<SVulkan2Camera>(width, height, fovy, near, far, this, shader, shared);
   mCameras.push_back(std::move(cam));
   return mCameras.back().get();
 }
@@ -53,6 +53,8 @@ protected:
   uint32_t mCol2{0};
   uint32_t mCol3{0};
 
+  int mEnvironment{-1};
+
   bool collisionRender{false};
   bool mHidden{false};
   float mDisplayVisibility{1.f};
@@ -84,6 +86,9 @@ public:
   inline physx_id_t getId() { return mId; }
   PxTransform getPose() const override;
 
+  /* environment slot of the parent scene, -1 if shared by all environments */
+  inline int getEnvironment() const { return mEnvironment; }
+
   void attachShape(std::unique_ptr<SCollisionShape> shape);
   std::vector<SCollisionShape *> getCollisionShapes() const;
 
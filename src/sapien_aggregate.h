@@ -0,0 +1,37 @@
+#pragma once
+#include <PxPhysicsAPI.h>
+
+namespace sapien {
+
+/** Group of actors sharing a single broadphase entry
+ *
+ *  Created by SScene::createAggregate, actors and articulations join it when built with the
+ *  aggregate set on their builder. With self collision disabled, members never collide with
+ *  each other and their pairs are not even generated by the broadphase.
+ */
+class SAggregate {
+public:
+  /* PhysX 4.1 limit on actors (articulation links count individually) per aggregate */
+  static constexpr uint32_t MaxActorCount = 128;
+
+private:
+  physx::PxAggregate *mPxAggregate;
+
+  // created for a single actor or articulation and released together with it
+  bool mOwnedByMember;
+
+public:
+  SAggregate(physx::PxAggregate *aggregate, bool ownedByMember)
+      : mPxAggregate(aggregate), mOwnedByMember(ownedByMember) {}
+  SAggregate(SAggregate const &) = delete;
+  SAggregate &operator=(SAggregate const &) = delete;
+
+  inline physx::PxAggregate *getPxAggregate() const { return mPxAggregate; }
+  inline bool isOwnedByMember() const { return mOwnedByMember; }
+
+  inline uint32_t getMaxActorCount() const { return mPxAggregate->getMaxNbActors(); }
+  inline uint32_t getActorCount() const { return mPxAggregate->getNbActors(); }
+  inline bool getSelfCollision() const { return mPxAggregate->getSelfCollision(); }
+};
+
+} // namespace sapien
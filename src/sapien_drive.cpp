@@ -170,6 +170,49 @@ std::tuple<PxVec3, PxVec3> SDrive6D::getTargetVelocity() const {
   return {linear, angular};
 }
 
+void SDrive6D::setTargetTrajectory(std::vector<PxReal> const &times,
+                                   std::vector<PxTransform> const &poses,
+                                   STrajectory::Interpolation interpolation) {
+  if (!times.empty() && times[0] > 0) {
+    std::vector<PxReal> t = {0};
+    std::vector<PxTransform> p = {getTarget()};
+    t.insert(t.end(), times.begin(), times.end());
+    p.insert(p.end(), poses.begin(), poses.end());
+    mTrajectory.setWaypoints(t, p, interpolation);
+  } else {
+    mTrajectory.setWaypoints(times, poses, interpolation);
+  }
+}
+
+void SDrive6D::appendTargetTrajectory(std::vector<PxReal> const &times,
+                                      std::vector<PxTransform> const &poses) {
+  if (!mTrajectory.isActive()) {
+    setTargetTrajectory(times, poses, STrajectory::Interpolation::eCUBIC);
+    return;
+  }
+  mTrajectory.appendWaypoints(times, poses);
+}
+
+void SDrive6D::stopTargetTrajectory() {
+  mTrajectory.clear();
+  setTargetVelocity({0, 0, 0}, {0, 0, 0});
+}
+
+void SDrive6D::prestep() {
+  if (!mTrajectory.isActive()) {
+    return;
+  }
+  mTrajectory.advance(mScene->getTimestep());
+  PxTransform pose;
+  PxVec3 v, w;
+  mTrajectory.evaluate(pose, v, w);
+  setTarget(pose);
+  setTargetVelocity(v, w);
+  if (mTrajectory.isFinished()) {
+    mTrajectory.markCompleted();
+  }
+}
+
 /// revolute
 SDriveRevolute::SDriveRevolute(SScene *scene, SActorBase *actor1, PxTransform const &pose1,
                                SActorBase *actor2, PxTransform const &pose2)
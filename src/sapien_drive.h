@@ -1,4 +1,5 @@
 #pragma once
+#include "sapien_trajectory.h"
 #include <PxPhysicsAPI.h>
 #include <tuple>
 
@@ -26,6 +27,9 @@ public:
   PxTransform getLocalPose1() const;
   PxTransform getLocalPose2() const;
 
+  /** called by SScene before each simulation step */
+  virtual void prestep() {}
+
   virtual ~SDrive() = default;
 };
 
@@ -34,6 +38,7 @@ class SDrive6D : public SDrive {
 
 private:
   PxD6Joint *mJoint;
+  SPoseTrajectory mTrajectory;
 
   SDrive6D(SScene *scene, SActorBase *actor1, PxTransform const &pose1, SActorBase *actor2,
            PxTransform const &pose2);
@@ -69,6 +74,22 @@ public:
 
   void setTargetVelocity(PxVec3 const &velocity, PxVec3 const &angularVelocity);
   std::tuple<PxVec3, PxVec3> getTargetVelocity() const;
+
+  /** Target trajectory, interpolated into target pose and velocity in prestep
+   *
+   *  Poses are in the same frame as setTarget. setTargetTrajectory preempts the current
+   *  trajectory; if the first waypoint time is positive, the current target is used as the
+   *  waypoint at time 0.
+   */
+  void setTargetTrajectory(std::vector<PxReal> const &times,
+                           std::vector<PxTransform> const &poses,
+                           STrajectory::Interpolation interpolation);
+  void appendTargetTrajectory(std::vector<PxReal> const &times,
+                              std::vector<PxTransform> const &poses);
+  void stopTargetTrajectory();
+  inline SPoseTrajectory const &getTargetTrajectory() const { return mTrajectory; }
+
+  void prestep() override;
 };
 
 class SDriveRevolute : public SDrive {
@@ -0,0 +1,92 @@
+#include "sapien_height_field.h"
+#include "simulation.h"
+
+namespace sapien {
+using namespace physx;
+
+// cyclic permutation x -> y, y -> z, z -> x
+PxQuat const SHeightField::Frame = PxQuat(0.5f, 0.5f, 0.5f, 0.5f);
+
+SHeightField::SHeightField(std::shared_ptr<Simulation const> simulation,
+                           PxHeightField *heightField, PxVec3 const &scale, PxReal heightScale,
+                           PxReal heightOffset)
+    : mHeightField(heightField), mSimulation(simulation), mScale(scale),
+      mHeightScale(heightScale), mHeightOffset(heightOffset) {
+  generateMesh(getGeometry(), mVertices, mNormals, mIndices);
+  for (auto &v : mVertices) {
+    v = Frame.rotate(v) + PxVec3(0, 0, mHeightOffset);
+  }
+  for (auto &n : mNormals) {
+    n = Frame.rotate(n);
+  }
+}
+
+SHeightField::~SHeightField() { mHeightField->release(); }
+
+PxHeightFieldGeometry SHeightField::getGeometry() const {
+  return PxHeightFieldGeometry(mHeightField, PxMeshGeometryFlags(), mHeightScale, mScale.y,
+                               mScale.x);
+}
+
+std::vector<PxReal> SHeightField::getHeights() const {
+  uint32_t count = getRows() * getColumns();
+  std::vector<PxHeightFieldSample> samples(count);
+  mHeightField->saveCells(samples.data(), count * sizeof(PxHeightFieldSample));
+  std::vector<PxReal> heights;
+  heights.reserve(count);
+  for (auto &s : samples) {
+    heights.push_back(s.height * mHeightScale + mHeightOffset);
+  }
+  return heights;
+}
+
+void SHeightField::generateMesh(PxHeightFieldGeometry const &geometry,
+                                std::vector<PxVec3> &vertices, std::vector<PxVec3> &normals,
+                                std::vector<uint32_t> &indices) {
+  PxHeightField *hf = geometry.heightField;
+  uint32_t rows = hf->getNbRows();
+  uint32_t columns = hf->getNbColumns();
+  std::vector<PxHeightFieldSample> samples(rows * columns);
+  hf->saveCells(samples.data(), samples.size() * sizeof(PxHeightFieldSample));
+
+  vertices.resize(rows * columns);
+  normals.assign(rows * columns, PxVec3(0.f));
+  indices.clear();
+  indices.reserve((rows - 1) * (columns - 1) * 6);
+  for (uint32_t r = 0; r < rows; ++r) {
+    for (uint32_t c = 0; c < columns; ++c) {
+      vertices[r * columns + c] = {r * geometry.rowScale,
+                                   samples[r * columns + c].height * geometry.heightScale,
+                                   c * geometry.columnScale};
+    }
+  }
+
+  auto addTriangle = [&](uint32_t a, uint32_t b, uint32_t c) {
+    indices.insert(indices.end(), {a, b, c});
+    // area weighted smooth normals
+    PxVec3 n = (vertices[b] - vertices[a]).cross(vertices[c] - vertices[a]);
+    normals[a] += n;
+    normals[b] += n;
+    normals[c] += n;
+  };
+  for (uint32_t r = 0; r + 1 < rows; ++r) {
+    for (uint32_t c = 0; c + 1 < columns; ++c) {
+      uint32_t i00 = r * columns + c;
+      uint32_t i01 = i00 + 1;
+      uint32_t i10 = i00 + columns;
+      uint32_t i11 = i10 + 1;
+      if (samples[i00].tessFlag()) {
+        addTriangle(i00, i01, i11);
+        addTriangle(i00, i11, i10);
+      } else {
+        addTriangle(i00, i01, i10);
+        addTriangle(i10, i01, i11);
+      }
+    }
+  }
+  for (auto &n : normals) {
+    n.normalizeSafe();
+  }
+}
+
+} // namespace sapien
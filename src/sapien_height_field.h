@@ -0,0 +1,66 @@
+#pragma once
+#include <PxPhysicsAPI.h>
+#include <memory>
+#include <vector>
+
+namespace sapien {
+
+/** Terrain surface backed by a PxHeightField
+ *
+ *  Samples are row-major with rows along y and columns along x. The origin is at sample (0, 0)
+ *  and heights point along z. Heights are quantized to 16 bits over their [min, max] range.
+ *  Heightfield shapes are only supported on static and kinematic actors.
+ *
+ *  A render mesh matching the collision surface is generated once on creation and shared by
+ *  every visual using this heightfield.
+ */
+class SHeightField {
+  physx::PxHeightField *mHeightField;
+  std::shared_ptr<class Simulation const> mSimulation;
+  physx::PxVec3 mScale;
+  physx::PxReal mHeightScale;
+  physx::PxReal mHeightOffset;
+
+  std::vector<physx::PxVec3> mVertices;
+  std::vector<physx::PxVec3> mNormals;
+  std::vector<uint32_t> mIndices;
+
+public:
+  /* rotation from the PhysX heightfield frame (rows x, heights y, columns z) to z up */
+  static physx::PxQuat const Frame;
+
+  SHeightField(std::shared_ptr<class Simulation const> simulation,
+               physx::PxHeightField *heightField, physx::PxVec3 const &scale,
+               physx::PxReal heightScale, physx::PxReal heightOffset);
+
+  SHeightField(SHeightField const &other) = delete;
+  SHeightField &operator=(SHeightField const &other) = delete;
+  ~SHeightField();
+
+  inline physx::PxHeightField *getPxHeightField() const { return mHeightField; }
+  inline uint32_t getRows() const { return mHeightField->getNbRows(); }
+  inline uint32_t getColumns() const { return mHeightField->getNbColumns(); }
+
+  /* column spacing (x), row spacing (y) and height multiplier (z) */
+  inline physx::PxVec3 getScale() const { return mScale; }
+
+  physx::PxHeightFieldGeometry getGeometry() const;
+
+  /* heights are quantized around this offset, shapes are shifted up by it */
+  inline physx::PxReal getHeightOffset() const { return mHeightOffset; }
+
+  /* dequantized heights, row-major */
+  std::vector<physx::PxReal> getHeights() const;
+
+  /* render mesh in the z-up frame */
+  inline std::vector<physx::PxVec3> const &getVertices() const { return mVertices; }
+  inline std::vector<physx::PxVec3> const &getNormals() const { return mNormals; }
+  inline std::vector<uint32_t> const &getIndices() const { return mIndices; }
+
+  /* triangulate a heightfield geometry in its own frame, following the cell tessellation */
+  static void generateMesh(physx::PxHeightFieldGeometry const &geometry,
+                           std::vector<physx::PxVec3> &vertices,
+                           std::vector<physx::PxVec3> &normals, std::vector<uint32_t> &indices);
+};
+
+} // namespace sapien
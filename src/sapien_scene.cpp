@@ -7,6 +7,7 @@
 #include "articulation/sapien_kinematic_joint.h"
 #include "articulation/sapien_link.h"
 #include "articulation/urdf_loader.h"
+#include "episode_recorder.h"
 #include "renderer/render_interface.h"
 #include "sapien_actor.h"
 #include "sapien_contact.h"
@@ -32,6 +33,8 @@ SScene::SScene(std::shared_ptr<Simulation> sim, PxScene *scene, SceneConfig cons
   mDefaultSleepThreshold = config.sleepThreshold;
   mDefaultSolverIterations = config.solverIterations;
   mDefaultSolverVelocityIterations = config.solverVelocityIterations;
+  mArticulationAggregate = config.enableArticulationAggregate;
+  mActorAggregateShapeCount = config.actorAggregateShapeCount;
 
   mPxScene->setSimulationEventCallback(&mSimulationCallback);
 
@@ -42,6 +45,18 @@ SScene::SScene(std::shared_ptr<Simulation> sim, PxScene *scene, SceneConfig cons
 }
 
 SScene::~SScene() {
+  // pending loads may still schedule tasks, wait for them and fail the tasks they scheduled
+  {
+    std::unique_lock<std::mutex> lock(mBackgroundLock);
+    mBackgroundDone.wait(lock, [this] { return mBackgroundCount == 0; });
+  }
+  for (auto &task : mScheduledTasks) {
+    if (task.cancel) {
+      task.cancel();
+    }
+  }
+  mScheduledTasks.clear();
+
   mDefaultMaterial.reset();
 
   for (auto &actor : mActors) {
@@ -58,8 +73,13 @@ SScene::~SScene() {
   for (auto &drive : mDrives) {
     drive.release();
   }
+  for (auto &[pxAggregate, aggregate] : mAggregates) {
+    pxAggregate->release();
+  }
   mPxScene->release();
 
+  mRecorder.reset();
+
   // TODO: check whether we implement mXXX.release() to replace the workaround
   mActors.clear();
   mArticulations.clear();
@@ -117,25 +137,98 @@ SDrive6D *SScene::createDrive(SActorBase *actor1, PxTransform const &pose1, SAct
   return static_cast<SDrive6D *>(drive);
 }
 
-void SScene::addActor(std::unique_ptr<SActorBase> actor) {
-  mPxScene->addActor(*actor->getPxActor());
+SAggregate *SScene::createAggregate(uint32_t maxActorCount, bool selfCollision) {
+  return createAggregate(maxActorCount, selfCollision, false);
+}
+
+SAggregate *SScene::createAggregate(uint32_t maxActorCount, bool selfCollision,
+                                    bool ownedByMember) {
+  if (maxActorCount > SAggregate::MaxActorCount) {
+    throw std::runtime_error("Failed to create aggregate of size " +
+                             std::to_string(maxActorCount) + ", at most " +
+                             std::to_string(SAggregate::MaxActorCount) + " actors are supported");
+  }
+  auto pxAggregate =
+      mSimulationShared->mPhysicsSDK->createAggregate(maxActorCount, selfCollision);
+  if (!pxAggregate) {
+    throw std::runtime_error("Failed to create aggregate of size " +
+                             std::to_string(maxActorCount));
+  }
+  // members added later enter the scene with the aggregate
+  mPxScene->addAggregate(*pxAggregate);
+  auto &aggregate = mAggregates[pxAggregate];
+  aggregate = std::make_unique<SAggregate>(pxAggregate, ownedByMember);
+  return aggregate.get();
+}
+
+void SScene::addActor(std::unique_ptr<SActorBase> actor, SAggregate *aggregate) {
+  if (!aggregate || !aggregate->getPxAggregate()->addActor(*actor->getPxActor())) {
+    if (aggregate) {
+      spdlog::get("SAPIEN")->error("Aggregate is full, the actor is added without it");
+    }
+    mPxScene->addActor(*actor->getPxActor());
+  }
   mActorId2Actor[actor->getId()] = actor.get();
+  addSegmentationEntries(actor.get(), -1, 0);
+  addEnvironmentMember(actor.get());
   mActors.push_back(std::move(actor));
 }
 
-void SScene::addArticulation(std::unique_ptr<SArticulation> articulation) {
+void SScene::addArticulation(std::unique_ptr<SArticulation> articulation,
+                             SAggregate *aggregate) {
+  physx_id_t articulationId = articulation->getRootLink()->getId();
   for (auto link : articulation->getBaseLinks()) {
     mActorId2Link[link->getId()] = link;
+    addSegmentationEntries(link, link->getIndex(), articulationId);
+  }
+  if (!aggregate ||
+      !aggregate->getPxAggregate()->addArticulation(*articulation->getPxArticulation())) {
+    if (aggregate) {
+      spdlog::get("SAPIEN")->error("Aggregate is full, the articulation is added without it");
+    }
+    mPxScene->addArticulation(*articulation->getPxArticulation());
   }
-  mPxScene->addArticulation(*articulation->getPxArticulation());
+  addEnvironmentMember(articulation.get());
   mArticulations.push_back(std::move(articulation));
 }
 
+void SScene::removePxActor(PxActor &actor) {
+  if (auto aggregate = actor.getAggregate()) {
+    // also removes the actor from the scene
+    aggregate->removeActor(actor);
+    releaseOwnedAggregate(aggregate);
+  } else {
+    mPxScene->removeActor(actor);
+  }
+}
+
+void SScene::removePxArticulation(PxArticulationBase &articulation) {
+  if (auto aggregate = articulation.getAggregate()) {
+    aggregate->removeArticulation(articulation);
+    releaseOwnedAggregate(aggregate);
+  } else {
+    mPxScene->removeArticulation(articulation);
+  }
+}
+
+void SScene::releaseOwnedAggregate(PxAggregate *aggregate) {
+  auto it = mAggregates.find(aggregate);
+  if (it == mAggregates.end() || !it->second->isOwnedByMember() || aggregate->getNbActors()) {
+    return;
+  }
+  mPxScene->removeAggregate(*aggregate);
+  aggregate->release();
+  mAggregates.erase(it);
+}
+
 void SScene::addKinematicArticulation(std::unique_ptr<SKArticulation> articulation) {
+  physx_id_t articulationId = articulation->getRootLink()->getId();
   for (auto link : articulation->getBaseLinks()) {
     mActorId2Link[link->getId()] = link;
+    addSegmentationEntries(link, link->getIndex(), articulationId);
     mPxScene->addActor(*link->getPxActor());
   }
+  addEnvironmentMember(articulation.get());
   mKinematicArticulations.push_back(std::move(articulation));
 }
 
@@ -148,7 +241,7 @@ void SScene::removeCleanUp1() {
     // release actors
     for (auto &a : mActors) {
       if (a->getDestroyedState() == 1) {
-        mPxScene->removeActor(*a->getPxActor());
+        removePxActor(*a->getPxActor());
         a->setDestroyedState(2);
       }
     }
@@ -156,7 +249,7 @@ void SScene::removeCleanUp1() {
     // release articulation
     for (auto &a : mArticulations) {
       if (a->getDestroyedState() == 1) {
-        mPxScene->removeArticulation(*a->getPxArticulation());
+        removePxArticulation(*a->getPxArticulation());
         a->setDestroyedState(2);
       }
     }
@@ -222,6 +315,8 @@ void SScene::removeActor(SActorBase *actor) {
   actor->EventEmitter<EventActorPreDestroy>::emit(e);
 
   mActorId2Actor.erase(actor->getId());
+  removeSegmentationEntries(actor);
+  removeEnvironmentMember(actor);
 
   // remove drives
   for (auto drive : actor->getDrives()) {
@@ -253,6 +348,7 @@ void SScene::removeArticulation(SArticulation *articulation) {
   EventArticulationPreDestroy e;
   e.articulation = articulation;
   articulation->EventEmitter<EventArticulationPreDestroy>::emit(e);
+  removeEnvironmentMember(articulation);
 
   for (auto link : articulation->getBaseLinks()) {
     // predestroy event
@@ -260,6 +356,8 @@ void SScene::removeArticulation(SArticulation *articulation) {
     e.actor = link;
     link->EventEmitter<EventActorPreDestroy>::emit(e);
 
+    removeSegmentationEntries(link);
+
     // remove drives
     for (auto drive : link->getDrives()) {
       removeDrive(drive);
@@ -295,6 +393,7 @@ void SScene::removeKinematicArticulation(SKArticulation *articulation) {
   EventArticulationPreDestroy e;
   e.articulation = articulation;
   articulation->EventEmitter<EventArticulationPreDestroy>::emit(e);
+  removeEnvironmentMember(articulation);
 
   for (auto link : articulation->getBaseLinks()) {
     // predestroy event
@@ -302,6 +401,8 @@ void SScene::removeKinematicArticulation(SKArticulation *articulation) {
     e.actor = link;
     link->EventEmitter<EventActorPreDestroy>::emit(e);
 
+    removeSegmentationEntries(link);
+
     // remove drives
     for (auto drive : link->getDrives()) {
       removeDrive(drive);
@@ -408,9 +509,47 @@ void SScene::removeCamera(SCamera *cam) {
                  mCameras.end());
 }
 
+void SScene::scheduleAtStep(std::function<void()> task, std::function<void()> cancel) {
+  std::lock_guard<std::mutex> lock(mScheduledTasksLock);
+  mScheduledTasks.push_back({std::move(task), std::move(cancel)});
+}
+
+void SScene::runScheduledTasks() {
+  std::vector<ScheduledTask> tasks;
+  {
+    std::lock_guard<std::mutex> lock(mScheduledTasksLock);
+    tasks.swap(mScheduledTasks);
+  }
+  for (auto &task : tasks) {
+    task.run();
+  }
+}
+
+void SScene::runInBackground(std::function<void()> work) {
+  {
+    std::lock_guard<std::mutex> lock(mBackgroundLock);
+    mBackgroundCount++;
+  }
+  mSimulationShared->getThreadPool().submit([this, work = std::move(work)]() mutable {
+    try {
+      work();
+    } catch (...) {
+      spdlog::get("SAPIEN")->error("Uncaught exception in background scene work");
+    }
+    // release captured state before the scene can be destroyed
+    work = nullptr;
+    std::lock_guard<std::mutex> lock(mBackgroundLock);
+    if (--mBackgroundCount == 0) {
+      mBackgroundDone.notify_all();
+    }
+  });
+}
+
 void SScene::step() {
   EASY_BLOCK("Pre-step processing", profiler::colors::Blue);
 
+  runScheduledTasks();
+
   for (auto &a : mActors) {
     if (!a->isBeingDestroyed())
       a->prestep();
@@ -423,6 +562,9 @@ void SScene::step() {
     if (!a->isBeingDestroyed())
       a->prestep();
   }
+  for (auto &d : mDrives) {
+    d->prestep();
+  }
 
   // confirm removal of marked objects
   removeCleanUp1();
@@ -448,6 +590,7 @@ void SScene::step() {
 }
 
 void SScene::stepAsync() {
+  runScheduledTasks();
   for (auto &a : mActors) {
     if (!a->isBeingDestroyed())
       a->prestep();
@@ -460,6 +603,9 @@ void SScene::stepAsync() {
     if (!a->isBeingDestroyed())
       a->prestep();
   }
+  for (auto &d : mDrives) {
+    d->prestep();
+  }
   removeCleanUp1();
   mPxScene->simulate(mTimestep);
 }
@@ -476,6 +622,17 @@ void SScene::stepWait() {
   emit(event);
 }
 
+void SScene::updateArticulationLinkPoses() {
+  for (auto &a : mArticulations) {
+    if (!a->isBeingDestroyed())
+      a->updateLinkPoses();
+  }
+  for (auto &a : mKinematicArticulations) {
+    if (!a->isBeingDestroyed())
+      a->updateLinkPoses();
+  }
+}
+
 void SScene::updateRender() {
   EASY_FUNCTION("Update Render", profiler::colors::Magenta);
 
@@ -492,7 +649,7 @@ void SScene::updateRender() {
   for (auto &articulation : mArticulations) {
     for (auto &link : articulation->getBaseLinks()) {
       if (!articulation->isBeingDestroyed()) {
-        link->updateRender(link->getPxActor()->getGlobalPose());
+        link->updateRender(link->getPose());
       }
     }
   }
@@ -509,9 +666,52 @@ void SScene::updateRender() {
     cam->update();
   }
 
+  if (mRecorder) {
+    EpisodeFrame frame;
+    auto addObject = [&](SActorBase *actor) {
+      frame.ids.push_back(actor->getId());
+      frame.poses.push_back(actor->getPose());
+      frame.visibility.push_back(actor->isHidingVisual() ? 0.f : actor->getDisplayVisibility());
+    };
+    for (auto &actor : mActors) {
+      if (!actor->isBeingDestroyed()) {
+        addObject(actor.get());
+      }
+    }
+    for (auto &articulation : mArticulations) {
+      if (!articulation->isBeingDestroyed()) {
+        for (auto &link : articulation->getBaseLinks()) {
+          addObject(link);
+        }
+      }
+    }
+    for (auto &articulation : mKinematicArticulations) {
+      if (!articulation->isBeingDestroyed()) {
+        for (auto &link : articulation->getBaseLinks()) {
+          addObject(link);
+        }
+      }
+    }
+    for (auto &cam : mCameras) {
+      frame.cameraPoses.push_back(cam->getRendererCamera()->getPose());
+    }
+    mRecorder->record(frame);
+  }
+
   getRendererScene()->updateRender();
 }
 
+void SScene::startRecording(std::string const &filename, float positionPrecision,
+                            uint32_t chunkSize) {
+  if (!mRendererScene) {
+    throw std::runtime_error("failed to start recording: renderer is not added");
+  }
+  mRecorder.reset();
+  mRecorder = std::make_unique<EpisodeRecorder>(filename, positionPrecision, chunkSize);
+}
+
+void SScene::stopRecording() { mRecorder.reset(); }
+
 SActorStatic *SScene::addGround(PxReal altitude, bool render,
                                 std::shared_ptr<SPhysicalMaterial> material,
                                 std::shared_ptr<Renderer::IPxrMaterial> renderMaterial) {
@@ -576,26 +776,83 @@ std::vector<SLight *> SScene::getAllLights() const {
 
 std::map<physx_id_t, std::string> SScene::findRenderId2VisualName() const {
   std::map<physx_id_t, std::string> result;
-  for (auto &actor : mActors) {
-    for (auto &v : actor->getRenderBodies()) {
-      result[v->getUniqueId()] = v->getName();
+  for (physx_id_t id = 0; id < mVisualActorIds.size(); ++id) {
+    if (mVisualActorIds[id]) {
+      result[id] = mVisualNames[id];
     }
   }
-  for (auto &articulation : mArticulations) {
-    for (auto &actor : articulation->getBaseLinks()) {
-      for (auto &v : actor->getRenderBodies()) {
-        result[v->getUniqueId()] = v->getName();
-      }
+  for (auto &[id, entry] : mSparseVisualEntries) {
+    result[id] = entry.name;
+  }
+  return result;
+}
+
+/** set table[id], filling new entries with empty */
+template <typename T>
+static void setTableEntry(std::vector<T> &table, physx_id_t id, T const &value, T const &empty) {
+  if (id >= table.size()) {
+    table.resize(id + 1, empty);
+  }
+  table[id] = value;
+}
+
+void SScene::setVisualEntry(physx_id_t visualId, physx_id_t actorId, std::string const &name) {
+  if (visualId >= mVisualActorIds.size() && visualId < mRenderIdGenerator.peek()) {
+    physx_id_t size = mRenderIdGenerator.peek();
+    mVisualActorIds.resize(size, 0);
+    mVisualNames.resize(size);
+    // hand-set ids the generated ones have caught up with
+    for (auto it = mSparseVisualEntries.begin();
+         it != mSparseVisualEntries.end() && it->first < size;) {
+      mVisualActorIds[it->first] = it->second.actorId;
+      mVisualNames[it->first] = std::move(it->second.name);
+      it = mSparseVisualEntries.erase(it);
     }
   }
-  for (auto &articulation : mKinematicArticulations) {
-    for (auto &actor : articulation->getBaseLinks()) {
-      for (auto &v : actor->getRenderBodies()) {
-        result[v->getUniqueId()] = v->getName();
-      }
+  if (visualId < mVisualActorIds.size()) {
+    mVisualActorIds[visualId] = actorId;
+    mVisualNames[visualId] = name;
+  } else {
+    mSparseVisualEntries[visualId] = {actorId, name};
+  }
+}
+
+void SScene::clearVisualEntry(physx_id_t visualId, physx_id_t actorId) {
+  // another body may have taken the id since
+  if (visualId < mVisualActorIds.size()) {
+    if (mVisualActorIds[visualId] == actorId) {
+      mVisualActorIds[visualId] = 0;
+      mVisualNames[visualId].clear();
     }
+  } else if (auto it = mSparseVisualEntries.find(visualId);
+             it != mSparseVisualEntries.end() && it->second.actorId == actorId) {
+    mSparseVisualEntries.erase(it);
+  }
+}
+
+void SScene::addSegmentationEntries(SActorBase *actor, int32_t linkIndex,
+                                    physx_id_t articulationId) {
+  setTableEntry(mActorLinkIndices, actor->getId(), linkIndex, -1);
+  setTableEntry(mActorArticulationIds, actor->getId(), articulationId, physx_id_t(0));
+  physx_id_t actorId = actor->getId();
+  for (auto body : actor->getRenderBodies()) {
+    setVisualEntry(body->getUniqueId(), actorId, body->getName());
+    body->setChangeCallback([this, actorId](Renderer::IPxrRigidbody *body, uint32_t previousId) {
+      clearVisualEntry(previousId, actorId);
+      setVisualEntry(body->getUniqueId(), actorId, body->getName());
+    });
+  }
+}
+
+void SScene::removeSegmentationEntries(SActorBase *actor) {
+  if (actor->getId() < mActorLinkIndices.size()) {
+    mActorLinkIndices[actor->getId()] = -1;
+    mActorArticulationIds[actor->getId()] = 0;
+  }
+  for (auto body : actor->getRenderBodies()) {
+    body->setChangeCallback({});
+    clearVisualEntry(body->getUniqueId(), actor->getId());
   }
-  return result;
 }
 
 SceneData SScene::packScene() {
@@ -646,6 +903,198 @@ void SScene::unpackScene(SceneData const &data) {
   }
 }
 
+uint32_t SScene::addEnvironment(PxVec3 const &offset) {
+  if (mEnvironments.size() >= 0xffff) {
+    throw std::runtime_error("failed to add environment: at most 65535 environments per scene");
+  }
+  mEnvironments.push_back({offset, {}, {}, {}});
+  return mEnvironments.size() - 1;
+}
+
+PxVec3 SScene::getEnvironmentOffset(int environment) const {
+  if (environment < 0) {
+    return {0, 0, 0};
+  }
+  if (static_cast<uint32_t>(environment) >= mEnvironments.size()) {
+    throw std::runtime_error("invalid environment " + std::to_string(environment));
+  }
+  return mEnvironments[environment].offset;
+}
+
+std::vector<SActorBase *> SScene::getEnvironmentActors(int environment) const {
+  if (environment >= 0) {
+    getEnvironmentOffset(environment); // validate
+    return mEnvironments[environment].actors;
+  }
+  // shared objects are not tracked, they are rarely queried
+  std::vector<SActorBase *> result;
+  for (auto &actor : mActors) {
+    if (!actor->isBeingDestroyed() && actor->getEnvironment() < 0) {
+      result.push_back(actor.get());
+    }
+  }
+  return result;
+}
+
+std::vector<SArticulationBase *> SScene::getEnvironmentArticulations(int environment) const {
+  if (environment >= 0) {
+    getEnvironmentOffset(environment); // validate
+    return mEnvironments[environment].articulations;
+  }
+  std::vector<SArticulationBase *> result;
+  for (auto &articulation : mArticulations) {
+    if (!articulation->isBeingDestroyed() && articulation->getRootLink()->getEnvironment() < 0) {
+      result.push_back(articulation.get());
+    }
+  }
+  for (auto &articulation : mKinematicArticulations) {
+    if (!articulation->isBeingDestroyed() && articulation->getRootLink()->getEnvironment() < 0) {
+      result.push_back(articulation.get());
+    }
+  }
+  return result;
+}
+
+void SScene::addEnvironmentMember(SActorBase *actor) {
+  if (actor->getEnvironment() >= 0) {
+    mEnvironments.at(actor->getEnvironment()).actors.push_back(actor);
+  }
+}
+
+void SScene::addEnvironmentMember(SArticulationBase *articulation) {
+  int environment = articulation->getRootLink()->getEnvironment();
+  if (environment >= 0) {
+    mEnvironments.at(environment).articulations.push_back(articulation);
+  }
+}
+
+void SScene::removeEnvironmentMember(SActorBase *actor) {
+  if (actor->getEnvironment() >= 0) {
+    auto &actors = mEnvironments[actor->getEnvironment()].actors;
+    actors.erase(std::remove(actors.begin(), actors.end(), actor), actors.end());
+  }
+}
+
+void SScene::removeEnvironmentMember(SArticulationBase *articulation) {
+  int environment = articulation->getRootLink()->getEnvironment();
+  if (environment >= 0) {
+    auto &articulations = mEnvironments[environment].articulations;
+    articulations.erase(std::remove(articulations.begin(), articulations.end(), articulation),
+                        articulations.end());
+  }
+}
+
+SceneData SScene::packEnvironment(uint32_t environment) {
+  PxVec3 offset = getEnvironmentOffset(environment);
+  SceneData data;
+
+  // objects are keyed by their order in the environment instead of their ids
+  physx_id_t actorIndex = 0;
+  for (auto actor : getEnvironmentActors(environment)) {
+    auto actorData = actor->packData();
+    if (actorData.size() >= 3) {
+      actorData[0] -= offset.x;
+      actorData[1] -= offset.y;
+      actorData[2] -= offset.z;
+    }
+    data.mActorData[actorIndex++] = std::move(actorData);
+  }
+
+  physx_id_t index = 0;
+  for (auto base : getEnvironmentArticulations(environment)) {
+    if (base->getType() == EArticulationType::KINEMATIC) {
+      // joint state followed by the root pose
+      auto articulationData = static_cast<SKArticulation *>(base)->packData();
+      auto root = articulationData.size() - 7;
+      articulationData[root] -= offset.x;
+      articulationData[root + 1] -= offset.y;
+      articulationData[root + 2] -= offset.z;
+      data.mArticulationData[index++] = std::move(articulationData);
+      continue;
+    }
+    auto articulation = static_cast<SArticulation *>(base);
+    auto articulationData = articulation->packData();
+    // root pose followed by root velocities and accelerations
+    auto root = articulationData.size() - 19;
+    articulationData[root] -= offset.x;
+    articulationData[root + 1] -= offset.y;
+    articulationData[root + 2] -= offset.z;
+    data.mArticulationData[index] = std::move(articulationData);
+    data.mArticulationDriveData[index++] = articulation->packDrive();
+  }
+  return data;
+}
+
+void SScene::unpackEnvironment(uint32_t environment, SceneData const &data) {
+  PxVec3 offset = getEnvironmentOffset(environment);
+
+  physx_id_t actorIndex = 0;
+  for (auto actor : getEnvironmentActors(environment)) {
+    auto it = data.mActorData.find(actorIndex++);
+    if (it != data.mActorData.end()) {
+      auto actorData = it->second;
+      if (actorData.size() >= 3) {
+        actorData[0] += offset.x;
+        actorData[1] += offset.y;
+        actorData[2] += offset.z;
+      }
+      actor->unpackData(actorData);
+    }
+  }
+
+  physx_id_t index = 0;
+  for (auto base : getEnvironmentArticulations(environment)) {
+    if (base->getType() == EArticulationType::KINEMATIC) {
+      auto it = data.mArticulationData.find(index++);
+      if (it != data.mArticulationData.end() && it->second.size() >= 7) {
+        auto articulationData = it->second;
+        auto root = articulationData.size() - 7;
+        articulationData[root] += offset.x;
+        articulationData[root + 1] += offset.y;
+        articulationData[root + 2] += offset.z;
+        static_cast<SKArticulation *>(base)->unpackData(articulationData);
+      }
+      continue;
+    }
+    auto articulation = static_cast<SArticulation *>(base);
+    {
+      auto it = data.mArticulationData.find(index);
+      if (it != data.mArticulationData.end() && it->second.size() >= 19) {
+        auto articulationData = it->second;
+        auto root = articulationData.size() - 19;
+        articulationData[root] += offset.x;
+        articulationData[root + 1] += offset.y;
+        articulationData[root + 2] += offset.z;
+        articulation->unpackData(articulationData);
+      }
+    }
+    {
+      auto it = data.mArticulationDriveData.find(index);
+      if (it != data.mArticulationDriveData.end()) {
+        articulation->unpackDrive(it->second);
+      }
+    }
+    index++;
+  }
+}
+
+void SScene::saveEnvironmentState(uint32_t environment) {
+  auto data = packEnvironment(environment);
+  mEnvironments[environment].savedState = std::move(data);
+}
+
+void SScene::resetEnvironment(uint32_t environment) {
+  if (environment >= mEnvironments.size()) {
+    throw std::runtime_error("invalid environment " + std::to_string(environment));
+  }
+  auto &state = mEnvironments[environment].savedState;
+  if (!state) {
+    throw std::runtime_error("failed to reset environment " + std::to_string(environment) +
+                             ": no state saved");
+  }
+  unpackEnvironment(environment, *state);
+}
+
 void SScene::setAmbientLight(PxVec3 const &color) {
   mRendererScene->setAmbientLight({color.x, color.y, color.z});
 }
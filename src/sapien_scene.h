@@ -13,10 +13,15 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include <PxPhysicsAPI.h>
@@ -24,6 +29,7 @@
 #include "event_system/event_system.h"
 #include "id_generator.h"
 #include "renderer/render_interface.h"
+#include "sapien_aggregate.h"
 #include "sapien_camera.h"
 #include "sapien_light.h"
 #include "sapien_material.h"
@@ -45,6 +51,7 @@ class ArticulationBuilder;
 class SDrive6D;
 class SDrive;
 struct SContact;
+class EpisodeRecorder;
 
 namespace Renderer {
 class IPxrScene;
@@ -120,10 +127,39 @@ public:
   void stepAsync();
   void stepWait();
 
+  /** update link poses of all articulations from their current qpos without stepping */
+  void updateArticulationLinkPoses();
+
+  /** run a task on the simulation thread at the start of the next step
+   *
+   *  Thread safe. Used by asynchronous loading to insert objects into the PhysX scene only
+   *  between steps. If the scene is destroyed before the next step, cancel is called instead.
+   */
+  void scheduleAtStep(std::function<void()> task, std::function<void()> cancel = {});
+
+  /** run work on the simulation thread pool
+   *
+   *  The scene waits for pending work when it is destroyed, so the work may use the scene and
+   *  call scheduleAtStep.
+   */
+  void runInBackground(std::function<void()> work);
+
 private:
   PxReal mTimestep = 1 / 500.f;
   std::string mName;
 
+  struct ScheduledTask {
+    std::function<void()> run;
+    std::function<void()> cancel;
+  };
+  std::mutex mScheduledTasksLock;
+  std::vector<ScheduledTask> mScheduledTasks;
+  void runScheduledTasks();
+
+  std::mutex mBackgroundLock;
+  std::condition_variable mBackgroundDone;
+  uint32_t mBackgroundCount{0};
+
   /************************************************
    * Physical Objects
    ***********************************************/
@@ -155,6 +191,14 @@ public:
    */
   void removeKinematicArticulation(SKArticulation *articulation);
 
+  /** Create a broadphase group for actors and articulations built with it
+   *
+   *  Articulations are already placed in their own aggregate unless disabled in the
+   *  SceneConfig, so this is for grouping several objects, e.g. a robot and what it carries.
+   *  Aggregates live as long as the scene and hold at most SAggregate::MaxActorCount actors.
+   */
+  SAggregate *createAggregate(uint32_t maxActorCount, bool selfCollision);
+
   SDrive6D *createDrive(SActorBase *actor1, PxTransform const &pose1, SActorBase *actor2,
                         PxTransform const &pose2);
   /** Remove a drive immediately */
@@ -165,9 +209,10 @@ public:
   inline physx_id_t generateUniqueRenderId() { return mRenderIdGenerator.next(); };
 
 private:
-  void addActor(std::unique_ptr<SActorBase> actor); // called by actor builder
-  void
-  addArticulation(std::unique_ptr<SArticulation> articulation); // called by articulation builder
+  // called by builders, objects with an aggregate enter the scene through it
+  void addActor(std::unique_ptr<SActorBase> actor, SAggregate *aggregate = nullptr);
+  void addArticulation(std::unique_ptr<SArticulation> articulation,
+                       SAggregate *aggregate = nullptr);
   void addKinematicArticulation(
       std::unique_ptr<SKArticulation> articulation); // called by articulation builder
 
@@ -181,6 +226,16 @@ private:
   void removeCleanUp1();
   void removeCleanUp2();
 
+  // aggregates created for a single actor or articulation by its builder
+  SAggregate *createAggregate(uint32_t maxActorCount, bool selfCollision, bool ownedByMember);
+  void removePxActor(PxActor &actor);
+  void removePxArticulation(PxArticulationBase &articulation);
+  void releaseOwnedAggregate(PxAggregate *aggregate);
+
+  bool mArticulationAggregate;
+  uint32_t mActorAggregateShapeCount;
+  std::unordered_map<PxAggregate *, std::unique_ptr<SAggregate>> mAggregates;
+
   IDGenerator mActorIdGenerator;  // unique id generator for actors (including links)
   IDGenerator mRenderIdGenerator; //  unique id generator for visuals
 
@@ -195,6 +250,53 @@ private:
 
   std::vector<std::unique_ptr<SDrive>> mDrives;
 
+  /************************************************
+   * Environments
+   ***********************************************/
+public:
+  /** Add an environment slot hosted by this scene and return its index
+   *
+   *  Objects built into an environment start at its offset and only collide with objects of
+   *  the same environment and with shared objects (environment -1, e.g. the ground). Poses are
+   *  still given in the scene frame.
+   */
+  uint32_t addEnvironment(PxVec3 const &offset);
+  inline uint32_t getEnvironmentCount() const { return mEnvironments.size(); }
+
+  /** offset of an environment, zero for the shared environment -1 */
+  PxVec3 getEnvironmentOffset(int environment) const;
+
+  std::vector<SActorBase *> getEnvironmentActors(int environment) const;
+  std::vector<SArticulationBase *> getEnvironmentArticulations(int environment) const;
+
+  /** Pack the state of one environment
+   *
+   *  Poses are relative to the environment offset and objects are keyed by build order within
+   *  the environment, so the data can be unpacked into any environment built the same way.
+   *  Kinematic articulations are stored as joint state and root pose.
+   */
+  SceneData packEnvironment(uint32_t environment);
+  void unpackEnvironment(uint32_t environment, SceneData const &data);
+
+  /** remember the current state as the one restored by resetEnvironment */
+  void saveEnvironmentState(uint32_t environment);
+  void resetEnvironment(uint32_t environment);
+
+private:
+  struct Environment {
+    PxVec3 offset;
+    std::optional<SceneData> savedState;
+    // members in build order, removed objects are dropped when removal starts
+    std::vector<SActorBase *> actors;
+    std::vector<SArticulationBase *> articulations;
+  };
+  std::vector<Environment> mEnvironments;
+
+  void addEnvironmentMember(SActorBase *actor);
+  void addEnvironmentMember(SArticulationBase *articulation);
+  void removeEnvironmentMember(SActorBase *actor);
+  void removeEnvironmentMember(SArticulationBase *articulation);
+
   /************************************************
    * Sensor
    ***********************************************/
@@ -244,6 +346,7 @@ public:
                           std::shared_ptr<SPhysicalMaterial> material = nullptr,
                           std::shared_ptr<Renderer::IPxrMaterial> renderMaterial = nullptr);
 
+  /** visual id to name, built from the segmentation tables */
   std::map<physx_id_t, std::string> findRenderId2VisualName() const;
 
 private:
@@ -251,6 +354,65 @@ private:
 
   std::vector<std::unique_ptr<SCamera>> mCameras;
 
+  /************************************************
+   * Segmentation
+   ***********************************************/
+public:
+  /** Lookup tables indexed by the ids of segmentation images
+   *
+   *  Visual ids (channel 0) map to the id of their actor or link and to their name; actor ids
+   *  (channel 1) map to the link index and the articulation, identified by the id of its root
+   *  link. A segmentation image is remapped with a single gather. Unused ids map to 0, -1 for
+   *  link indices of actors that are not links, and an empty name.
+   *
+   *  The tables are kept as objects are added and removed and as render bodies change their
+   *  visual id or name. They grow with the ids handed out and do not shrink when objects are
+   *  removed. Visual ids set by hand at or past the next generated id are kept in a map
+   *  instead, so a large id does not grow the visual tables; they are missing from
+   *  getVisualActorIds and getVisualNames until the generated ids reach them.
+   */
+  inline std::vector<physx_id_t> const &getVisualActorIds() const { return mVisualActorIds; }
+  inline std::vector<std::string> const &getVisualNames() const { return mVisualNames; }
+  inline std::vector<int32_t> const &getActorLinkIndices() const { return mActorLinkIndices; }
+  inline std::vector<physx_id_t> const &getActorArticulationIds() const {
+    return mActorArticulationIds;
+  }
+
+private:
+  void addSegmentationEntries(SActorBase *actor, int32_t linkIndex, physx_id_t articulationId);
+  void removeSegmentationEntries(SActorBase *actor);
+  void setVisualEntry(physx_id_t visualId, physx_id_t actorId, std::string const &name);
+  /** clears the entry only if it still belongs to the actor */
+  void clearVisualEntry(physx_id_t visualId, physx_id_t actorId);
+
+  struct VisualEntry {
+    physx_id_t actorId;
+    std::string name;
+  };
+  std::vector<physx_id_t> mVisualActorIds;
+  std::vector<std::string> mVisualNames;
+  std::map<physx_id_t, VisualEntry> mSparseVisualEntries;
+  std::vector<int32_t> mActorLinkIndices;
+  std::vector<physx_id_t> mActorArticulationIds;
+
+  /************************************************
+   * Recording
+   ***********************************************/
+public:
+  /** Record actor and link poses, visibility and camera poses at every updateRender
+   *
+   *  See EpisodeRecorder for the file format. Render bodies carry their actor or link id as
+   *  segmentation id, which EpisodeReplayer uses to drive them.
+   */
+  void startRecording(std::string const &filename, float positionPrecision = 1e-4f,
+                      uint32_t chunkSize = 256);
+  /** finish the episode file, blocks until it is written */
+  void stopRecording();
+  inline bool isRecording() const { return mRecorder != nullptr; }
+
+private:
+  std::unique_ptr<EpisodeRecorder> mRecorder;
+
   /************************************************
    * Contact
    ***********************************************/
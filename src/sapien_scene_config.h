@@ -20,5 +20,7 @@ struct SceneConfig {
   bool enableFrictionEveryIteration =
       true;                         // better friction calculation, recommended for robotics
   bool enableAdaptiveForce = false; // improve solver convergence
+  bool enableArticulationAggregate = true; // one broadphase entry per articulation
+  uint32_t actorAggregateShapeCount = 0;   // aggregate actors with >= this many shapes, 0: off
 };
 } // namespace sapien
@@ -1,4 +1,5 @@
 #include "sapien_shape.h"
+#include "filter_shader.h"
 #include "sapien_material.h"
 #include <array>
 #include <stdexcept>
@@ -18,7 +19,20 @@ SCollisionShape::~SCollisionShape() { mPxShape->release(); }
 
 void SCollisionShape::setCollisionGroups(uint32_t group0, uint32_t group1, uint32_t group2,
                                          uint32_t group3) {
-  mPxShape->setSimulationFilterData(PxFilterData(group0, group1, group2, group3));
+  if (group3 > 0xffff) {
+    throw std::invalid_argument("collision group 3 must not exceed 0xffff, the high 16 bits "
+                                "hold the environment");
+  }
+  // the high 16 bits of group 3 hold the environment and are kept
+  uint32_t environment = mPxShape->getSimulationFilterData().word3 & 0xffff0000;
+  mPxShape->setSimulationFilterData(
+      PxFilterData(group0, group1, group2, group3 | environment));
+}
+
+void SCollisionShape::setEnvironment(int environment) {
+  auto data = mPxShape->getSimulationFilterData();
+  data.word3 = (data.word3 & 0xffff) | environmentFilterBits(environment);
+  mPxShape->setSimulationFilterData(data);
 }
 
 std::array<uint32_t, 4> SCollisionShape::getCollisionGroups() const {
@@ -85,6 +99,8 @@ std::string SCollisionShape::getType() const {
     return "convex_mesh";
   case PxGeometryType::eTRIANGLEMESH:
     return "nonconvex_mesh";
+  case PxGeometryType::eHEIGHTFIELD:
+    return "height_field";
   default:
     throw std::runtime_error("unsupported shape type");
   }
@@ -185,6 +201,23 @@ std::unique_ptr<SGeometry> SCollisionShape::getGeometry() const {
     }
     return sg;
   }
+  case PxGeometryType::eHEIGHTFIELD: {
+    PxHeightFieldGeometry g;
+    mPxShape->getHeightFieldGeometry(g);
+    auto sg = std::make_unique<SHeightFieldGeometry>();
+    sg->rows = g.heightField->getNbRows();
+    sg->columns = g.heightField->getNbColumns();
+    sg->rowScale = g.rowScale;
+    sg->columnScale = g.columnScale;
+
+    std::vector<PxHeightFieldSample> samples(sg->rows * sg->columns);
+    g.heightField->saveCells(samples.data(), samples.size() * sizeof(PxHeightFieldSample));
+    sg->heights.reserve(samples.size());
+    for (auto &sample : samples) {
+      sg->heights.push_back(sample.height * g.heightScale);
+    }
+    return sg;
+  }
 
   default:
     throw std::runtime_error("unsupported shape type");
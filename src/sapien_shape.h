@@ -45,6 +45,16 @@ struct SNonconvexMeshGeometry : public SGeometry {
   inline virtual std::string getType() const { return "nonconvex_mesh"; };
 };
 
+/* samples in the PhysX heightfield frame: rows along x, heights along y, columns along z */
+struct SHeightFieldGeometry : public SGeometry {
+  uint32_t rows;
+  uint32_t columns;
+  physx::PxReal rowScale;
+  physx::PxReal columnScale;
+  std::vector<physx::PxReal> heights;
+  inline virtual std::string getType() const { return "height_field"; };
+};
+
 struct SPlaneGeometry : public SGeometry {
   inline virtual std::string getType() const { return "plane"; };
 };
@@ -61,9 +71,13 @@ public:
 
   SActorBase *getActor() const;
 
+  /* only the low 16 bits of group3 are set, the high bits hold the environment */
   void setCollisionGroups(uint32_t group0, uint32_t group1, uint32_t group2, uint32_t group3);
   std::array<uint32_t, 4> getCollisionGroups() const;
 
+  /* environment slot of the scene, -1 for shapes shared by all environments */
+  void setEnvironment(int environment);
+
   void setRestOffset(physx::PxReal offset);
   physx::PxReal getRestOffset() const;
 
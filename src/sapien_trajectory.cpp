@@ -0,0 +1,254 @@
+#include "sapien_trajectory.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace sapien {
+
+STrajectory::STrajectory(uint32_t dim) : mDim(dim) {}
+
+void STrajectory::setWaypoints(std::vector<PxReal> const &times,
+                               std::vector<PxReal> const &positions,
+                               std::vector<PxReal> const &velocities,
+                               Interpolation interpolation) {
+  clear();
+  mInterpolation = interpolation;
+  addWaypoints(times, positions, velocities);
+}
+
+void STrajectory::appendWaypoints(std::vector<PxReal> const &times,
+                                  std::vector<PxReal> const &positions,
+                                  std::vector<PxReal> const &velocities) {
+  // re-estimating the velocities of the executing segment would make the target jump
+  uint32_t executed = getExecutedCount();
+  for (uint32_t i = 0; i < executed; ++i) {
+    mVelocityFixed[i] = true;
+  }
+  addWaypoints(times, positions, velocities);
+}
+
+uint32_t STrajectory::getExecutedCount() const {
+  uint32_t next = std::upper_bound(mTimes.begin(), mTimes.end(), mTime) - mTimes.begin();
+  return std::min<uint32_t>(next + 1, mTimes.size());
+}
+
+void STrajectory::clear() {
+  mTimes.clear();
+  mPositions.clear();
+  mVelocities.clear();
+  mVelocityFixed.clear();
+  mTime = 0;
+  mCompleted = false;
+}
+
+void STrajectory::addWaypoints(std::vector<PxReal> const &times,
+                               std::vector<PxReal> const &positions,
+                               std::vector<PxReal> const &velocities) {
+  if (positions.size() != times.size() * mDim) {
+    throw std::runtime_error("Trajectory positions do not match waypoint count and dimension");
+  }
+  if (!velocities.empty() && velocities.size() != positions.size()) {
+    throw std::runtime_error("Trajectory velocities must have the same size as positions");
+  }
+  PxReal last = mTimes.empty() ? -PX_MAX_F32 : mTimes.back();
+  for (PxReal t : times) {
+    if (t <= last) {
+      throw std::runtime_error("Trajectory waypoint times must be strictly increasing");
+    }
+    last = t;
+  }
+
+  mTimes.insert(mTimes.end(), times.begin(), times.end());
+  mPositions.insert(mPositions.end(), positions.begin(), positions.end());
+  if (velocities.empty()) {
+    mVelocities.insert(mVelocities.end(), positions.size(), 0.f);
+    mVelocityFixed.insert(mVelocityFixed.end(), times.size(), false);
+  } else {
+    mVelocities.insert(mVelocities.end(), velocities.begin(), velocities.end());
+    mVelocityFixed.insert(mVelocityFixed.end(), times.size(), true);
+  }
+  mCompleted = false;
+  estimateVelocities();
+}
+
+void STrajectory::estimateVelocities() {
+  uint32_t n = mTimes.size();
+  for (uint32_t i = 0; i < n; ++i) {
+    if (mVelocityFixed[i]) {
+      continue;
+    }
+    for (uint32_t d = 0; d < mDim; ++d) {
+      if (i == 0 || i == n - 1) {
+        mVelocities[i * mDim + d] = 0.f;
+      } else {
+        mVelocities[i * mDim + d] =
+            (mPositions[(i + 1) * mDim + d] - mPositions[(i - 1) * mDim + d]) /
+            (mTimes[i + 1] - mTimes[i - 1]);
+      }
+    }
+  }
+}
+
+bool STrajectory::locate(uint32_t &segment, PxReal &u) const {
+  if (mTimes.size() < 2 || mTime <= mTimes.front() || mTime >= mTimes.back()) {
+    return false;
+  }
+  segment = std::upper_bound(mTimes.begin(), mTimes.end(), mTime) - mTimes.begin() - 1;
+  u = (mTime - mTimes[segment]) / (mTimes[segment + 1] - mTimes[segment]);
+  return true;
+}
+
+void STrajectory::evaluate(PxReal *position, PxReal *velocity) const {
+  if (mTimes.empty()) {
+    return;
+  }
+  uint32_t i;
+  PxReal u;
+  if (!locate(i, u)) {
+    uint32_t w = mTime <= mTimes.front() ? 0 : mTimes.size() - 1;
+    for (uint32_t d = 0; d < mDim; ++d) {
+      position[d] = mPositions[w * mDim + d];
+      velocity[d] = 0.f;
+    }
+    return;
+  }
+  interpolate(mInterpolation, mDim, u, mTimes[i + 1] - mTimes[i], &mPositions[i * mDim],
+              &mVelocities[i * mDim], &mPositions[(i + 1) * mDim],
+              &mVelocities[(i + 1) * mDim], position, velocity);
+}
+
+void STrajectory::interpolate(Interpolation interpolation, uint32_t dim, PxReal u, PxReal h,
+                              PxReal const *p0, PxReal const *v0, PxReal const *p1,
+                              PxReal const *v1, PxReal *position, PxReal *velocity) {
+  switch (interpolation) {
+  case Interpolation::eLINEAR:
+    for (uint32_t d = 0; d < dim; ++d) {
+      position[d] = p0[d] + u * (p1[d] - p0[d]);
+      velocity[d] = (p1[d] - p0[d]) / h;
+    }
+    return;
+  case Interpolation::eCUBIC: {
+    // cubic Hermite
+    PxReal u2 = u * u, u3 = u2 * u;
+    PxReal h00 = 2 * u3 - 3 * u2 + 1, h10 = u3 - 2 * u2 + u;
+    PxReal h01 = -2 * u3 + 3 * u2, h11 = u3 - u2;
+    PxReal d00 = 6 * u2 - 6 * u, d10 = 3 * u2 - 4 * u + 1;
+    PxReal d01 = -6 * u2 + 6 * u, d11 = 3 * u2 - 2 * u;
+    for (uint32_t d = 0; d < dim; ++d) {
+      position[d] = h00 * p0[d] + h10 * h * v0[d] + h01 * p1[d] + h11 * h * v1[d];
+      velocity[d] = (d00 * p0[d] + d01 * p1[d]) / h + d10 * v0[d] + d11 * v1[d];
+    }
+    return;
+  }
+  case Interpolation::eQUINTIC: {
+    // quintic Hermite with zero waypoint accelerations
+    PxReal u2 = u * u, u3 = u2 * u, u4 = u3 * u, u5 = u4 * u;
+    PxReal h0 = 1 - 10 * u3 + 15 * u4 - 6 * u5, h1 = u - 6 * u3 + 8 * u4 - 3 * u5;
+    PxReal h4 = -4 * u3 + 7 * u4 - 3 * u5, h5 = 10 * u3 - 15 * u4 + 6 * u5;
+    PxReal d0 = -30 * u2 + 60 * u3 - 30 * u4, d1 = 1 - 18 * u2 + 32 * u3 - 15 * u4;
+    PxReal d4 = -12 * u2 + 28 * u3 - 15 * u4, d5 = 30 * u2 - 60 * u3 + 30 * u4;
+    for (uint32_t d = 0; d < dim; ++d) {
+      position[d] = h0 * p0[d] + h1 * h * v0[d] + h4 * h * v1[d] + h5 * p1[d];
+      velocity[d] = (d0 * p0[d] + d5 * p1[d]) / h + d1 * v0[d] + d4 * v1[d];
+    }
+    return;
+  }
+  }
+}
+
+/* rotation vector of q1 * q0^-1 along the shortest arc */
+static PxVec3 rotationVector(PxQuat const &q0, PxQuat const &q1) {
+  PxQuat dq = q1 * q0.getConjugate();
+  if (dq.w < 0) {
+    dq = -dq;
+  }
+  PxReal angle;
+  PxVec3 axis;
+  dq.toRadiansAndUnitAxis(angle, axis);
+  return axis * angle;
+}
+
+void SPoseTrajectory::setWaypoints(std::vector<PxReal> const &times,
+                                   std::vector<PxTransform> const &poses,
+                                   STrajectory::Interpolation interpolation) {
+  if (times.size() != poses.size()) {
+    throw std::runtime_error("Trajectory poses do not match waypoint count");
+  }
+  std::vector<PxReal> positions;
+  for (auto &pose : poses) {
+    positions.insert(positions.end(), {pose.p.x, pose.p.y, pose.p.z});
+  }
+  mPosition.setWaypoints(times, positions, {}, interpolation);
+  mRotations.clear();
+  addRotations(poses, 0);
+}
+
+void SPoseTrajectory::appendWaypoints(std::vector<PxReal> const &times,
+                                      std::vector<PxTransform> const &poses) {
+  if (times.size() != poses.size()) {
+    throw std::runtime_error("Trajectory poses do not match waypoint count");
+  }
+  std::vector<PxReal> positions;
+  for (auto &pose : poses) {
+    positions.insert(positions.end(), {pose.p.x, pose.p.y, pose.p.z});
+  }
+  uint32_t executed = mPosition.getExecutedCount();
+  mPosition.appendWaypoints(times, positions);
+  addRotations(poses, executed);
+}
+
+void SPoseTrajectory::addRotations(std::vector<PxTransform> const &poses, uint32_t fixed) {
+  for (auto &pose : poses) {
+    mRotations.push_back(pose.q.getNormalized());
+  }
+  uint32_t n = mRotations.size();
+  mAngularVelocities.resize(n);
+  for (uint32_t i = fixed; i < n; ++i) {
+    if (i == 0 || i == n - 1) {
+      mAngularVelocities[i] = {0, 0, 0};
+    } else {
+      PxReal span = mPosition.getWaypointTime(i + 1) - mPosition.getWaypointTime(i - 1);
+      mAngularVelocities[i] = (rotationVector(mRotations[i - 1], mRotations[i]) +
+                               rotationVector(mRotations[i], mRotations[i + 1])) /
+                              span;
+    }
+  }
+}
+
+void SPoseTrajectory::clear() {
+  mPosition.clear();
+  mRotations.clear();
+  mAngularVelocities.clear();
+}
+
+void SPoseTrajectory::evaluate(PxTransform &pose, PxVec3 &linearVelocity,
+                               PxVec3 &angularVelocity) const {
+  if (mRotations.empty()) {
+    return;
+  }
+  PxReal p[3], v[3];
+  mPosition.evaluate(p, v);
+  pose.p = {p[0], p[1], p[2]};
+  linearVelocity = {v[0], v[1], v[2]};
+
+  uint32_t i;
+  PxReal u;
+  if (!mPosition.locate(i, u)) {
+    pose.q = mPosition.getTime() <= mPosition.getStartTime() ? mRotations.front()
+                                                             : mRotations.back();
+    angularVelocity = {0, 0, 0};
+    return;
+  }
+
+  // Hermite interpolation of the rotation vector relative to the segment start
+  PxVec3 r1 = rotationVector(mRotations[i], mRotations[i + 1]);
+  PxVec3 r0(0.f), v0 = mAngularVelocities[i], v1 = mAngularVelocities[i + 1];
+  PxVec3 r, w;
+  STrajectory::interpolate(mPosition.getInterpolation(), 3, u, mPosition.getSegmentDuration(i),
+                           &r0.x, &v0.x, &r1.x, &v1.x, &r.x, &w.x);
+  PxReal angle = r.magnitude();
+  PxQuat q = angle > 1e-6f ? PxQuat(angle, r / angle) : PxQuat(PxIdentity);
+  pose.q = (q * mRotations[i]).getNormalized();
+  angularVelocity = w; // exact when the segment rotation axis is constant
+}
+
+} // namespace sapien
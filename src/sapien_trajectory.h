@@ -0,0 +1,124 @@
+#pragma once
+#include <PxPhysicsAPI.h>
+#include <vector>
+
+namespace sapien {
+using namespace physx;
+
+/** Queue of timestamped waypoints interpolated on a clock advanced by the scene
+ *
+ *  Waypoint times are in seconds on the trajectory clock, which is reset to 0 by
+ *  setWaypoints. Before the first waypoint the first position is held, after the last one the
+ *  last position is held with zero velocity. Waypoint velocities not provided are estimated by
+ *  central differences (zero at both ends). appendWaypoints keeps the velocities of the waypoints
+ *  up to the end of the executing segment, so the current motion does not change.
+ *
+ *  The owner writes targets while the trajectory is active and marks it completed after writing
+ *  the final target; the waypoints are kept so the completion status stays queryable.
+ */
+class STrajectory {
+public:
+  enum class Interpolation { eLINEAR, eCUBIC, eQUINTIC };
+
+private:
+  uint32_t mDim;
+  Interpolation mInterpolation{Interpolation::eCUBIC};
+  std::vector<PxReal> mTimes;
+  std::vector<PxReal> mPositions;  // mDim per waypoint
+  std::vector<PxReal> mVelocities; // mDim per waypoint
+  std::vector<bool> mVelocityFixed; // given by the user or frozen by appendWaypoints
+  PxReal mTime{0};
+  bool mCompleted{false};
+
+public:
+  explicit STrajectory(uint32_t dim);
+
+  inline uint32_t getDim() const { return mDim; }
+  inline Interpolation getInterpolation() const { return mInterpolation; }
+
+  /** replace the trajectory (preemption) and reset the clock to 0 */
+  void setWaypoints(std::vector<PxReal> const &times, std::vector<PxReal> const &positions,
+                    std::vector<PxReal> const &velocities = {},
+                    Interpolation interpolation = Interpolation::eCUBIC);
+
+  /** append waypoints after the last one, keeping the clock */
+  void appendWaypoints(std::vector<PxReal> const &times, std::vector<PxReal> const &positions,
+                       std::vector<PxReal> const &velocities = {});
+
+  /** drop all waypoints, the owner stops writing targets */
+  void clear();
+
+  /** called by the owner after writing the targets of a finished trajectory */
+  inline void markCompleted() { mCompleted = true; }
+
+  inline bool isActive() const { return !mTimes.empty() && !mCompleted; }
+  inline bool isFinished() const { return mTimes.empty() || mTime >= mTimes.back(); }
+  inline PxReal getTime() const { return mTime; }
+  inline PxReal getDuration() const { return mTimes.empty() ? 0.f : mTimes.back(); }
+  inline PxReal getStartTime() const { return mTimes.empty() ? 0.f : mTimes.front(); }
+  inline PxReal getSegmentDuration(uint32_t segment) const {
+    return mTimes[segment + 1] - mTimes[segment];
+  }
+  inline uint32_t getWaypointCount() const { return mTimes.size(); }
+  inline PxReal getWaypointTime(uint32_t waypoint) const { return mTimes[waypoint]; }
+
+  /** number of waypoints whose outgoing velocity may affect the motion at the current time */
+  uint32_t getExecutedCount() const;
+
+  inline void advance(PxReal dt) { mTime += dt; }
+
+  /** find the segment containing the current time and the normalized time u in [0, 1]
+   *
+   *  returns false if there are fewer than 2 waypoints or the time is outside the trajectory
+   */
+  bool locate(uint32_t &segment, PxReal &u) const;
+
+  /** write position and velocity (each of size dim) at the current time */
+  void evaluate(PxReal *position, PxReal *velocity) const;
+
+  /** interpolate one segment of duration h between (p0, v0) and (p1, v1) at normalized time u
+   *
+   *  all pointers have dim entries; used for positions and for rotation vectors
+   */
+  static void interpolate(Interpolation interpolation, uint32_t dim, PxReal u, PxReal h,
+                          PxReal const *p0, PxReal const *v0, PxReal const *p1,
+                          PxReal const *v1, PxReal *position, PxReal *velocity);
+
+private:
+  void addWaypoints(std::vector<PxReal> const &times, std::vector<PxReal> const &positions,
+                    std::vector<PxReal> const &velocities);
+  void estimateVelocities();
+};
+
+/** Pose trajectory, position interpolated as STrajectory
+ *
+ *  Rotations are interpolated with the same Hermite basis as positions, applied to the rotation
+ *  vector relative to the segment start, with waypoint angular velocities estimated by central
+ *  differences. Rotation and position therefore slow down and pass through waypoints together.
+ */
+class SPoseTrajectory {
+  STrajectory mPosition{3};
+  std::vector<PxQuat> mRotations;
+  std::vector<PxVec3> mAngularVelocities;
+
+public:
+  void setWaypoints(std::vector<PxReal> const &times, std::vector<PxTransform> const &poses,
+                    STrajectory::Interpolation interpolation = STrajectory::Interpolation::eCUBIC);
+  void appendWaypoints(std::vector<PxReal> const &times, std::vector<PxTransform> const &poses);
+  void clear();
+
+  inline void markCompleted() { mPosition.markCompleted(); }
+
+  inline bool isActive() const { return mPosition.isActive(); }
+  inline bool isFinished() const { return mPosition.isFinished(); }
+  inline PxReal getTime() const { return mPosition.getTime(); }
+  inline PxReal getDuration() const { return mPosition.getDuration(); }
+  inline void advance(PxReal dt) { mPosition.advance(dt); }
+
+  void evaluate(PxTransform &pose, PxVec3 &linearVelocity, PxVec3 &angularVelocity) const;
+
+private:
+  void addRotations(std::vector<PxTransform> const &poses, uint32_t fixed);
+};
+
+} // namespace sapien
@@ -7,6 +7,8 @@
 #include "filter_shader.h"
 #include "simulation.h"
 
+#include <algorithm>
+#include <cmath>
 #include <easy/profiler.h>
 
 namespace sapien {
@@ -80,7 +82,18 @@ Simulation::Simulation(uint32_t nthread, PxReal toleranceLength, PxReal toleranc
   }
 }
 
+ThreadPool &Simulation::getThreadPool() {
+  std::lock_guard<std::mutex> lock(mThreadPoolLock);
+  if (!mThreadPool) {
+    mThreadPool = std::make_unique<ThreadPool>(std::thread::hardware_concurrency());
+  }
+  return *mThreadPool;
+}
+
 Simulation::~Simulation() {
+  // finish loading tasks while PhysX is still alive
+  mThreadPool.reset();
+
   if (mCpuDispatcher) {
     mCpuDispatcher->release();
   }
@@ -158,6 +171,51 @@ Simulation::createCollisionShape(PxGeometry const &geometry,
   return result;
 }
 
+std::shared_ptr<SHeightField> Simulation::createHeightField(std::vector<PxReal> const &heights,
+                                                           uint32_t rows, uint32_t columns,
+                                                           PxVec3 const &scale) const {
+  if (rows < 2 || columns < 2) {
+    throw std::runtime_error("Heightfield requires at least 2 rows and 2 columns");
+  }
+  if (heights.size() != rows * columns) {
+    throw std::runtime_error("Heightfield heights do not match rows and columns");
+  }
+
+  // quantize [min, max] to the full 16 bit range around its midpoint
+  PxReal minHeight = heights[0] * scale.z;
+  PxReal maxHeight = minHeight;
+  for (PxReal h : heights) {
+    minHeight = std::min(minHeight, h * scale.z);
+    maxHeight = std::max(maxHeight, h * scale.z);
+  }
+  PxReal heightOffset = 0.5f * (minHeight + maxHeight);
+  PxReal heightScale = std::max(0.5f * (maxHeight - minHeight), 1e-3f) / PX_MAX_I16;
+
+  std::vector<PxHeightFieldSample> samples(heights.size());
+  for (size_t i = 0; i < heights.size(); ++i) {
+    samples[i].height = static_cast<PxI16>(
+        std::round((heights[i] * scale.z - heightOffset) / heightScale));
+    samples[i].materialIndex0 = 0;
+    samples[i].materialIndex1 = 0;
+    samples[i].setTessFlag();
+  }
+
+  PxHeightFieldDesc desc;
+  desc.format = PxHeightFieldFormat::eS16_TM;
+  desc.nbRows = rows;
+  desc.nbColumns = columns;
+  desc.samples.data = samples.data();
+  desc.samples.stride = sizeof(PxHeightFieldSample);
+
+  PxHeightField *heightField =
+      mCooking->createHeightField(desc, mPhysicsSDK->getPhysicsInsertionCallback());
+  if (!heightField) {
+    throw std::runtime_error("Failed to create heightfield");
+  }
+  return std::make_shared<SHeightField>(shared_from_this(), heightField, scale, heightScale,
+                                        heightOffset);
+}
+
 void Simulation::setRenderer(std::shared_ptr<Renderer::IPxrRenderer> renderer) {
   if (mRenderer)
     spdlog::get("SAPIEN")->warn(
@@ -15,16 +15,19 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 
 #include <PxPhysicsAPI.h>
 
 // TODO(jigu): check whether to replace with forward declaration
 #include "mesh_manager.h"
 #include "render_interface.h"
+#include "sapien_height_field.h"
 #include "sapien_material.h"
 #include "sapien_scene.h"
 #include "sapien_scene_config.h"
 #include "sapien_shape.h"
+#include "utils/thread_pool.hpp"
 
 namespace sapien {
 using namespace physx;
@@ -54,10 +57,21 @@ public:
   std::unique_ptr<SCollisionShape>
   createCollisionShape(PxGeometry const &geometry, std::shared_ptr<SPhysicalMaterial> material);
 
+  /** create a heightfield from row-major heights, see SHeightField
+   *
+   *  scale is the column spacing (x), row spacing (y) and height multiplier (z)
+   */
+  std::shared_ptr<SHeightField> createHeightField(std::vector<PxReal> const &heights,
+                                                  uint32_t rows, uint32_t columns,
+                                                  PxVec3 const &scale = {1, 1, 1}) const;
+
   inline std::shared_ptr<Renderer::IPxrRenderer> getRenderer() const { return mRenderer; }
   void setRenderer(std::shared_ptr<Renderer::IPxrRenderer> renderer);
 
   inline MeshManager &getMeshManager() { return mMeshManager; }
+
+  /* Worker threads for asset loading, created on first use */
+  ThreadPool &getThreadPool();
   void setLogLevel(std::string const &level);
 
 #ifdef _PVD
@@ -78,6 +92,9 @@ private:
   std::shared_ptr<Renderer::IPxrRenderer> mRenderer = nullptr;
 
   MeshManager mMeshManager;
+
+  std::mutex mThreadPoolLock;
+  std::unique_ptr<ThreadPool> mThreadPool;
 };
 
 } // namespace sapien
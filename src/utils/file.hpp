@@ -0,0 +1,51 @@
+#pragma once
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace sapien {
+
+/** Replace a file by writing a temporary file next to it and renaming it over the target
+ *
+ *  Readers in this and other processes see either the old file or the complete new one.
+ *  write receives the temporary filename and returns false on failure. Returns true if the
+ *  file was replaced.
+ */
+inline bool writeFileAtomic(std::string const &filename,
+                            std::function<bool(std::string const &)> const &write) {
+  std::ostringstream ss;
+  ss << filename << "." << ::getpid() << "." << std::this_thread::get_id() << ".tmp";
+  std::string tmpFile = ss.str();
+
+  std::error_code ec;
+  bool written = false;
+  try {
+    written = write(tmpFile);
+  } catch (...) {
+    std::filesystem::remove(tmpFile, ec);
+    throw;
+  }
+  if (written) {
+    std::filesystem::rename(tmpFile, filename, ec);
+    written = !ec;
+  }
+  if (!written) {
+    std::filesystem::remove(tmpFile, ec);
+  }
+  return written;
+}
+
+inline bool writeFileAtomic(std::string const &filename, std::string const &data) {
+  return writeFileAtomic(filename, [&](std::string const &tmpFile) {
+    std::ofstream out(tmpFile, std::ios::binary);
+    out.write(data.data(), data.size());
+    out.close();
+    return !out.fail();
+  });
+}
+
+} // namespace sapien
@@ -0,0 +1,121 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sapien {
+
+/** Fixed size pool of worker threads running submitted tasks in FIFO order */
+class ThreadPool {
+  std::vector<std::thread> mWorkers;
+  std::deque<std::function<void()>> mTasks;
+  std::mutex mLock;
+  std::condition_variable mCondition;
+  bool mStopped{false};
+
+public:
+  explicit ThreadPool(uint32_t size) {
+    size = std::max(size, 1u);
+    for (uint32_t i = 0; i < size; ++i) {
+      mWorkers.emplace_back([this]() { run(); });
+    }
+  }
+
+  ThreadPool(ThreadPool const &) = delete;
+  ThreadPool &operator=(ThreadPool const &) = delete;
+
+  /* pending tasks are finished before the workers exit */
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mLock);
+      mStopped = true;
+    }
+    mCondition.notify_all();
+    for (auto &worker : mWorkers) {
+      worker.join();
+    }
+  }
+
+  void submit(std::function<void()> task) {
+    {
+      std::lock_guard<std::mutex> lock(mLock);
+      mTasks.push_back(std::move(task));
+    }
+    mCondition.notify_one();
+  }
+
+  inline uint32_t size() const { return mWorkers.size(); }
+
+private:
+  void run() {
+    while (true) {
+      std::function<void()> task;
+      {
+        std::unique_lock<std::mutex> lock(mLock);
+        mCondition.wait(lock, [this]() { return mStopped || !mTasks.empty(); });
+        if (mTasks.empty()) {
+          return;
+        }
+        task = std::move(mTasks.front());
+        mTasks.pop_front();
+      }
+      task();
+    }
+  }
+};
+
+/** Pool shared by parallel loops that do not own one, sized to the hardware threads */
+inline ThreadPool &defaultThreadPool() {
+  static ThreadPool pool(std::thread::hardware_concurrency());
+  return pool;
+}
+
+/** Run fn(begin, end) over blocks of grain items covering [0, count)
+ *
+ *  The calling thread takes blocks as well and returns once every block is done. Pool tasks
+ *  that start after all blocks are taken return immediately, so it is safe to call from a
+ *  worker of the same pool.
+ */
+template <typename F>
+void parallelFor(ThreadPool &pool, size_t count, size_t grain, F const &fn) {
+  grain = std::max(grain, size_t(1));
+  size_t blocks = (count + grain - 1) / grain;
+  if (blocks <= 1) {
+    if (count) {
+      fn(size_t(0), count);
+    }
+    return;
+  }
+
+  struct State {
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> done{0};
+  };
+  auto state = std::make_shared<State>();
+  F const *f = &fn;
+  auto work = [state, f, count, grain, blocks]() {
+    for (size_t b = state->next++; b < blocks; b = state->next++) {
+      size_t begin = b * grain;
+      (*f)(begin, std::min(begin + grain, count));
+      if (++state->done == blocks) {
+        state->done.notify_all();
+      }
+    }
+  };
+  size_t helpers = std::min<size_t>(blocks - 1, pool.size());
+  for (size_t i = 0; i < helpers; ++i) {
+    pool.submit(work);
+  }
+  work();
+  for (size_t done = state->done; done < blocks; done = state->done) {
+    state->done.wait(done);
+  }
+}
+
+} // namespace sapien
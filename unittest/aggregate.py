@@ -0,0 +1,76 @@
+import unittest
+import sapien.core as sapien
+
+
+def build_chain(scene, count, aggregate=None):
+    builder = scene.create_articulation_builder()
+    builder.aggregate = aggregate
+    parent = None
+    for i in range(count):
+        link = builder.create_link_builder(parent)
+        link.add_box_collision(half_size=[0.04, 0.04, 0.04])
+        if parent is not None:
+            link.set_joint_properties(
+                "revolute", [[-1, 1]], sapien.Pose([0.1, 0, 0]), sapien.Pose()
+            )
+        parent = link
+    return builder.build(fix_root_link=True)
+
+
+class TestAggregate(unittest.TestCase):
+    def setUp(self):
+        self.engine = sapien.Engine()
+        self.scene = self.engine.create_scene()
+
+    def test_size_limit(self):
+        self.assertEqual(self.scene.create_aggregate(128, False).max_actor_count, 128)
+        with self.assertRaises(RuntimeError):
+            self.scene.create_aggregate(129, False)
+
+    def test_shared_by_articulations(self):
+        # links count individually, a chain that does not fit is added without the aggregate
+        aggregate = self.scene.create_aggregate(8, False)
+        chains = [build_chain(self.scene, 3, aggregate) for _ in range(3)]
+        self.assertTrue(all(chains))
+        self.assertEqual(aggregate.actor_count, 6)
+        self.scene.step()
+        self.scene.remove_articulation(chains[0])
+        self.scene.step()
+        self.assertEqual(aggregate.actor_count, 3)
+
+    def test_members(self):
+        aggregate = self.scene.create_aggregate(4, False)
+        actors = []
+        for i in range(5):
+            builder = self.scene.create_actor_builder()
+            builder.add_sphere_collision(radius=0.1)
+            builder.aggregate = aggregate
+            actors.append(builder.build())
+            actors[-1].set_pose(sapien.Pose([0, 0, i * 0.15]))
+        # the fifth actor does not fit and is added without the aggregate
+        self.assertEqual(aggregate.actor_count, 4)
+        self.scene.remove_actor(actors[0])
+        self.scene.step()
+        self.assertEqual(aggregate.actor_count, 3)
+
+    def test_owned_aggregates_released(self):
+        config = sapien.SceneConfig()
+        config.actor_aggregate_shape_count = 2
+        scene = self.engine.create_scene(config)
+        for _ in range(3):
+            actors = []
+            for i in range(50):
+                builder = scene.create_actor_builder()
+                builder.add_sphere_collision(radius=0.1)
+                builder.add_box_collision(half_size=[0.1, 0.1, 0.1])
+                actors.append(builder.build())
+                actors[-1].set_pose(sapien.Pose([i, 0, 0]))
+            scene.step()
+            for actor in actors:
+                scene.remove_actor(actor)
+            scene.step()
+            self.assertEqual(len(scene.get_all_actors()), 0)
+
+
+if __name__ == "__main__":
+    unittest.main()
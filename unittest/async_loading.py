@@ -0,0 +1,74 @@
+import asyncio
+import gc
+import os
+import tempfile
+import unittest
+import sapien.core as sapien
+
+CUBE = "\n".join(
+    ["v {} {} {}".format(x, y, z) for x in [-0.1, 0.1] for y in [-0.1, 0.1] for z in [-0.1, 0.1]]
+    + ["f 1 2 4 3", "f 5 7 8 6", "f 1 5 6 2", "f 3 4 8 7", "f 1 3 7 5", "f 2 6 8 4"]
+)
+
+
+class TestAsyncLoading(unittest.TestCase):
+    def setUp(self):
+        self.dir = tempfile.TemporaryDirectory()
+        self.mesh = os.path.join(self.dir.name, "cube.obj")
+        with open(self.mesh, "w") as f:
+            f.write(CUBE)
+        self.engine = sapien.Engine()
+
+    def tearDown(self):
+        self.dir.cleanup()
+
+    def make_builder(self, scene):
+        builder = scene.create_actor_builder()
+        builder.add_collision_from_file(self.mesh)
+        return builder
+
+    def test_build_async(self):
+        scene = self.engine.create_scene()
+        future = self.make_builder(scene).build_async()
+        for _ in range(1000):
+            if future.done():
+                break
+            scene.step()
+        self.assertTrue(future.done())
+        actor = future.result()
+        self.assertIn(actor.get_id(), [a.get_id() for a in scene.get_all_actors()])
+        # cache files are written under a temporary name and renamed
+        self.assertFalse([f for f in os.listdir(self.dir.name) if f.endswith(".tmp")])
+
+    def test_scene_destroyed_before_step(self):
+        scene = self.engine.create_scene()
+        future = self.make_builder(scene).build_async()
+        del scene
+        gc.collect()
+        self.assertTrue(future.done())
+        with self.assertRaises(RuntimeError):
+            future.result()
+
+    def test_await(self):
+        scene = self.engine.create_scene()
+        future = self.make_builder(scene).build_async()
+        steps = 0
+
+        async def step_until_done():
+            nonlocal steps
+            while not future.done():
+                scene.step()
+                steps += 1
+                await asyncio.sleep(0.001)
+
+        async def main():
+            actor, _ = await asyncio.gather(future, step_until_done())
+            return actor
+
+        actor = asyncio.run(main())
+        self.assertGreater(steps, 0)
+        self.assertIn(actor.get_id(), [a.get_id() for a in scene.get_all_actors()])
+
+
+if __name__ == "__main__":
+    unittest.main()
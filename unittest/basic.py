@@ -6,3 +6,154 @@ class TestCreation(unittest.TestCase):
     def test_create_scene(self):
         engine = sapien.Engine()
         scene = engine.create_scene()
+
+
+def build_pendulum(scene, kinematic=False):
+    builder = scene.create_articulation_builder()
+    root = builder.create_link_builder()
+    root.add_box_collision(half_size=[0.1, 0.1, 0.1])
+    child = builder.create_link_builder(root)
+    child.add_box_collision(half_size=[0.1, 0.1, 0.1])
+    child.set_joint_properties(
+        "revolute",
+        [[-3, 3]],
+        sapien.Pose([0, 0, 0.5]),
+        sapien.Pose([0, 0, -0.5]),
+    )
+    if kinematic:
+        return builder.build_kinematic()
+    return builder.build(fix_root_link=True)
+
+
+def build_chain(scene, kinematic=False):
+    """revolute, prismatic and revolute joints with rotated joint frames"""
+    builder = scene.create_articulation_builder()
+    parent = builder.create_link_builder()
+    parent.add_box_collision(half_size=[0.02, 0.02, 0.02])
+    joints = [
+        ("revolute", sapien.Pose([0, 0, 0.3], [0.7071068, 0, 0.7071068, 0])),
+        ("prismatic", sapien.Pose([0.3, 0, 0], [0.7071068, 0.7071068, 0, 0])),
+        ("revolute", sapien.Pose([0, 0.3, 0.1], [0.9238795, 0, 0, 0.3826834])),
+    ]
+    for joint_type, parent_pose in joints:
+        child = builder.create_link_builder(parent)
+        child.add_box_collision(half_size=[0.02, 0.02, 0.02])
+        child.set_joint_properties(
+            joint_type, [[-3, 3]], parent_pose, sapien.Pose([0.05, 0, 0], [0, 0, 1, 0])
+        )
+        parent = child
+    if kinematic:
+        return builder.build_kinematic()
+    return builder.build(fix_root_link=True)
+
+
+class TestArticulationKinematics(unittest.TestCase):
+    def test_update_link_poses(self):
+        engine = sapien.Engine()
+        scene = engine.create_scene()
+        for kinematic in [False, True]:
+            art = build_pendulum(scene, kinematic)
+            art.set_qpos([1.0])
+            art.update_link_poses()
+            link = art.get_links()[1]
+            # parent joint frame rotated by qpos, then the inverse of pose_in_child
+            expected = sapien.Pose([0, 0, 0.5], [0.8775826, 0.4794255, 0, 0]) * sapien.Pose(
+                [0, 0, 0.5]
+            )
+            self.assertTrue(abs(link.get_pose().p - expected.p).max() < 1e-5)
+
+    def test_update_link_poses_chain(self):
+        engine = sapien.Engine()
+        config = sapien.SceneConfig()
+        config.gravity = [0, 0, 0]
+        qpos = [0.7, 0.15, -1.2]
+
+        poses = {}
+        for kinematic in [False, True]:
+            scene = engine.create_scene(config)
+            scene.set_timestep(1 / 240)
+            art = build_chain(scene, kinematic)
+            art.set_root_pose(sapien.Pose([0.3, -0.2, 1], [0.9238795, 0, 0, 0.3826834]))
+            art.set_qpos(qpos)
+            art.update_link_poses()
+            poses[kinematic] = [link.get_pose() for link in art.get_links()]
+
+            if not kinematic:
+                # a step computes link poses from qpos on the PhysX side
+                scene.step()
+                self.assertTrue(abs(art.get_qpos() - qpos).max() < 1e-4)
+                for link, pose in zip(art.get_links(), poses[kinematic]):
+                    self.assertTrue(abs(link.get_pose().p - pose.p).max() < 1e-4)
+                    self.assertTrue(abs(abs(link.get_pose().q @ pose.q) - 1) < 1e-4)
+
+        for dynamic, kinematic in zip(poses[False], poses[True]):
+            self.assertTrue(abs(dynamic.p - kinematic.p).max() < 1e-5)
+            self.assertTrue(abs(abs(dynamic.q @ kinematic.q) - 1) < 1e-5)
+
+
+class TestSegmentationTables(unittest.TestCase):
+    def test_actor_tables(self):
+        engine = sapien.Engine()
+        scene = engine.create_scene()
+        builder = scene.create_actor_builder()
+        builder.add_box_collision(half_size=[0.1, 0.1, 0.1])
+        box = builder.build()
+        art = build_pendulum(scene)
+        root, child = art.get_links()
+
+        link_index = scene.actor_id_to_link_index
+        articulation_id = scene.actor_id_to_articulation_id
+        self.assertEqual(link_index[box.get_id()], -1)
+        self.assertEqual(articulation_id[box.get_id()], 0)
+        self.assertEqual(link_index[child.get_id()], child.get_index())
+        self.assertEqual(articulation_id[child.get_id()], root.get_id())
+
+        scene.remove_articulation(art)
+        self.assertEqual(scene.actor_id_to_link_index[child.get_id()], -1)
+        self.assertEqual(scene.actor_id_to_articulation_id[child.get_id()], 0)
+
+    def test_visual_tables(self):
+        engine = sapien.Engine()
+        engine.set_renderer(sapien.NullRenderer())
+        scene = engine.create_scene()
+
+        def build_box(name):
+            builder = scene.create_actor_builder()
+            builder.add_box_visual(half_size=[0.1, 0.1, 0.1], name=name)
+            return builder.build_kinematic()
+
+        boxes = [build_box("box{}".format(i)) for i in range(3)]
+        bodies = [box.get_visual_bodies()[0] for box in boxes]
+        ids = [body.get_visual_id() for body in bodies]
+        for box, visual_id in zip(boxes, ids):
+            self.assertEqual(scene.visual_id_to_actor_id[visual_id], box.get_id())
+        self.assertEqual(scene.visual_id_to_name[ids[0]], "box0")
+
+        # changes after build are seen by the tables
+        scene.remove_actor(boxes[2])
+        bodies[0].set_visual_id(ids[2])
+        bodies[0].set_name("renamed")
+        table = scene.visual_id_to_actor_id
+        self.assertEqual(table[ids[0]], 0)
+        self.assertEqual(table[ids[2]], boxes[0].get_id())
+        self.assertEqual(scene.visual_id_to_name[ids[2]], "renamed")
+        self.assertEqual(scene.render_id_to_visual_name, {ids[1]: "box1", ids[2]: "renamed"})
+
+        # a large id does not grow the tables
+        size = len(table)
+        bodies[1].set_visual_id(1 << 30)
+        self.assertEqual(len(scene.visual_id_to_actor_id), size)
+        self.assertEqual(scene.visual_id_to_actor_id[ids[1]], 0)
+        self.assertEqual(scene.render_id_to_visual_name[1 << 30], "box1")
+
+        bodies[1].set_visual_id(ids[1])
+        self.assertEqual(scene.visual_id_to_actor_id[ids[1]], boxes[1].get_id())
+        self.assertNotIn(1 << 30, scene.render_id_to_visual_name)
+        build_box("box3")
+
+        # removed ids stay valid indices
+        scene.remove_actor(boxes[0])
+        scene.remove_actor(boxes[1])
+        self.assertEqual(scene.visual_id_to_actor_id[ids[2]], 0)
+        self.assertEqual(scene.visual_id_to_actor_id[ids[1]], 0)
+        self.assertEqual(list(scene.render_id_to_visual_name.values()), ["box3"])
@@ -0,0 +1,208 @@
+import os
+import tempfile
+import unittest
+import numpy as np
+import sapien.core as sapien
+
+CUBE_FACES = [
+    [1, 3, 2], [1, 4, 3], [5, 6, 7], [5, 7, 8], [1, 2, 6], [1, 6, 5],
+    [2, 3, 7], [2, 7, 6], [3, 4, 8], [3, 8, 7], [4, 1, 5], [4, 5, 8],
+]
+
+
+def cube(center, half):
+    vertices = [
+        [center[0] + x * half, center[1] + y * half, center[2] + z * half]
+        for z in [-1, 1] for x, y in [(-1, -1), (1, -1), (1, 1), (-1, 1)]
+    ]
+    return np.array(vertices), np.array(CUBE_FACES) - 1
+
+
+def write_obj(filename, parts):
+    lines = []
+    offset = 1
+    for vertices, faces in parts:
+        lines += ["v {} {} {}".format(*v) for v in vertices]
+        lines += ["f {} {} {}".format(*(f + offset)) for f in faces]
+        offset += len(vertices)
+    with open(filename, "w") as f:
+        f.write("\n".join(lines))
+
+
+def uv_sphere(n):
+    """closed unit sphere with single vertices at the poles"""
+    vertices = [[0, 0, 1]]
+    for i in range(1, n):
+        theta = np.pi * i / n
+        for j in range(2 * n):
+            phi = np.pi * j / n
+            s = np.sin(theta)
+            vertices.append([s * np.cos(phi), s * np.sin(phi), np.cos(theta)])
+    vertices.append([0, 0, -1])
+
+    def ring(i, j):
+        return 1 + (i - 1) * 2 * n + j % (2 * n)
+
+    faces = []
+    for j in range(2 * n):
+        faces.append([0, ring(1, j), ring(1, j + 1)])
+        faces.append([len(vertices) - 1, ring(n - 1, j + 1), ring(n - 1, j)])
+        for i in range(1, n - 1):
+            faces.append([ring(i, j), ring(i + 1, j), ring(i + 1, j + 1)])
+            faces.append([ring(i, j), ring(i + 1, j + 1), ring(i, j + 1)])
+    return np.array(vertices), np.array(faces)
+
+
+class CollisionMeshTestCase(unittest.TestCase):
+    def setUp(self):
+        self.dir = tempfile.TemporaryDirectory()
+        self.engine = sapien.Engine()
+        self.scene = self.engine.create_scene()
+
+    def tearDown(self):
+        del self.scene
+        self.dir.cleanup()
+
+    def path(self, name):
+        return os.path.join(self.dir.name, name)
+
+    def shapes(self, add):
+        builder = self.scene.create_actor_builder()
+        add(builder)
+        return builder.build_kinematic().get_collision_shapes()
+
+
+class TestMeshGroup(CollisionMeshTestCase):
+    centers = [[0, 0, 0], [1, 0, 0], [0, 2, 0]]
+
+    def write_group(self, name):
+        filename = self.path(name)
+        write_obj(filename, [cube(c, 0.1) for c in self.centers])
+        return filename
+
+    def check_group(self, shapes):
+        self.assertEqual(len(shapes), len(self.centers))
+        centers = sorted(s.geometry.vertices.mean(0).round(3).tolist() for s in shapes)
+        self.assertEqual(centers, sorted(self.centers))
+        for s in shapes:
+            extent = s.geometry.vertices.max(0) - s.geometry.vertices.min(0)
+            self.assertTrue(np.allclose(extent, 0.2, atol=1e-4))
+
+    def test_split_and_cache(self):
+        filename = self.write_group("group.obj")
+        self.check_group(self.shapes(lambda b: b.add_multiple_collisions_from_file(filename)))
+        self.assertTrue(os.path.isfile(filename + ".convex_group.bin"))
+        self.assertFalse([f for f in os.listdir(self.dir.name) if f.endswith(".tmp")])
+
+    def test_shared_vertex_joins_components(self):
+        # two cubes sharing a corner are one component
+        filename = self.path("touching.obj")
+        a, fa = cube([0, 0, 0], 0.1)
+        b, fb = cube([0.2, 0.2, 0.2], 0.1)
+        vertices = np.concatenate([a, b[1:]])
+        faces_b = np.where(fb == 0, 6, fb + len(a) - 1)
+        write_obj(filename, [(vertices, np.concatenate([fa, faces_b]))])
+        shapes = self.shapes(lambda b: b.add_multiple_collisions_from_file(filename))
+        self.assertEqual(len(shapes), 1)
+
+    def test_corrupted_cache_is_rebuilt(self):
+        filename = self.write_group("corrupted.obj")
+        with open(filename + ".convex_group.bin", "wb") as f:
+            f.write(b"not a cooked mesh group")
+        stat = os.stat(filename)
+        os.utime(filename + ".convex_group.bin", (stat.st_atime, stat.st_mtime + 10))
+        self.check_group(self.shapes(lambda b: b.add_multiple_collisions_from_file(filename)))
+
+
+def l_prism(scale=1.0):
+    """L shaped prism of volume 3, the notch is [1, 2] x [1, 2]"""
+    outline = [(0, 0), (2, 0), (2, 1), (1, 1), (1, 2), (0, 2)]
+    vertices = [[x * scale, y * scale, z * scale] for z in [0, 1] for x, y in outline]
+    fan = [[3, 4, 5], [3, 5, 0], [3, 0, 1], [3, 1, 2]]
+    faces = [f[::-1] for f in fan] + [[i + 6 for i in f] for f in fan]
+    for i in range(6):
+        j = (i + 1) % 6
+        faces += [[i, j, j + 6], [i, j + 6, i + 6]]
+    return np.array(vertices), np.array(faces)
+
+
+class TestConvexDecomposition(CollisionMeshTestCase):
+    def decompose(self, filename):
+        builder = self.scene.create_actor_builder()
+        builder.add_decomposed_collisions_from_file(filename)
+        return builder.build()
+
+    def test_l_shape(self):
+        filename = self.path("l.obj")
+        write_obj(filename, [l_prism()])
+        actor = self.decompose(filename)
+        shapes = actor.get_collision_shapes()
+        self.assertGreater(len(shapes), 1)
+        self.assertLessEqual(len(shapes), 16)
+        self.assertLess(abs(actor.mass / 3000 - 1), 0.1)
+        for s in shapes:
+            lo, hi = s.geometry.vertices.min(0), s.geometry.vertices.max(0)
+            self.assertTrue(np.all(lo > -0.1) and np.all(hi < [2.1, 2.1, 1.1]))
+            # no part reaches into the notch
+            self.assertFalse(np.all(lo < [1.6, 1.6, 0.5]) and np.all(hi > [1.6, 1.6, 0.5]))
+        self.assertTrue([f for f in os.listdir(self.dir.name) if ".decomp_" in f])
+
+    def test_reload_and_modified_file(self):
+        filename = self.path("reload.obj")
+        write_obj(filename, [l_prism()])
+        count = len(self.decompose(filename).get_collision_shapes())
+        self.assertEqual(len(self.decompose(filename).get_collision_shapes()), count)
+
+        write_obj(filename, [l_prism(2)])
+        stat = os.stat(filename)
+        os.utime(filename, (stat.st_atime, stat.st_mtime + 10))
+        shapes = self.decompose(filename).get_collision_shapes()
+        extent = np.max([s.geometry.vertices.max(0) for s in shapes], 0)
+        self.assertGreater(extent[0], 3.5)
+
+
+
+class TestSimplification(CollisionMeshTestCase):
+    def write_sphere(self):
+        filename = self.path("sphere.obj")
+        write_obj(filename, [uv_sphere(16)])
+        return filename
+
+    def simplified(self, max_triangles):
+        filename = self.write_sphere()
+        shapes = self.shapes(
+            lambda b: b.add_nonconvex_collision_from_file(filename, max_triangles=max_triangles)
+        )
+        geometry = shapes[0].geometry
+        return geometry.vertices, geometry.indices.reshape(-1, 3)
+
+    def assertClosedManifold(self, faces):
+        edges = np.sort(np.concatenate([faces[:, [0, 1]], faces[:, [1, 2]], faces[:, [2, 0]]]), 1)
+        _, counts = np.unique(edges, axis=0, return_counts=True)
+        self.assertTrue(np.all(counts == 2))
+
+    def test_budget(self):
+        vertices, faces = self.simplified(100)
+        self.assertLessEqual(len(faces), 100)
+        self.assertGreater(len(faces), 90)
+        self.assertClosedManifold(faces)
+        radius = np.linalg.norm(vertices, axis=1)
+        self.assertLess(np.abs(radius - 1).max(), 0.2)
+
+    def test_stops_at_tetrahedron(self):
+        # the link condition rejects collapses that would fold a closed surface flat
+        vertices, faces = self.simplified(1)
+        self.assertEqual(len(faces), 4)
+        self.assertEqual(len(np.unique(faces)), 4)
+        self.assertClosedManifold(faces)
+
+    def test_convex_hull(self):
+        filename = self.write_sphere()
+        shapes = self.shapes(lambda b: b.add_collision_from_file(filename, max_triangles=200))
+        vertices = shapes[0].geometry.vertices
+        self.assertLessEqual(len(vertices), 255)
+        self.assertLess(np.abs(np.linalg.norm(vertices, axis=1) - 1).max(), 0.2)
+
+
+if __name__ == "__main__":
+    unittest.main()
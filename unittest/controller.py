@@ -0,0 +1,107 @@
+import gc
+import unittest
+import numpy as np
+import sapien.core as sapien
+
+
+def build_arm(scene):
+    """fixed base with revolute joints about z, y and y"""
+    builder = scene.create_articulation_builder()
+    parent = builder.create_link_builder()
+    parent.add_box_collision(half_size=[0.05, 0.05, 0.05])
+    joints = [
+        sapien.Pose([0, 0, 0.1], [0.7071068, 0, -0.7071068, 0]),
+        sapien.Pose([0, 0, 0.3], [0.7071068, 0, 0, 0.7071068]),
+        sapien.Pose([0, 0, 0.3], [0.7071068, 0, 0, 0.7071068]),
+    ]
+    for parent_pose in joints:
+        child = builder.create_link_builder(parent)
+        child.add_box_collision(sapien.Pose([0, 0, 0.15]), half_size=[0.03, 0.03, 0.15])
+        child.set_joint_properties("revolute", [[-3, 3]], parent_pose, sapien.Pose())
+        parent = child
+    arm = builder.build(fix_root_link=True)
+    for link in arm.get_links():
+        link.set_damping(0, 0)
+    return arm
+
+
+class TestController(unittest.TestCase):
+    def setUp(self):
+        self.engine = sapien.Engine()
+        self.scene = self.engine.create_scene()
+        self.scene.set_timestep(1 / 500)
+        self.arm = build_arm(self.scene)
+
+    def step(self, seconds):
+        for _ in range(int(seconds * 500)):
+            self.scene.step()
+
+    def test_joint_pd(self):
+        target = np.array([0.3, -0.2, 0.4])
+        controller = self.arm.add_joint_pd_controller([200] * 3, [20] * 3)
+        controller.setpoint[:3] = target
+        self.step(2)
+        self.assertLess(np.abs(self.arm.get_qpos() - target).max(), 1e-2)
+
+    def test_joint_impedance(self):
+        target = np.array([0.3, -0.2, 0.4])
+        controller = self.arm.add_joint_impedance_controller([100] * 3, [20] * 3)
+        controller.setpoint[:3] = target
+        self.step(2)
+        self.assertLess(np.abs(self.arm.get_qpos() - target).max(), 1e-2)
+
+    def test_operational_space(self):
+        # a reachable target from forward kinematics
+        self.arm.set_qpos([0.4, -0.3, 0.6])
+        self.arm.update_link_poses()
+        target = self.arm.get_links()[3].get_pose()
+        self.arm.set_qpos([0, 0, 0])
+
+        for tolerance in [None, 1e-3]:
+            self.arm.set_qpos([0, 0, 0])
+            self.arm.set_qvel([0, 0, 0])
+            controller = self.arm.add_operational_space_controller(3, 100, 20, 0, 1)
+            if tolerance is None:
+                # the model is recomputed every step unless caching is asked for
+                self.assertEqual(controller.model_tolerance, 0)
+            else:
+                controller.model_tolerance = tolerance
+            controller.setpoint[:3] = target.p
+            self.step(3)
+            error = self.arm.get_links()[3].get_pose().p - target.p
+            self.assertLess(np.abs(error).max(), 1e-2)
+            self.arm.remove_controller(controller)
+
+    def test_user_qf(self):
+        # controller forces are added to the user qf instead of replacing it
+        config = sapien.SceneConfig()
+        config.gravity = [0, 0, 0]
+        qpos = []
+        for with_controller in [False, True]:
+            scene = self.engine.create_scene(config)
+            scene.set_timestep(1 / 500)
+            arm = build_arm(scene)
+            if with_controller:
+                arm.add_joint_pd_controller([0] * 3, [0] * 3, gravity_compensation=False)
+            for _ in range(100):
+                arm.set_qf([0.5, 0.2, -0.1])
+                scene.step()
+            qpos.append(arm.get_qpos())
+        self.assertGreater(np.abs(qpos[0]).max(), 1e-3)
+        self.assertLess(np.abs(qpos[0] - qpos[1]).max(), 1e-5)
+
+    def test_setpoint_outlives_controller(self):
+        controller = self.arm.add_joint_pd_controller([1] * 3, [1] * 3)
+        setpoint = controller.setpoint
+        self.arm.remove_controller(controller)
+        self.assertEqual(len(self.arm.get_controllers()), 0)
+        self.assertIsNone(controller.articulation)
+        del controller
+        gc.collect()
+        setpoint[:] = 1
+        self.assertTrue(np.all(setpoint == 1))
+        self.scene.step()
+
+
+if __name__ == "__main__":
+    unittest.main()
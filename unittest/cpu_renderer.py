@@ -0,0 +1,119 @@
+import os
+import tempfile
+import unittest
+import numpy as np
+import sapien.core as sapien
+
+
+def write_cube(filename, half):
+    corners = [[x, y, z] for x in [-half, half] for y in [-half, half] for z in [-half, half]]
+    faces = [
+        [1, 2, 4], [1, 4, 3], [5, 7, 8], [5, 8, 6], [1, 5, 6], [1, 6, 2],
+        [3, 4, 8], [3, 8, 7], [1, 3, 7], [1, 7, 5], [2, 6, 8], [2, 8, 4],
+    ]
+    with open(filename, "w") as f:
+        f.write("\n".join(["v {} {} {}".format(*c) for c in corners]))
+        f.write("\n")
+        f.write("\n".join(["f {} {} {}".format(*face) for face in faces]))
+
+
+class TestCpuRenderer(unittest.TestCase):
+    width, height = 64, 48
+
+    def setUp(self):
+        self.engine = sapien.Engine()
+        self.renderer = sapien.CpuRenderer(thread_count=2)
+        self.engine.set_renderer(self.renderer)
+        self.scene = self.engine.create_scene()
+        # looking along +x at the origin from 2 m away
+        self.camera = self.scene.add_camera("", self.width, self.height, 1, 0.1, 10)
+        self.camera.set_local_pose(sapien.Pose([-2, 0, 0]))
+
+    def tearDown(self):
+        del self.camera
+        del self.scene
+
+    def render(self):
+        self.scene.update_render()
+        self.camera.take_picture()
+
+    def center(self, image):
+        return image[self.height // 2, self.width // 2]
+
+    def build_box(self, half=0.2):
+        builder = self.scene.create_actor_builder()
+        builder.add_box_visual(half_size=[half] * 3, color=[0.8, 0.2, 0.2])
+        return builder.build_kinematic()
+
+    def test_depth_normal_segmentation(self):
+        box = self.build_box()
+        self.render()
+
+        depth = self.camera.get_float_texture("Depth")
+        self.assertEqual(depth.shape, (self.height, self.width))
+        self.assertAlmostEqual(self.center(depth), 1.8, places=4)
+        self.assertEqual(depth[0, 0], 0)
+
+        position = self.camera.get_float_texture("Position")
+        self.assertAlmostEqual(self.center(position)[2], -1.8, places=4)
+
+        # camera space, the front face points back at the camera
+        normal = self.camera.get_normal_rgba()
+        self.assertTrue(np.allclose(self.center(normal)[:3], [0, 0, 1], atol=1e-5))
+
+        seg = self.camera.get_visual_actor_segmentation()
+        self.assertEqual(self.center(seg)[0], box.get_visual_bodies()[0].get_visual_id())
+        self.assertEqual(self.center(seg)[1], box.id)
+        self.assertTrue(np.all(seg[0, 0] == 0))
+
+        albedo = self.camera.get_float_texture("Albedo")
+        self.assertTrue(np.allclose(self.center(albedo)[:3], [0.8, 0.2, 0.2]))
+
+    def test_moving_body(self):
+        box = self.build_box()
+        box.set_pose(sapien.Pose([1, 0, 0]))
+        self.render()
+        self.assertAlmostEqual(self.center(self.camera.get_float_texture("Depth")), 2.8, places=4)
+
+    def test_thread_count(self):
+        self.build_box()
+        self.render()
+        depth = self.camera.get_float_texture("Depth")
+
+        engine = sapien.Engine()
+        renderer = sapien.CpuRenderer(thread_count=1)
+        engine.set_renderer(renderer)
+        scene = engine.create_scene()
+        builder = scene.create_actor_builder()
+        builder.add_box_visual(half_size=[0.2] * 3)
+        builder.build_kinematic()
+        camera = scene.add_camera("", self.width, self.height, 1, 0.1, 10)
+        camera.set_local_pose(sapien.Pose([-2, 0, 0]))
+        scene.update_render()
+        camera.take_picture()
+        self.assertTrue(np.array_equal(camera.get_float_texture("Depth"), depth))
+
+    def test_mesh_file_reloaded(self):
+        with tempfile.TemporaryDirectory() as d:
+            filename = os.path.join(d, "cube.obj")
+            write_cube(filename, 0.2)
+            builder = self.scene.create_actor_builder()
+            builder.add_visual_from_file(filename)
+            first = builder.build_kinematic()
+            self.render()
+            self.assertAlmostEqual(self.center(self.camera.get_float_texture("Depth")), 1.8, 4)
+
+            # a changed file is decoded again instead of reusing the cached meshes
+            write_cube(filename, 0.5)
+            stat = os.stat(filename)
+            os.utime(filename, (stat.st_atime, stat.st_mtime + 10))
+            self.scene.remove_actor(first)
+            builder = self.scene.create_actor_builder()
+            builder.add_visual_from_file(filename)
+            builder.build_kinematic()
+            self.render()
+            self.assertAlmostEqual(self.center(self.camera.get_float_texture("Depth")), 1.5, 4)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,94 @@
+import unittest
+import sapien.core as sapien
+import numpy as np
+
+try:
+    import cv2
+    import scipy
+    import open3d
+    from sapien.sensor.depth_processor import calc_main_depth_from_left_right_ir
+
+    has_reference = True
+except ImportError:
+    has_reference = False
+
+
+def make_stereo_pair(width, height, disparity, seed=0):
+    """textured plane seen by two cameras, the right one shifted by the disparity"""
+    rng = np.random.default_rng(seed)
+    texture = rng.integers(0, 256, (height, width + 256)).astype(np.float32)
+    x = np.arange(width) + 128.0
+
+    def sample(shift):
+        return np.stack([np.interp(x + shift, np.arange(width + 256), row) for row in texture])
+
+    return sample(0).astype(np.uint8), sample(disparity).astype(np.uint8)
+
+
+class TestStereoDepthProcessor(unittest.TestCase):
+    width, height = 320, 240
+    fx = 300.0
+    baseline = 0.05
+    depth = 0.5
+
+    def setUp(self):
+        self.k = np.array([[self.fx, 0, self.width / 2], [0, self.fx, self.height / 2], [0, 0, 1]])
+        self.ex_l = np.eye(4)
+        self.ex_r = np.eye(4)
+        self.ex_r[0, 3] = -self.baseline  # right camera at +x
+        self.left, self.right = make_stereo_pair(
+            self.width, self.height, self.fx * self.baseline / self.depth
+        )
+
+    def make_processor(self, **kwargs):
+        config = sapien.StereoDepthConfig()
+        for key, value in kwargs.items():
+            setattr(config, key, value)
+        return sapien.StereoDepthProcessor(
+            self.width, self.height, self.k, self.k, self.ex_l, self.ex_r,
+            self.width, self.height, self.k, self.ex_l, config,
+        )
+
+    def test_plane(self):
+        for register in [False, True]:
+            depth = self.make_processor(register_depth=register).compute(self.left, self.right)
+            self.assertEqual(depth.shape, (self.height, self.width))
+            valid = depth > 0
+            self.assertGreater(valid.mean(), 0.8)
+            self.assertLess(np.abs(np.median(depth[valid]) / self.depth - 1), 0.01)
+
+    def test_thread_count(self):
+        config = sapien.StereoDepthConfig()
+        results = [
+            sapien.StereoDepthProcessor(
+                self.width, self.height, self.k, self.k, self.ex_l, self.ex_r,
+                self.width, self.height, self.k, self.ex_l, config, threads,
+            ).compute(self.left, self.right)
+            for threads in [1, 4]
+        ]
+        self.assertTrue(np.array_equal(results[0], results[1]))
+
+    def test_invalid_extrinsics(self):
+        ex_r = self.ex_r.copy()
+        ex_r[1, 3] = 0.1
+        with self.assertRaises(ValueError):
+            sapien.StereoDepthProcessor(
+                self.width, self.height, self.k, self.k, self.ex_l, ex_r,
+                self.width, self.height, self.k, self.ex_l,
+            )
+
+    @unittest.skipUnless(has_reference, "requires opencv-contrib, scipy and open3d")
+    def test_parity(self):
+        native = self.make_processor().compute(self.left, self.right)
+        reference = calc_main_depth_from_left_right_ir(
+            self.left, self.right, self.ex_l, self.ex_r, self.ex_l, self.k, self.k, self.k,
+            ndisp=128, use_noise=False, main_cam_size=(self.width, self.height),
+        )
+        both = (native > 0) & (reference > 0)
+        self.assertGreater(both.sum(), 0.8 * (reference > 0).sum())
+        error = np.abs(native[both] - reference[both]) / reference[both]
+        self.assertLess(np.median(error), 0.02)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,130 @@
+import unittest
+import numpy as np
+import sapien.core as sapien
+
+
+def build_box(scene, environment, z=0.5):
+    builder = scene.create_actor_builder()
+    builder.add_box_collision(half_size=[0.1, 0.1, 0.1])
+    builder.environment = environment
+    box = builder.build()
+    box.set_pose(sapien.Pose(scene.get_environment_offset(environment) + [0, 0, z]))
+    return box
+
+
+def build_arm(scene, environment, kinematic=False):
+    builder = scene.create_articulation_builder()
+    builder.environment = environment
+    base = builder.create_link_builder()
+    base.add_box_collision(half_size=[0.05, 0.05, 0.05])
+    link = builder.create_link_builder(base)
+    link.add_box_collision(sapien.Pose([0, 0, 0.15]), half_size=[0.03, 0.03, 0.15])
+    link.set_joint_properties(
+        "revolute", [[-3, 3]], sapien.Pose([0, 0, 0.1], [0.7071068, 0, -0.7071068, 0]),
+        sapien.Pose(),
+    )
+    if kinematic:
+        return builder.build_kinematic()
+    return builder.build(fix_root_link=True)
+
+
+class TestEnvironment(unittest.TestCase):
+    def setUp(self):
+        self.engine = sapien.Engine()
+        self.scene = self.engine.create_scene()
+        self.scene.set_timestep(1 / 240)
+        self.scene.add_ground(0)
+        self.envs = [self.scene.add_environment([0, 0, 0]), self.scene.add_environment([5, 0, 0])]
+
+    def step(self, count=240):
+        for _ in range(count):
+            self.scene.step()
+
+    def test_isolation(self):
+        # an overlapping environment does not collide, the shared ground does
+        env2 = self.scene.add_environment([0, 0, 0])
+        boxes = [build_box(self.scene, self.envs[0]), build_box(self.scene, env2, 0.55)]
+        self.step()
+        for box in boxes:
+            self.assertAlmostEqual(box.get_pose().p[2], 0.1, delta=0.01)
+
+    def test_collision_groups_keep_environment(self):
+        env2 = self.scene.add_environment([0, 0, 0])
+        boxes = [build_box(self.scene, self.envs[0]), build_box(self.scene, env2, 0.55)]
+        for box in boxes:
+            for shape in box.get_collision_shapes():
+                shape.set_collision_groups(1, 1, 0, 0x2345)
+        shape = boxes[1].get_collision_shapes()[0]
+        self.assertEqual(shape.get_collision_groups()[3], 0x2345 | ((env2 + 1) << 16))
+        # the high 16 bits of group 3 are not available
+        with self.assertRaises(ValueError):
+            shape.set_collision_groups(1, 1, 0, 0x12345)
+        with self.assertRaises(ValueError):
+            self.scene.create_actor_builder().set_collision_groups(1, 1, 0, 0x10000)
+        self.assertEqual(shape.get_collision_groups()[3], 0x2345 | ((env2 + 1) << 16))
+        self.step()
+        for box in boxes:
+            self.assertAlmostEqual(box.get_pose().p[2], 0.1, delta=0.01)
+
+    def test_members(self):
+        def ids(objects):
+            return [o.id for o in objects]
+
+        def root_ids(articulations):
+            return [a.get_links()[0].id for a in articulations]
+
+        boxes = [build_box(self.scene, env) for env in self.envs for _ in range(2)]
+        arms = [build_arm(self.scene, self.envs[1]), build_arm(self.scene, self.envs[1], True)]
+        actors = self.scene.get_environment_actors
+        articulations = self.scene.get_environment_articulations
+        self.assertEqual(ids(actors(self.envs[0])), ids(boxes[:2]))
+        self.assertEqual(ids(actors(self.envs[1])), ids(boxes[2:]))
+        self.assertEqual(root_ids(articulations(self.envs[1])), root_ids(arms))
+        self.assertEqual(articulations(self.envs[0]), [])
+
+        self.scene.remove_actor(boxes[0])
+        self.scene.remove_articulation(arms[0])
+        self.assertEqual(ids(actors(self.envs[0])), ids(boxes[1:2]))
+        self.assertEqual(root_ids(articulations(self.envs[1])), root_ids(arms[1:]))
+        self.step(1)
+        with self.assertRaises(RuntimeError):
+            actors(len(self.envs))
+
+    def test_pack_across_environments(self):
+        for env in self.envs:
+            build_box(self.scene, env)
+            build_arm(self.scene, env)
+            build_arm(self.scene, env, True)
+        source = self.scene.get_environment_articulations(self.envs[0])
+        for arm in source:
+            arm.set_qpos([0.7])
+            arm.set_root_pose(sapien.Pose([0.2, 0.3, 0.4]))
+        self.step(10)
+        data = self.scene.pack_environment(self.envs[0])
+        self.scene.unpack_environment(self.envs[1], data)
+
+        offset = self.scene.get_environment_offset(self.envs[1])
+        target = self.scene.get_environment_articulations(self.envs[1])
+        for a, b in zip(source, target):
+            self.assertTrue(np.allclose(a.get_qpos(), b.get_qpos(), atol=1e-5))
+            self.assertTrue(np.allclose(b.get_root_pose().p - offset, [0.2, 0.3, 0.4], atol=1e-5))
+        # kinematic links follow the unpacked joint state and root pose
+        relative = target[1].get_links()[1].get_pose().p - offset
+        self.assertTrue(np.allclose(relative, source[1].get_links()[1].get_pose().p, atol=1e-4))
+        box = self.scene.get_environment_actors(self.envs[1])[0]
+        source_box = self.scene.get_environment_actors(self.envs[0])[0]
+        self.assertTrue(np.allclose(box.get_pose().p - offset, source_box.get_pose().p, atol=1e-5))
+
+    def test_reset(self):
+        arm = build_arm(self.scene, self.envs[1], True)
+        arm.set_qpos([0.5])
+        self.scene.save_environment_state(self.envs[1])
+        arm.set_qpos([-1])
+        arm.set_root_pose(sapien.Pose([9, 9, 9]))
+        self.scene.reset_environment(self.envs[1])
+        self.assertAlmostEqual(arm.get_qpos()[0], 0.5, places=5)
+        self.assertTrue(np.allclose(arm.get_root_pose().p, [5, 0, 0], atol=1e-5))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,149 @@
+import os
+import tempfile
+import unittest
+import numpy as np
+import sapien.core as sapien
+
+
+def random_quaternions(rng, count):
+    q = rng.normal(size=(count, 4))
+    return q / np.linalg.norm(q, axis=1, keepdims=True)
+
+
+def assert_rotations_close(test, a, b, atol):
+    # q and -q are the same rotation
+    error = np.minimum(np.abs(a - b).max(axis=1), np.abs(a + b).max(axis=1))
+    test.assertLess(error.max(), atol)
+
+
+class TestEpisode(unittest.TestCase):
+    precision = 1e-3
+
+    def setUp(self):
+        self.engine = sapien.Engine()
+        self.engine.set_renderer(sapien.NullRenderer())
+        self.scene = self.engine.create_scene()
+        self.directory = tempfile.TemporaryDirectory()
+        self.filename = os.path.join(self.directory.name, "episode.sapien")
+        self.rng = np.random.default_rng(0)
+
+    def tearDown(self):
+        self.scene.stop_recording()
+        self.directory.cleanup()
+
+    def build_boxes(self, count):
+        boxes = []
+        for _ in range(count):
+            builder = self.scene.create_actor_builder()
+            builder.add_box_visual(half_size=[0.1, 0.1, 0.1])
+            boxes.append(builder.build_kinematic())
+        return boxes
+
+    def record(self, boxes, frame_count, chunk_size):
+        """random poses every frame, the deltas between frames take both signs"""
+        self.scene.start_recording(self.filename, self.precision, chunk_size)
+        frames = []
+        for _ in range(frame_count):
+            p = self.rng.uniform(-2, 2, size=(len(boxes), 3))
+            q = random_quaternions(self.rng, len(boxes))
+            for box, position, rotation in zip(boxes, p, q):
+                box.set_pose(sapien.Pose(position, rotation))
+            self.scene.update_render()
+            frames.append(np.concatenate([p, q], axis=1))
+        self.scene.stop_recording()
+        return frames
+
+    def test_poses(self):
+        boxes = self.build_boxes(6)
+        frames = self.record(boxes, 40, 16)
+        replayer = sapien.EpisodeReplayer(self.filename)
+        self.assertEqual(replayer.frame_count, 40)
+        for i in range(40):
+            frame = replayer.get_frame(i)
+            self.assertEqual(list(frame["ids"]), [box.id for box in boxes])
+            poses = frame["poses"]
+            self.assertLess(np.abs(poses[:, :3] - frames[i][:, :3]).max(), self.precision)
+            assert_rotations_close(self, poses[:, 3:], frames[i][:, 3:], 1e-4)
+            self.assertTrue(np.allclose(frame["visibility"], 1))
+
+    def test_smallest_three(self):
+        # every component is the largest once, with either sign
+        rotations = []
+        for largest in range(4):
+            for sign in [1, -1]:
+                q = np.full(4, 0.3)
+                q[(largest + 1) % 4] = -0.3
+                q[largest] = sign * 0.85
+                rotations.append(q / np.linalg.norm(q))
+        rotations.append(np.array([0.5, -0.5, 0.5, -0.5]))
+        rotations = np.array(rotations)
+        boxes = self.build_boxes(len(rotations))
+        for box, q in zip(boxes, rotations):
+            box.set_pose(sapien.Pose([0, 0, 0], q))
+        self.scene.start_recording(self.filename, self.precision)
+        self.scene.update_render()
+        self.scene.stop_recording()
+
+        poses = sapien.EpisodeReplayer(self.filename).get_frame(0)["poses"]
+        assert_rotations_close(self, poses[:, 3:], rotations, 1e-4)
+        self.assertTrue(np.allclose(np.linalg.norm(poses[:, 3:], axis=1), 1, atol=1e-6))
+
+    def test_chunk_index(self):
+        boxes = self.build_boxes(3)
+        frames = self.record(boxes, 50, 8)
+        replayer = sapien.EpisodeReplayer(self.filename)
+        self.assertEqual(replayer.chunk_count, 7)
+        self.assertEqual(replayer.frame_count, 50)
+
+        # seeking backwards and across chunks decodes the right chunk
+        for i in [49, 0, 8, 7, 48, 23, 24, 16]:
+            poses = replayer.get_frame(i)["poses"]
+            self.assertLess(np.abs(poses[:, :3] - frames[i][:, :3]).max(), self.precision)
+        with self.assertRaises(IndexError):
+            replayer.get_frame(50)
+
+    def test_objects_change_within_chunk(self):
+        boxes = self.build_boxes(2)
+        self.scene.start_recording(self.filename, self.precision, 64)
+        self.scene.update_render()
+        boxes.append(self.build_boxes(1)[0])
+        boxes[2].set_pose(sapien.Pose([1, -1, 0.5]))
+        boxes[0].hide_visual()
+        self.scene.update_render()
+        self.scene.remove_actor(boxes[1])
+        self.scene.update_render()
+        self.scene.stop_recording()
+
+        replayer = sapien.EpisodeReplayer(self.filename)
+        self.assertEqual(replayer.chunk_count, 1)
+        ids = [box.id for box in boxes]
+        self.assertEqual(list(replayer.get_frame(0)["ids"]), ids[:2])
+        frame = replayer.get_frame(1)
+        self.assertEqual(list(frame["ids"]), ids)
+        self.assertEqual(list(frame["visibility"]), [0, 1, 1])
+        self.assertTrue(np.allclose(frame["poses"][2, :3], [1, -1, 0.5], atol=self.precision))
+        self.assertEqual(list(replayer.get_frame(2)["ids"]), [ids[0], ids[2]])
+
+    def test_apply(self):
+        boxes = self.build_boxes(4)
+        frames = self.record(boxes, 20, 8)
+        replayer = sapien.EpisodeReplayer(self.filename)
+        replayer.bind([b for box in boxes for b in box.get_visual_bodies()])
+        for i in [19, 3, 12]:
+            replayer.apply(i)
+            poses = self.scene.renderer_scene.get_poses()
+            self.assertLess(np.abs(poses[:, :3] - frames[i][:, :3]).max(), self.precision)
+            assert_rotations_close(self, poses[:, 3:], frames[i][:, 3:], 1e-4)
+
+    def test_incomplete_file(self):
+        self.build_boxes(1)
+        self.scene.start_recording(self.filename, self.precision)
+        self.scene.update_render()
+        with self.assertRaises(RuntimeError):
+            sapien.EpisodeReplayer(self.filename)
+        self.scene.stop_recording()
+        self.assertEqual(sapien.EpisodeReplayer(self.filename).frame_count, 1)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,82 @@
+import os
+import tempfile
+import unittest
+import numpy as np
+import sapien.core as sapien
+
+try:
+    from PIL import Image
+
+    has_pillow = True
+except ImportError:
+    has_pillow = False
+
+
+class TestHeightField(unittest.TestCase):
+    def setUp(self):
+        self.engine = sapien.Engine()
+        self.scene = self.engine.create_scene()
+
+    def test_quantization_range(self):
+        # a small relief far from zero keeps the precision of its own range
+        rng = np.random.default_rng(0)
+        heights = 10 + 0.5 * rng.random((16, 24))
+        field = self.engine.create_height_field(heights, [0.1, 0.2, 2])
+        self.assertEqual((field.rows, field.columns), (16, 24))
+        self.assertLess(np.abs(field.heights - heights * 2).max(), 1e-4)
+        self.assertAlmostEqual(field.vertices[:, 2].min(), heights.min() * 2, places=4)
+
+    def test_shape_surface(self):
+        heights = np.full((8, 8), 5.0)
+        heights[4, 4] = 6
+        field = self.engine.create_height_field(heights)
+        builder = self.scene.create_actor_builder()
+        builder.add_height_field_collision(field)
+        ground = builder.build_static()
+        self.assertEqual(len(ground.get_collision_shapes()), 1)
+
+        builder = self.scene.create_actor_builder()
+        builder.add_sphere_collision(radius=0.1)
+        ball = builder.build()
+        ball.set_pose(sapien.Pose([1.5, 1.5, 5.5]))
+        for _ in range(200):
+            self.scene.step()
+        self.assertAlmostEqual(ball.get_pose().p[2], 5.1, delta=0.02)
+
+    def test_dynamic_actor_rejected(self):
+        field = self.engine.create_height_field(np.zeros((4, 4)))
+        builder = self.scene.create_actor_builder()
+        builder.add_height_field_collision(field)
+        with self.assertRaises(RuntimeError):
+            builder.build()
+        self.assertIsNotNone(builder.build_kinematic())
+
+        builder = self.scene.create_articulation_builder()
+        builder.create_link_builder().add_height_field_collision(field)
+        self.assertIsNone(builder.build())
+        self.assertIsNotNone(builder.build_kinematic())
+
+    @unittest.skipUnless(has_pillow, "requires Pillow")
+    def test_image_bit_depth(self):
+        with tempfile.TemporaryDirectory() as d:
+            pixels = np.array([[0, 1000], [30000, 65535]], dtype=np.uint16)
+            filename = os.path.join(d, "16.png")
+            Image.fromarray(pixels).save(filename)
+            field = self.engine.create_height_field_from_image(filename)
+            self.assertTrue(np.allclose(field.heights, pixels / 65535, atol=1e-4))
+
+            pixels = np.array([[0, 10], [128, 255]], dtype=np.uint8)
+            filename = os.path.join(d, "8.png")
+            Image.fromarray(pixels).save(filename)
+            field = self.engine.create_height_field_from_image(filename)
+            self.assertTrue(np.allclose(field.heights, pixels / 255, atol=1e-4))
+
+            pixels = np.array([[-1.5, 0], [2, 3.25]], dtype=np.float32)
+            filename = os.path.join(d, "f.tiff")
+            Image.fromarray(pixels).save(filename)
+            field = self.engine.create_height_field_from_image(filename)
+            self.assertTrue(np.allclose(field.heights, pixels, atol=1e-4))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,57 @@
+import unittest
+import numpy as np
+import sapien.core as sapien
+
+
+class TestImageReadback(unittest.TestCase):
+    # more pixels than one conversion block, so conversions run on several threads
+    width, height = 256, 192
+
+    def setUp(self):
+        self.engine = sapien.Engine()
+        self.renderer = sapien.CpuRenderer(thread_count=2)
+        self.engine.set_renderer(self.renderer)
+        self.scene = self.engine.create_scene()
+        builder = self.scene.create_actor_builder()
+        builder.add_box_visual(half_size=[0.2, 0.2, 0.2], color=[0.8, 0.2, 0.2])
+        builder.build_kinematic()
+        # looking along +x at the box from 2 m away
+        self.camera = self.scene.add_camera("", self.width, self.height, 1, 0.1, 10)
+        self.camera.set_local_pose(sapien.Pose([-2, 0, 0]))
+        self.scene.update_render()
+        self.camera.take_picture()
+
+    def tearDown(self):
+        self.camera = None
+        self.scene = None
+
+    def test_color_rgb8(self):
+        color = self.camera.get_float_texture("Color")
+        rgb = self.camera.get_color_rgb8()
+        self.assertEqual(rgb.dtype, np.uint8)
+        self.assertEqual(rgb.shape, (self.height, self.width, 3))
+        expected = np.floor(np.clip(color[..., :3], 0, 1) * 255 + 0.5).astype(np.uint8)
+        self.assertTrue(np.array_equal(rgb, expected))
+
+    def test_float16(self):
+        for name in ["Color", "Position"]:
+            image = self.camera.get_float_texture(name)
+            half = self.camera.get_float16_texture(name)
+            self.assertEqual(half.dtype, np.float16)
+            self.assertEqual(half.shape, image.shape)
+            # numpy rounds to nearest even as well
+            self.assertTrue(np.array_equal(half, image.astype(np.float16)))
+
+    def test_depth(self):
+        position = self.camera.get_float_texture("Position")
+        depth = self.camera.get_depth()
+        self.assertEqual(depth.shape, (self.height, self.width))
+        expected = np.where(position[..., 3] < 1, -position[..., 2], 0)
+        self.assertTrue(np.array_equal(depth, expected))
+        self.assertTrue(np.array_equal(depth, self.camera.get_float_texture("Depth")))
+        self.assertAlmostEqual(depth[self.height // 2, self.width // 2], 1.8, places=4)
+        self.assertEqual(depth[0, 0], 0)
+
+
+if __name__ == "__main__":
+    unittest.main()
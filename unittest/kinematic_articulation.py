@@ -0,0 +1,144 @@
+import unittest
+import numpy as np
+import sapien.core as sapien
+
+
+def build_tree(scene):
+    """root -> fixed -> revolute -> prismatic, and a revolute branch off the root
+
+    The branch is created last, so the order of the joints differs from their topological order.
+    """
+    builder = scene.create_articulation_builder()
+    root = builder.create_link_builder()
+    root.add_box_collision(half_size=[0.02, 0.02, 0.02])
+
+    def add(parent, joint_type, limits, parent_pose):
+        child = builder.create_link_builder(parent)
+        child.add_box_collision(half_size=[0.02, 0.02, 0.02])
+        child.set_joint_properties(
+            joint_type, limits, parent_pose, sapien.Pose([0.05, 0, 0], [0, 0, 1, 0])
+        )
+        return child
+
+    fixed = add(
+        root, "fixed", np.zeros((0, 2)), sapien.Pose([0, 0, 0.2], [0.7071068, 0, 0.7071068, 0])
+    )
+    revolute = add(fixed, "revolute", [[-1, 1]], sapien.Pose([0.2, 0, 0]))
+    add(
+        revolute,
+        "prismatic",
+        [[-0.1, 0.3]],
+        sapien.Pose([0, 0.2, 0], [0.7071068, 0.7071068, 0, 0]),
+    )
+    add(root, "revolute", [[-3, 3]], sapien.Pose([0, 0, -0.2]))
+    return builder.build_kinematic()
+
+
+def reference_step(pos, vel, drive, dt):
+    """the per-joint update kinematic joints ran before their state moved into arrays"""
+    f = np.float32
+    for i, (target, velocity_target, stiffness, damping, max_velocity, limits) in enumerate(drive):
+        acc = f(stiffness) * (f(target) - pos[i]) + f(damping) * (f(velocity_target) - vel[i])
+        vel[i] = np.clip(vel[i] + acc * f(dt), -f(max_velocity), f(max_velocity))
+        pos[i] = np.clip(pos[i] + vel[i] * f(dt), f(limits[0]), f(limits[1]))
+
+
+def joint_pose(joint, q):
+    if joint.type == "revolute":
+        return sapien.Pose([0, 0, 0], [np.cos(q / 2), np.sin(q / 2), 0, 0])
+    return sapien.Pose([q, 0, 0])
+
+
+class TestKinematicArticulation(unittest.TestCase):
+    def setUp(self):
+        self.engine = sapien.Engine()
+        self.scene = self.engine.create_scene()
+        self.scene.set_timestep(0.01)
+        self.art = build_tree(self.scene)
+        self.joints = [j for j in self.art.get_joints() if j.get_dof()]
+
+    def tearDown(self):
+        self.art = None
+        self.scene = None
+
+    def test_joint_order(self):
+        self.assertEqual(self.art.dof, 3)
+        self.assertEqual([j.type for j in self.joints], ["revolute", "prismatic", "revolute"])
+        expected = [[-1, 1], [-0.1, 0.3], [-3, 3]]
+        self.assertTrue(np.allclose(self.art.get_qlimits(), expected))
+        for joint, limits in zip(self.joints, expected):
+            self.assertTrue(np.allclose(joint.get_limits(), [limits]))
+
+        self.art.set_qpos([0.5, 0.2, -2])
+        self.assertTrue(np.allclose(self.art.get_qpos(), [0.5, 0.2, -2]))
+        # positions are clamped to the limits
+        self.art.set_qpos([2, -1, 0.5])
+        self.assertTrue(np.allclose(self.art.get_qpos(), [1, -0.1, 0.5]))
+        self.art.set_qvel([0.1, -0.2, 0.3])
+        self.assertTrue(np.allclose(self.art.get_qvel(), [0.1, -0.2, 0.3]))
+        with self.assertRaises(RuntimeError):
+            self.art.set_qpos([0, 0])
+
+    def test_drive_target(self):
+        self.assertTrue(np.array_equal(self.art.get_drive_target(), [0, 0, 0]))
+        self.art.set_drive_target([0.3, 0.1, -0.5])
+        self.assertTrue(np.allclose(self.art.get_drive_target(), [0.3, 0.1, -0.5]))
+        # targets are not clamped
+        self.art.set_drive_target([5, 0.1, -0.5])
+        self.assertTrue(np.allclose(self.art.get_drive_target(), [5, 0.1, -0.5]))
+
+    def test_integration_matches_reference(self):
+        # target, velocity target, stiffness, damping, max velocity, limits
+        drive = [
+            (0.8, 0.2, 50, 5, 2, (-1, 1)),
+            (0.5, 0, 100, 20, 0.5, (-0.1, 0.3)),
+            (0, 0, 0, 0, 3.4e38, (-3, 3)),
+        ]
+        for joint, (_, velocity_target, stiffness, damping, max_velocity, _) in zip(
+            self.joints, drive
+        ):
+            joint.set_drive_property(stiffness, damping, max_velocity)
+            joint.set_drive_velocity_target([velocity_target])
+        fixed = [j for j in self.art.get_joints() if j.type == "fixed"]
+        self.assertTrue(fixed)
+        for joint in fixed:
+            joint.set_drive_property(10, 1)
+            joint.set_drive_velocity_target([])
+        self.art.set_drive_target([d[0] for d in drive])
+        self.art.set_qpos([-0.5, 0, 2.5])
+        self.art.set_qvel([0, 0.1, 1.5])
+
+        pos = np.array([-0.5, 0, 2.5], dtype=np.float32)
+        vel = np.array([0, 0.1, 1.5], dtype=np.float32)
+        for _ in range(300):
+            self.scene.step()
+            reference_step(pos, vel, drive, 0.01)
+            self.assertTrue(np.allclose(self.art.get_qpos(), pos, atol=1e-4))
+            self.assertTrue(np.allclose(self.art.get_qvel(), vel, atol=1e-4))
+        # the first drive settled where its position and velocity terms cancel, the second
+        # at its limit, and the undriven joint stopped at its limit
+        self.assertTrue(np.allclose(self.art.get_qpos(), [0.82, 0.3, 3], atol=1e-3))
+
+    def test_link_poses_follow_qpos(self):
+        self.art.set_root_pose(sapien.Pose([0.3, -0.2, 1], [0.9238795, 0, 0, 0.3826834]))
+        self.art.set_qvel([0.4, 0.2, -0.6])
+        for _ in range(10):
+            self.scene.step()
+
+        qpos = dict(zip([j.get_child_link().get_id() for j in self.joints], self.art.get_qpos()))
+        for joint in self.art.get_joints():
+            parent = joint.get_parent_link()
+            if parent is None:
+                continue
+            child = joint.get_child_link()
+            local = joint.get_pose_in_parent()
+            if joint.get_dof():
+                local = local * joint_pose(joint, qpos[child.get_id()])
+            expected = parent.get_pose() * local * joint.get_pose_in_child().inv()
+            pose = child.get_pose()
+            self.assertTrue(abs(pose.p - expected.p).max() < 1e-5)
+            self.assertTrue(abs(abs(pose.q @ expected.q) - 1) < 1e-5)
+
+
+if __name__ == "__main__":
+    unittest.main()
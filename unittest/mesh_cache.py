@@ -0,0 +1,89 @@
+import os
+import tempfile
+import unittest
+import sapien.core as sapien
+
+
+def write_grid(filename, n):
+    """n x n grid of quads in the xy plane"""
+    lines = ["v {} {} 0".format(x, y) for x in range(n) for y in range(n)]
+    for x in range(n - 1):
+        for y in range(n - 1):
+            a = x * n + y + 1
+            lines.append("f {} {} {} {}".format(a, a + n, a + n + 1, a + 1))
+    with open(filename, "w") as f:
+        f.write("\n".join(lines))
+
+
+class TestMeshCache(unittest.TestCase):
+    def setUp(self):
+        self.dir = tempfile.TemporaryDirectory()
+        self.engine = sapien.Engine()
+        self.engine.set_renderer(sapien.NullRenderer())
+        self.scene = self.engine.create_scene()
+        self.capacity = sapien.Engine.mesh_cache_capacity
+
+    def tearDown(self):
+        sapien.Engine.mesh_cache_capacity = self.capacity
+        del self.scene
+        self.dir.cleanup()
+
+    def decode(self, filename):
+        """decode the file through a visual body and return its vertex count"""
+        builder = self.scene.create_actor_builder()
+        builder.add_visual_from_file(filename)
+        actor = builder.build_kinematic()
+        shapes = actor.get_visual_bodies()[0].get_render_shapes()
+        self.scene.remove_actor(actor)
+        return sum(len(s.mesh.vertices) for s in shapes)
+
+    def test_visual_and_collision_share_decoded_file(self):
+        filename = os.path.join(self.dir.name, "shared.obj")
+        write_grid(filename, 8)
+        builder = self.scene.create_actor_builder()
+        builder.add_multiple_collisions_from_file(filename)
+        builder.build_kinematic()
+        size = sapien.Engine.get_mesh_cache_size()
+        self.assertGreater(self.decode(filename), 0)
+        self.assertEqual(sapien.Engine.get_mesh_cache_size(), size)
+
+    def test_changed_file_replaces_entry(self):
+        filename = os.path.join(self.dir.name, "changed.obj")
+        write_grid(filename, 4)
+        before = sapien.Engine.get_mesh_cache_size()
+        small_count = self.decode(filename)
+        small = sapien.Engine.get_mesh_cache_size() - before
+
+        write_grid(filename, 32)
+        stat = os.stat(filename)
+        os.utime(filename, (stat.st_atime, stat.st_mtime + 10))
+        self.assertGreater(self.decode(filename), small_count)
+        large = sapien.Engine.get_mesh_cache_size() - before
+        self.assertGreater(large, small)
+
+        copy = os.path.join(self.dir.name, "copy.obj")
+        write_grid(copy, 32)
+        self.decode(copy)
+        self.assertEqual(sapien.Engine.get_mesh_cache_size() - before, 2 * large)
+
+    def test_capacity(self):
+        files = []
+        for i in range(4):
+            files.append(os.path.join(self.dir.name, "grid{}.obj".format(i)))
+            write_grid(files[-1], 32)
+        self.decode(files[0])
+        sapien.Engine.mesh_cache_capacity = 0
+        self.assertEqual(sapien.Engine.get_mesh_cache_size(), 0)
+
+        # the most recent file is always kept
+        self.decode(files[1])
+        one = sapien.Engine.get_mesh_cache_size()
+        self.assertGreater(one, 0)
+        sapien.Engine.mesh_cache_capacity = 2 * one
+        for filename in files:
+            self.assertGreater(self.decode(filename), 0)
+            self.assertLessEqual(sapien.Engine.get_mesh_cache_size(), 2 * one)
+
+
+if __name__ == "__main__":
+    unittest.main()
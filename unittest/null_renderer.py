@@ -0,0 +1,95 @@
+import unittest
+import numpy as np
+import sapien.core as sapien
+
+
+def pose_row(pose):
+    return np.concatenate([pose.p, pose.q])
+
+
+class TestNullRenderer(unittest.TestCase):
+    def setUp(self):
+        self.engine = sapien.Engine()
+        self.engine.set_renderer(sapien.NullRenderer())
+        self.scene = self.engine.create_scene()
+        self.scene.set_timestep(1 / 240)
+        self.record = self.scene.renderer_scene
+
+    def build_box(self, z):
+        # one visual body, the collision shape adds a hidden body
+        builder = self.scene.create_actor_builder()
+        builder.add_box_collision(half_size=[0.1, 0.1, 0.1])
+        builder.add_box_visual(half_size=[0.1, 0.1, 0.1], color=[0.8, 0.2, 0.2])
+        box = builder.build()
+        box.set_pose(sapien.Pose([0, 0, z]))
+        return box
+
+    def run_steps(self, actor, count):
+        poses = []
+        for _ in range(count):
+            self.scene.step()
+            self.scene.update_render()
+            poses.append(pose_row(actor.get_pose()))
+        return np.array(poses)
+
+    def test_record(self):
+        box = self.build_box(1)
+        self.record.recording = True
+        poses = self.run_steps(box, 20)
+        self.assertEqual(self.record.frame_count, 20)
+        for i in [0, 19]:
+            frame = self.record.get_frame_poses(i)
+            self.assertEqual(frame.shape, (2, 7))
+            self.assertTrue(np.allclose(frame[0], poses[i], atol=1e-6))
+            self.assertEqual(list(self.record.get_frame_visibility(i)), [1, 0])
+        self.assertTrue(np.allclose(self.record.get_poses(), self.record.get_frame_poses(19)))
+
+        self.record.recording = False
+        self.run_steps(box, 5)
+        self.assertEqual(self.record.frame_count, 20)
+        self.record.clear_frames()
+        self.assertEqual(self.record.frame_count, 0)
+
+    def test_replay(self):
+        box = self.build_box(1)
+        self.scene.add_directional_light([0, 1, -1], [0.5, 0.5, 0.5])
+        self.record.recording = True
+        self.run_steps(box, 30)
+
+        replay_scene = self.engine.create_scene()
+        target = replay_scene.renderer_scene
+        bodies = self.record.instantiate(target)
+        self.assertEqual(len(bodies), 2)
+        # instantiated at the current poses
+        self.assertTrue(np.allclose(target.get_poses(), self.record.get_poses()))
+
+        for i in [0, 15, 29]:
+            self.record.apply_frame(i, bodies)
+            self.assertTrue(np.allclose(target.get_poses(), self.record.get_frame_poses(i)))
+            self.assertTrue(
+                np.array_equal(target.get_visibility(), self.record.get_frame_visibility(i))
+            )
+
+    def test_removed_body_keeps_slots(self):
+        first = self.build_box(1)
+        second = self.build_box(2)
+        self.scene.remove_actor(first)
+        self.scene.step()
+        self.record.recording = True
+        poses = self.run_steps(second, 3)
+
+        frame = self.record.get_frame_poses(2)
+        self.assertEqual(frame.shape, (4, 7))
+        self.assertTrue(np.allclose(frame[2], poses[2], atol=1e-6))
+        self.assertEqual(self.record.get_frame_visibility(2)[0], 0)
+
+        replay_scene = self.engine.create_scene()
+        bodies = self.record.instantiate(replay_scene.renderer_scene)
+        self.assertEqual(len(bodies), 4)
+        self.assertIsNone(bodies[0])
+        self.assertIsNone(bodies[1])
+        self.assertIsNotNone(bodies[2])
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,116 @@
+import unittest
+import numpy as np
+import sapien.core as sapien
+
+
+def build_tree(scene):
+    """fixed, rotated revolute, continuous, prismatic joints and a branch created last"""
+    builder = scene.create_articulation_builder()
+    root = builder.create_link_builder()
+    root.add_box_collision(half_size=[0.1, 0.1, 0.1])
+
+    def add(parent, joint_type, limits, parent_pose, half_size):
+        child = builder.create_link_builder(parent)
+        child.add_box_collision(sapien.Pose([0.02, 0.01, 0]), half_size=half_size)
+        child_pose = sapien.Pose([0.05, 0, 0], [0.9238795, 0, 0.3826834, 0])
+        child.set_joint_properties(joint_type, limits, parent_pose, child_pose)
+        return child
+
+    fixed = add(
+        root,
+        "fixed",
+        np.zeros((0, 2)),
+        sapien.Pose([0, 0, 0.2], [0.7071068, 0, 0.7071068, 0]),
+        [0.05, 0.03, 0.02],
+    )
+    revolute = add(
+        fixed,
+        "revolute",
+        [[-1.5, 1.5]],
+        sapien.Pose([0.2, 0, 0], [0.7071068, 0.7071068, 0, 0]),
+        [0.1, 0.02, 0.02],
+    )
+    continuous = add(
+        revolute, "revolute", [[-np.inf, np.inf]], sapien.Pose([0, 0.2, 0.1]), [0.04, 0.04, 0.1]
+    )
+    add(
+        continuous,
+        "prismatic",
+        [[-0.2, 0.3]],
+        sapien.Pose([0.1, 0, 0], [0.9238795, 0, 0, 0.3826834]),
+        [0.03, 0.06, 0.03],
+    )
+    add(root, "revolute", [[-3, 3]], sapien.Pose([0, 0, -0.2]), [0.02, 0.02, 0.08])
+    return builder.build(fix_root_link=True)
+
+
+@unittest.skipUnless(hasattr(sapien.Articulation, "create_pinocchio_model"), "no Pinocchio")
+class TestPinocchioModel(unittest.TestCase):
+    def setUp(self):
+        self.engine = sapien.Engine()
+        self.scene = self.engine.create_scene()
+        self.art = build_tree(self.scene)
+        self.model = self.art.create_pinocchio_model()
+        self.urdf_model = self.art.create_pinocchio_model_from_urdf()
+        self.qpos = [[0.7, -2.5, 0.1, 1.2], [-1.2, 3, -0.15, -2.5], [0, 0, 0, 0]]
+
+    def tearDown(self):
+        self.art = None
+        self.scene = None
+
+    def assert_pose_equal(self, a, b, eps=1e-5):
+        self.assertTrue(abs(a.p - b.p).max() < eps)
+        self.assertTrue(abs(abs(a.q @ b.q) - 1) < eps)
+
+    def test_forward_kinematics(self):
+        self.assertEqual(self.art.dof, 4)
+        for qpos in self.qpos:
+            self.art.set_qpos(qpos)
+            self.art.update_link_poses()
+            self.model.compute_forward_kinematics(qpos)
+            self.urdf_model.compute_forward_kinematics(qpos)
+            # links are indexed like the articulation's links in both models
+            for link in self.art.get_links():
+                index = link.get_index()
+                self.assert_pose_equal(self.model.get_link_pose(index), link.get_pose())
+                # the exported URDF keeps 6 significant digits
+                self.assert_pose_equal(
+                    self.model.get_link_pose(index), self.urdf_model.get_link_pose(index), 1e-4
+                )
+
+    def test_dynamics(self):
+        qvel = [0.3, -0.5, 0.2, 1.0]
+        qacc = [-1.0, 0.4, 2.0, 0.1]
+        for qpos in self.qpos:
+            # only the upper triangle is computed
+            mass = np.triu(self.model.compute_generalized_mass_matrix(qpos))
+            expected = np.triu(self.urdf_model.compute_generalized_mass_matrix(qpos))
+            self.assertTrue(np.allclose(mass, expected, rtol=1e-4, atol=1e-6))
+            self.assertGreater(np.diag(mass).min(), 0)
+            self.assertTrue(
+                np.allclose(
+                    self.model.compute_inverse_dynamics(qpos, qvel, qacc),
+                    self.urdf_model.compute_inverse_dynamics(qpos, qvel, qacc),
+                    rtol=1e-4,
+                    atol=1e-5,
+                )
+            )
+
+    def test_jacobian(self):
+        qpos = self.qpos[0]
+        self.model.compute_full_jacobian(qpos)
+        self.urdf_model.compute_full_jacobian(qpos)
+        for link in self.art.get_links():
+            index = link.get_index()
+            for local in [False, True]:
+                self.assertTrue(
+                    np.allclose(
+                        self.model.get_link_jacobian(index, local),
+                        self.urdf_model.get_link_jacobian(index, local),
+                        atol=1e-4,
+                    )
+                )
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,128 @@
+import unittest
+import numpy as np
+import sapien.core as sapien
+
+
+def voxel_keys(xyz, size):
+    # the same float32 operations as the builder
+    return np.floor(xyz * (np.float32(1) / np.float32(size))).astype(np.int64)
+
+
+class TestPointCloudBuilder(unittest.TestCase):
+    width, height = 64, 48
+
+    def setUp(self):
+        self.engine = sapien.Engine()
+        self.renderer = sapien.CpuRenderer(thread_count=2)
+        self.engine.set_renderer(self.renderer)
+        self.scene = self.engine.create_scene()
+        self.boxes = [self.build_box([0, 0, 0]), self.build_box([0, 0.6, 0])]
+        # looking along +x at the boxes from 2 m away, and down at them from 2 m above
+        self.cameras = []
+        for pose in [
+            sapien.Pose([-2, 0.3, 0]),
+            sapien.Pose([0, 0.3, 2], [0.7071068, 0, 0.7071068, 0]),
+        ]:
+            camera = self.scene.add_camera("", self.width, self.height, 1.2, 0.1, 10)
+            camera.set_local_pose(pose)
+            self.cameras.append(camera)
+        self.scene.update_render()
+        for camera in self.cameras:
+            camera.take_picture()
+
+    def tearDown(self):
+        self.cameras = None
+        self.scene = None
+
+    def build_box(self, p):
+        builder = self.scene.create_actor_builder()
+        builder.add_box_visual(half_size=[0.2, 0.2, 0.2])
+        box = builder.build_kinematic()
+        box.set_pose(sapien.Pose(p))
+        return box
+
+    def assert_on_surface(self, cloud):
+        """every point lies on the surface of the box its label names"""
+        centers = {box.id: box.get_pose().p for box in self.boxes}
+        for point, label in zip(cloud["xyz"], cloud["label"]):
+            distance = np.abs(point - centers[label])
+            self.assertLess(distance.max(), 0.2 + 1e-4)
+            self.assertAlmostEqual(distance.max(), 0.2, places=4)
+
+    def test_world_points(self):
+        builder = sapien.PointCloudBuilder(2)
+        front = builder.build(self.cameras[:1], with_color=True, with_label=True)
+        top = builder.build(self.cameras[1:], with_label=True)
+        xyz = front["xyz"]
+        self.assertGreater(len(xyz), 0)
+        self.assertEqual(front["rgb"].shape, xyz.shape)
+        self.assertEqual(front["label"].shape, (len(xyz),))
+        self.assert_on_surface(front)
+        self.assert_on_surface(top)
+        # faces turned away from a camera are not seen
+        self.assertTrue(np.all(xyz[:, 0] < 0.2 - 1e-4))
+        self.assertTrue(np.all(top["xyz"][:, 2] > -0.2 + 1e-4))
+
+        both = builder.build(self.cameras)
+        self.assertTrue(np.array_equal(both["xyz"], np.concatenate([xyz, top["xyz"]])))
+
+    def test_depth_range(self):
+        builder = sapien.PointCloudBuilder(2)
+        builder.set_depth_range(0, 1.5)
+        self.assertEqual(len(builder.build(self.cameras[:1])["xyz"]), 0)
+        builder.set_depth_range(1.7, 1.9)
+        xyz = builder.build(self.cameras[:1])["xyz"]
+        self.assertGreater(len(xyz), 0)
+        self.assertLess(len(xyz), len(sapien.PointCloudBuilder(2).build(self.cameras[:1])["xyz"]))
+        # the front camera looks along +x from x = -2
+        depth = xyz[:, 0] + 2
+        self.assertTrue(np.all((depth > 1.7 - 1e-4) & (depth < 1.9 + 1e-4)))
+        with self.assertRaises(ValueError):
+            builder.set_depth_range(2, 1)
+
+    def test_segmentation_filter(self):
+        builder = sapien.PointCloudBuilder(2)
+        builder.set_segmentation_filter([self.boxes[1].id])
+        cloud = builder.build(self.cameras, with_label=True)
+        self.assertGreater(len(cloud["xyz"]), 0)
+        self.assertTrue(np.all(cloud["label"] == self.boxes[1].id))
+        self.assertTrue(np.all(cloud["xyz"][:, 1] > 0.4 - 1e-4))
+
+        visual_id = self.boxes[0].get_visual_bodies()[0].get_visual_id()
+        builder.set_segmentation_filter([visual_id], 0)
+        cloud = builder.build(self.cameras, with_label=True)
+        self.assertTrue(np.all(cloud["label"] == visual_id))
+        self.assertTrue(np.all(cloud["xyz"][:, 1] < 0.2 + 1e-4))
+        with self.assertRaises(ValueError):
+            builder.set_segmentation_filter([], 2)
+
+    def test_voxel_downsampling(self):
+        builder = sapien.PointCloudBuilder(2)
+        full = builder.build(self.cameras, with_label=True)
+        builder.voxel_size = 0.15
+        cloud = builder.build(self.cameras, with_color=True, with_label=True)
+        xyz = cloud["xyz"]
+        self.assertLess(len(xyz), len(full["xyz"]))
+
+        # one point per occupied voxel, at the mean of its points
+        keys = voxel_keys(full["xyz"], 0.15)
+        self.assertEqual(len(xyz), len(np.unique(keys, axis=0)))
+        for point in xyz:
+            inside = np.all(keys == voxel_keys(point, 0.15), axis=1)
+            members = full["xyz"][inside].astype(np.float64)
+            self.assertTrue(np.allclose(point, members.mean(axis=0), atol=1e-5))
+        self.assertTrue(set(cloud["label"]) <= {box.id for box in self.boxes})
+
+        # the result does not depend on the thread count
+        for threads in [1, 5]:
+            other = sapien.PointCloudBuilder(threads)
+            other.voxel_size = 0.15
+            result = other.build(self.cameras, with_color=True, with_label=True)
+            for name in ["xyz", "rgb", "label"]:
+                self.assertTrue(np.array_equal(result[name], cloud[name]))
+        with self.assertRaises(ValueError):
+            builder.voxel_size = -1
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,115 @@
+import unittest
+import numpy as np
+import sapien.core as sapien
+
+
+def take_pictures(cameras):
+    for camera in cameras:
+        camera.take_picture()
+
+
+class TestSharedCamera(unittest.TestCase):
+    width, height = 32, 24
+
+    def setUp(self):
+        self.engine = sapien.Engine()
+        self.renderer = sapien.VulkanRenderer(True)
+        self.engine.set_renderer(self.renderer)
+
+    def tearDown(self):
+        self.renderer.share_camera_targets = False
+
+    def build_scene(self, box_x=0):
+        scene = self.engine.create_scene()
+        scene.set_ambient_light([0.5, 0.5, 0.5])
+        builder = scene.create_actor_builder()
+        builder.add_box_visual(half_size=[0.2, 0.2, 0.2], color=[0.8, 0.2, 0.2])
+        builder.build_kinematic().set_pose(sapien.Pose([box_x, 0, 0]))
+        return scene
+
+    def add_camera(self, scene, distance):
+        # looking along +x at the origin
+        camera = scene.add_camera("", self.width, self.height, 1, 0.1, 10)
+        camera.set_local_pose(sapien.Pose([-distance, 0, 0]))
+        return camera
+
+    def center_depth(self, camera):
+        return -camera.get_float_texture("Position")[self.height // 2, self.width // 2, 2]
+
+    def test_images_match_unshared(self):
+        scene = self.build_scene()
+        own = self.add_camera(scene, 2)
+        self.renderer.share_camera_targets = True
+        shared = [self.add_camera(scene, 2), self.add_camera(scene, 3)]
+        scene.update_render()
+        take_pictures([own] + shared)
+
+        self.assertTrue(
+            np.array_equal(
+                shared[0].get_float_texture("Position"), own.get_float_texture("Position")
+            )
+        )
+        self.assertTrue(
+            np.array_equal(
+                shared[0].get_uint32_texture("Segmentation"),
+                own.get_uint32_texture("Segmentation"),
+            )
+        )
+        # each camera reads its own picture from the shared targets
+        self.assertAlmostEqual(self.center_depth(shared[0]), 1.8, places=4)
+        self.assertAlmostEqual(self.center_depth(shared[1]), 2.8, places=4)
+
+    def test_memory_stats(self):
+        scene = self.build_scene()
+        own = self.add_camera(scene, 2)
+        self.renderer.share_camera_targets = True
+        shared = [self.add_camera(scene, 2), self.add_camera(scene, 3)]
+        scene.update_render()
+        take_pictures([own] + shared)
+        first = [c.get_memory_stats() for c in shared]
+        take_pictures([own] + shared)
+        stats = [c.get_memory_stats() for c in [own] + shared]
+
+        self.assertEqual([s["sharing_cameras"] for s in stats], [1, 2, 2])
+        self.assertEqual(stats[0]["readback_bytes"], 0)
+        self.assertEqual(stats[1]["render_target_bytes"], stats[2]["render_target_bytes"])
+        # every readable target is copied into two alternating sets of buffers
+        for before, after in zip(first, stats[1:]):
+            self.assertGreater(before["readback_bytes"], 0)
+            self.assertEqual(after["readback_bytes"], 2 * before["readback_bytes"])
+        self.assertEqual(len(self.renderer.get_camera_memory_stats()), 3)
+
+    def test_across_scenes(self):
+        self.renderer.share_camera_targets = True
+        scenes = [self.build_scene(0), self.build_scene(1)]
+        cameras = [self.add_camera(scene, 2) for scene in scenes]
+        for _ in range(2):
+            for scene, camera in zip(scenes, cameras):
+                scene.update_render()
+                camera.take_picture()
+            self.assertAlmostEqual(self.center_depth(cameras[0]), 1.8, places=4)
+            self.assertAlmostEqual(self.center_depth(cameras[1]), 2.8, places=4)
+        self.assertEqual([c.get_memory_stats()["sharing_cameras"] for c in cameras], [2, 2])
+
+        # the remaining camera renders its own scene after the other one is gone
+        scenes[0].remove_camera(cameras[0])
+        scenes[0] = None
+        self.assertEqual(cameras[1].get_memory_stats()["sharing_cameras"], 1)
+        scenes[1].update_render()
+        cameras[1].take_picture()
+        self.assertAlmostEqual(self.center_depth(cameras[1]), 2.8, places=4)
+
+    def test_new_camera_after_all_removed(self):
+        self.renderer.share_camera_targets = True
+        scene = self.build_scene()
+        camera = self.add_camera(scene, 2)
+        scene.remove_camera(camera)
+        camera = self.add_camera(scene, 3)
+        self.assertEqual(camera.get_memory_stats()["sharing_cameras"], 1)
+        scene.update_render()
+        camera.take_picture()
+        self.assertAlmostEqual(self.center_depth(camera), 2.8, places=4)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -129,3 +129,29 @@ class TestCamera(unittest.TestCase):
         ]
         self.assertTrue(np.allclose(model, gt_model))
         self.assertTrue(np.allclose(proj, gt_proj))
+
+    def test_segmentation_tables(self):
+        engine = sapien.Engine()
+        renderer = sapien.VulkanRenderer(True)
+        engine.set_renderer(renderer)
+
+        scene = engine.create_scene()
+        b = scene.create_actor_builder()
+        b.add_box_visual(half_size=[0.2, 0.2, 0.2], name="box")
+        actor = b.build_kinematic()
+        cam = scene.add_camera("", 32, 32, 1, 0.1, 10)
+        cam.set_local_pose(sapien.Pose([-1, 0, 0]))
+
+        scene.update_render()
+        cam.take_picture()
+        seg = cam.get_visual_actor_segmentation()
+        remapped = scene.visual_id_to_actor_id[seg[..., 0]]
+        self.assertTrue(np.array_equal(remapped, seg[..., 1]))
+        self.assertTrue((remapped == actor.get_id()).any())
+
+        visual_id = actor.get_visual_bodies()[0].get_visual_id()
+        self.assertEqual(scene.visual_id_to_name[visual_id], "box")
+        self.assertEqual(scene.render_id_to_visual_name, {visual_id: "box"})
+
+        scene.remove_actor(actor)
+        self.assertEqual(scene.visual_id_to_actor_id[visual_id], 0)
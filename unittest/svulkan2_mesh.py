@@ -0,0 +1,91 @@
+import os
+import struct
+import tempfile
+import unittest
+import zlib
+import numpy as np
+import sapien.core as sapien
+
+
+def write_png(filename, width, height):
+    """opaque RGBA image"""
+    rows = b"".join(b"\x00" + b"\xff\x80\x40\xff" * width for _ in range(height))
+
+    def chunk(tag, data):
+        return (
+            struct.pack(">I", len(data))
+            + tag
+            + data
+            + struct.pack(">I", zlib.crc32(tag + data) & 0xFFFFFFFF)
+        )
+
+    with open(filename, "wb") as f:
+        f.write(b"\x89PNG\r\n\x1a\n")
+        f.write(chunk(b"IHDR", struct.pack(">IIBBBBB", width, height, 8, 6, 0, 0, 0)))
+        f.write(chunk(b"IDAT", zlib.compress(rows)))
+        f.write(chunk(b"IEND", b""))
+
+
+def write_textured_quad(directory):
+    """quad whose material has a diffuse color, transparency and a diffuse texture"""
+    write_png(os.path.join(directory, "tex.png"), 4, 2)
+    with open(os.path.join(directory, "quad.mtl"), "w") as f:
+        f.write("newmtl mat\nKd 0.2 0.4 0.6\nd 0.5\nmap_Kd tex.png\n")
+    filename = os.path.join(directory, "quad.obj")
+    with open(filename, "w") as f:
+        f.write(
+            "mtllib quad.mtl\n"
+            "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+            "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+            "usemtl mat\nf 1/1 2/2 3/3 4/4\n"
+        )
+    return filename
+
+
+class TestVisualMesh(unittest.TestCase):
+    def setUp(self):
+        self.dir = tempfile.TemporaryDirectory()
+        self.engine = sapien.Engine()
+        self.renderer = sapien.VulkanRenderer(True)
+        self.engine.set_renderer(self.renderer)
+        self.scene = self.engine.create_scene()
+        self.filename = write_textured_quad(self.dir.name)
+
+    def tearDown(self):
+        del self.scene
+        self.dir.cleanup()
+
+    def shapes(self, material=None):
+        builder = self.scene.create_actor_builder()
+        builder.add_visual_from_file(self.filename, material=material)
+        actor = builder.build_kinematic()
+        return actor.get_visual_bodies()[0].get_render_shapes()
+
+    def test_file_material(self):
+        shapes = self.shapes()
+        self.assertEqual(len(shapes), 1)
+        material = shapes[0].material
+        self.assertTrue(np.allclose(material.base_color, [0.2, 0.4, 0.6, 0.5]))
+        self.assertTrue(material.diffuse_texture_filename.endswith("tex.png"))
+        self.assertEqual(material.diffuse_texture.width, 4)
+        self.assertEqual(material.diffuse_texture.height, 2)
+        self.assertEqual(len(shapes[0].mesh.uvs), len(shapes[0].mesh.vertices))
+
+    def test_material_override_keeps_geometry(self):
+        material = self.renderer.create_material()
+        material.base_color = [1, 0, 0, 1]
+        shapes = self.shapes(material)
+        self.assertEqual(len(shapes), 1)
+        self.assertTrue(np.allclose(shapes[0].material.base_color, [1, 0, 0, 1]))
+
+        expected = self.shapes()[0].mesh
+        mesh = shapes[0].mesh
+        self.assertEqual(
+            {tuple(v) for v in np.round(mesh.vertices, 5)},
+            {tuple(v) for v in np.round(expected.vertices, 5)},
+        )
+        self.assertEqual(len(mesh.indices), len(expected.indices))
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,115 @@
+import gc
+import unittest
+import numpy as np
+import sapien.core as sapien
+
+try:
+    import torch.utils.dlpack
+
+    has_torch = True
+except ImportError:
+    has_torch = False
+
+
+class TestAsyncReadback(unittest.TestCase):
+    width, height = 64, 48
+
+    def setUp(self):
+        self.engine = sapien.Engine()
+        self.renderer = sapien.VulkanRenderer(True)
+        self.engine.set_renderer(self.renderer)
+        self.scene = self.engine.create_scene()
+        self.scene.set_ambient_light([0.5, 0.5, 0.5])
+        builder = self.scene.create_actor_builder()
+        builder.add_box_visual(half_size=[0.2, 0.2, 0.2], color=[0.8, 0.2, 0.2])
+        self.box = builder.build_kinematic()
+        # looking along +x at the box from 2 m away
+        self.camera = self.scene.add_camera("", self.width, self.height, 1, 0.1, 10)
+        self.camera.set_local_pose(sapien.Pose([-2, 0, 0]))
+        self.scene.update_render()
+
+    def tearDown(self):
+        self.camera = None
+        self.scene = None
+
+    def center(self, image):
+        return image[self.height // 2, self.width // 2]
+
+    def test_matches_blocking_readback(self):
+        self.camera.take_picture()
+        position = self.camera.get_float_texture("Position")
+        segmentation = self.camera.get_uint32_texture("Segmentation")
+
+        self.camera.take_picture_async(["Position", "Segmentation"])
+        self.assertTrue(np.array_equal(self.camera.get_image_async("Position"), position))
+        self.assertTrue(
+            np.array_equal(self.camera.get_image_async("Segmentation"), segmentation)
+        )
+        self.assertAlmostEqual(self.center(position)[2], -1.8, places=4)
+        with self.assertRaises(RuntimeError):
+            self.camera.get_image_async("Color")
+
+    def test_view_outlives_camera(self):
+        self.camera.take_picture_async(["Position"])
+        view = self.camera.get_image_async("Position")
+        expected = view.copy()
+        self.camera = None
+        self.scene = None
+        gc.collect()
+        self.assertTrue(np.array_equal(view, expected))
+
+    def test_view_overwritten_two_pictures_later(self):
+        self.camera.take_picture_async(["Position"])
+        view = self.camera.get_image_async("Position")
+        expected = view.copy()
+
+        self.box.set_pose(sapien.Pose([1, 0, 0]))
+        self.scene.update_render()
+        self.camera.take_picture_async(["Position"])
+        self.camera.get_image_async("Position")
+        self.assertTrue(np.array_equal(view, expected))
+
+        self.camera.take_picture_async(["Position"])
+        self.camera.get_image_async("Position")
+        self.assertAlmostEqual(self.center(view)[2], -2.8, places=4)
+
+    def test_take_picture_after_async(self):
+        # a pending asynchronous picture is finished before the camera renders again
+        self.camera.take_picture_async(["Position"])
+        view = self.camera.get_image_async("Position")
+        self.camera.take_picture()
+        self.assertTrue(np.array_equal(self.camera.get_float_texture("Position"), view))
+
+    def test_conversions(self):
+        self.camera.take_picture()
+        rgb = self.camera.get_color_rgb8()
+        half = self.camera.get_float16_texture("Position")
+        depth = self.camera.get_depth()
+        self.assertEqual(rgb.dtype, np.uint8)
+        self.assertEqual(half.dtype, np.float16)
+        self.assertAlmostEqual(self.center(depth), 1.8, places=4)
+        self.assertEqual(depth[0, 0], 0)
+
+        # the async variants convert the mapped buffers of the same picture
+        self.camera.take_picture_async(["Color", "Position"])
+        self.assertTrue(np.array_equal(self.camera.get_color_rgb8_async(), rgb))
+        self.assertTrue(np.array_equal(self.camera.get_float16_texture_async("Position"), half))
+        self.assertTrue(np.array_equal(self.camera.get_depth_async(), depth))
+
+    def test_dl_tensor(self):
+        self.camera.take_picture_async(["Position"])
+        view = self.camera.get_image_async("Position")
+        capsule = self.camera.get_dl_tensor_async("Position")
+        self.camera = None
+        self.scene = None
+        gc.collect()
+        if has_torch:
+            tensor = torch.utils.dlpack.from_dlpack(capsule)
+            self.assertTrue(np.array_equal(tensor.numpy(), view))
+        del capsule
+        gc.collect()
+        self.assertAlmostEqual(self.center(view)[2], -1.8, places=4)
+
+
+if __name__ == "__main__":
+    unittest.main()
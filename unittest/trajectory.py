@@ -0,0 +1,76 @@
+import unittest
+import numpy as np
+import sapien.core as sapien
+
+
+def build_slider(scene):
+    builder = scene.create_articulation_builder()
+    root = builder.create_link_builder()
+    root.add_box_collision(half_size=[0.1, 0.1, 0.1])
+    child = builder.create_link_builder(root)
+    child.add_box_collision(half_size=[0.05, 0.05, 0.05])
+    child.set_joint_properties("prismatic", [[-5, 5]], sapien.Pose(), sapien.Pose())
+    return builder.build(fix_root_link=True)
+
+
+class TestDriveTrajectory(unittest.TestCase):
+    def setUp(self):
+        self.engine = sapien.Engine()
+        self.scene = self.engine.create_scene()
+        self.dt = 1 / 100
+        self.scene.set_timestep(self.dt)
+
+    def test_completion_status(self):
+        art = build_slider(self.scene)
+        art.set_drive_trajectory([0.5, 1.0], [[0.5], [1.0]])
+        for _ in range(120):
+            self.scene.step()
+        status = art.get_drive_trajectory_status()
+        self.assertFalse(status["active"])
+        self.assertTrue(status["finished"])
+        self.assertAlmostEqual(status["duration"], 1.0, places=5)
+        self.assertGreaterEqual(status["time"], 1.0)
+        self.assertAlmostEqual(art.get_drive_target()[0], 1.0, places=5)
+
+        # targets written after completion are kept
+        art.set_drive_target([0.2])
+        self.scene.step()
+        self.assertAlmostEqual(art.get_drive_target()[0], 0.2, places=5)
+
+    def test_append_is_continuous(self):
+        art = build_slider(self.scene)
+        art.set_drive_trajectory([1.0, 2.0], [[1.0], [0.0]])
+        targets = []
+        for i in range(300):
+            if i == 150:
+                # in the middle of the second segment
+                art.append_drive_trajectory([3.0, 4.0], [[2.0], [1.0]])
+            self.scene.step()
+            targets.append(art.get_drive_target()[0])
+        steps = np.abs(np.diff(targets))
+        # the largest step stays within the velocity bound of the trajectory
+        self.assertLess(steps.max(), 4.0 * self.dt)
+        self.assertLess(abs(steps[149] - steps[148]), 1e-3)
+
+    def test_pose_rotation_follows_position(self):
+        builder = self.scene.create_actor_builder()
+        builder.add_box_collision(half_size=[0.1, 0.1, 0.1])
+        box = builder.build()
+        drive = self.scene.create_drive(None, sapien.Pose(), box, sapien.Pose())
+
+        def pose(k):
+            angle = 0.5 * k
+            return sapien.Pose([k, 0, 0], [np.cos(angle / 2), 0, 0, np.sin(angle / 2)])
+
+        drive.set_target_trajectory([0, 1, 2, 3], [pose(k) for k in range(4)], "cubic")
+        for _ in range(299):
+            self.scene.step()
+            target = drive.get_target()
+            angle = 2 * np.arctan2(target.q[3], target.q[0])
+            self.assertAlmostEqual(angle, 0.5 * target.p[0], places=4)
+            linear, angular = drive.get_target_velocity()
+            self.assertAlmostEqual(angular[2], 0.5 * linear[0], places=3)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,178 @@
+import gc
+import os
+import struct
+import tempfile
+import unittest
+import sapien.core as sapien
+
+URDF = """
+<robot name="pendulum">
+  <link name="base">
+    <collision><geometry><box size="0.2 0.2 0.2"/></geometry></collision>
+  </link>
+  <link name="arm">
+    <collision><geometry><mesh filename="arm.obj"/></geometry></collision>
+  </link>
+  <joint name="hinge" type="revolute">
+    <parent link="base"/>
+    <child link="arm"/>
+    <origin xyz="0 0 0.5"/>
+    <axis xyz="0 1 0"/>
+    <limit lower="-1" upper="1"/>
+  </joint>
+</robot>
+"""
+
+CUBE = """
+v -0.05 -0.05 -0.05
+v 0.05 -0.05 -0.05
+v 0.05 0.05 -0.05
+v -0.05 0.05 -0.05
+v -0.05 -0.05 0.05
+v 0.05 -0.05 0.05
+v 0.05 0.05 0.05
+v -0.05 0.05 0.05
+f 1 3 2
+f 1 4 3
+f 5 6 7
+f 5 7 8
+f 1 2 6
+f 1 6 5
+f 2 3 7
+f 2 7 6
+f 3 4 8
+f 3 8 7
+f 4 1 5
+f 4 5 8
+"""
+
+
+class TestCompiledURDFCache(unittest.TestCase):
+    def setUp(self):
+        self.dir = tempfile.TemporaryDirectory()
+        self.urdf = os.path.join(self.dir.name, "pendulum.urdf")
+        with open(self.urdf, "w") as f:
+            f.write(URDF)
+        with open(os.path.join(self.dir.name, "arm.obj"), "w") as f:
+            f.write(CUBE)
+        self.engine = sapien.Engine()
+        self.scene = self.engine.create_scene()
+
+    def tearDown(self):
+        self.dir.cleanup()
+
+    def load(self, **options):
+        loader = self.scene.create_urdf_loader()
+        for key, value in options.items():
+            setattr(loader, key, value)
+        return loader, loader.load(self.urdf)
+
+    def test_disabled_by_default(self):
+        loader, robot = self.load()
+        self.assertFalse(loader.use_compiled_cache)
+        self.assertEqual(robot.dof, 1)
+
+    def test_cached_load_matches(self):
+        cache = os.path.join(self.dir.name, "cache")
+        os.mkdir(cache)
+        robots = [self.load(use_compiled_cache=True, compiled_cache_directory=cache)[1]]
+        self.assertEqual(len(os.listdir(cache)), 1)
+        self.assertFalse([f for f in os.listdir(cache) if f.endswith(".tmp")])
+        robots.append(self.load(use_compiled_cache=True, compiled_cache_directory=cache)[1])
+
+        # a mesh written after compilation invalidates the cached description
+        mesh = os.path.join(self.dir.name, "arm.obj")
+        stat = os.stat(mesh)
+        os.utime(mesh, (stat.st_atime + 10, stat.st_mtime + 10))
+        robots.append(self.load(use_compiled_cache=True, compiled_cache_directory=cache)[1])
+
+        for robot in robots[1:]:
+            self.assertEqual(
+                [l.name for l in robot.get_links()], [l.name for l in robots[0].get_links()]
+            )
+            self.assertEqual(robot.get_qlimits().tolist(), robots[0].get_qlimits().tolist())
+
+    def test_corrupt_cache_ignored(self):
+        cache = os.path.join(self.dir.name, "cache")
+        os.mkdir(cache)
+        robot = self.load(use_compiled_cache=True, compiled_cache_directory=cache)[1]
+        names = [l.name for l in robot.get_links()]
+        (filename,) = [os.path.join(cache, f) for f in os.listdir(cache)]
+        mesh = os.path.join(self.dir.name, "arm.obj")
+
+        # after the magic and the version: the link count, then the length of the first name
+        for offset, value in [(12, 0xFFFFFFF0), (16, 0xFFFFFFF0), (16, 0x7FFFFFFF)]:
+            with open(filename, "r+b") as f:
+                f.seek(offset)
+                f.write(struct.pack("<I", value))
+            # the mesh changes so the description is not taken from memory
+            stat = os.stat(mesh)
+            os.utime(mesh, (stat.st_atime + 10, stat.st_mtime + 10))
+            robot = self.load(use_compiled_cache=True, compiled_cache_directory=cache)[1]
+            self.assertEqual([l.name for l in robot.get_links()], names)
+            self.assertEqual(robot.dof, 1)
+
+
+class TestBundle(unittest.TestCase):
+    def setUp(self):
+        self.dir = tempfile.TemporaryDirectory()
+        self.urdf = os.path.join(self.dir.name, "pendulum.urdf")
+        self.mesh = os.path.join(self.dir.name, "arm.obj")
+        self.bundle = os.path.join(self.dir.name, "pendulum.bundle")
+        with open(self.urdf, "w") as f:
+            f.write(URDF.replace("<collision>", '<visual><geometry><mesh filename="arm.obj"/>'
+                                 "</geometry></visual><collision>", 2))
+        self.write_mesh(1)
+        self.engine = sapien.Engine()
+        self.engine.set_renderer(sapien.NullRenderer())
+        self.scene = self.engine.create_scene()
+
+    def tearDown(self):
+        del self.scene
+        self.dir.cleanup()
+
+    def write_mesh(self, scale):
+        lines = []
+        for line in CUBE.strip().splitlines():
+            if line.startswith("v "):
+                line = "v " + " ".join(str(float(x) * scale) for x in line.split()[1:])
+            lines.append(line)
+        with open(self.mesh, "w") as f:
+            f.write("\n".join(lines))
+
+    def extent(self, robot):
+        shapes = robot.get_links()[1].get_visual_bodies()[0].get_render_shapes()
+        return max(abs(s.mesh.vertices).max() for s in shapes)
+
+    def test_bundle_scoped_to_loader(self):
+        bundler = self.scene.create_urdf_loader()
+        bundler.save_bundle(self.urdf, self.bundle)
+
+        self.write_mesh(4)
+        stat = os.stat(self.mesh)
+        os.utime(self.mesh, (stat.st_atime, stat.st_mtime + 10))
+
+        loader = self.scene.create_urdf_loader()
+        bundled = loader.load_bundle(self.bundle)
+        self.assertAlmostEqual(self.extent(bundled), 0.05, places=5)
+
+        # the bundle does not shadow the file for other loaders
+        from_disk = self.scene.create_urdf_loader().load(self.urdf)
+        self.assertAlmostEqual(self.extent(from_disk), 0.2, places=5)
+
+        # built articulations keep their bundled meshes after the loader is gone
+        del loader
+        gc.collect()
+        self.assertAlmostEqual(self.extent(bundled), 0.05, places=5)
+
+    def test_bundle_without_source_files(self):
+        self.scene.create_urdf_loader().save_bundle(self.urdf, self.bundle)
+        os.remove(self.mesh)
+        robot = self.scene.create_urdf_loader().load_bundle(self.bundle)
+        self.assertEqual(robot.dof, 1)
+        self.assertEqual(len(robot.get_links()[1].get_collision_shapes()), 1)
+        self.assertAlmostEqual(self.extent(robot), 0.05, places=5)
+
+
+if __name__ == "__main__":
+    unittest.main()